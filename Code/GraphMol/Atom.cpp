@@ -194,7 +194,7 @@ Atom::Atom(const std::string &what) : RDProps() {
   initAtom();
 };
 
-void Atom::initFromOther(const Atom &other) {
+void Atom::initFromOther(const Atom &other, bool copyMonomerInfo) {
   RDProps::operator=(other);
   // NOTE: we do *not* copy ownership!
   dp_mol = nullptr;
@@ -211,7 +211,7 @@ void Atom::initFromOther(const Atom &other) {
   d_hybrid = other.d_hybrid;
   d_implicitValence = other.d_implicitValence;
   d_explicitValence = other.d_explicitValence;
-  if (other.dp_monomerInfo) {
+  if (other.dp_monomerInfo && copyMonomerInfo) {
     dp_monomerInfo = other.dp_monomerInfo->copy();
   } else {
     dp_monomerInfo = nullptr;
@@ -245,7 +245,12 @@ void Atom::initAtom() {
   d_explicitValence = -1;
 }
 
-Atom::~Atom() { delete dp_monomerInfo; }
+Atom::~Atom() {
+  // monomer info stored in a molecule's PDBResidueTable belongs to the table
+  if (dp_monomerInfo && !dp_monomerInfo->isOwnedByResidueTable()) {
+    delete dp_monomerInfo;
+  }
+}
 
 Atom *Atom::copy() const {
   auto *res = new Atom(*this);
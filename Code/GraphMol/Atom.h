@@ -431,7 +431,7 @@ class RDKIT_GRAPHMOL_EXPORT Atom : public RDProps {
   ROMol *dp_mol;
   AtomMonomerInfo *dp_monomerInfo;
   void initAtom();
-  void initFromOther(const Atom &other);
+  void initFromOther(const Atom &other, bool copyMonomerInfo = true);
 };
 
 //! Set the atom's MDL integer RLabel
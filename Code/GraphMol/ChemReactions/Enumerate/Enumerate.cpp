@@ -38,6 +38,7 @@
 #include "../ReactionPickler.h"
 #include <GraphMol/MolPickler.h>
 #include <GraphMol/SmilesParse/SmilesWrite.h>
+#include <RDGeneral/RDThreads.h>
 
 #include <RDGeneral/BoostStartInclude.h>
 #include <boost/multiprecision/cpp_int.hpp>
@@ -209,6 +210,70 @@ std::vector<MOL_SPTR_VECT> EnumerateLibrary::next() {
   return m_rxn.runReactants(reactants);
 }
 
+void EnumerateLibrary::updateMatchCache(const std::vector<RGROUPS> &positions,
+                                        int numThreads) {
+  if (!m_compiled) {
+    m_compiled = ReactionRunnerUtils::compileReaction(m_rxn);
+  }
+  if (m_matchCache.size() != m_bbs.size()) {
+    m_matchCache.clear();
+    m_matchCache.resize(m_bbs.size());
+    for (size_t i = 0; i < m_bbs.size(); ++i) {
+      m_matchCache[i].resize(m_bbs[i].size());
+    }
+  }
+  // find the reagents which have not been matched yet
+  std::vector<std::pair<size_t, size_t>> toMatch;
+  for (const auto &position : positions) {
+    for (size_t i = 0; i < position.size(); ++i) {
+      auto &entry = m_matchCache[i][position[i]];
+      if (!entry) {
+        // use an empty placeholder so that we don't add the reagent twice
+        entry = std::make_shared<const std::vector<MatchVectType>>();
+        toMatch.emplace_back(i, position[i]);
+      }
+    }
+  }
+  // this is the same maximum run_Reactants uses in next()
+  const unsigned int maxMatches = 1000;
+  auto func = [&](size_t idx) {
+    const auto &[templateIdx, reagentIdx] = toMatch[idx];
+    m_matchCache[templateIdx][reagentIdx] =
+        std::make_shared<const std::vector<MatchVectType>>(
+            ReactionRunnerUtils::getReactantTemplateMatches(
+                m_rxn, *m_bbs[templateIdx][reagentIdx], templateIdx,
+                maxMatches));
+  };
+  runOnIndices(func, toMatch.size(), numThreads);
+}
+
+std::vector<std::vector<MOL_SPTR_VECT>> EnumerateLibrary::nextBatch(
+    unsigned int maxSets, int numThreads, std::vector<RGROUPS> *positions) {
+  std::vector<RGROUPS> batch;
+  while (batch.size() < maxSets && static_cast<bool>(*this)) {
+    batch.push_back(m_enumerator->next());
+  }
+  updateMatchCache(batch, numThreads);
+
+  std::vector<std::vector<MOL_SPTR_VECT>> res(batch.size());
+  auto func = [&](size_t idx) {
+    const auto &position = batch[idx];
+    MOL_SPTR_VECT reactants(m_bbs.size());
+    std::vector<std::vector<MatchVectType>> matches(m_bbs.size());
+    for (size_t i = 0; i < m_bbs.size(); ++i) {
+      reactants[i] = m_bbs[i][position[i]];
+      matches[i] = *m_matchCache[i][position[i]];
+    }
+    res[idx] = ReactionRunnerUtils::runReactantsWithMatches(
+        m_rxn, reactants, matches, 1000, m_compiled.get());
+  };
+  runOnIndices(func, batch.size(), numThreads);
+  if (positions) {
+    *positions = std::move(batch);
+  }
+  return res;
+}
+
 void EnumerateLibrary::toStream(std::ostream &ss) const {
 #ifdef RDK_USE_BOOST_SERIALIZATION
   boost::archive::text_oarchive ar(ss);
@@ -222,6 +287,8 @@ void EnumerateLibrary::initFromStream(std::istream &ss) {
 #ifdef RDK_USE_BOOST_SERIALIZATION
   boost::archive::text_iarchive ar(ss);
   ar >> *this;
+  m_matchCache.clear();
+  m_compiled.reset();
 #else
   PRECONDITION(0, "BOOST SERIALIZATION NOT INSTALLED");
 #endif
@@ -273,4 +340,84 @@ bool EnumerateLibraryCanSerialize() {
   return false;
 #endif
 }
+
+EnumeratedProductHash hashEnumeratedProduct(const std::string &smiles) {
+  // two independent 64 bit hashes: FNV-1a and a multiply-xorshift hash
+  // with the finalizer from MurmurHash3
+  std::uint64_t h1 = 14695981039346656037ULL;
+  std::uint64_t h2 = smiles.size();
+  for (auto c : smiles) {
+    auto byte = static_cast<std::uint64_t>(static_cast<unsigned char>(c));
+    h1 = (h1 ^ byte) * 1099511628211ULL;
+    h2 = (h2 ^ byte) * 0xff51afd7ed558ccdULL;
+    h2 ^= h2 >> 29;
+  }
+  h2 ^= h2 >> 33;
+  h2 *= 0xc4ceb9fe1a85ec53ULL;
+  h2 ^= h2 >> 33;
+  return {h1, h2};
+}
+
+boost::uint64_t enumerateLibraryToStream(EnumerateLibrary &library,
+                                         std::ostream &outs,
+                                         const EnumerateToStreamParams &params,
+                                         EnumeratedProductSet *seen) {
+  PRECONDITION(params.batchSize > 0, "batchSize must be positive");
+  EnumeratedProductSet localSeen;
+  if (!seen) {
+    seen = &localSeen;
+  }
+  const bool doIsomeric = true;
+  boost::uint64_t numProcessed = 0;
+  boost::uint64_t numWritten = 0;
+  std::vector<RGROUPS> positions;
+  while (static_cast<bool>(library)) {
+    unsigned int batchSize = params.batchSize;
+    if (params.maxToEnumerate) {
+      if (numProcessed >= params.maxToEnumerate) {
+        break;
+      }
+      batchSize = static_cast<unsigned int>(std::min<boost::uint64_t>(
+          batchSize, params.maxToEnumerate - numProcessed));
+    }
+    auto batch = library.nextBatch(batchSize, params.numThreads, &positions);
+    numProcessed += batch.size();
+
+    // generating the SMILES is a significant part of the work, so we do
+    // that in parallel too
+    std::vector<std::vector<std::string>> smiles(batch.size());
+    auto func = [&](size_t idx) {
+      for (const auto &prods : batch[idx]) {
+        std::string smi;
+        for (const auto &prod : prods) {
+          if (!smi.empty()) {
+            smi += ".";
+          }
+          smi += MolToSmiles(*prod, doIsomeric);
+        }
+        smiles[idx].push_back(std::move(smi));
+      }
+    };
+    runOnIndices(func, batch.size(), params.numThreads);
+
+    for (size_t idx = 0; idx < batch.size(); ++idx) {
+      for (const auto &smi : smiles[idx]) {
+        if (params.removeDuplicates &&
+            !seen->insert(hashEnumeratedProduct(smi)).second) {
+          continue;
+        }
+        outs << smi << "\t";
+        for (size_t i = 0; i < positions[idx].size(); ++i) {
+          if (i) {
+            outs << ",";
+          }
+          outs << positions[idx][i];
+        }
+        outs << "\n";
+        ++numWritten;
+      }
+    }
+  }
+  return numWritten;
+}
 }  // namespace RDKit
@@ -33,6 +33,12 @@
 #ifndef RDKIT_ENUMERATE_H
 #define RDKIT_ENUMERATE_H
 #include "EnumerateBase.h"
+#include <GraphMol/ChemReactions/ReactionRunner.h>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <unordered_set>
+#include <utility>
 
 /*! \file Enumerate.h
 
@@ -133,10 +139,40 @@ class RDKIT_CHEMREACTIONS_EXPORT EnumerateLibrary
   //! Get the next product set
   std::vector<MOL_SPTR_VECT> next() override;
 
+  //! Get the next product sets, running the reactions on multiple threads
+  /*!
+    The reactant combinations are taken from the enumeration strategy in
+    order, so after this returns the state of the library (see getState())
+    is the same as it would be after calling next() the same number of times.
+
+    The matches of each reagent to its reactant template are cached, so each
+    reagent is only matched once, no matter how many products it is used in.
+
+    \param maxSets    the maximum number of reactant combinations to process
+    \param numThreads the number of threads to use, values <= 0 are
+                      interpreted as described for getNumThreadsToUse()
+    \param positions  if provided, this is used to return the positions in
+                      the reagent vectors of each reactant combination
+
+    \return one entry for each reactant combination, containing what next()
+            would have returned for it
+  */
+  std::vector<std::vector<MOL_SPTR_VECT>> nextBatch(
+      unsigned int maxSets, int numThreads = 1,
+      std::vector<EnumerationTypes::RGROUPS> *positions = nullptr);
+
   void toStream(std::ostream &ss) const override;
   void initFromStream(std::istream &ss) override;
 
  private:
+  // cached reactant matches for the reagents: indexed by
+  // [reactant template][reagent]. These are not serialized.
+  std::vector<std::vector<std::shared_ptr<const std::vector<MatchVectType>>>>
+      m_matchCache;
+  std::shared_ptr<const ReactionRunnerUtils::CompiledReaction> m_compiled;
+  void updateMatchCache(const std::vector<EnumerationTypes::RGROUPS> &positions,
+                        int numThreads);
+
 #ifdef RDK_USE_BOOST_SERIALIZATION
   friend class boost::serialization::access;
   template <class Archive>
@@ -183,5 +219,64 @@ class RDKIT_CHEMREACTIONS_EXPORT EnumerateLibrary
 
 RDKIT_CHEMREACTIONS_EXPORT bool EnumerateLibraryCanSerialize();
 
+//! Parameters controlling enumerateLibraryToStream()
+struct RDKIT_CHEMREACTIONS_EXPORT EnumerateToStreamParams {
+  int numThreads{1};  //!< number of threads to use, see getNumThreadsToUse()
+  unsigned int batchSize{10000};  //!< reactant combinations per batch
+  boost::uint64_t maxToEnumerate{0};  //!< maximum number of reactant
+                                      //!< combinations to process, 0 means
+                                      //!< there is no limit
+  bool removeDuplicates{false};  //!< only write the first product set with
+                                 //!< each SMILES
+};
+
+//! a 128 bit hash of the SMILES of a product set, used to remove duplicates
+using EnumeratedProductHash = std::pair<std::uint64_t, std::uint64_t>;
+
+struct RDKIT_CHEMREACTIONS_EXPORT EnumeratedProductHasher {
+  std::size_t operator()(const EnumeratedProductHash &hash) const {
+    return static_cast<std::size_t>(hash.first);
+  }
+};
+
+//! the product sets which have already been written by
+//! enumerateLibraryToStream()
+using EnumeratedProductSet =
+    std::unordered_set<EnumeratedProductHash, EnumeratedProductHasher>;
+
+//! returns the hash used to identify a product set by
+//! enumerateLibraryToStream()
+RDKIT_CHEMREACTIONS_EXPORT EnumeratedProductHash
+hashEnumeratedProduct(const std::string &smiles);
+
+//! Enumerates a library, writing the product SMILES to a stream
+/*!
+  Each product set is written to a single line: the SMILES of the products,
+  separated by '.', followed by a tab and the comma-separated positions of the
+  reagents used to make it.
+
+  The enumeration starts at the library's current position. When this
+  returns, the library's state (see EnumerateLibraryBase::getState()) can be
+  saved and used to resume the enumeration later.
+
+  \param library  the library to enumerate
+  \param outs     the stream the results are written to
+  \param params   controls the enumeration
+  \param seen     if provided and \c params.removeDuplicates is set, this
+                  holds the hashes (see hashEnumeratedProduct()) of the SMILES
+                  which have already been written. It can be used to carry
+                  the duplicate removal over between multiple calls.
+
+  The duplicates are found using 128 bit hashes of the SMILES, so the memory
+  used does not depend on the size of the products. The chance of two
+  distinct products colliding is negligible, even for billions of products.
+
+  \return the number of lines written
+*/
+RDKIT_CHEMREACTIONS_EXPORT boost::uint64_t enumerateLibraryToStream(
+    EnumerateLibrary &library, std::ostream &outs,
+    const EnumerateToStreamParams &params = EnumerateToStreamParams(),
+    EnumeratedProductSet *seen = nullptr);
+
 }  // namespace RDKit
 #endif
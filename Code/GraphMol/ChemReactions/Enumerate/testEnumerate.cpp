@@ -36,6 +36,7 @@
 #include <GraphMol/RDKitBase.h>
 #include <GraphMol/RDKitQueries.h>
 #include <GraphMol/SmilesParse/SmilesParse.h>
+#include <GraphMol/SmilesParse/SmilesWrite.h>
 #include <GraphMol/FileParsers/MolSupplier.h>
 
 #include <GraphMol/ChemReactions/Enumerate/CartesianProduct.h>
@@ -332,6 +333,127 @@ void testInsaneEnumerations() {
   delete rxn2;
 }
 
+void testBatchEnumeration() {
+  BOOST_LOG(rdInfoLog) << "-------------------------------------" << std::endl;
+  BOOST_LOG(rdInfoLog) << "Testing multithreaded batch enumeration"
+                       << std::endl;
+  EnumerationTypes::BBS bbs;
+  bbs.resize(2);
+  const char *isothiocyanates[] = {"C=CCN=C=S", "CC=CCN=C=S", "S=C=NCc1ccccc1",
+                                   "S=C=NC1CCCCC1", "C=CCN=C=S"};
+  for (auto smi : isothiocyanates) {
+    bbs[0].push_back(boost::shared_ptr<ROMol>(SmilesToMol(smi)));
+  }
+  const char *amines[] = {"NCc1ncc(Cl)cc1Br", "NCCc1ncc(Cl)cc1Br",
+                          "NCCCc1ncc(Cl)cc1Br", "NCC(N)CO", "c1ccccc1",
+                          "NCc1ncc(Cl)cc1Br"};
+  for (auto smi : amines) {
+    bbs[1].push_back(boost::shared_ptr<ROMol>(SmilesToMol(smi)));
+  }
+
+  std::unique_ptr<ChemicalReaction> rxn(RxnSmartsToChemicalReaction(
+      "[N;$(N-[#6]):3]=[C;$(C=S):1].[N;$(N[#6]);!$(N=*);!$([N-]);!$(N#*);"
+      "!$([ND3]);!$([ND4]);!$(N[O,N]);!$(N[C,S]=[S,O,N]):2]>>[N:3]-[C:1]-[N+0:"
+      "2]"));
+  TEST_ASSERT(rxn);
+
+  // the reference results come from next()
+  std::vector<std::vector<std::vector<std::string>>> expected;
+  std::vector<EnumerationTypes::RGROUPS> expectedPositions;
+  {
+    EnumerateLibrary en(*rxn, bbs);
+    while (static_cast<bool>(en)) {
+      expected.push_back(en.nextSmiles());
+      expectedPositions.push_back(en.getPosition());
+    }
+  }
+  // the aromatic "amine" is removed by removeNonmatchingReagents()
+  TEST_ASSERT(expected.size() == 5 * 5);
+
+  for (auto numThreads : {1, 4}) {
+    EnumerateLibrary en(*rxn, bbs);
+    std::vector<std::vector<std::vector<std::string>>> results;
+    std::vector<EnumerationTypes::RGROUPS> positions;
+    std::vector<EnumerationTypes::RGROUPS> allPositions;
+    while (static_cast<bool>(en)) {
+      auto batch = en.nextBatch(7, numThreads, &positions);
+      TEST_ASSERT(batch.size() == positions.size());
+      TEST_ASSERT(batch.size() <= 7);
+      TEST_ASSERT(en.getPosition() == positions.back());
+      for (const auto &prods : batch) {
+        std::vector<std::vector<std::string>> smis(prods.size());
+        for (size_t i = 0; i < prods.size(); ++i) {
+          for (const auto &prod : prods[i]) {
+            smis[i].push_back(MolToSmiles(*prod));
+          }
+        }
+        results.push_back(smis);
+      }
+      allPositions.insert(allPositions.end(), positions.begin(),
+                          positions.end());
+    }
+    TEST_ASSERT(results == expected);
+    TEST_ASSERT(allPositions == expectedPositions);
+  }
+
+  {  // streaming, with and without duplicate removal
+    EnumerateLibrary en(*rxn, bbs);
+    EnumerateToStreamParams ps;
+    ps.batchSize = 4;
+    ps.numThreads = 2;
+    std::stringstream allOut;
+    // the diamine gives two product sets
+    TEST_ASSERT(enumerateLibraryToStream(en, allOut, ps) == 5 * 4 + 5 * 2);
+    TEST_ASSERT(!static_cast<bool>(en));
+    std::string line;
+    std::getline(allOut, line);
+    TEST_ASSERT(line == std::string(smiresults[0]) + "\t0,0");
+
+    en.resetState();
+    ps.removeDuplicates = true;
+    std::stringstream uniqueOut;
+    // the first and last building blocks in each set are duplicates
+    TEST_ASSERT(enumerateLibraryToStream(en, uniqueOut, ps) == 4 * 3 + 4 * 2);
+    TEST_ASSERT(hashEnumeratedProduct("CCO") == hashEnumeratedProduct("CCO"));
+    TEST_ASSERT(hashEnumeratedProduct("CCO") != hashEnumeratedProduct("OCC"));
+  }
+
+#ifdef RDK_USE_BOOST_SERIALIZATION
+  {  // stopping and resuming with the pickled state
+    EnumerateToStreamParams ps;
+    ps.batchSize = 3;
+    ps.removeDuplicates = true;
+    EnumeratedProductSet seen;
+
+    EnumerateLibrary en(*rxn, bbs);
+    std::stringstream fullOut;
+    enumerateLibraryToStream(en, fullOut, ps);
+
+    EnumerateLibrary en1(*rxn, bbs);
+    ps.maxToEnumerate = 10;
+    std::stringstream resumedOut;
+    TEST_ASSERT(enumerateLibraryToStream(en1, resumedOut, ps, &seen) > 0);
+    auto state = en1.getState();
+
+    EnumerateLibrary en2(*rxn, bbs);
+    en2.setState(state);
+    ps.maxToEnumerate = 0;
+    enumerateLibraryToStream(en2, resumedOut, ps, &seen);
+    TEST_ASSERT(resumedOut.str() == fullOut.str());
+    // seen holds exactly the hashes of the SMILES that were written
+    std::string line;
+    unsigned int nLines = 0;
+    while (std::getline(resumedOut, line)) {
+      TEST_ASSERT(
+          seen.count(hashEnumeratedProduct(line.substr(0, line.find('\t')))));
+      ++nLines;
+    }
+    TEST_ASSERT(nLines == seen.size());
+  }
+#endif
+  BOOST_LOG(rdInfoLog) << "\tdone" << std::endl;
+}
+
 #ifdef RDK_USE_BOOST_SERIALIZATION
 void testGithub1657() {
   BOOST_LOG(rdInfoLog) << "-------------------------------------" << std::endl;
@@ -387,4 +509,5 @@ int main() {
   testInsaneEnumerations();
 #endif
   testGithub1657();
+  testBatchEnumeration();
 }
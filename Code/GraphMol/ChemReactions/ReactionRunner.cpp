@@ -36,6 +36,7 @@
 #include <GraphMol/Substruct/SubstructMatch.h>
 #include <GraphMol/QueryOps.h>
 #include <boost/dynamic_bitset.hpp>
+#include <deque>
 #include <map>
 #include <algorithm>
 #include <GraphMol/ChemTransforms/ChemTransforms.h>
@@ -485,6 +486,80 @@ ReactantProductAtomMapping *getAtomMappingsReactantProduct(
   return mapping;
 }
 
+// the reactant-independent part of the mapping information, this is used
+// to construct the ReactantProductAtomMapping without having to look at the
+// templates
+struct CompiledReaction {
+  // the product templates, converted by convertTemplateToMol()
+  std::vector<RWMOL_SPTR> productMols;
+  // indexed by [product template][reactant template][reactant template atom]
+  // the product atoms which the reactant template atom maps to
+  std::vector<std::vector<std::vector<UINT_VECT>>> productAtomsForTemplateAtom;
+  // indexed by reactant template
+  std::vector<std::map<std::pair<unsigned int, unsigned int>, unsigned int>>
+      reactantTemplateAtomBonds;
+};
+
+std::shared_ptr<const CompiledReaction> compileReaction(
+    const ChemicalReaction &rxn) {
+  auto res = std::make_shared<CompiledReaction>();
+  for (const auto &reactantTemplate : rxn.getReactants()) {
+    // the empty match is enough to get the template bonds
+    std::unique_ptr<ReactantProductAtomMapping> mapping(
+        getAtomMappingsReactantProduct(MatchVectType(), *reactantTemplate,
+                                       RWMOL_SPTR(new RWMol()), 0));
+    res->reactantTemplateAtomBonds.push_back(
+        std::move(mapping->reactantTemplateAtomBonds));
+  }
+  for (const auto &productTemplate : rxn.getProducts()) {
+    auto product = convertTemplateToMol(productTemplate);
+    std::vector<std::vector<UINT_VECT>> productAtoms;
+    for (const auto &reactantTemplate : rxn.getReactants()) {
+      std::vector<UINT_VECT> templateAtoms(reactantTemplate->getNumAtoms());
+      for (const auto atom : reactantTemplate->atoms()) {
+        int mapNum;
+        if (atom->getPropIfPresent(common_properties::molAtomMapNumber,
+                                   mapNum) &&
+            product->hasAtomBookmark(mapNum)) {
+          for (const auto pAtom : product->getAllAtomsWithBookmark(mapNum)) {
+            templateAtoms[atom->getIdx()].push_back(pAtom->getIdx());
+          }
+        }
+      }
+      productAtoms.push_back(std::move(templateAtoms));
+    }
+    res->productMols.push_back(product);
+    res->productAtomsForTemplateAtom.push_back(std::move(productAtoms));
+  }
+  return res;
+}
+
+namespace {
+ReactantProductAtomMapping *getCompiledAtomMappingsReactantProduct(
+    const MatchVectType &match, const CompiledReaction &compiled,
+    unsigned int productIdx, unsigned int reactantIdx,
+    unsigned numReactAtoms) {
+  auto *mapping = new ReactantProductAtomMapping(numReactAtoms);
+  mapping->reactantTemplateAtomBonds =
+      compiled.reactantTemplateAtomBonds[reactantIdx];
+  const auto &productAtoms =
+      compiled.productAtomsForTemplateAtom[productIdx][reactantIdx];
+  for (const auto &i : match) {
+    const auto &pIdxs = productAtoms[i.first];
+    if (pIdxs.empty()) {
+      mapping->skippedAtoms[i.second] = 1;
+      continue;
+    }
+    for (auto pIdx : pIdxs) {
+      mapping->reactProdAtomMap[i.second].push_back(pIdx);
+      mapping->mappedAtoms[i.second] = 1;
+      mapping->prodReactAtomMap[pIdx] = i.second;
+    }
+  }
+  return mapping;
+}
+}  // namespace
+
 namespace {
 unsigned reactProdMapAnchorIdx(Atom *atom, const RDKit::UINT_VECT &pMatches) {
   PRECONDITION(atom, "no atom");
@@ -894,8 +969,8 @@ void addMissingProductBonds(const Bond &origB, RWMOL_SPTR product,
   unsigned int begIdx = origB.getBeginAtomIdx();
   unsigned int endIdx = origB.getEndAtomIdx();
 
-  std::vector<unsigned> prodBeginIdxs = mapping->reactProdAtomMap[begIdx];
-  std::vector<unsigned> prodEndIdxs = mapping->reactProdAtomMap[endIdx];
+  const auto &prodBeginIdxs = mapping->reactProdAtomMap[begIdx];
+  const auto &prodEndIdxs = mapping->reactProdAtomMap[endIdx];
   CHECK_INVARIANT(prodBeginIdxs.size() == prodEndIdxs.size(),
                   "Different number of start-end points for product bonds.");
   for (unsigned i = 0; i < prodBeginIdxs.size(); i++) {
@@ -941,7 +1016,7 @@ void addReactantNeighborsToProduct(
     boost::dynamic_bitset<> &visitedAtoms,
     std::vector<const Atom *> &chiralAtomsToCheck,
     ReactantProductAtomMapping *mapping) {
-  std::list<const Atom *> atomStack;
+  std::deque<const Atom *> atomStack;
   atomStack.push_back(&reactantAtom);
 
   // std::cerr << "-------------------" << std::endl;
@@ -963,7 +1038,9 @@ void addReactantNeighborsToProduct(
                         mapping->reactProdAtomMap.end(),
                     "reactant atom on traversal stack not present in product.");
 
-    std::vector<unsigned> lReactantAtomProductIndex =
+    // this is a reference into a std::map, so it stays valid when the
+    // neighbors are added to the map below
+    const auto &lReactantAtomProductIndex =
         mapping->reactProdAtomMap[lReactantAtom->getIdx()];
     unsigned lreactIdx = lReactantAtom->getIdx();
     visitedAtoms[lreactIdx] = 1;
@@ -1324,17 +1401,8 @@ void generateProductConformers(Conformer *productConf, const ROMol &reactant,
 void addReactantAtomsAndBonds(const ChemicalReaction &rxn, RWMOL_SPTR product,
                               const ROMOL_SPTR reactantSptr,
                               const MatchVectType &match,
-                              const ROMOL_SPTR reactantTemplate,
+                              ReactantProductAtomMapping *mapping,
                               Conformer *productConf) {
-  // start by looping over all matches and marking the reactant atoms that
-  // have already been "added" by virtue of being in the product. We'll also
-  // mark "skipped" atoms: those that are in the match, but not in this
-  // particular product (or, perhaps, not in any product)
-  // At the same time we'll set up a map between the indices of those
-  // atoms and their index in the product.
-  ReactantProductAtomMapping *mapping = getAtomMappingsReactantProduct(
-      match, *reactantTemplate, product, reactantSptr->getNumAtoms());
-
   boost::dynamic_bitset<> visitedAtoms(reactantSptr->getNumAtoms());
 
   const ROMol *reactant = reactantSptr.get();
@@ -1406,14 +1474,13 @@ void addReactantAtomsAndBonds(const ChemicalReaction &rxn, RWMOL_SPTR product,
     productConf->resize(product->getNumAtoms());
     generateProductConformers(productConf, *reactant, mapping);
   }
-
-  delete (mapping);
 }  // end of addReactantAtomsAndBonds
 
-MOL_SPTR_VECT
-generateOneProductSet(const ChemicalReaction &rxn,
-                      const MOL_SPTR_VECT &reactants,
-                      const std::vector<MatchVectType> &reactantsMatch) {
+namespace {
+MOL_SPTR_VECT generateOneProductSetHelper(
+    const ChemicalReaction &rxn, const MOL_SPTR_VECT &reactants,
+    const std::vector<MatchVectType> &reactantsMatch,
+    const CompiledReaction *compiled) {
   PRECONDITION(reactants.size() == reactantsMatch.size(),
                "vector size mismatch");
 
@@ -1446,7 +1513,12 @@ generateOneProductSet(const ChemicalReaction &rxn,
   for (auto pTemplIt = rxn.beginProductTemplates();
        pTemplIt != rxn.endProductTemplates(); ++pTemplIt) {
     // copy product template and its properties to a new product RWMol
-    RWMOL_SPTR product = convertTemplateToMol(*pTemplIt);
+    RWMOL_SPTR product;
+    if (compiled) {
+      product.reset(new RWMol(*compiled->productMols[prodId]));
+    } else {
+      product = convertTemplateToMol(*pTemplIt);
+    }
     Conformer *conf = nullptr;
     if (doConfs) {
       conf = new Conformer();
@@ -1456,8 +1528,24 @@ generateOneProductSet(const ChemicalReaction &rxn,
     unsigned int reactantId = 0;
     for (auto iter = rxn.beginReactantTemplates();
          iter != rxn.endReactantTemplates(); ++iter, reactantId++) {
-      addReactantAtomsAndBonds(rxn, product, reactants.at(reactantId),
-                               reactantsMatch.at(reactantId), *iter, conf);
+      const auto &reactant = reactants.at(reactantId);
+      const auto &match = reactantsMatch.at(reactantId);
+      // start by looping over all matches and marking the reactant atoms that
+      // have already been "added" by virtue of being in the product. We'll
+      // also mark "skipped" atoms: those that are in the match, but not in
+      // this particular product (or, perhaps, not in any product)
+      // At the same time we'll set up a map between the indices of those
+      // atoms and their index in the product.
+      std::unique_ptr<ReactantProductAtomMapping> mapping;
+      if (compiled) {
+        mapping.reset(getCompiledAtomMappingsReactantProduct(
+            match, *compiled, prodId, reactantId, reactant->getNumAtoms()));
+      } else {
+        mapping.reset(getAtomMappingsReactantProduct(
+            match, **iter, product, reactant->getNumAtoms()));
+      }
+      addReactantAtomsAndBonds(rxn, product, reactant, match, mapping.get(),
+                               conf);
     }
 
     if (doConfs) {
@@ -1475,6 +1563,14 @@ generateOneProductSet(const ChemicalReaction &rxn,
   }
   return res;
 }
+}  // namespace
+
+MOL_SPTR_VECT
+generateOneProductSet(const ChemicalReaction &rxn,
+                      const MOL_SPTR_VECT &reactants,
+                      const std::vector<MatchVectType> &reactantsMatch) {
+  return generateOneProductSetHelper(rxn, reactants, reactantsMatch, nullptr);
+}
 void identifyAtomsInReactantTemplateNotProductTemplate(
     const ROMol &reactant, boost::dynamic_bitset<> &atoms,
     std::map<unsigned int, unsigned int> &reactantProductMap,
@@ -1524,9 +1620,11 @@ void traverseToFindAtomsToRemove(const ROMol &reactant, const ROMol &templ,
 
 }  // namespace ReactionRunnerUtils
 
-std::vector<MOL_SPTR_VECT> run_Reactants(const ChemicalReaction &rxn,
-                                         const MOL_SPTR_VECT &reactants,
-                                         unsigned int maxProducts) {
+namespace {
+std::vector<MOL_SPTR_VECT> runReactantsHelper(
+    const ChemicalReaction &rxn, const MOL_SPTR_VECT &reactants,
+    unsigned int maxProducts,
+    const ReactionRunnerUtils::CompiledReaction *compiled) {
   if (!rxn.isInitialized()) {
     throw ChemicalReactionException(
         "initMatchers() must be called before runReactants()");
@@ -1556,24 +1654,73 @@ std::vector<MOL_SPTR_VECT> run_Reactants(const ChemicalReaction &rxn,
     // some reactants didn't find a match, return an empty product list:
     return productMols;
   }
+  return ReactionRunnerUtils::runReactantsWithMatches(
+      rxn, reactants, matchesByReactant, maxProducts, compiled);
+}
+}  // namespace
+
+namespace ReactionRunnerUtils {
+std::vector<MatchVectType> getReactantTemplateMatches(
+    const ChemicalReaction &rxn, const ROMol &reactant,
+    unsigned int templateIdx, unsigned int maxMatches) {
+  URANGE_CHECK(templateIdx, rxn.getNumReactantTemplates());
+  return getReactantMatchesToTemplate(reactant,
+                                      *rxn.getReactants()[templateIdx],
+                                      maxMatches, rxn.getSubstructParams());
+}
+
+std::vector<MOL_SPTR_VECT> runReactantsWithMatches(
+    const ChemicalReaction &rxn, const MOL_SPTR_VECT &reactants,
+    const std::vector<std::vector<MatchVectType>> &matchesByReactant,
+    unsigned int maxProducts, const CompiledReaction *compiled) {
+  PRECONDITION(reactants.size() == rxn.getNumReactantTemplates() &&
+                   matchesByReactant.size() == reactants.size(),
+               "reactant size mismatch");
+  std::vector<MOL_SPTR_VECT> productMols;
+  if (!rxn.getNumProductTemplates()) {
+    return productMols;
+  }
+  for (const auto &matches : matchesByReactant) {
+    if (matches.empty()) {
+      return productMols;
+    }
+  }
   // -------------------------------------------------------
   // we now have matches for each reactant, so we can start creating products:
   // start by doing the combinatorics on the matches:
   VectVectMatchVectType reactantMatchesPerProduct;
-  ReactionRunnerUtils::generateReactantCombinations(
-      matchesByReactant, reactantMatchesPerProduct, maxProducts);
+  generateReactantCombinations(matchesByReactant, reactantMatchesPerProduct,
+                               maxProducts);
   productMols.resize(reactantMatchesPerProduct.size());
 
   for (unsigned int productId = 0; productId != productMols.size();
        ++productId) {
-    MOL_SPTR_VECT lProds = ReactionRunnerUtils::generateOneProductSet(
-        rxn, reactants, reactantMatchesPerProduct[productId]);
+    MOL_SPTR_VECT lProds = generateOneProductSetHelper(
+        rxn, reactants, reactantMatchesPerProduct[productId], compiled);
     productMols[productId] = lProds;
   }
 
   return productMols;
+}
+}  // namespace ReactionRunnerUtils
+
+std::vector<MOL_SPTR_VECT> run_Reactants(const ChemicalReaction &rxn,
+                                         const MOL_SPTR_VECT &reactants,
+                                         unsigned int maxProducts) {
+  return runReactantsHelper(rxn, reactants, maxProducts, nullptr);
 }  // end of ChemicalReaction::runReactants()
 
+std::vector<MOL_SPTR_VECT> run_Reactants(
+    const ChemicalReaction &rxn, const MOL_SPTR_VECT &reactants,
+    const ReactionRunnerUtils::CompiledReaction &compiled,
+    unsigned int maxProducts) {
+  PRECONDITION(compiled.productMols.size() == rxn.getNumProductTemplates() &&
+                   compiled.reactantTemplateAtomBonds.size() ==
+                       rxn.getNumReactantTemplates(),
+               "compiled reaction does not match the reaction");
+  return runReactantsHelper(rxn, reactants, maxProducts, &compiled);
+}
+
 namespace {
 bool updateAtomsModifiedByReaction(
     RWMol &reactant, const ROMOL_SPTR reactantTemplate,
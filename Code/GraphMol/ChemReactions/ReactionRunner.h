@@ -38,8 +38,13 @@
 
 #include <GraphMol/ChemReactions/Reaction.h>
 #include <GraphMol/ROMol.h>
+#include <memory>
 
 namespace RDKit {
+namespace ReactionRunnerUtils {
+struct CompiledReaction;
+}  // namespace ReactionRunnerUtils
+
 //! Runs the reaction on a set of reactants
 /*!
   \param rxn:       the template reaction we are interested
@@ -61,6 +66,17 @@ RDKIT_CHEMREACTIONS_EXPORT std::vector<MOL_SPTR_VECT> run_Reactants(
     const ChemicalReaction& rxn, const MOL_SPTR_VECT& reactants,
     unsigned int maxProducts = 1000);
 
+//! \overload
+/*!
+  Uses the information in \c compiled, which must have been generated from
+  \c rxn by ReactionRunnerUtils::compileReaction(), instead of processing
+  the product templates each time the reaction is run.
+*/
+RDKIT_CHEMREACTIONS_EXPORT std::vector<MOL_SPTR_VECT> run_Reactants(
+    const ChemicalReaction& rxn, const MOL_SPTR_VECT& reactants,
+    const ReactionRunnerUtils::CompiledReaction& compiled,
+    unsigned int maxProducts = 1000);
+
 //! Runs a single reactant against a single reactant template
 /*!
   \param reactant The single reactant to use
@@ -110,6 +126,43 @@ RDKIT_CHEMREACTIONS_EXPORT MOL_SPTR_VECT generateOneProductSet(
 
 RDKIT_CHEMREACTIONS_EXPORT RWMOL_SPTR
 convertTemplateToMol(const ROMOL_SPTR prodTemplateSptr);
+
+//! returns the matches of a reactant to one of the reaction's reactant
+//! templates
+/*!
+  These are the matches run_Reactants() uses: they are not uniquified and
+  matches which include protected atoms are removed.
+*/
+RDKIT_CHEMREACTIONS_EXPORT std::vector<MatchVectType>
+getReactantTemplateMatches(const ChemicalReaction& rxn, const ROMol& reactant,
+                           unsigned int templateIdx,
+                           unsigned int maxMatches = 1000);
+
+//! Runs the reaction using precomputed reactant matches
+/*!
+  \param matchesByReactant the matches of each reactant to its template, as
+                           returned by getReactantTemplateMatches()
+  \param compiled          if provided, this must have been generated from
+                           \c rxn by compileReaction()
+
+  The results are the same as those from run_Reactants(). Unlike
+  run_Reactants() this does not modify the reactants, so it can safely be
+  called from multiple threads using the same reactants.
+*/
+RDKIT_CHEMREACTIONS_EXPORT std::vector<MOL_SPTR_VECT> runReactantsWithMatches(
+    const ChemicalReaction& rxn, const MOL_SPTR_VECT& reactants,
+    const std::vector<std::vector<MatchVectType>>& matchesByReactant,
+    unsigned int maxProducts = 1000,
+    const CompiledReaction* compiled = nullptr);
+
+//! precomputes the reactant-independent work done when running a reaction
+/*!
+  The result holds the converted product templates and the mapping between
+  reactant template atoms and product atoms. It remains valid as long as the
+  reaction's templates are not modified.
+*/
+RDKIT_CHEMREACTIONS_EXPORT std::shared_ptr<const CompiledReaction>
+compileReaction(const ChemicalReaction& rxn);
 }  // namespace ReactionRunnerUtils
 
 }  // namespace RDKit
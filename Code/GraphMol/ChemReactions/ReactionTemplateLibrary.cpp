@@ -0,0 +1,104 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "ReactionTemplateLibrary.h"
+#include <DataStructs/ExplicitBitVect.h>
+#include <DataStructs/BitOps.h>
+#include <GraphMol/Fingerprints/Fingerprints.h>
+#include <RDGeneral/RDThreads.h>
+#include <numeric>
+
+namespace RDKit {
+
+ReactionTemplateLibrary::ReactionTemplateLibrary(
+    unsigned int fpSize, unsigned int minReactionsToScreen)
+    : d_fpSize(fpSize), d_minReactionsToScreen(minReactionsToScreen) {}
+
+ReactionTemplateLibrary::~ReactionTemplateLibrary() = default;
+
+unsigned int ReactionTemplateLibrary::addReaction(const ChemicalReaction &rxn) {
+  if (rxn.getNumReactantTemplates() != 1) {
+    throw ChemicalReactionException(
+        "only reactions with a single reactant template can be added to a "
+        "ReactionTemplateLibrary");
+  }
+  std::unique_ptr<ChemicalReaction> rcopy(new ChemicalReaction(rxn));
+  if (!rcopy->isInitialized()) {
+    rcopy->initReactantMatchers();
+    if (!rcopy->isInitialized()) {
+      throw ChemicalReactionException("reaction could not be initialized");
+    }
+  }
+  // the pattern fingerprint isn't a valid screen when conjugated bonds can
+  // match aromatic ones or when generic matchers are in use
+  std::unique_ptr<ExplicitBitVect> fp;
+  const auto &ps = rcopy->getSubstructParams();
+  if (!ps.aromaticMatchesConjugated && !ps.useGenericMatchers) {
+    fp.reset(PatternFingerprintMol(*rcopy->getReactants()[0], d_fpSize));
+  }
+  d_compiled.push_back(ReactionRunnerUtils::compileReaction(*rcopy));
+  d_fps.push_back(std::move(fp));
+  d_reactions.push_back(std::move(rcopy));
+  return size() - 1;
+}
+
+const ChemicalReaction &ReactionTemplateLibrary::getReaction(
+    unsigned int idx) const {
+  URANGE_CHECK(idx, d_reactions.size());
+  return *d_reactions[idx];
+}
+
+std::vector<unsigned int> ReactionTemplateLibrary::getCandidateReactions(
+    const ROMol &mol) const {
+  std::vector<unsigned int> res;
+  if (d_reactions.empty()) {
+    return res;
+  }
+  std::unique_ptr<ExplicitBitVect> molFp(PatternFingerprintMol(mol, d_fpSize));
+  for (unsigned int i = 0; i < d_reactions.size(); ++i) {
+    if (!d_fps[i] || AllProbeBitsMatch(*d_fps[i], *molFp)) {
+      res.push_back(i);
+    }
+  }
+  return res;
+}
+
+std::vector<ReactionTemplateResult> ReactionTemplateLibrary::runReactions(
+    const ROMOL_SPTR &mol, unsigned int maxProducts) const {
+  PRECONDITION(mol, "bad molecule");
+  std::vector<ReactionTemplateResult> res;
+  MOL_SPTR_VECT reactants{mol};
+  std::vector<unsigned int> candidates;
+  if (size() >= d_minReactionsToScreen) {
+    candidates = getCandidateReactions(*mol);
+  } else {
+    candidates.resize(size());
+    std::iota(candidates.begin(), candidates.end(), 0);
+  }
+  for (auto idx : candidates) {
+    auto prods = run_Reactants(*d_reactions[idx], reactants, *d_compiled[idx],
+                               maxProducts);
+    if (!prods.empty()) {
+      res.push_back(ReactionTemplateResult{idx, std::move(prods)});
+    }
+  }
+  return res;
+}
+
+std::vector<std::vector<ReactionTemplateResult>>
+ReactionTemplateLibrary::runReactions(const MOL_SPTR_VECT &mols,
+                                      unsigned int maxProducts,
+                                      int numThreads) const {
+  std::vector<std::vector<ReactionTemplateResult>> res(mols.size());
+  runOnIndices([&](size_t i) { res[i] = runReactions(mols[i], maxProducts); },
+               mols.size(), numThreads);
+  return res;
+}
+
+}  // namespace RDKit
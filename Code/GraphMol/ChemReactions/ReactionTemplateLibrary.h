@@ -0,0 +1,126 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include <RDGeneral/export.h>
+#ifndef RD_REACTIONTEMPLATELIBRARY_H
+#define RD_REACTIONTEMPLATELIBRARY_H
+
+#include <memory>
+#include <vector>
+#include <GraphMol/ChemReactions/Reaction.h>
+#include <GraphMol/ChemReactions/ReactionRunner.h>
+
+class ExplicitBitVect;
+
+namespace RDKit {
+
+//! the products from running one of the reactions in a ReactionTemplateLibrary
+struct RDKIT_CHEMREACTIONS_EXPORT ReactionTemplateResult {
+  unsigned int reactionIdx;  //!< index of the reaction in the library
+  //! the products, as returned by ChemicalReaction::runReactants()
+  std::vector<MOL_SPTR_VECT> products;
+};
+
+//! A collection of single-reactant reactions to be applied to many molecules
+/*!
+  This is intended for applications like retrosynthesis, where a large number
+  of reaction templates are applied to each molecule and only a small
+  fraction of them match.
+
+  <b>Notes:</b>
+    - Pattern fingerprints of the reactant templates are calculated when the
+      reactions are added. For libraries with at least
+      \c minReactionsToScreen reactions a reaction is only run on a molecule
+      if all of the bits in its template's fingerprint are set in the
+      molecule's fingerprint. Smaller libraries are not screened:
+      calculating the molecule's fingerprint would take longer than trying
+      all of the templates.
+    - The reactions are compiled with ReactionRunnerUtils::compileReaction()
+      when they are added, so the product templates do not need to be
+      processed each time a reaction is run.
+    - The products are the same as those from ChemicalReaction::runReactants()
+*/
+class RDKIT_CHEMREACTIONS_EXPORT ReactionTemplateLibrary {
+ public:
+  //! \param fpSize               the size of the pattern fingerprints used
+  //!                             for screening
+  //! \param minReactionsToScreen the smallest library which is screened.
+  //!                             Calculating the pattern fingerprint of a
+  //!                             typical drug-like molecule takes about as
+  //!                             long as trying to match a couple of hundred
+  //!                             reactant templates.
+  ReactionTemplateLibrary(unsigned int fpSize = 2048,
+                          unsigned int minReactionsToScreen = 250);
+  ReactionTemplateLibrary(const ReactionTemplateLibrary &) = delete;
+  ReactionTemplateLibrary &operator=(const ReactionTemplateLibrary &) =
+      delete;
+  ~ReactionTemplateLibrary();
+
+  //! adds a copy of a reaction to the library
+  /*!
+    \param rxn the reaction to add, this must have a single reactant
+               template. It will be initialized if that has not already
+               been done.
+
+    \return the index of the reaction in the library
+  */
+  unsigned int addReaction(const ChemicalReaction &rxn);
+
+  //! returns the number of reactions in the library
+  unsigned int size() const {
+    return rdcast<unsigned int>(d_reactions.size());
+  }
+  //! returns a reaction from the library
+  const ChemicalReaction &getReaction(unsigned int idx) const;
+
+  //! returns the indices of the reactions which pass the fingerprint screen
+  //! for a molecule
+  std::vector<unsigned int> getCandidateReactions(const ROMol &mol) const;
+
+  //! runs all of the reactions which match a molecule
+  /*!
+    \param mol         the reactant
+    \param maxProducts if non zero, the maximum number of products to
+                       generate for each reaction
+
+    \return one entry for each reaction which produced products, in the
+            order of the reactions in the library
+  */
+  std::vector<ReactionTemplateResult> runReactions(
+      const ROMOL_SPTR &mol, unsigned int maxProducts = 1000) const;
+
+  //! runs all of the reactions on each of a set of molecules
+  /*!
+    \param mols        the reactants. These should be distinct molecules,
+                       each one is modified by the thread which processes it
+                       (see the notes on ChemicalReaction::runReactants())
+    \param maxProducts if non zero, the maximum number of products to
+                       generate for each reaction
+    \param numThreads  the number of threads to use, values <= 0 are
+                       interpreted as described for getNumThreadsToUse()
+
+    \return the results for each molecule, as returned by runReactions()
+  */
+  std::vector<std::vector<ReactionTemplateResult>> runReactions(
+      const MOL_SPTR_VECT &mols, unsigned int maxProducts = 1000,
+      int numThreads = 1) const;
+
+ private:
+  unsigned int d_fpSize;
+  unsigned int d_minReactionsToScreen;
+  std::vector<std::unique_ptr<ChemicalReaction>> d_reactions;
+  std::vector<std::shared_ptr<const ReactionRunnerUtils::CompiledReaction>>
+      d_compiled;
+  // fingerprints of the reactant templates, null if the template can't be
+  // screened
+  std::vector<std::unique_ptr<ExplicitBitVect>> d_fps;
+};
+
+}  // namespace RDKit
+#endif
@@ -25,9 +25,14 @@
 #include <GraphMol/ChemReactions/ReactionUtils.h>
 #include <GraphMol/ChemReactions/ReactionPickler.h>
 #include <GraphMol/ChemReactions/SanitizeRxn.h>
+#include <GraphMol/ChemReactions/ReactionTemplateLibrary.h>
+#include <GraphMol/test_fixtures.h>
 #include <GraphMol/FileParsers/PNGParser.h>
 #include <GraphMol/FileParsers/FileParserUtils.h>
 
+#include <algorithm>
+#include <chrono>
+
 using namespace RDKit;
 using std::unique_ptr;
 
@@ -1900,3 +1905,207 @@ TEST_CASE("Github #7372: SMILES output option to disable dative bonds") {
         "[C:1]-[C:2].[N&H3:3]-[#26:4]-[N&H2:5]>>[C:1]=[C:2].[N&H3:3]-[#26:4]-[N&H2:5]");
   }
 }
+
+namespace {
+const std::vector<std::string> templateLibrarySmarts = {
+    "[C:1](=[O:2])[NX3;H1,H2;!$(NC=O)C:3]>>[C:1](=[O:2])O.[N:3]",
+    "[C:1](=[O:2])O[CX4:3]>>[C:1](=[O:2])O.O[C:3]",
+    "[c:1]-!@[c:2]>>[c:1]Br.[c:2]B(O)O",
+    "[c:1][O:2][CH2:3]>>[c:1][OH:2].Br[CH2:3]",
+    "[c:1]-!@[NX3;!$(N=*);!$(N-C=O):2]>>[c:1]Cl.[N:2]",
+    "[S:1](=[O:2])(=[O:3])[N:4]>>[S:1](=[O:2])(=[O:3])Cl.[N:4]",
+    "[CH2:1]-!@[NX3;!$(N-C=O):2]>>[CH:1]=O.[N:2]",
+    "[N;!$(N-C=O):1]C(=O)[N;!$(N-C=O):2]>>[N:1]C(=O)Cl.[N:2]",
+    "[c:1][NH2:2]>>[c:1][N+:2](=O)[O-]",
+    "[CX4:1][OH:2]>>[C:1]=[O:2]",
+    "[C:1]/[CH:2]=[CH:3]/[C:4]>>[C:1][CH:2]=O.[C:4][CH:3]=P(c1ccccc1)(c1ccccc1)c1ccccc1",
+    "[n:1]1[c:2][n:3][c:4][c:5]1>>[N:1][C:2]=[N:3].O[C:4][C:5]",
+    "[Si:1][O:2]>>[Si:1]Cl.[O:2]",
+    "[C@@H:1]([N:2])([C:3])[C:4]>>[CH:1]([N:2])([C:3])[C:4]",
+    "[P:1]=[O:2]>>[P:1]",
+};
+std::vector<std::string> productSmiles(
+    const std::vector<MOL_SPTR_VECT> &products) {
+  std::vector<std::string> res;
+  for (const auto &prodSet : products) {
+    std::string smi;
+    for (const auto &prod : prodSet) {
+      prod->updatePropertyCache(false);
+      smi += MolToSmiles(*prod) + ".";
+    }
+    res.push_back(smi);
+  }
+  return res;
+}
+}  // namespace
+
+TEST_CASE("ReactionTemplateLibrary") {
+  std::vector<std::unique_ptr<ChemicalReaction>> rxns;
+  ReactionTemplateLibrary library;
+  for (const auto &sma : templateLibrarySmarts) {
+    rxns.emplace_back(RxnSmartsToChemicalReaction(sma));
+    REQUIRE(rxns.back());
+    rxns.back()->initReactantMatchers();
+    CHECK(library.addReaction(*rxns.back()) == rxns.size() - 1);
+  }
+  REQUIRE(library.size() == rxns.size());
+  auto smis = readChemblTestSmiles(200);
+  REQUIRE(smis.size() == 200);
+  smis.push_back("Nc1ccc(CO)cc1");
+  smis.push_back("C/C=C/CC(=O)OC");
+  smis.push_back("C[Si](C)(C)OCC");
+
+  // the expected results come from running each reaction directly
+  std::vector<std::vector<std::pair<unsigned int, std::vector<std::string>>>>
+      expected;
+  unsigned int nMatches = 0;
+  for (const auto &smi : smis) {
+    ROMOL_SPTR mol(SmilesToMol(smi));
+    REQUIRE(mol);
+    expected.emplace_back();
+    for (unsigned int i = 0; i < rxns.size(); ++i) {
+      auto prods = rxns[i]->runReactants(MOL_SPTR_VECT{mol});
+      if (!prods.empty()) {
+        expected.back().emplace_back(i, productSmiles(prods));
+        ++nMatches;
+      }
+    }
+  }
+  // make sure the test is actually testing something
+  CHECK(nMatches > smis.size());
+
+  auto compareResults = [&](const auto &results) {
+    REQUIRE(results.size() == smis.size());
+    for (unsigned int i = 0; i < smis.size(); ++i) {
+      INFO(smis[i]);
+      REQUIRE(results[i].size() == expected[i].size());
+      for (unsigned int j = 0; j < results[i].size(); ++j) {
+        CHECK(results[i][j].reactionIdx == expected[i][j].first);
+        CHECK(productSmiles(results[i][j].products) == expected[i][j].second);
+      }
+    }
+  };
+  SECTION("single molecules") {
+    std::vector<std::vector<ReactionTemplateResult>> results;
+    for (const auto &smi : smis) {
+      ROMOL_SPTR mol(SmilesToMol(smi));
+      results.push_back(library.runReactions(mol));
+    }
+    compareResults(results);
+  }
+  SECTION("multiple molecules") {
+    for (auto numThreads : {1, 4}) {
+      MOL_SPTR_VECT mols;
+      for (const auto &smi : smis) {
+        mols.emplace_back(SmilesToMol(smi));
+      }
+      compareResults(library.runReactions(mols, 1000, numThreads));
+    }
+  }
+  SECTION("screening") {
+    std::unique_ptr<ROMol> mol(SmilesToMol("CC(=O)NCc1ccccc1"));
+    REQUIRE(mol);
+    auto candidates = library.getCandidateReactions(*mol);
+    CHECK(std::find(candidates.begin(), candidates.end(), 0) !=
+          candidates.end());
+    // no Si and no P
+    CHECK(std::find(candidates.begin(), candidates.end(), 12) ==
+          candidates.end());
+    CHECK(std::find(candidates.begin(), candidates.end(), 14) ==
+          candidates.end());
+  }
+  SECTION("screened library") {
+    // the library is too small to be screened by default
+    ReactionTemplateLibrary screened(2048, 1);
+    for (const auto &rxn : rxns) {
+      screened.addReaction(*rxn);
+    }
+    MOL_SPTR_VECT mols;
+    unsigned int nCandidates = 0;
+    for (const auto &smi : smis) {
+      mols.emplace_back(SmilesToMol(smi));
+      nCandidates += screened.getCandidateReactions(*mols.back()).size();
+    }
+    // make sure the screen removes something
+    CHECK(nCandidates < mols.size() * rxns.size());
+    compareResults(screened.runReactions(mols));
+  }
+  SECTION("compiled reactions") {
+    ROMOL_SPTR mol(SmilesToMol("OC(=O)CNC(=O)c1ccc(-c2ccccc2)cc1"));
+    REQUIRE(mol);
+    for (const auto &rxn : rxns) {
+      auto compiled = ReactionRunnerUtils::compileReaction(*rxn);
+      CHECK(productSmiles(run_Reactants(*rxn, {mol}, *compiled)) ==
+            productSmiles(rxn->runReactants({mol})));
+    }
+  }
+  SECTION("errors") {
+    auto rxn = "[C:1]=O.[N:2]>>[C:1][N:2]"_rxnsmarts;
+    REQUIRE(rxn);
+    CHECK_THROWS_AS(library.addReaction(*rxn), ChemicalReactionException);
+  }
+}
+
+TEST_CASE("ReactionTemplateLibrary benchmark", "[.][benchmark]") {
+  // make a library which is large enough to be screened by repeating the
+  // templates
+  const unsigned int nCopies = 50;
+  std::vector<std::unique_ptr<ChemicalReaction>> rxns;
+  ReactionTemplateLibrary library;
+  for (unsigned int i = 0; i < nCopies; ++i) {
+    for (const auto &sma : templateLibrarySmarts) {
+      rxns.emplace_back(RxnSmartsToChemicalReaction(sma));
+      rxns.back()->initReactantMatchers();
+      library.addReaction(*rxns.back());
+    }
+  }
+  MOL_SPTR_VECT mols;
+  for (const auto &smi : readChemblTestSmiles()) {
+    mols.emplace_back(SmilesToMol(smi));
+    REQUIRE(mols.back());
+  }
+  auto report = [&](const std::string &label, const auto &t1) {
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "TIMING : " << label << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << mols.size() * rxns.size()
+              << " applications" << std::endl;
+  };
+  auto countProducts = [](const auto &results) {
+    unsigned int res = 0;
+    for (const auto &molRes : results) {
+      for (const auto &rxnRes : molRes) {
+        res += rxnRes.products.size();
+      }
+    }
+    return res;
+  };
+
+  // hold on to the products so that the comparison with the library, which
+  // returns everything at the end, is fair
+  auto t1 = std::chrono::high_resolution_clock::now();
+  unsigned int nProducts = 0;
+  std::vector<std::vector<MOL_SPTR_VECT>> allProducts;
+  for (const auto &mol : mols) {
+    for (const auto &rxn : rxns) {
+      allProducts.push_back(rxn->runReactants({mol}));
+      nProducts += allProducts.back().size();
+    }
+  }
+  report("runReactants", t1);
+  allProducts.clear();
+
+  t1 = std::chrono::high_resolution_clock::now();
+  auto results = library.runReactions(mols);
+  report("ReactionTemplateLibrary, 1 thread", t1);
+  CHECK(countProducts(results) == nProducts);
+  results.clear();
+
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  t1 = std::chrono::high_resolution_clock::now();
+  results = library.runReactions(mols, 1000, -1);
+  report("ReactionTemplateLibrary, all threads", t1);
+  CHECK(countProducts(results) == nProducts);
+#endif
+}
@@ -379,14 +379,31 @@ bool EmbeddedFrag::matchToTemplate(const RDKit::INT_VECT &ringSystemAtoms,
   }
   rs_mol.commitBatchEdit();
 
+  // only templates with the same graph hash can match, unless the ring
+  // system has bonds of unspecified type, which match any bond type
+  bool useHash = coordinate_templates.hashIndexUsable();
+  for (const auto bond : rs_mol.bonds()) {
+    if (bond->getBondType() == RDKit::Bond::UNSPECIFIED) {
+      useHash = false;
+      break;
+    }
+  }
+  const auto &candidates =
+      useHash ? coordinate_templates.getTemplatesWithHash(
+                    CoordinateTemplates::ringSystemHash(rs_mol))
+              : coordinate_templates.getMatchingTemplates(
+                    ringSystemAtoms.size());
+
   // find template that this mol matches to, if any
   RDKit::MatchVectType match;
   std::shared_ptr<RDKit::ROMol> template_mol(nullptr);
-  for (const auto &mol :
-       coordinate_templates.getMatchingTemplates(ringSystemAtoms.size())) {
+  for (const auto &mol : candidates) {
     // To reduce how often we have to do substructure matches, check ring info
-    // and bond count first
-    if (mol->getNumBonds() != rs_mol.getNumBonds()) {
+    // and atom and bond counts first. Candidates found by hash can have any
+    // number of atoms.
+    if (mol->getNumAtoms() != rs_mol.getNumAtoms()) {
+      continue;
+    } else if (mol->getNumBonds() != rs_mol.getNumBonds()) {
       continue;
     } else if (mol->getRingInfo()->numRings() != ring_count) {
       continue;
@@ -34,6 +34,7 @@
 #include <iostream>
 #include <boost/dynamic_bitset.hpp>
 #include <algorithm>
+#include <RDGeneral/RDThreads.h>
 
 namespace RDDepict {
 
@@ -655,6 +656,25 @@ unsigned int compute2DCoords(RDKit::ROMol &mol,
   return cid;
 }
 
+std::vector<int> compute2DCoords(const std::vector<RDKit::ROMol *> &mols,
+                                 const Compute2DCoordParameters &params,
+                                 int numThreads) {
+  std::vector<int> res(mols.size(), -1);
+  auto func = [&mols, &params, &res](size_t i) {
+    if (mols[i]) {
+      res[i] = compute2DCoords(*mols[i], params);
+    }
+  };
+
+  bool serialOnly = (params.nSamples > 0) && (params.nFlipsPerSample > 0);
+#ifdef RDK_BUILD_COORDGEN_SUPPORT
+  serialOnly |= !params.forceRDKit && preferCoordGen;
+#endif
+  // each molecule is laid out independently
+  RDKit::runOnIndices(func, mols.size(), serialOnly ? 1 : numThreads);
+  return res;
+}
+
 //! \brief Compute the 2D coordinates such that the interatom distances
 //!        mimic those in a distance matrix
 /*!
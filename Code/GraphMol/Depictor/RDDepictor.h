@@ -108,6 +108,28 @@ struct RDKIT_DEPICTOR_EXPORT Compute2DCoordParameters {
 RDKIT_DEPICTOR_EXPORT unsigned int compute2DCoords(
     RDKit::ROMol &mol, const Compute2DCoordParameters &params);
 
+//! \brief Generate 2D coordinates (depictions) for a set of molecules
+/*!
+
+  \param mols the molecules we are interested in, null entries are skipped
+
+  \param params parameters used for 2D coordinate generation, these are used
+  for every molecule, so params.coordMap should normally be null
+
+  \param numThreads the number of threads to use, values <= 0 are
+  interpreted as in getNumThreadsToUse(). The molecules are processed
+  serially if CoordGen is used or if random sampling is requested
+  (params.nSamples and params.nFlipsPerSample both > 0), because those
+  rely on global state.
+
+  \return the IDs of the conformations added to the molecules containing
+  the 2D coordinates, -1 for null entries
+
+*/
+RDKIT_DEPICTOR_EXPORT std::vector<int> compute2DCoords(
+    const std::vector<RDKit::ROMol *> &mols,
+    const Compute2DCoordParameters &params, int numThreads = 1);
+
 //! \brief Generate 2D coordinates (a depiction) for a molecule
 /*!
 
@@ -12,6 +12,9 @@
 
 #include "RDDepictor.h"
 
+#include <RDGeneral/hash/hash.hpp>
+#include <algorithm>
+
 namespace RDDepict {
 void CoordinateTemplates::assertValidTemplate(RDKit::ROMol& mol,
                                               const std::string& smiles) {
@@ -49,6 +52,77 @@ void CoordinateTemplates::assertValidTemplate(RDKit::ROMol& mol,
   }
 }
 
+namespace {
+// templates with query features or bonds of unspecified type can match ring
+// systems with a different hash
+bool isHashable(const RDKit::ROMol& mol) {
+  for (const auto atom : mol.atoms()) {
+    if (atom->hasQuery()) {
+      return false;
+    }
+  }
+  for (const auto bond : mol.bonds()) {
+    if (bond->hasQuery() || bond->getBondType() == RDKit::Bond::UNSPECIFIED) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
+std::uint32_t CoordinateTemplates::ringSystemHash(const RDKit::ROMol& mol) {
+  // a few rounds of Morgan-like refinement of atom invariants built from the
+  // atomic numbers and bond types, which is what the substructure match of a
+  // template against a ring system compares
+  constexpr unsigned int numIterations = 4;
+  std::vector<std::uint32_t> invars(mol.getNumAtoms());
+  for (const auto atom : mol.atoms()) {
+    invars[atom->getIdx()] = atom->getAtomicNum();
+  }
+  std::vector<std::uint32_t> nextInvars(invars.size());
+  std::vector<std::uint32_t> nbrInvars;
+  for (unsigned int iter = 0; iter < numIterations; ++iter) {
+    for (const auto atom : mol.atoms()) {
+      nbrInvars.clear();
+      for (const auto bond : mol.atomBonds(atom)) {
+        std::uint32_t nbrInvar =
+            invars[bond->getOtherAtomIdx(atom->getIdx())];
+        gboost::hash_combine(nbrInvar,
+                             static_cast<unsigned int>(bond->getBondType()));
+        nbrInvars.push_back(nbrInvar);
+      }
+      std::sort(nbrInvars.begin(), nbrInvars.end());
+      auto invar = invars[atom->getIdx()];
+      for (auto nbrInvar : nbrInvars) {
+        gboost::hash_combine(invar, nbrInvar);
+      }
+      nextInvars[atom->getIdx()] = invar;
+    }
+    invars.swap(nextInvars);
+  }
+  std::sort(invars.begin(), invars.end());
+  std::uint32_t res = mol.getNumAtoms();
+  gboost::hash_combine(res, mol.getNumBonds());
+  for (auto invar : invars) {
+    gboost::hash_combine(res, invar);
+  }
+  return res;
+}
+
+void CoordinateTemplates::buildHashIndex() {
+  // the templates for each atom count are already in the order in which they
+  // should be tried, and templates with different atom counts can't compete
+  // for the same ring system
+  m_hashIndex.clear();
+  m_hashIndexUsable = true;
+  for (const auto& [atomCount, templates] : m_templates) {
+    for (const auto& mol : templates) {
+      m_hashIndexUsable &= isHashable(*mol);
+      m_hashIndex[ringSystemHash(*mol)].push_back(mol);
+    }
+  }
+}
+
 void CoordinateTemplates::loadTemplatesFromPath(
     const std::string& templatePath,
     std::unordered_map<unsigned int,
@@ -91,6 +165,7 @@ void CoordinateTemplates::setRingSystemTemplates(
   loadTemplatesFromPath(templatePath, templates);
   clearTemplates();
   m_templates = std::move(templates);
+  buildHashIndex();
 }
 
 void CoordinateTemplates::addRingSystemTemplates(
@@ -104,5 +179,6 @@ void CoordinateTemplates::addRingSystemTemplates(
     m_templates[kv.first].insert(m_templates[kv.first].begin(),
                                  kv.second.begin(), kv.second.end());
   }
+  buildHashIndex();
 }
 }  // namespace RDDepict
\ No newline at end of file
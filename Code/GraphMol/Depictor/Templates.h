@@ -14,6 +14,7 @@
 
 #include "TemplateSmiles.h"
 
+#include <cstdint>
 #include <iostream>
 #include <fstream>
 #include <unordered_map>
@@ -36,7 +37,7 @@ class RDKIT_DEPICTOR_EXPORT CoordinateTemplates {
     return template_mols;
   }
 
-  bool hasTemplateOfSize(unsigned int atomCount) {
+  bool hasTemplateOfSize(unsigned int atomCount) const {
     if (m_templates.find(atomCount) != m_templates.end()) {
       return true;
     }
@@ -44,10 +45,38 @@ class RDKIT_DEPICTOR_EXPORT CoordinateTemplates {
   }
 
   const std::vector<std::shared_ptr<RDKit::ROMol>>& getMatchingTemplates(
-      unsigned int atomCount) {
-    return m_templates[atomCount];
+      unsigned int atomCount) const {
+    static const std::vector<std::shared_ptr<RDKit::ROMol>> noTemplates;
+    auto it = m_templates.find(atomCount);
+    return it == m_templates.end() ? noTemplates : it->second;
   }
 
+  //! returns the templates with the given ring system hash, in the order in
+  //! which they should be tried
+  const std::vector<std::shared_ptr<RDKit::ROMol>>& getTemplatesWithHash(
+      std::uint32_t hash) const {
+    static const std::vector<std::shared_ptr<RDKit::ROMol>> noTemplates;
+    auto it = m_hashIndex.find(hash);
+    return it == m_hashIndex.end() ? noTemplates : it->second;
+  }
+
+  //! returns a hash of the graph of a ring system
+  /*
+      The hash only depends on the atomic numbers, bond types and
+      connectivity, so a template and a ring system with the same number
+      of atoms and bonds that match each other always have the same hash.
+      Different ring systems can share a hash, so a substructure match is
+      still needed to confirm a hit.
+
+      Bonds of unspecified type match any bond type and should not be
+      looked up with the hash.
+   */
+  static std::uint32_t ringSystemHash(const RDKit::ROMol& mol);
+
+  //! returns false if some of the templates have query features or bonds of
+  //! unspecified type, so that getTemplatesWithHash() could miss matches
+  bool hashIndexUsable() const { return m_hashIndexUsable; }
+
   void setRingSystemTemplates(const std::string& templatePath);
   void addRingSystemTemplates(const std::string& templatePath);
 
@@ -72,6 +101,7 @@ class RDKIT_DEPICTOR_EXPORT CoordinateTemplates {
       std::shared_ptr<RDKit::ROMol> mol(RDKit::SmilesToMol(smiles));
       m_templates[mol->getNumAtoms()].push_back(mol);
     }
+    buildHashIndex();
   }
 
  private:
@@ -84,8 +114,12 @@ class RDKIT_DEPICTOR_EXPORT CoordinateTemplates {
       romols.clear();
     }
     m_templates.clear();
+    m_hashIndex.clear();
+    m_hashIndexUsable = true;
   }
 
+  void buildHashIndex();
+
   ~CoordinateTemplates() { clearTemplates(); }
 
   void loadTemplatesFromPath(
@@ -95,5 +129,9 @@ class RDKIT_DEPICTOR_EXPORT CoordinateTemplates {
 
   std::unordered_map<unsigned int, std::vector<std::shared_ptr<RDKit::ROMol>>>
       m_templates;
+  std::unordered_map<std::uint32_t,
+                     std::vector<std::shared_ptr<RDKit::ROMol>>>
+      m_hashIndex;
+  bool m_hashIndexUsable = true;
 };
 }  // namespace RDDepict
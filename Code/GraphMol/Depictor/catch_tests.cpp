@@ -10,10 +10,15 @@
 
 #include <catch2/catch_all.hpp>
 
+#include <chrono>
+#include <fstream>
+#include <numeric>
+
 #include <GraphMol/RDKitBase.h>
 #include <GraphMol/Chirality.h>
 #include "RDDepictor.h"
 #include "DepictUtils.h"
+#include "Templates.h"
 #include <GraphMol/SmilesParse/SmilesParse.h>
 #include <GraphMol/SmilesParse/SmilesWrite.h>
 #include <GraphMol/FileParsers/FileParsers.h>
@@ -227,6 +232,107 @@ TEST_CASE("use ring system templates") {
   TEST_ASSERT(RDKit::feq(diff.length(), 1.0, .1))
 }
 
+TEST_CASE("ring system template hash index") {
+  auto &templates = RDDepict::CoordinateTemplates::getRingSystemTemplates();
+  REQUIRE(templates.hashIndexUsable());
+  auto mol = "C1CCC2C(C1)C1CCN2NN1"_smiles;
+  REQUIRE(mol);
+  auto hash = RDDepict::CoordinateTemplates::ringSystemHash(*mol);
+  const auto &candidates = templates.getTemplatesWithHash(hash);
+  REQUIRE(!candidates.empty());
+  for (const auto &tmpl : candidates) {
+    CHECK(tmpl->getNumAtoms() == mol->getNumAtoms());
+  }
+  SECTION("the hash does not depend on the atom order") {
+    std::vector<unsigned int> order(mol->getNumAtoms());
+    std::iota(order.rbegin(), order.rend(), 0);
+    std::unique_ptr<ROMol> renumbered(MolOps::renumberAtoms(*mol, order));
+    CHECK(RDDepict::CoordinateTemplates::ringSystemHash(*renumbered) == hash);
+  }
+  SECTION("the hash depends on atom and bond types") {
+    auto other = "C1CCC2C(C1)C1CCN2NO1"_smiles;
+    REQUIRE(other);
+    CHECK(RDDepict::CoordinateTemplates::ringSystemHash(*other) != hash);
+    other = "C1CCC2C(C1)C1CCN2N=N1"_smiles;
+    REQUIRE(other);
+    CHECK(RDDepict::CoordinateTemplates::ringSystemHash(*other) != hash);
+  }
+}
+
+TEST_CASE("batch compute2DCoords") {
+  std::vector<std::unique_ptr<RWMol>> mols;
+  for (const auto smi :
+       {"C1CCC2C(C1)C1CCN2NN1", "CCC1(CCC1)CC1CCCCC1", "c1ccccc1C(=O)O",
+        "CN1C=NC2=C1C(=O)N(C(=O)N2C)C", "C[C@H](N)C(=O)O"}) {
+    mols.emplace_back(SmilesToMol(smi));
+    REQUIRE(mols.back());
+  }
+  RDDepict::Compute2DCoordParameters params;
+  params.useRingTemplates = true;
+  params.forceRDKit = true;
+  std::vector<RDGeom::POINT3D_VECT> expected;
+  for (auto &mol : mols) {
+    RDDepict::compute2DCoords(*mol, params);
+    expected.push_back(mol->getConformer().getPositions());
+    mol->clearConformers();
+  }
+  std::vector<ROMol *> molPtrs;
+  for (auto &mol : mols) {
+    molPtrs.push_back(mol.get());
+    molPtrs.push_back(nullptr);
+  }
+  for (auto numThreads : {1, 4}) {
+    auto cids = RDDepict::compute2DCoords(molPtrs, params, numThreads);
+    REQUIRE(cids.size() == molPtrs.size());
+    for (size_t i = 0; i < mols.size(); ++i) {
+      CHECK(cids[2 * i] == 0);
+      CHECK(cids[2 * i + 1] == -1);
+      const auto &conf = mols[i]->getConformer();
+      REQUIRE(conf.getNumAtoms() == expected[i].size());
+      for (unsigned int j = 0; j < conf.getNumAtoms(); ++j) {
+        CHECK((conf.getAtomPos(j) - expected[i][j]).length() < 1e-4);
+      }
+    }
+  }
+}
+
+TEST_CASE("depiction throughput", "[.][benchmark]") {
+  std::string rdbase = getenv("RDBASE");
+  std::ifstream inf(rdbase + "/Data/NCI/first_5K.smi");
+  std::vector<std::unique_ptr<ROMol>> mols;
+  std::string line;
+  while (std::getline(inf, line)) {
+    std::unique_ptr<ROMol> mol(SmilesToMol(line.substr(0, line.find('\t'))));
+    if (mol) {
+      mols.push_back(std::move(mol));
+    }
+  }
+  REQUIRE(!mols.empty());
+  std::vector<ROMol *> molPtrs;
+  for (const auto &mol : mols) {
+    molPtrs.push_back(mol.get());
+  }
+  for (auto useRingTemplates : {false, true}) {
+    RDDepict::Compute2DCoordParameters params;
+    params.forceRDKit = true;
+    params.useRingTemplates = useRingTemplates;
+    for (auto numThreads : {1, -1}) {
+      auto t1 = std::chrono::high_resolution_clock::now();
+      auto cids = RDDepict::compute2DCoords(molPtrs, params, numThreads);
+      auto t2 = std::chrono::high_resolution_clock::now();
+      std::cout << "TIMING : compute2DCoords, useRingTemplates="
+                << useRingTemplates << " numThreads=" << numThreads
+                << " took "
+                << std::chrono::duration_cast<std::chrono::milliseconds>(t2 -
+                                                                         t1)
+                       .count()
+                << " milliseconds for " << molPtrs.size() << " molecules"
+                << std::endl;
+      CHECK(cids.size() == molPtrs.size());
+    }
+  }
+}
+
 TEST_CASE("dative bonds and rings") {
   auto mol = "O->[Pt]1(<-O)<-NC2CCC2N->1"_smiles;
   REQUIRE(mol);
@@ -35,16 +35,10 @@
 
 #include "AUTOCORR3D.h"
 #include "MolData3Ddescriptors.h"
+#include "Descriptors3DContext.h"
 
 #include <cmath>
-#include <iostream>
 
-#include <Eigen/Core>
-#include <Eigen/Dense>
-#include <Eigen/QR>
-#include <Eigen/SVD>
-
-using namespace Eigen;
 namespace RDKit {
 namespace Descriptors {
 
@@ -52,202 +46,86 @@ namespace {
 
 MolData3Ddescriptors moldata3D;
 
-VectorXd getEigenVect(std::vector<double> v) {
-  double* varray_ptr = &v[0];
-  Map<VectorXd> V(varray_ptr, v.size());
-  return V;
-}
+const unsigned int maxLag = 10;
 
-double* GetGeodesicMatrix(double* dist, int lag, int numAtoms) {
-  int sizeArray = numAtoms * numAtoms;
-  auto* Geodesic = new double[sizeArray];
-  for (int i = 0; i < sizeArray; i++) {
-    if (dist[i] == lag) {
-      Geodesic[i] = 1.0;
-    } else {
-      Geodesic[i] = 0.0;
-    }
-  }
-  return Geodesic;
-}
-
-// matrix prod that mimic the v2 version
+// The 3D autocorrelation for lag l is the sum over all ordered pairs of atoms
+// (i, j) with topological distance l of w_i * d_ij * w_j, where d_ij is the
+// 3D distance. This accumulates the sums for all lags and weights in a
+// single pass over the unordered pairs.
 // the code is in respect to Dragon 6 descriptors.
 // replace the number of "Bicount" vertex per lag by a (numAtoms * (numAtoms -
 // 1))!
 // provided by Kobe team!
-void get3DautocorrelationDesc(double* dist3D, double* topologicaldistance,
-                              int numAtoms, const ROMol& mol,
-                              std::vector<double>& res) {
-  Map<MatrixXd> dm(dist3D, numAtoms, numAtoms);
-  Map<MatrixXd> di(topologicaldistance, numAtoms, numAtoms);
-
-  std::vector<double> wp = moldata3D.GetRelativePol(mol);
-  VectorXd Wp = getEigenVect(wp);
-
-  std::vector<double> wm = moldata3D.GetRelativeMW(mol);
-  VectorXd Wm = getEigenVect(wm);
-
-  std::vector<double> wi = moldata3D.GetRelativeIonPol(mol);
-  VectorXd Wi = getEigenVect(wi);
-
-  std::vector<double> wv = moldata3D.GetRelativeVdW(mol);
-  VectorXd Wv = getEigenVect(wv);
-
-  std::vector<double> we = moldata3D.GetRelativeENeg(mol);
-  VectorXd We = getEigenVect(we);
-
-  std::vector<double> wu = moldata3D.GetUn(numAtoms);
-  VectorXd Wu = getEigenVect(wu);
-
-  std::vector<double> ws = moldata3D.GetIState(mol);
-  VectorXd Ws = getEigenVect(ws);
-
-  std::vector<double> wr = moldata3D.GetRelativeRcov(mol);
-  VectorXd Wr = getEigenVect(wr);
-
-  double TDBmat[8][10];
-  double dtmp;
-
-  for (int i = 0; i < 10; i++) {
-    double* Bimat = GetGeodesicMatrix(topologicaldistance, i + 1, numAtoms);
-    Map<MatrixXd> Bi(Bimat, numAtoms, numAtoms);
-    MatrixXd RBi = Bi.cwiseProduct(dm);
-
-    MatrixXd tmp = Wu.transpose() * RBi * Wu;
-    dtmp = (double)tmp(0);
-    if (std::isnan(dtmp)) {
-      dtmp = 0.0;
-    }
-    TDBmat[0][i] = dtmp;
-
-    tmp = Wm.transpose() * RBi * Wm;
-    dtmp = (double)tmp(0);
-    if (std::isnan(dtmp)) {
-      dtmp = 0.0;
-    }
-    TDBmat[1][i] = dtmp;
-
-    tmp = Wv.transpose() * RBi * Wv;
-    dtmp = (double)tmp(0);
-    if (std::isnan(dtmp)) {
-      dtmp = 0.0;
-    }
-    TDBmat[2][i] = dtmp;
-
-    tmp = We.transpose() * RBi * We;
-    dtmp = (double)tmp(0);
-    if (std::isnan(dtmp)) {
-      dtmp = 0.0;
-    }
-    TDBmat[3][i] = dtmp;
-
-    tmp = Wp.transpose() * RBi * Wp;
-    dtmp = (double)tmp(0);
-    if (std::isnan(dtmp)) {
-      dtmp = 0.0;
+void get3DautocorrelationDesc(
+    const Descriptors3DContext &context,
+    const std::vector<const std::vector<double> *> &pairWeights,
+    std::vector<double> &res) {
+  auto numAtoms = context.getNumAtoms();
+  const auto &topDist = context.getTopologicalDistanceMatrix();
+  const auto &pairDists = context.getPairDistances();
+  auto numWeights = pairWeights.size();
+  std::vector<double> sums(numWeights * maxLag, 0.0);
+  unsigned int p = 0;
+  for (unsigned int j = 0; j + 1 < numAtoms; ++j) {
+    for (unsigned int k = j + 1; k < numAtoms; ++k, ++p) {
+      double lag = topDist[j * numAtoms + k];
+      if (lag < 1 || lag > maxLag) {
+        continue;
+      }
+      double *lagSums = &sums[static_cast<unsigned int>(lag) - 1];
+      for (unsigned int w = 0; w < numWeights; ++w) {
+        lagSums[w * maxLag] += (*pairWeights[w])[p] * pairDists[p];
+      }
     }
-    TDBmat[4][i] = dtmp;
-
-    tmp = Wi.transpose() * RBi * Wi;
-    dtmp = (double)tmp(0);
-    if (std::isnan(dtmp)) {
-      dtmp = 0.0;
-    }
-    TDBmat[5][i] = dtmp;
-
-    tmp = Ws.transpose() * RBi * Ws;
-    dtmp = (double)tmp(0);
-    if (std::isnan(dtmp)) {
-      dtmp = 0.0;
-    }
-    TDBmat[6][i] = dtmp;
-
-    tmp = Wr.transpose() * RBi * Wr;
-    dtmp = (double)tmp(0);
-    if (std::isnan(dtmp)) {
-      dtmp = 0.0;
-    }
-    TDBmat[7][i] = dtmp;
-    delete[] Bimat;
   }
 
   // update the Output vector!
-  for (unsigned int j = 0; j < 8; ++j) {
-    for (unsigned int i = 0; i < 10; ++i) {
-      res[j * 10 + i] =
-          std::round(1000 * TDBmat[j][i] / (numAtoms * (numAtoms - 1))) / 1000;
-    }
-  }
-}
-
-void get3DautocorrelationDescCustom(double* dist3D, double* topologicaldistance,
-                                    int numAtoms, const ROMol& mol,
-                                    std::vector<double>& res,
-                                    const std::string& customAtomPropName) {
-  Map<MatrixXd> dm(dist3D, numAtoms, numAtoms);
-  Map<MatrixXd> di(topologicaldistance, numAtoms, numAtoms);
-
-  std::vector<double> customAtomArray =
-      moldata3D.GetCustomAtomProp(mol, customAtomPropName);
-  VectorXd Wc = getEigenVect(customAtomArray);
-
-  double TDBmat[10];
-  double dtmp;
-
-  for (int i = 0; i < 10; i++) {
-    double* Bimat = GetGeodesicMatrix(topologicaldistance, i + 1, numAtoms);
-    Map<MatrixXd> Bi(Bimat, numAtoms, numAtoms);
-    MatrixXd RBi = Bi.cwiseProduct(dm);
-
-    MatrixXd tmp = Wc.transpose() * RBi * Wc;
-    dtmp = (double)tmp(0);
+  res.resize(numWeights * maxLag);
+  for (unsigned int i = 0; i < sums.size(); ++i) {
+    // each pair was only visited once
+    double dtmp = 2 * sums[i];
     if (std::isnan(dtmp)) {
       dtmp = 0.0;
     }
-    TDBmat[i] = dtmp;
-    delete[] Bimat;
+    res[i] = std::round(1000 * dtmp / (numAtoms * (numAtoms - 1))) / 1000;
   }
-  // update the Output vector!
-  for (unsigned int i = 0; i < 10; ++i) {
-    res[i] = std::round(1000 * TDBmat[i] / (numAtoms * (numAtoms - 1))) / 1000;
-  }
-}
-
-void Get3Dauto(double* dist3D, double* topologicaldistance, int numAtoms,
-               const ROMol& mol, std::vector<double>& res) {
-  // AUTOCORRNAMES={"TDB01u","TDB02u","TDB03u","TDB04u","TDB05u","TDB06u","TDB07u","TDB08u","TDB09u","TDB10u","TDB01m","TDB02m","TDB03m","TDB04m","TDB05m","TDB06m","TDB07m","TDB08m","TDB09m","TDB10m","TDB01v","TDB02v","TDB03v","TDB04v","TDB05v","TDB06v","TDB07v","TDB08v","TDB09v","TDB10v","TDB01e","TDB02e","TDB03e","TDB04e","TDB05e","TDB06e","TDB07e","TDB08e","TDB09e","TDB10e","TDB01p","TDB02p","TDB03p","TDB04p","TDB05p","TDB06p","TDB07p","TDB08p","TDB09p","TDB10p","TDB01i","TDB02i","TDB03i","TDB04i","TDB05i","TDB06i","TDB07i","TDB08i","TDB09i","TDB10i","TDB01s","TDB02s","TDB03s","TDB04s","TDB05s","TDB06s","TDB07s","TDB08s","TDB09s","TDB10s","TDB01r","TDB02r","TDB03r","TDB04r","TDB05r","TDB06r","TDB07r","TDB08r","TDB09r","TDB10r"};
-  get3DautocorrelationDesc(dist3D, topologicaldistance, numAtoms, mol, res);
-}
-
-void Get3Dautoone(double* dist3D, double* topologicaldistance, int numAtoms,
-                  const ROMol& mol, std::vector<double>& res,
-                  const std::string& customAtomPropName) {
-  get3DautocorrelationDescCustom(dist3D, topologicaldistance, numAtoms, mol,
-                                 res, customAtomPropName);
 }
 
 }  // end of anonymous namespace
 
-void AUTOCORR3D(const ROMol& mol, std::vector<double>& res, int confId,
-                const std::string& customAtomPropName) {
-  PRECONDITION(mol.getNumConformers() >= 1, "molecule has no conformers")
-  int numAtoms = mol.getNumAtoms();
-
-  double* topologicaldistance =
-      MolOps::getDistanceMat(mol, false);  // topological matrix
-  double* dist3D =
-      MolOps::get3DDistanceMat(mol, confId, false, true);  // 3D distance matrix
+void AUTOCORR3D(const Descriptors3DContext &context, std::vector<double> &res,
+                const std::string &customAtomPropName) {
+  // AUTOCORRNAMES={"TDB01u","TDB02u","TDB03u","TDB04u","TDB05u","TDB06u","TDB07u","TDB08u","TDB09u","TDB10u","TDB01m","TDB02m","TDB03m","TDB04m","TDB05m","TDB06m","TDB07m","TDB08m","TDB09m","TDB10m","TDB01v","TDB02v","TDB03v","TDB04v","TDB05v","TDB06v","TDB07v","TDB08v","TDB09v","TDB10v","TDB01e","TDB02e","TDB03e","TDB04e","TDB05e","TDB06e","TDB07e","TDB08e","TDB09e","TDB10e","TDB01p","TDB02p","TDB03p","TDB04p","TDB05p","TDB06p","TDB07p","TDB08p","TDB09p","TDB10p","TDB01i","TDB02i","TDB03i","TDB04i","TDB05i","TDB06i","TDB07i","TDB08i","TDB09i","TDB10i","TDB01s","TDB02s","TDB03s","TDB04s","TDB05s","TDB06s","TDB07s","TDB08s","TDB09s","TDB10s","TDB01r","TDB02r","TDB03r","TDB04r","TDB05r","TDB06r","TDB07r","TDB08r","TDB09r","TDB10r"};
+  res.clear();
   if (customAtomPropName != "") {
-    res.clear();
-    res.resize(10);
-    Get3Dautoone(dist3D, topologicaldistance, numAtoms, mol, res,
-                 customAtomPropName);
+    auto numAtoms = context.getNumAtoms();
+    std::vector<double> customAtomArray =
+        moldata3D.GetCustomAtomProp(context.getMol(), customAtomPropName);
+    std::vector<double> weights;
+    weights.reserve(context.getNumPairs());
+    for (unsigned int j = 0; j + 1 < numAtoms; ++j) {
+      for (unsigned int k = j + 1; k < numAtoms; ++k) {
+        weights.push_back(customAtomArray[j] * customAtomArray[k]);
+      }
+    }
+    get3DautocorrelationDesc(context, {&weights}, res);
   } else {
-    res.clear();
-    res.resize(80);
-    Get3Dauto(dist3D, topologicaldistance, numAtoms, mol, res);
+    std::vector<const std::vector<double> *> pairWeights;
+    for (auto prop :
+         {AtomProperty3D::Unit, AtomProperty3D::RelativeMW,
+          AtomProperty3D::RelativeVdW, AtomProperty3D::RelativeENeg,
+          AtomProperty3D::RelativePol, AtomProperty3D::RelativeIonPol,
+          AtomProperty3D::IState, AtomProperty3D::RelativeRcov}) {
+      pairWeights.push_back(&context.getPairProducts(prop));
+    }
+    get3DautocorrelationDesc(context, pairWeights, res);
   }
 }
+
+void AUTOCORR3D(const ROMol &mol, std::vector<double> &res, int confId,
+                const std::string &customAtomPropName) {
+  PRECONDITION(mol.getNumConformers() >= 1, "molecule has no conformers")
+  AUTOCORR3D(Descriptors3DContext(mol, confId), res, customAtomPropName);
+}
 }  // namespace Descriptors
 }  // namespace RDKit
@@ -164,46 +164,66 @@ double getAlpha(const Atom &atom, bool &found) {
   }
   return res;
 }
-}  // namespace detail
 
-double calcChiNv(const ROMol &mol, unsigned int n, bool force) {
-  std::vector<double> hkDs(mol.getNumAtoms());
-  detail::hkDeltas(mol, hkDs, force);
-  PATH_LIST ps = findAllPathsOfLengthN(mol, n + 1, false);
+double calcChiN(const PATH_LIST &paths, const std::vector<double> &vals,
+                unsigned int n) {
   double res = 0.0;
-  for (const auto &p : ps) {
+  for (const auto &p : paths) {
     TEST_ASSERT(p.size() == n + 1);
     double accum = 1.0;
     for (unsigned int i = 0; i < n; ++i) {
-      accum *= hkDs[p[i]];
+      accum *= vals[p[i]];
     }
     // only push on the last element if this isn't a ring; this was github 463:
     if (p[n] != p[0]) {
-      accum *= hkDs[p[n]];
+      accum *= vals[p[n]];
     }
     res += accum;
   }
   return res;
 }
+
+double kappa1Helper(double P1, double A, double alpha) {
+  double denom = P1 + alpha;
+  double kappa = 0.0;
+  if (denom) {
+    kappa = (A + alpha) * (A + alpha - 1) * (A + alpha - 1) / (denom * denom);
+  }
+  return kappa;
+}
+double kappa2Helper(double P2, double A, double alpha) {
+  double denom = (P2 + alpha) * (P2 + alpha);
+  double kappa = 0.0;
+  if (denom) {
+    kappa = (A + alpha - 1) * (A + alpha - 2) * (A + alpha - 2) / denom;
+  }
+  return kappa;
+}
+double kappa3Helper(double P3, int A, double alpha) {
+  double denom = (P3 + alpha) * (P3 + alpha);
+  double kappa = 0.0;
+  if (denom) {
+    if (A % 2) {
+      kappa = (A + alpha - 1) * (A + alpha - 3) * (A + alpha - 3) / denom;
+    } else {
+      kappa = (A + alpha - 2) * (A + alpha - 3) * (A + alpha - 3) / denom;
+    }
+  }
+  return kappa;
+}
+}  // namespace detail
+
+double calcChiNv(const ROMol &mol, unsigned int n, bool force) {
+  std::vector<double> hkDs(mol.getNumAtoms());
+  detail::hkDeltas(mol, hkDs, force);
+  PATH_LIST ps = findAllPathsOfLengthN(mol, n + 1, false);
+  return detail::calcChiN(ps, hkDs, n);
+}
 double calcChiNn(const ROMol &mol, unsigned int n, bool force) {
   std::vector<double> nVs(mol.getNumAtoms());
   detail::nVals(mol, nVs, force);
   PATH_LIST ps = findAllPathsOfLengthN(mol, n + 1, false);
-  double res = 0.0;
-  for (const auto &p : ps) {
-    TEST_ASSERT(p.size() == n + 1);
-    double accum = 1.0;
-    for (unsigned int i = 0; i < n; ++i) {
-      accum *= nVs[p[i]];
-    }
-    // only push on the last element if this isn't a ring; this was github 463:
-    if (p[n] != p[0]) {
-      accum *= nVs[p[n]];
-    }
-
-    res += accum;
-  }
-  return res;
+  return detail::calcChiN(ps, nVs, n);
 }
 
 double calcChi0v(const ROMol &mol, bool force) {
@@ -293,42 +313,11 @@ double calcHallKierAlpha(const ROMol &mol, std::vector<double> *atomContribs) {
   return alphaSum;
 };
 
-namespace {
-double kappa1Helper(double P1, double A, double alpha) {
-  double denom = P1 + alpha;
-  double kappa = 0.0;
-  if (denom) {
-    kappa = (A + alpha) * (A + alpha - 1) * (A + alpha - 1) / (denom * denom);
-  }
-  return kappa;
-}
-double kappa2Helper(double P2, double A, double alpha) {
-  double denom = (P2 + alpha) * (P2 + alpha);
-  double kappa = 0.0;
-  if (denom) {
-    kappa = (A + alpha - 1) * (A + alpha - 2) * (A + alpha - 2) / denom;
-  }
-  return kappa;
-}
-double kappa3Helper(double P3, int A, double alpha) {
-  double denom = (P3 + alpha) * (P3 + alpha);
-  double kappa = 0.0;
-  if (denom) {
-    if (A % 2) {
-      kappa = (A + alpha - 1) * (A + alpha - 3) * (A + alpha - 3) / denom;
-    } else {
-      kappa = (A + alpha - 2) * (A + alpha - 3) * (A + alpha - 3) / denom;
-    }
-  }
-  return kappa;
-}
-}  // end of anonymous namespace
-
 double calcKappa1(const ROMol &mol) {
   double P1 = mol.getNumBonds();
   double A = mol.getNumHeavyAtoms();
   double alpha = calcHallKierAlpha(mol);
-  double kappa = kappa1Helper(P1, A, alpha);
+  double kappa = detail::kappa1Helper(P1, A, alpha);
   return kappa;
 }
 double calcKappa2(const ROMol &mol) {
@@ -336,14 +325,14 @@ double calcKappa2(const ROMol &mol) {
   double P2 = ps.size();
   double A = mol.getNumHeavyAtoms();
   double alpha = calcHallKierAlpha(mol);
-  double kappa = kappa2Helper(P2, A, alpha);
+  double kappa = detail::kappa2Helper(P2, A, alpha);
   return kappa;
 }
 double calcKappa3(const ROMol &mol) {
   double P3 = findAllPathsOfLengthN(mol, 3).size();
   int A = mol.getNumHeavyAtoms();
   double alpha = calcHallKierAlpha(mol);
-  double kappa = kappa3Helper(P3, A, alpha);
+  double kappa = detail::kappa3Helper(P3, A, alpha);
   return kappa;
 }
 double calcPhi(const ROMol &mol) {
@@ -353,9 +342,9 @@ double calcPhi(const ROMol &mol) {
   auto alpha = calcHallKierAlpha(mol);
   auto P1 = mol.getNumBonds();
   auto A = mol.getNumHeavyAtoms();
-  auto kappa1 = kappa1Helper(P1, A, alpha);
+  auto kappa1 = detail::kappa1Helper(P1, A, alpha);
   auto P2 = findAllPathsOfLengthN(mol, 2).size();
-  auto kappa2 = kappa2Helper(P2, A, alpha);
+  auto kappa2 = detail::kappa2Helper(P2, A, alpha);
   auto Phi = kappa1 * kappa2 / A;
   return Phi;
 }
@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 #include <boost/smart_ptr.hpp>
+#include <GraphMol/Subgraphs/Subgraphs.h>
 
 namespace RDKit {
 class ROMol;
@@ -48,7 +49,7 @@ const std::string chi1vVersion = "1.2.0";
                        of pulled from the cache
 */
 RDKIT_DESCRIPTORS_EXPORT double calcChi2v(const ROMol &mol, bool force = false);
-const std::string chi2vVersion = "1.2.0";
+const std::string chi2vVersion = "1.2.1";
 //! From equations (5),(9) and (10) of Rev. Comp. Chem. vol 2, 367-422, (1991)
 /*!
   \param mol           the molecule of interest
@@ -102,7 +103,7 @@ const std::string chi1nVersion = "1.2.0";
                        of pulled from the cache
 */
 RDKIT_DESCRIPTORS_EXPORT double calcChi2n(const ROMol &mol, bool force = false);
-const std::string chi2nVersion = "1.2.0";
+const std::string chi2nVersion = "1.2.1";
 //! Similar to Hall Kier ChiXv, but uses nVal instead of valence
 //!   This makes a big difference after we get out of the first row.
 /*!
@@ -203,7 +204,21 @@ const std::string PhiVersion = "1.0.0";
 namespace detail {
 RDKIT_DESCRIPTORS_EXPORT void hkDeltas(const ROMol &mol,
                                        std::vector<double> &deltas, bool force);
-}
+RDKIT_DESCRIPTORS_EXPORT void nVals(const ROMol &mol, std::vector<double> &nVs,
+                                    bool force);
+//! calculates a chi index of order \c n from the atomic values \c vals
+//! (from hkDeltas() or nVals()) and the atom paths containing \c n+1 atoms
+RDKIT_DESCRIPTORS_EXPORT double calcChiN(const PATH_LIST &paths,
+                                         const std::vector<double> &vals,
+                                         unsigned int n);
+//! calculates the kappa values from the number of paths of the appropriate
+//! length, the number of heavy atoms and the Hall-Kier alpha value
+RDKIT_DESCRIPTORS_EXPORT double kappa1Helper(double P1, double A,
+                                             double alpha);
+RDKIT_DESCRIPTORS_EXPORT double kappa2Helper(double P2, double A,
+                                             double alpha);
+RDKIT_DESCRIPTORS_EXPORT double kappa3Helper(double P3, int A, double alpha);
+}  // namespace detail
 
 }  // end of namespace Descriptors
 }  // namespace RDKit
@@ -15,11 +15,11 @@
 #include <GraphMol/Substruct/SubstructMatch.h>
 #include "MolDescriptors.h"
 #include "Crippen.h"
+#include "SubstructCountEngine.h"
 #include <iostream>
 #include <sstream>
 #include <RDGeneral/StreamOps.h>
 #include <boost/lexical_cast.hpp>
-#include <boost/dynamic_bitset.hpp>
 #include <boost/tokenizer.hpp>
 typedef boost::tokenizer<boost::char_separator<char>> tokenizer;
 
@@ -56,30 +56,21 @@ void getCrippenAtomContribs(const ROMol &mol, std::vector<double> &logpContribs,
     }
   }
 
-  boost::dynamic_bitset<> atomNeeded(mol.getNumAtoms());
-  atomNeeded.set();
   const CrippenParamCollection *params = CrippenParamCollection::getParams();
-  for (const auto &param : *params) {
-    std::vector<MatchVectType> matches;
-    SubstructMatch(mol, *(param.dp_pattern.get()), matches, false, true);
-    for (std::vector<MatchVectType>::const_iterator matchIt = matches.begin();
-         matchIt != matches.end(); ++matchIt) {
-      int idx = (*matchIt)[0].second;
-      if (atomNeeded[idx]) {
-        atomNeeded[idx] = 0;
-        logpContribs[idx] = param.logp;
-        mrContribs[idx] = param.mr;
-        if (atomTypes) {
-          (*atomTypes)[idx] = param.idx;
-        }
-        if (atomTypeLabels) {
-          (*atomTypeLabels)[idx] = param.label;
-        }
-      }
+  // each atom gets the parameters of the first pattern which matches it
+  auto paramIndices = params->getEngine().assignAtomsToPatterns(mol);
+  for (unsigned int idx = 0; idx < mol.getNumAtoms(); ++idx) {
+    if (paramIndices[idx] < 0) {
+      continue;
     }
-    // no need to keep matching stuff if we already found all the atoms:
-    if (atomNeeded.none()) {
-      break;
+    const auto &param = *(params->begin() + paramIndices[idx]);
+    logpContribs[idx] = param.logp;
+    mrContribs[idx] = param.mr;
+    if (atomTypes) {
+      (*atomTypes)[idx] = param.idx;
+    }
+    if (atomTypeLabels) {
+      (*atomTypeLabels)[idx] = param.label;
     }
   }
   mol.setProp(common_properties::_crippenLogPContribs, logpContribs, true);
@@ -187,6 +178,19 @@ CrippenParamCollection::CrippenParamCollection(const std::string &paramData) {
     }
     inLine = RDKit::getLine(inStream);
   }
+  auto engine = std::make_shared<SubstructCountEngine>();
+  for (const auto &param : d_params) {
+    if (param.dp_pattern) {
+      // the engine shares ownership of the pattern with the parameters
+      auto pattern = param.dp_pattern;
+      engine->addPattern(std::shared_ptr<const ROMol>(
+          pattern.get(),
+          [pattern](const ROMol *) mutable { pattern.reset(); }));
+    } else {
+      engine->addPattern(std::make_shared<const ROMol>());
+    }
+  }
+  dp_engine = engine;
 }
 
 CrippenParams::~CrippenParams() { dp_pattern.reset(); }
@@ -17,6 +17,7 @@
 #ifndef __RD_CRIPPEN_H__
 #define __RD_CRIPPEN_H__
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <boost/smart_ptr.hpp>
@@ -24,7 +25,8 @@
 namespace RDKit {
 class ROMol;
 namespace Descriptors {
-const std::string crippenVersion = "1.2.0";
+class SubstructCountEngine;
+const std::string crippenVersion = "1.2.1";
 
 //! generate atomic contributions to the Wildman-Crippen LogP and MR
 //! estimates for a molecule
@@ -125,11 +127,14 @@ class RDKIT_DESCRIPTORS_EXPORT CrippenParamCollection {
       const std::string &paramData = "");
   ParamsVect::const_iterator begin() const { return d_params.begin(); }
   ParamsVect::const_iterator end() const { return d_params.end(); }
+  //! returns an engine for matching the parameters' patterns
+  const SubstructCountEngine &getEngine() const { return *dp_engine; }
 
   CrippenParamCollection(const std::string &paramData);
 
  private:
   ParamsVect d_params;  //!< the parameters
+  std::shared_ptr<const SubstructCountEngine> dp_engine;
 };
 }  // end of namespace Descriptors
 }  // namespace RDKit
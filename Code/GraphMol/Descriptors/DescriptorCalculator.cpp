@@ -0,0 +1,409 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "DescriptorCalculator.h"
+#include <GraphMol/RDKitBase.h>
+#include <GraphMol/Descriptors/MolDescriptors.h>
+#include <GraphMol/Descriptors/AUTOCORR2D.h>
+#include <GraphMol/Descriptors/BCUT.h>
+#include <GraphMol/Descriptors/Property.h>
+#include <GraphMol/PartialCharges/GasteigerCharges.h>
+#include <RDGeneral/RDThreads.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+namespace RDKit {
+namespace Descriptors {
+
+namespace detail {
+//! the intermediate results which are shared between descriptors, each one
+//! is calculated the first time it's needed
+class DescriptorContext {
+ public:
+  explicit DescriptorContext(const ROMol &mol) : d_mol(mol) {}
+
+  const ROMol &mol() const { return d_mol; }
+
+  //! the Gasteiger charges, as calculated by computeGasteigerCharges()
+  const std::vector<double> &gasteigerCharges() {
+    if (!d_haveCharges) {
+      d_charges.resize(d_mol.getNumAtoms());
+      try {
+        computeGasteigerCharges(d_mol, d_charges, 12, true);
+      } catch (const ValueErrorException &) {
+        d_missingChargeParams = true;
+        computeGasteigerCharges(d_mol, d_charges);
+      }
+      d_haveCharges = true;
+    }
+    return d_charges;
+  }
+  //! whether or not there are Gasteiger parameters for all of the atoms
+  bool haveGasteigerParams() {
+    gasteigerCharges();
+    return !d_missingChargeParams;
+  }
+
+  //! the paths containing \c numAtoms atoms, as used for the chi indices
+  const PATH_LIST &atomPaths(unsigned int numAtoms) {
+    auto iter = d_atomPaths.find(numAtoms);
+    if (iter == d_atomPaths.end()) {
+      iter = d_atomPaths
+                 .emplace(numAtoms,
+                          findAllPathsOfLengthN(d_mol, numAtoms, false))
+                 .first;
+    }
+    return iter->second;
+  }
+  //! the number of paths containing \c numBonds bonds, as used for the
+  //! kappa indices
+  size_t numBondPaths(unsigned int numBonds) {
+    auto iter = d_numBondPaths.find(numBonds);
+    if (iter == d_numBondPaths.end()) {
+      auto numPaths = findAllPathsOfLengthN(d_mol, numBonds).size();
+      iter = d_numBondPaths.emplace(numBonds, numPaths).first;
+    }
+    return iter->second;
+  }
+
+  double hallKierAlpha() {
+    if (!d_haveAlpha) {
+      d_alpha = calcHallKierAlpha(d_mol);
+      d_haveAlpha = true;
+    }
+    return d_alpha;
+  }
+
+  //! the Crippen logP and MR contributions of the atoms, as calculated by
+  //! getCrippenAtomContribs()
+  const std::vector<double> &crippenLogPContribs() {
+    calcCrippenContribs();
+    return d_logpContribs;
+  }
+  const std::vector<double> &crippenMRContribs() {
+    calcCrippenContribs();
+    return d_mrContribs;
+  }
+
+  unsigned int numRotatableBonds() {
+    if (!d_haveNumRotatableBonds) {
+      d_numRotatableBonds = calcNumRotatableBonds(d_mol);
+      d_haveNumRotatableBonds = true;
+    }
+    return d_numRotatableBonds;
+  }
+
+ private:
+  void calcCrippenContribs() {
+    if (!d_haveCrippenContribs) {
+      d_logpContribs.resize(d_mol.getNumAtoms());
+      d_mrContribs.resize(d_mol.getNumAtoms());
+      getCrippenAtomContribs(d_mol, d_logpContribs, d_mrContribs);
+      d_haveCrippenContribs = true;
+    }
+  }
+
+  const ROMol &d_mol;
+  bool d_haveCharges = false;
+  bool d_missingChargeParams = false;
+  std::vector<double> d_charges;
+  std::map<unsigned int, PATH_LIST> d_atomPaths;
+  std::map<unsigned int, size_t> d_numBondPaths;
+  bool d_haveAlpha = false;
+  double d_alpha = 0.0;
+  bool d_haveNumRotatableBonds = false;
+  unsigned int d_numRotatableBonds = 0;
+  bool d_haveCrippenContribs = false;
+  std::vector<double> d_logpContribs;
+  std::vector<double> d_mrContribs;
+};
+
+//! a set of descriptors which are calculated together
+struct DescriptorGroup {
+  std::vector<std::string> names;
+  //! fills in the values of all of the descriptors in the group
+  std::function<void(DescriptorContext &, double *)> func;
+};
+}  // namespace detail
+
+namespace {
+using detail::DescriptorContext;
+using GroupPtr = std::shared_ptr<const detail::DescriptorGroup>;
+
+std::vector<std::string> numberedNames(const std::string &prefix,
+                                       unsigned int count) {
+  std::vector<std::string> res;
+  for (unsigned int i = 1; i <= count; ++i) {
+    res.push_back(prefix + std::to_string(i));
+  }
+  return res;
+}
+
+void copyValues(const std::vector<double> &vals, double *res) {
+  std::copy(vals.begin(), vals.end(), res);
+}
+
+void calcChiValues(DescriptorContext &ctx, double *res) {
+  const auto &mol = ctx.mol();
+  res[0] = calcChi0v(mol);
+  res[1] = calcChi1v(mol);
+  res[5] = calcChi0n(mol);
+  res[6] = calcChi1n(mol);
+  std::vector<double> hkDs(mol.getNumAtoms());
+  detail::hkDeltas(mol, hkDs, false);
+  std::vector<double> nVs(mol.getNumAtoms());
+  detail::nVals(mol, nVs, false);
+  for (unsigned int n = 2; n <= 4; ++n) {
+    const auto &paths = ctx.atomPaths(n + 1);
+    res[n] = detail::calcChiN(paths, hkDs, n);
+    res[n + 5] = detail::calcChiN(paths, nVs, n);
+  }
+}
+
+void calcKappaValues(DescriptorContext &ctx, double *res) {
+  const auto &mol = ctx.mol();
+  auto alpha = ctx.hallKierAlpha();
+  double P1 = mol.getNumBonds();
+  double P2 = ctx.numBondPaths(2);
+  double P3 = ctx.numBondPaths(3);
+  auto A = mol.getNumHeavyAtoms();
+  res[0] = alpha;
+  res[1] = detail::kappa1Helper(P1, A, alpha);
+  res[2] = detail::kappa2Helper(P2, A, alpha);
+  res[3] = detail::kappa3Helper(P3, A, alpha);
+  res[4] = A ? res[1] * res[2] / A : 0.0;
+}
+
+#ifdef RDK_HAS_EIGEN3
+void calcBCUTValues(DescriptorContext &ctx, double *res) {
+  const auto &mol = ctx.mol();
+  // BCUT2D() works on a copy of the molecule without Hs; we can only use the
+  // shared intermediates if that's the same as the molecule itself
+  bool hasHs = false;
+  for (const auto atom : mol.atoms()) {
+    if (atom->getAtomicNum() == 1) {
+      hasHs = true;
+      break;
+    }
+  }
+  if (!mol.getNumAtoms() || hasHs || !ctx.haveGasteigerParams()) {
+    copyValues(BCUT2D(mol), res);
+    return;
+  }
+  std::vector<double> masses;
+  masses.reserve(mol.getNumAtoms());
+  for (const auto atom : mol.atoms()) {
+    masses.push_back(atom->getMass());
+  }
+  unsigned int i = 0;
+  for (const auto &props : {masses, ctx.gasteigerCharges(),
+                            ctx.crippenLogPContribs(),
+                            ctx.crippenMRContribs()}) {
+    auto vals = BCUT2D(mol, props);
+    res[i++] = vals.first;
+    res[i++] = vals.second;
+  }
+}
+#endif
+
+const std::vector<GroupPtr> &getBuiltinGroups() {
+  static const std::vector<GroupPtr> groups = [] {
+    std::vector<detail::DescriptorGroup> res;
+    res.push_back({{"CrippenClogP", "CrippenMR"},
+                   [](DescriptorContext &ctx, double *vals) {
+                     calcCrippenDescriptors(ctx.mol(), vals[0], vals[1]);
+                   }});
+    res.push_back({{"chi0v", "chi1v", "chi2v", "chi3v", "chi4v", "chi0n",
+                    "chi1n", "chi2n", "chi3n", "chi4n"},
+                   calcChiValues});
+    res.push_back(
+        {{"hallKierAlpha", "kappa1", "kappa2", "kappa3", "Phi"},
+         calcKappaValues});
+    res.push_back({{"NumRotatableBonds"},
+                   [](DescriptorContext &ctx, double *vals) {
+                     vals[0] = ctx.numRotatableBonds();
+                   }});
+    res.push_back({numberedNames("SlogP_VSA", 12),
+                   [](DescriptorContext &ctx, double *vals) {
+                     copyValues(calcSlogP_VSA(ctx.mol()), vals);
+                   }});
+    res.push_back({numberedNames("SMR_VSA", 10),
+                   [](DescriptorContext &ctx, double *vals) {
+                     copyValues(calcSMR_VSA(ctx.mol()), vals);
+                   }});
+    res.push_back({numberedNames("PEOE_VSA", 14),
+                   [](DescriptorContext &ctx, double *vals) {
+                     copyValues(detail::calcPEOE_VSA(ctx.mol(),
+                                                     ctx.gasteigerCharges()),
+                                vals);
+                   }});
+    res.push_back({numberedNames("MQN", 42),
+                   [](DescriptorContext &ctx, double *vals) {
+                     auto mqns = detail::calcMQNs(ctx.mol(),
+                                                  ctx.numRotatableBonds());
+                     std::copy(mqns.begin(), mqns.end(), vals);
+                   }});
+    res.push_back({numberedNames("AUTOCORR2D_", 192),
+                   [](DescriptorContext &ctx, double *vals) {
+                     std::vector<double> autocorr;
+                     AUTOCORR2D(ctx.mol(), autocorr);
+                     copyValues(autocorr, vals);
+                   }});
+#ifdef RDK_HAS_EIGEN3
+    res.push_back({{"BCUT2D_MWHI", "BCUT2D_MWLOW", "BCUT2D_CHGHI",
+                    "BCUT2D_CHGLO", "BCUT2D_LOGPHI", "BCUT2D_LOGPLOW",
+                    "BCUT2D_MRHI", "BCUT2D_MRLOW"},
+                   calcBCUTValues});
+#endif
+    std::vector<GroupPtr> ptrs;
+    for (auto &group : res) {
+      ptrs.push_back(
+          std::make_shared<const detail::DescriptorGroup>(std::move(group)));
+    }
+    return ptrs;
+  }();
+  return groups;
+}
+
+//! returns all of the available groups: the builtin groups plus one group
+//! for each registered property which isn't covered by those
+std::vector<GroupPtr> getAllGroups() {
+  auto res = getBuiltinGroups();
+  std::unordered_map<std::string, bool> builtinNames;
+  for (const auto &group : res) {
+    for (const auto &name : group->names) {
+      builtinNames[name] = true;
+    }
+  }
+  // the registered properties come first so that the order of the
+  // descriptors matches Properties::getAvailableProperties()
+  std::vector<GroupPtr> propGroups;
+  for (const auto &name : Properties::getAvailableProperties()) {
+    if (builtinNames.find(name) != builtinNames.end()) {
+      continue;
+    }
+    auto prop = Properties::getProperty(name);
+    propGroups.push_back(std::make_shared<const detail::DescriptorGroup>(
+        detail::DescriptorGroup{
+            {name}, [prop](DescriptorContext &ctx, double *vals) {
+              vals[0] = (*prop)(ctx.mol());
+            }}));
+  }
+  res.insert(res.begin(), propGroups.begin(), propGroups.end());
+  return res;
+}
+
+std::vector<std::string> getAvailableNames(
+    const std::vector<GroupPtr> &groups) {
+  std::vector<std::string> res;
+  // registered properties which are in builtin groups keep their position
+  // in the registry
+  std::unordered_map<std::string, bool> seen;
+  for (const auto &name : Properties::getAvailableProperties()) {
+    res.push_back(name);
+    seen[name] = true;
+  }
+  for (const auto &group : groups) {
+    for (const auto &name : group->names) {
+      if (seen.find(name) == seen.end()) {
+        res.push_back(name);
+        seen[name] = true;
+      }
+    }
+  }
+  return res;
+}
+}  // namespace
+
+std::vector<std::string> DescriptorCalculator::getAvailableDescriptors() {
+  return getAvailableNames(getAllGroups());
+}
+
+DescriptorCalculator::DescriptorCalculator()
+    : DescriptorCalculator(getAvailableDescriptors()) {}
+
+DescriptorCalculator::DescriptorCalculator(
+    const std::vector<std::string> &names)
+    : d_names(names) {
+  auto groups = getAllGroups();
+  std::unordered_map<std::string, std::pair<unsigned int, unsigned int>>
+      locations;
+  for (unsigned int gidx = 0; gidx < groups.size(); ++gidx) {
+    for (unsigned int i = 0; i < groups[gidx]->names.size(); ++i) {
+      locations[groups[gidx]->names[i]] = std::make_pair(gidx, i);
+    }
+  }
+  // maps group index to position in d_groups
+  std::unordered_map<unsigned int, unsigned int> groupPositions;
+  for (unsigned int col = 0; col < d_names.size(); ++col) {
+    auto loc = locations.find(d_names[col]);
+    if (loc == locations.end()) {
+      throw KeyErrorException(d_names[col]);
+    }
+    auto gidx = loc->second.first;
+    auto pos = groupPositions.find(gidx);
+    if (pos == groupPositions.end()) {
+      pos = groupPositions.emplace(gidx, d_groups.size()).first;
+      d_groups.push_back(GroupColumns{groups[gidx], {}});
+    }
+    d_groups[pos->second].columns.emplace_back(loc->second.second, col);
+  }
+}
+
+DescriptorCalculator::~DescriptorCalculator() = default;
+
+void DescriptorCalculator::computeDescriptors(const ROMol &mol,
+                                              double *res) const {
+  DescriptorContext ctx(mol);
+  std::vector<double> vals;
+  for (const auto &gcols : d_groups) {
+    vals.assign(gcols.group->names.size(),
+                std::numeric_limits<double>::quiet_NaN());
+    try {
+      gcols.group->func(ctx, vals.data());
+    } catch (const std::exception &) {
+      std::fill(vals.begin(), vals.end(),
+                std::numeric_limits<double>::quiet_NaN());
+    }
+    for (const auto &col : gcols.columns) {
+      res[col.second] = vals[col.first];
+    }
+  }
+}
+
+std::vector<double> DescriptorCalculator::computeDescriptors(
+    const ROMol &mol) const {
+  std::vector<double> res(d_names.size());
+  computeDescriptors(mol, res.data());
+  return res;
+}
+
+std::vector<float> DescriptorCalculator::computeDescriptors(
+    const std::vector<const ROMol *> &mols, int numThreads) const {
+  auto numDescriptors = d_names.size();
+  std::vector<float> res(mols.size() * numDescriptors,
+                         std::numeric_limits<float>::quiet_NaN());
+  auto func = [&](size_t i) {
+    if (!mols[i]) {
+      return;
+    }
+    std::vector<double> row(numDescriptors);
+    computeDescriptors(*mols[i], row.data());
+    std::copy(row.begin(), row.end(), res.begin() + i * numDescriptors);
+  };
+  runOnIndices(func, mols.size(), numThreads);
+  return res;
+}
+
+}  // namespace Descriptors
+}  // namespace RDKit
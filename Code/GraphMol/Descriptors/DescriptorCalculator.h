@@ -0,0 +1,115 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+
+/*! \file DescriptorCalculator.h
+
+  \brief Defines the DescriptorCalculator class.
+
+*/
+#include <RDGeneral/export.h>
+#ifndef RD_DESCRIPTORCALCULATOR_H
+#define RD_DESCRIPTORCALCULATOR_H
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace RDKit {
+class ROMol;
+namespace Descriptors {
+namespace detail {
+struct DescriptorGroup;
+}
+
+//! Calculates a set of 2D descriptors for many molecules
+/*!
+  The available descriptors are the ones in the Properties registry plus
+  the members of these families:
+    - SlogP_VSA1-SlogP_VSA12, SMR_VSA1-SMR_VSA10, PEOE_VSA1-PEOE_VSA14
+    - MQN1-MQN42
+    - AUTOCORR2D_1-AUTOCORR2D_192
+    - BCUT2D_MWHI, BCUT2D_MWLOW, BCUT2D_CHGHI, BCUT2D_CHGLO, BCUT2D_LOGPHI,
+      BCUT2D_LOGPLOW, BCUT2D_MRHI, BCUT2D_MRLOW (if the RDKit was built with
+      Eigen3 support)
+
+  <b>Notes:</b>
+    - Descriptors which are calculated together are evaluated once per
+      molecule: each of the VSA, MQN, AUTOCORR2D and BCUT2D families, the
+      Crippen logP and MR, and the connectivity and kappa indices. The
+      intermediates those need (Crippen contributions, Gasteiger charges,
+      paths through the molecule, the Hall-Kier alpha value, the number of
+      rotatable bonds) are calculated at most once per molecule. The
+      Crippen contributions are shared by SlogP_VSA, SMR_VSA and BCUT2D;
+      CrippenClogP and CrippenMR are calculated on a copy of the molecule
+      with explicit Hs and don't use them.
+    - The values are the same as those from the individual descriptor
+      functions.
+    - As with the individual descriptor functions, some of the intermediate
+      results are cached on the molecules.
+    - Descriptors which can't be calculated for a molecule are set to NaN.
+*/
+class RDKIT_DESCRIPTORS_EXPORT DescriptorCalculator {
+ public:
+  //! construct a calculator for all of the available descriptors
+  DescriptorCalculator();
+  //! construct a calculator for the named descriptors
+  /*!
+    The values are returned in the order of \c names. A KeyErrorException
+    is thrown if any of the names isn't available.
+  */
+  DescriptorCalculator(const std::vector<std::string> &names);
+  ~DescriptorCalculator();
+
+  //! returns the names of all of the descriptors which can be calculated
+  static std::vector<std::string> getAvailableDescriptors();
+
+  //! returns the names of the descriptors which are calculated
+  const std::vector<std::string> &getDescriptorNames() const {
+    return d_names;
+  }
+  //! returns the number of descriptors which are calculated
+  unsigned int getNumDescriptors() const {
+    return static_cast<unsigned int>(d_names.size());
+  }
+
+  //! calculates the descriptors for a molecule
+  std::vector<double> computeDescriptors(const ROMol &mol) const;
+
+  //! calculates the descriptors for multiple molecules
+  /*!
+    \param mols       the molecules. These should be distinct molecules:
+                      intermediate results are cached on each molecule by
+                      the thread which processes it.
+    \param numThreads the number of threads to use, values <= 0 are
+                      interpreted as described for getNumThreadsToUse()
+
+    \return a matrix with one row for each molecule and one column for each
+            descriptor, in row-major order. The rows for null molecules are
+            filled with NaN.
+  */
+  std::vector<float> computeDescriptors(const std::vector<const ROMol *> &mols,
+                                        int numThreads = 1) const;
+
+ private:
+  void computeDescriptors(const ROMol &mol, double *res) const;
+
+  struct GroupColumns {
+    std::shared_ptr<const detail::DescriptorGroup> group;
+    // pairs of (index in the group's values, output column)
+    std::vector<std::pair<unsigned int, unsigned int>> columns;
+  };
+  std::vector<std::string> d_names;
+  std::vector<GroupColumns> d_groups;
+};
+
+}  // namespace Descriptors
+}  // namespace RDKit
+#endif
@@ -0,0 +1,318 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "Descriptors3DContext.h"
+#include "MolData3Ddescriptors.h"
+#include "RDF.h"
+#include "MORSE.h"
+#include "WHIM.h"
+#include "GETAWAY.h"
+#include "AUTOCORR3D.h"
+#include "PMI.h"
+#include <GraphMol/RDKitBase.h>
+#include <RDGeneral/RDThreads.h>
+
+#include <array>
+#include <mutex>
+
+namespace RDKit {
+namespace Descriptors {
+
+struct Descriptors3DContext::MolData {
+  const ROMol *mol;
+  unsigned int numAtoms;
+  unsigned int numPairs;
+  std::vector<std::vector<double>> atomProps;
+  // the products are only calculated when they are first needed, the
+  // contexts for different conformers may do that from different threads
+  mutable std::array<std::vector<double>,
+                     static_cast<size_t>(AtomProperty3D::NumProperties)>
+      pairProducts;
+  mutable std::array<std::once_flag,
+                     static_cast<size_t>(AtomProperty3D::NumProperties)>
+      pairProductsDone;
+  std::vector<double> topologicalDistances;
+  std::vector<double> adjacency;
+};
+
+struct Descriptors3DContext::ConfData {
+  const Conformer *conf;
+  std::vector<double> distances;
+  std::vector<double> pairDistances;
+  std::unique_ptr<Eigen::MatrixXd> centered;
+  std::unique_ptr<Eigen::MatrixXd> leverage;
+  std::unique_ptr<Eigen::MatrixXd> influenceDistance;
+};
+
+namespace {
+MolData3Ddescriptors moldata3D;
+
+std::vector<double> calcAtomProperty(const ROMol &mol, AtomProperty3D prop) {
+  switch (prop) {
+    case AtomProperty3D::Unit:
+      return moldata3D.GetUn(mol.getNumAtoms());
+    case AtomProperty3D::RelativeMW:
+      return moldata3D.GetRelativeMW(mol);
+    case AtomProperty3D::RelativeVdW:
+      return moldata3D.GetRelativeVdW(mol);
+    case AtomProperty3D::RelativeENeg:
+      return moldata3D.GetRelativeENeg(mol);
+    case AtomProperty3D::RelativePol:
+      return moldata3D.GetRelativePol(mol);
+    case AtomProperty3D::RelativeIonPol:
+      return moldata3D.GetRelativeIonPol(mol);
+    case AtomProperty3D::IState:
+      return moldata3D.GetIState(mol);
+    case AtomProperty3D::IStateDrag:
+      return moldata3D.GetIStateDrag(mol);
+    case AtomProperty3D::RelativeRcov:
+      return moldata3D.GetRelativeRcov(mol);
+    default:
+      throw ValueErrorException("bad atom property");
+  }
+}
+
+// the pseudo-inverse, with the tolerance used by GETAWAY
+Eigen::MatrixXd getPinv(const Eigen::MatrixXd &A) {
+  Eigen::JacobiSVD<Eigen::MatrixXd> svd(
+      A, Eigen::ComputeThinU | Eigen::ComputeThinV);
+  const double pinvtoler = 1.e-3;
+  Eigen::VectorXd vs = svd.singularValues();
+  Eigen::VectorXd vsinv = svd.singularValues();
+  for (unsigned int i = 0; i < A.cols(); ++i) {
+    if (vs(i) > pinvtoler) {
+      vsinv(i) = 1.0 / vs(i);
+    } else {
+      vsinv(i) = 0.0;
+    }
+  }
+  Eigen::MatrixXd S = vsinv.asDiagonal();
+  return svd.matrixV() * S * svd.matrixU().transpose();
+}
+}  // namespace
+
+Descriptors3DContext::Descriptors3DContext(const ROMol &mol, int confId) {
+  PRECONDITION(mol.getNumConformers() >= 1, "molecule has no conformers");
+  auto molData = std::make_shared<MolData>();
+  molData->mol = &mol;
+  auto numAtoms = mol.getNumAtoms();
+  molData->numAtoms = numAtoms;
+  molData->numPairs = numAtoms > 1 ? numAtoms * (numAtoms - 1) / 2 : 0;
+  for (unsigned int prop = 0;
+       prop < static_cast<unsigned int>(AtomProperty3D::NumProperties);
+       ++prop) {
+    molData->atomProps.push_back(
+        calcAtomProperty(mol, static_cast<AtomProperty3D>(prop)));
+  }
+  // the topological distances aren't weighted
+  const double *topDist = MolOps::getDistanceMat(mol, false);
+  molData->topologicalDistances.assign(topDist,
+                                       topDist + numAtoms * numAtoms);
+  const double *adjMat = MolOps::getAdjacencyMatrix(mol, false, 0, false);
+  molData->adjacency.assign(adjMat, adjMat + numAtoms * numAtoms);
+  dp_molData = molData;
+
+  dp_confData = std::make_shared<ConfData>();
+  dp_confData->conf = &mol.getConformer(confId);
+}
+
+Descriptors3DContext::Descriptors3DContext(
+    std::shared_ptr<const MolData> molData, int confId)
+    : dp_molData(std::move(molData)) {
+  dp_confData = std::make_shared<ConfData>();
+  dp_confData->conf = &dp_molData->mol->getConformer(confId);
+}
+
+Descriptors3DContext Descriptors3DContext::forConformer(int confId) const {
+  return Descriptors3DContext(dp_molData, confId);
+}
+
+const ROMol &Descriptors3DContext::getMol() const { return *dp_molData->mol; }
+const Conformer &Descriptors3DContext::getConformer() const {
+  return *dp_confData->conf;
+}
+int Descriptors3DContext::getConfId() const {
+  return static_cast<int>(dp_confData->conf->getId());
+}
+unsigned int Descriptors3DContext::getNumAtoms() const {
+  return dp_molData->numAtoms;
+}
+unsigned int Descriptors3DContext::getNumPairs() const {
+  return dp_molData->numPairs;
+}
+
+const std::vector<double> &Descriptors3DContext::getAtomProperty(
+    AtomProperty3D prop) const {
+  URANGE_CHECK(static_cast<unsigned int>(prop), dp_molData->atomProps.size());
+  return dp_molData->atomProps[static_cast<unsigned int>(prop)];
+}
+const std::vector<double> &Descriptors3DContext::getPairProducts(
+    AtomProperty3D prop) const {
+  auto idx = static_cast<unsigned int>(prop);
+  URANGE_CHECK(idx, dp_molData->pairProducts.size());
+  const auto &molData = *dp_molData;
+  std::call_once(molData.pairProductsDone[idx], [&molData, idx]() {
+    const auto &vals = molData.atomProps[idx];
+    auto &products = molData.pairProducts[idx];
+    products.reserve(molData.numPairs);
+    for (unsigned int i = 0; i + 1 < molData.numAtoms; ++i) {
+      for (unsigned int j = i + 1; j < molData.numAtoms; ++j) {
+        products.push_back(vals[i] * vals[j]);
+      }
+    }
+  });
+  return molData.pairProducts[idx];
+}
+const std::vector<double> &Descriptors3DContext::getTopologicalDistanceMatrix()
+    const {
+  return dp_molData->topologicalDistances;
+}
+const std::vector<double> &Descriptors3DContext::getAdjacencyMatrix() const {
+  return dp_molData->adjacency;
+}
+
+const std::vector<double> &Descriptors3DContext::getDistanceMatrix() const {
+  auto &confData = *dp_confData;
+  if (confData.distances.empty() && getNumAtoms()) {
+    // this is the same calculation as MolOps::get3DDistanceMat(), but
+    // nothing is cached on the molecule
+    auto numAtoms = getNumAtoms();
+    confData.distances.resize(numAtoms * numAtoms, 0.0);
+    confData.pairDistances.reserve(getNumPairs());
+    const auto &conf = *confData.conf;
+    for (unsigned int i = 0; i < numAtoms; ++i) {
+      for (unsigned int j = i + 1; j < numAtoms; ++j) {
+        double dist = (conf.getAtomPos(i) - conf.getAtomPos(j)).length();
+        confData.distances[i * numAtoms + j] = dist;
+        confData.distances[j * numAtoms + i] = dist;
+        confData.pairDistances.push_back(dist);
+      }
+    }
+  }
+  return confData.distances;
+}
+const std::vector<double> &Descriptors3DContext::getPairDistances() const {
+  getDistanceMatrix();
+  return dp_confData->pairDistances;
+}
+
+const Eigen::MatrixXd &Descriptors3DContext::getCenteredCoordinates() const {
+  auto &confData = *dp_confData;
+  if (!confData.centered) {
+    auto numAtoms = getNumAtoms();
+    Eigen::MatrixXd coords(numAtoms, 3);
+    const auto &conf = *confData.conf;
+    for (unsigned int i = 0; i < numAtoms; ++i) {
+      const auto &pos = conf.getAtomPos(i);
+      coords(i, 0) = pos.x;
+      coords(i, 1) = pos.y;
+      coords(i, 2) = pos.z;
+    }
+    Eigen::VectorXd mean = coords.colwise().mean();
+    confData.centered.reset(
+        new Eigen::MatrixXd(coords.rowwise() - mean.transpose()));
+  }
+  return *confData.centered;
+}
+
+const Eigen::MatrixXd &Descriptors3DContext::getLeverageMatrix() const {
+  auto &confData = *dp_confData;
+  if (!confData.leverage) {
+    const auto &X = getCenteredCoordinates();
+    Eigen::MatrixXd weighted = X.transpose() * X;
+    confData.leverage.reset(
+        new Eigen::MatrixXd(X * getPinv(weighted) * X.transpose()));
+  }
+  return *confData.leverage;
+}
+
+const Eigen::MatrixXd &Descriptors3DContext::getInfluenceDistanceMatrix()
+    const {
+  auto &confData = *dp_confData;
+  if (!confData.influenceDistance) {
+    auto numAtoms = getNumAtoms();
+    const auto &H = getLeverageMatrix();
+    const auto &dists = getDistanceMatrix();
+    auto R = new Eigen::MatrixXd(Eigen::MatrixXd::Zero(numAtoms, numAtoms));
+    for (unsigned int i = 0; i + 1 < numAtoms; ++i) {
+      for (unsigned int j = i + 1; j < numAtoms; ++j) {
+        (*R)(i, j) = sqrt(H(i, i) * H(j, j)) / dists[i * numAtoms + j];
+        (*R)(j, i) = (*R)(i, j);
+      }
+    }
+    confData.influenceDistance.reset(R);
+  }
+  return *confData.influenceDistance;
+}
+
+unsigned int getNumDescriptors3D(const Descriptors3DParams &params) {
+  unsigned int res = 0;
+  res += params.includeRDF ? 210 : 0;
+  res += params.includeMORSE ? 224 : 0;
+  res += params.includeWHIM ? 114 : 0;
+  res += params.includeGETAWAY ? 273 : 0;
+  res += params.includeAUTOCORR3D ? 80 : 0;
+  res += params.includePMI ? 10 : 0;
+  return res;
+}
+
+std::vector<double> calcDescriptors3D(const Descriptors3DContext &context,
+                                      const Descriptors3DParams &params) {
+  std::vector<double> res;
+  res.reserve(getNumDescriptors3D(params));
+  std::vector<double> block;
+  if (params.includeRDF) {
+    RDF(context, block);
+    res.insert(res.end(), block.begin(), block.end());
+  }
+  if (params.includeMORSE) {
+    MORSE(context, block);
+    res.insert(res.end(), block.begin(), block.end());
+  }
+  if (params.includeWHIM) {
+    WHIM(context, block, params.whimThreshold);
+    res.insert(res.end(), block.begin(), block.end());
+  }
+  if (params.includeGETAWAY) {
+    GETAWAY(context, block, params.getawayPrecision);
+    res.insert(res.end(), block.begin(), block.end());
+  }
+  if (params.includeAUTOCORR3D) {
+    AUTOCORR3D(context, block);
+    res.insert(res.end(), block.begin(), block.end());
+  }
+  if (params.includePMI) {
+    calcPMIDescriptors(context, block);
+    res.insert(res.end(), block.begin(), block.end());
+  }
+  return res;
+}
+
+std::vector<std::vector<double>> calcDescriptors3D(
+    const ROMol &mol, const std::vector<int> &confIds,
+    const Descriptors3DParams &params, int numThreads) {
+  PRECONDITION(mol.getNumConformers() >= 1, "molecule has no conformers");
+  std::vector<int> ids = confIds;
+  if (ids.empty()) {
+    for (auto cit = mol.beginConformers(); cit != mol.endConformers(); ++cit) {
+      ids.push_back(static_cast<int>((*cit)->getId()));
+    }
+  }
+  // the molecule-level data is calculated here and shared by the threads
+  Descriptors3DContext context(mol, ids[0]);
+  std::vector<std::vector<double>> res(ids.size());
+  auto func = [&](size_t i) {
+    res[i] = calcDescriptors3D(context.forConformer(ids[i]), params);
+  };
+  runOnIndices(func, ids.size(), numThreads);
+  return res;
+}
+
+}  // namespace Descriptors
+}  // namespace RDKit
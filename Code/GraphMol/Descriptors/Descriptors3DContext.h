@@ -0,0 +1,156 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+
+/*! \file Descriptors3DContext.h
+
+  \brief Defines the Descriptors3DContext class and batch calculation of
+  the 3D descriptors.
+
+*/
+#include <RDGeneral/export.h>
+#ifndef RD_DESCRIPTORS3DCONTEXT_H
+#define RD_DESCRIPTORS3DCONTEXT_H
+
+#ifdef RDK_BUILD_DESCRIPTORS3D
+#include <memory>
+#include <vector>
+#include <Eigen/Dense>
+
+namespace RDKit {
+class ROMol;
+class Conformer;
+namespace Descriptors {
+
+//! the atomic properties used to weight the 3D descriptors
+/*!
+  The first seven are the "u", "m", "v", "e", "p", "i" and "s" weights
+  used by RDF, MORSE, WHIM, GETAWAY and AUTOCORR3D.
+*/
+enum class AtomProperty3D {
+  Unit = 0,        //!< all ones
+  RelativeMW,      //!< atomic mass relative to carbon
+  RelativeVdW,     //!< van der Waals volume relative to carbon
+  RelativeENeg,    //!< Sanderson electronegativity relative to carbon
+  RelativePol,     //!< polarizability relative to carbon
+  RelativeIonPol,  //!< ionization potential relative to carbon
+  IState,          //!< the intrinsic state
+  IStateDrag,      //!< the intrinsic state as calculated by Dragon (RDF)
+  RelativeRcov,    //!< covalent radius relative to carbon
+  NumProperties
+};
+
+//! Holds the intermediates shared by the 3D descriptors of a conformer
+/*!
+  The molecule-level data (the atomic property tables, the topological
+  distance and adjacency matrices) are calculated when the context is
+  constructed and are shared by the contexts returned from forConformer().
+  The products of an atomic property for each pair of atoms are also
+  shared, but are only calculated the first time they are needed. The
+  conformer-level data (the 3D distances, the centered coordinates, the
+  leverage matrix) are calculated the first time they are needed.
+
+  <b>Notes:</b>
+    - A context only holds a reference to the molecule, so the molecule must
+      not be modified or destroyed while the context is in use.
+    - Contexts for different conformers can be used from different threads,
+      but a single context should only be used by one thread at a time.
+    - The atom pairs are (i, j) with i < j, ordered by i and then j.
+*/
+class RDKIT_DESCRIPTORS_EXPORT Descriptors3DContext {
+ public:
+  Descriptors3DContext(const ROMol &mol, int confId = -1);
+
+  //! returns a context for another conformer of the same molecule
+  Descriptors3DContext forConformer(int confId) const;
+
+  const ROMol &getMol() const;
+  const Conformer &getConformer() const;
+  int getConfId() const;
+  unsigned int getNumAtoms() const;
+  unsigned int getNumPairs() const;
+
+  //! returns the value of an atomic property for each atom
+  const std::vector<double> &getAtomProperty(AtomProperty3D prop) const;
+  //! returns the product of an atomic property for each pair of atoms
+  const std::vector<double> &getPairProducts(AtomProperty3D prop) const;
+  //! returns the topological distance matrix
+  const std::vector<double> &getTopologicalDistanceMatrix() const;
+  //! returns the (unweighted) adjacency matrix
+  const std::vector<double> &getAdjacencyMatrix() const;
+
+  //! returns the 3D distance matrix of the conformer
+  const std::vector<double> &getDistanceMatrix() const;
+  //! returns the 3D distance for each pair of atoms
+  const std::vector<double> &getPairDistances() const;
+  //! returns the coordinates of the conformer, centered at the origin
+  /*!
+    The matrix has one row per atom.
+  */
+  const Eigen::MatrixXd &getCenteredCoordinates() const;
+  //! returns the molecular influence (leverage) matrix used by GETAWAY
+  const Eigen::MatrixXd &getLeverageMatrix() const;
+  //! returns the influence/distance matrix used by GETAWAY
+  const Eigen::MatrixXd &getInfluenceDistanceMatrix() const;
+
+  struct MolData;
+  struct ConfData;
+
+ private:
+  Descriptors3DContext(std::shared_ptr<const MolData> molData, int confId);
+
+  std::shared_ptr<const MolData> dp_molData;
+  std::shared_ptr<ConfData> dp_confData;
+};
+
+//! Controls which descriptors are calculated by calcDescriptors3D()
+struct RDKIT_DESCRIPTORS_EXPORT Descriptors3DParams {
+  bool includeRDF = true;         //!< 210 values, see RDF()
+  bool includeMORSE = true;       //!< 224 values, see MORSE()
+  bool includeWHIM = true;        //!< 114 values, see WHIM()
+  bool includeGETAWAY = true;     //!< 273 values, see GETAWAY()
+  bool includeAUTOCORR3D = true;  //!< 80 values, see AUTOCORR3D()
+  bool includePMI = true;         //!< 10 values, see calcPMIDescriptors()
+  double whimThreshold = 0.001;   //!< the WHIM symmetry threshold
+  unsigned int getawayPrecision = 2;  //!< the GETAWAY precision
+};
+
+//! returns the number of values calcDescriptors3D() returns per conformer
+RDKIT_DESCRIPTORS_EXPORT unsigned int getNumDescriptors3D(
+    const Descriptors3DParams &params);
+
+//! calculates the requested 3D descriptors for one conformer
+/*!
+  The blocks are in the order RDF, MORSE, WHIM, GETAWAY, AUTOCORR3D, PMI and
+  have the same values as the individual functions.
+*/
+RDKIT_DESCRIPTORS_EXPORT std::vector<double> calcDescriptors3D(
+    const Descriptors3DContext &context,
+    const Descriptors3DParams &params = Descriptors3DParams());
+
+//! calculates the requested 3D descriptors for multiple conformers
+/*!
+  \param mol        the molecule
+  \param confIds    the conformers to use, an empty vector means all of
+                    the molecule's conformers
+  \param params     the descriptors to calculate
+  \param numThreads the number of threads to use, values <= 0 are
+                    interpreted as described for getNumThreadsToUse()
+
+  \return one vector of descriptor values for each conformer
+*/
+RDKIT_DESCRIPTORS_EXPORT std::vector<std::vector<double>> calcDescriptors3D(
+    const ROMol &mol, const std::vector<int> &confIds = std::vector<int>(),
+    const Descriptors3DParams &params = Descriptors3DParams(),
+    int numThreads = 1);
+
+}  // namespace Descriptors
+}  // namespace RDKit
+#endif
+#endif
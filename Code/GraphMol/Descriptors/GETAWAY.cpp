@@ -38,6 +38,7 @@
 #include "GETAWAY.h"
 #include "PBF.h"
 #include "MolData3Ddescriptors.h"
+#include "Descriptors3DContext.h"
 
 #include "GraphMol/PartialCharges/GasteigerCharges.h"
 #include "GraphMol/PartialCharges/GasteigerParams.h"
@@ -258,8 +259,7 @@ std::vector<double> GetGeodesicMatrix(const double* dist, int lag,
   PRECONDITION(dist != nullptr, "bad array");
 
   int sizeArray = numAtoms * numAtoms;
-  std::vector<double> Geodesic;
-  Geodesic.reserve(sizeArray);
+  std::vector<double> Geodesic(sizeArray);
   std::transform(dist, dist + sizeArray, Geodesic.begin(),
                  [lag](double dist) { return int(dist == lag); });
 
@@ -271,48 +271,6 @@ JacobiSVD<MatrixXd> getSVD(const MatrixXd& A) {
   return mysvd;
 }
 
-MatrixXd GetPinv(const MatrixXd& A) {
-  JacobiSVD<MatrixXd> svd = getSVD(A);
-  double pinvtoler = 1.e-3;  // choose your tolerance wisely!
-  VectorXd vs = svd.singularValues();
-  VectorXd vsinv = svd.singularValues();
-
-  for (unsigned int i = 0; i < A.cols(); ++i) {
-    if (vs(i) > pinvtoler) {
-      vsinv(i) = 1.0 / vs(i);
-    } else {
-      vsinv(i) = 0.0;
-    }
-  }
-
-  MatrixXd S = vsinv.asDiagonal();
-  MatrixXd Ap = svd.matrixV() * S * svd.matrixU().transpose();
-  return Ap;
-}
-
-MatrixXd GetCenterMatrix(MatrixXd Mat) {
-  VectorXd v = Mat.colwise().mean();
-  MatrixXd X = Mat.rowwise() - v.transpose();
-  return X;
-}
-
-MatrixXd GetHmatrix(MatrixXd X) {
-  MatrixXd Weighted = X.transpose() * X;
-  return X * GetPinv(Weighted) * X.transpose();
-}
-
-MatrixXd GetRmatrix(MatrixXd H, MatrixXd DM, int numAtoms) {
-  MatrixXd R = MatrixXd::Zero(numAtoms, numAtoms);
-  for (int i = 0; i < numAtoms - 1; i++) {
-    for (int j = i + 1; j < numAtoms; j++) {
-      R(i, j) = sqrt(H(i, i) * H(j, j)) / DM(i, j);
-      R(j, i) = R(i, j);
-    }
-  }
-
-  return R;
-}
-
 std::vector<int> GetHeavyList(const ROMol& mol) {
   int numAtoms = mol.getNumAtoms();
   std::vector<int> HeavyList;
@@ -335,7 +293,7 @@ double* AppendDouble(double* w, const double* Append, int length, int pos) {
   return w;
 }
 
-double getRCON(MatrixXd R, MatrixXd Adj, int numAtoms) {
+double getRCON(const MatrixXd& R, const MatrixXd& Adj, int numAtoms) {
   // similar implementation of J. Chem. Inf. Comput. Sci. 2004, 44, 200-209
   // equation 1 or 2 page 201
   // we use instead of atomic absolute values the atomic relative ones as in
@@ -370,8 +328,10 @@ double getMax(const double* Rk) {
   return RTp;
 }
 
-void getGETAWAYDescCustom(MatrixXd H, MatrixXd R, MatrixXd Adj, int numAtoms,
-                          std::vector<int> Heavylist, const ROMol& mol,
+void getGETAWAYDescCustom(const MatrixXd& H, const MatrixXd& R,
+                          const MatrixXd& Adj, int numAtoms,
+                          std::vector<int> Heavylist,
+                          const Descriptors3DContext& context,
                           std::vector<double>& res, unsigned int precision,
                           const std::string& customAtomPropName) {
   // prepare data for Getaway parameter computation
@@ -400,7 +360,8 @@ void getGETAWAYDescCustom(MatrixXd H, MatrixXd R, MatrixXd Adj, int numAtoms,
 
   // use the PBF to determine 2D vs 3D (with Threshold)
   // determine if this is a plane molecule
-  double pbf = RDKit::Descriptors::PBF(mol);
+  double pbf =
+      RDKit::Descriptors::PBF(context.getMol(), context.getConfId());
   double D;
   if (pbf < 1.e-5) {
     D = 2.0;
@@ -428,10 +389,10 @@ void getGETAWAYDescCustom(MatrixXd H, MatrixXd R, MatrixXd Adj, int numAtoms,
 
   VectorXd EIG = mysvd.singularValues();
 
-  double rcon = getRCON(R, std::move(Adj), numAtoms);
+  double rcon = getRCON(R, Adj, numAtoms);
 
   std::vector<double> customAtomArray =
-      moldata3D.GetCustomAtomProp(mol, customAtomPropName);
+      moldata3D.GetCustomAtomProp(context.getMol(), customAtomPropName);
   VectorXd Wc = getEigenVect(customAtomArray);
 
   MatrixXd Bi;
@@ -442,11 +403,10 @@ void getGETAWAYDescCustom(MatrixXd H, MatrixXd R, MatrixXd Adj, int numAtoms,
   double Rk[8];
   double Rp[8];
 
-  double* dist =
-      MolOps::getDistanceMat(mol, false);  // need to be be set to false to have
-  // topological distance not weighted!
+  // the topological distances aren't weighted
+  const double* dist = context.getTopologicalDistanceMatrix().data();
 
-  Map<MatrixXd> D2(dist, numAtoms, numAtoms);
+  Map<const MatrixXd> D2(dist, numAtoms, numAtoms);
 
   double Dmax = D2.colwise().maxCoeff().maxCoeff();
 
@@ -594,8 +554,10 @@ void getGETAWAYDescCustom(MatrixXd H, MatrixXd R, MatrixXd Adj, int numAtoms,
   res[44] = roundn(RTMc, 3);
 }
 
-void getGETAWAYDesc(MatrixXd H, MatrixXd R, MatrixXd Adj, int numAtoms,
-                    std::vector<int> Heavylist, const ROMol& mol,
+void getGETAWAYDesc(const MatrixXd& H, const MatrixXd& R,
+                    const MatrixXd& Adj, int numAtoms,
+                    std::vector<int> Heavylist,
+                    const Descriptors3DContext& context,
                     std::vector<double>& res, unsigned int precision) {
   // prepare data for Getaway parameter computation
   // compute parameters
@@ -623,7 +585,8 @@ void getGETAWAYDesc(MatrixXd H, MatrixXd R, MatrixXd Adj, int numAtoms,
 
   // use the PBF to determine 2D vs 3D (with Threshold)
   // determine if this is a plane molecule
-  double pbf = RDKit::Descriptors::PBF(mol);
+  double pbf =
+      RDKit::Descriptors::PBF(context.getMol(), context.getConfId());
   double D;
   if (pbf < 1.e-5) {
     D = 2.0;
@@ -651,33 +614,40 @@ void getGETAWAYDesc(MatrixXd H, MatrixXd R, MatrixXd Adj, int numAtoms,
 
   VectorXd EIG = mysvd.singularValues();
 
-  double rcon = getRCON(R, std::move(Adj), numAtoms);
+  double rcon = getRCON(R, Adj, numAtoms);
 
-  std::vector<double> wp = moldata3D.GetRelativePol(mol);
+  const std::vector<double>& wp =
+      context.getAtomProperty(AtomProperty3D::RelativePol);
 
   VectorXd Wp = getEigenVect(wp);
 
-  std::vector<double> wm = moldata3D.GetRelativeMW(mol);
+  const std::vector<double>& wm =
+      context.getAtomProperty(AtomProperty3D::RelativeMW);
 
   VectorXd Wm = getEigenVect(wm);
 
-  std::vector<double> wi = moldata3D.GetRelativeIonPol(mol);
+  const std::vector<double>& wi =
+      context.getAtomProperty(AtomProperty3D::RelativeIonPol);
 
   VectorXd Wi = getEigenVect(wi);
 
-  std::vector<double> wv = moldata3D.GetRelativeVdW(mol);
+  const std::vector<double>& wv =
+      context.getAtomProperty(AtomProperty3D::RelativeVdW);
 
   VectorXd Wv = getEigenVect(wv);
 
-  std::vector<double> we = moldata3D.GetRelativeENeg(mol);
+  const std::vector<double>& we =
+      context.getAtomProperty(AtomProperty3D::RelativeENeg);
 
   VectorXd We = getEigenVect(we);
 
-  std::vector<double> wu = moldata3D.GetUn(numAtoms);
+  const std::vector<double>& wu =
+      context.getAtomProperty(AtomProperty3D::Unit);
 
   VectorXd Wu = getEigenVect(wu);
 
-  std::vector<double> ws = moldata3D.GetIState(mol);
+  const std::vector<double>& ws =
+      context.getAtomProperty(AtomProperty3D::IState);
 
   VectorXd Ws = getEigenVect(ws);
 
@@ -696,11 +666,10 @@ void getGETAWAYDesc(MatrixXd H, MatrixXd R, MatrixXd Adj, int numAtoms,
   double Rk[7][8];
   double Rp[7][8];
 
-  double* dist =
-      MolOps::getDistanceMat(mol, false);  // need to be be set to false to have
-                                           // topological distance not weighted!
+  // the topological distances aren't weighted
+  const double* dist = context.getTopologicalDistanceMatrix().data();
 
-  Map<MatrixXd> D2(dist, numAtoms, numAtoms);
+  Map<const MatrixXd> D2(dist, numAtoms, numAtoms);
 
   double Dmax = D2.colwise().maxCoeff().maxCoeff();
 
@@ -1159,104 +1128,49 @@ GETAWAYNAMES={"ITH","ISH","HIC","HGM","H0u","H1u","H2u","H3u","H4u","H5u","H6u",
 "R7i+","R8i+","RTi+","R1s","R2s","R3s","R4s","R5s","R6s","R7s","R8s","RTs","R1s+","R2s+","R3s+","R4s+","R5s+","R6s+","R7s+","R8s+","RTs+"};
  */
 
-void GetGETAWAYone(double* dist3D, double* AdjMat, std::vector<double> Vpoints,
-                   const ROMol& mol, const Conformer& conf,
-                   std::vector<int> Heavylist, std::vector<double>& res,
-                   unsigned int precision,
+void GetGETAWAYone(const Descriptors3DContext& context,
+                   std::vector<double>& res, unsigned int precision,
                    const std::string& customAtomPropName) {
-  PRECONDITION(dist3D != nullptr, "no distance matrix");
-  PRECONDITION(AdjMat != nullptr, "no adjacency matrix");
-  int numAtoms = conf.getNumAtoms();
-
-  Map<MatrixXd> ADJ(AdjMat, numAtoms, numAtoms);
-
-  Map<MatrixXd> DM(dist3D, numAtoms, numAtoms);
-
-  double* vpoints = &Vpoints[0];
-
-  Map<MatrixXd> matorigin(vpoints, 3, numAtoms);
-
-  MatrixXd MatOrigin = matorigin.transpose();
-
-  MatrixXd Xmean = GetCenterMatrix(MatOrigin);
-
-  MatrixXd H = GetHmatrix(Xmean);
-
-  MatrixXd R = GetRmatrix(H, DM, numAtoms);
-
-  getGETAWAYDescCustom(H, R, ADJ, numAtoms, std::move(Heavylist), mol, res,
-                       precision, customAtomPropName);
+  int numAtoms = context.getNumAtoms();
+  Map<const MatrixXd> ADJ(context.getAdjacencyMatrix().data(), numAtoms,
+                          numAtoms);
+  getGETAWAYDescCustom(context.getLeverageMatrix(),
+                       context.getInfluenceDistanceMatrix(), ADJ, numAtoms,
+                       GetHeavyList(context.getMol()), context, res, precision,
+                       customAtomPropName);
 }
 
-void GetGETAWAY(double* dist3D, double* AdjMat, std::vector<double> Vpoints,
-                const ROMol& mol, const Conformer& conf,
-                std::vector<int> Heavylist, std::vector<double>& res,
+void GetGETAWAY(const Descriptors3DContext& context, std::vector<double>& res,
                 unsigned int precision) {
-  PRECONDITION(dist3D != nullptr, "no distance matrix");
-  PRECONDITION(AdjMat != nullptr, "no adjacency matrix");
-
-  int numAtoms = conf.getNumAtoms();
-
-  Map<MatrixXd> ADJ(AdjMat, numAtoms, numAtoms);
-
-  Map<MatrixXd> DM(dist3D, numAtoms, numAtoms);
-
-  double* vpoints = &Vpoints[0];
-
-  Map<MatrixXd> matorigin(vpoints, 3, numAtoms);
-
-  MatrixXd MatOrigin = matorigin.transpose();
-
-  MatrixXd Xmean = GetCenterMatrix(MatOrigin);
-
-  MatrixXd H = GetHmatrix(Xmean);
-
-  MatrixXd R = GetRmatrix(H, DM, numAtoms);
-
-  getGETAWAYDesc(H, R, ADJ, numAtoms, std::move(Heavylist), mol, res,
-                 precision);
+  int numAtoms = context.getNumAtoms();
+  Map<const MatrixXd> ADJ(context.getAdjacencyMatrix().data(), numAtoms,
+                          numAtoms);
+  getGETAWAYDesc(context.getLeverageMatrix(),
+                 context.getInfluenceDistanceMatrix(), ADJ, numAtoms,
+                 GetHeavyList(context.getMol()), context, res, precision);
 }
 
 }  // end of anonymous namespace
 
-void GETAWAY(const ROMol& mol, std::vector<double>& res, int confId,
+void GETAWAY(const Descriptors3DContext& context, std::vector<double>& res,
              unsigned int precision, const std::string& customAtomPropName) {
-  PRECONDITION(mol.getNumConformers() >= 1, "molecule has no conformers")
-
-  int numAtoms = mol.getNumAtoms();
-
-  const Conformer& conf = mol.getConformer(confId);
-
-  std::vector<double> Vpoints(3 * numAtoms);
-
-  for (int i = 0; i < numAtoms; ++i) {
-    Vpoints[3 * i] = conf.getAtomPos(i).x;
-    Vpoints[3 * i + 1] = conf.getAtomPos(i).y;
-    Vpoints[3 * i + 2] = conf.getAtomPos(i).z;
-  }
-
-  std::vector<int> Heavylist = GetHeavyList(mol);
-  // should be the same as the List size upper!
-  // int nHeavyAt= mol.getNumHeavyAtoms();
-
-  double* dist3D = MolOps::get3DDistanceMat(mol, confId);
-
-  double* AdjMat = MolOps::getAdjacencyMatrix(
-      mol, false, 0, false,
-      nullptr);  // false to have only the 1,0 matrix unweighted
-
   if (!customAtomPropName.empty()) {
     res.clear();
     res.resize(45);
-    GetGETAWAYone(dist3D, AdjMat, Vpoints, mol, conf, Heavylist, res, precision,
-                  customAtomPropName);
+    GetGETAWAYone(context, res, precision, customAtomPropName);
   } else {
     res.clear();
     res.resize(273);
-
-    GetGETAWAY(dist3D, AdjMat, Vpoints, mol, conf, Heavylist, res, precision);
+    GetGETAWAY(context, res, precision);
   }
 }
 
+void GETAWAY(const ROMol& mol, std::vector<double>& res, int confId,
+             unsigned int precision, const std::string& customAtomPropName) {
+  PRECONDITION(mol.getNumConformers() >= 1, "molecule has no conformers")
+  GETAWAY(Descriptors3DContext(mol, confId), res, precision,
+          customAtomPropName);
+}
+
 }  // namespace Descriptors
 }  // namespace RDKit
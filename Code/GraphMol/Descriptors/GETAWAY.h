@@ -41,10 +41,15 @@
 namespace RDKit {
 class ROMol;
 namespace Descriptors {
+class Descriptors3DContext;
 const std::string GETAWAYVersion = "1.0.0";
 RDKIT_DESCRIPTORS_EXPORT void GETAWAY(
     const ROMol &, std::vector<double> &res, int confId = -1,
     unsigned int precision = 2, const std::string &customAtomPropName = "");
+//! \overload
+RDKIT_DESCRIPTORS_EXPORT void GETAWAY(
+    const Descriptors3DContext &context, std::vector<double> &res,
+    unsigned int precision = 2, const std::string &customAtomPropName = "");
 }  // namespace Descriptors
 }  // namespace RDKit
 #endif
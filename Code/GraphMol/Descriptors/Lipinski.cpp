@@ -11,6 +11,7 @@
 #include <GraphMol/RDKitBase.h>
 #include <GraphMol/MolPickler.h>
 #include <GraphMol/Descriptors/MolDescriptors.h>
+#include <GraphMol/Descriptors/SubstructCountEngine.h>
 #include <GraphMol/SmilesParse/SmilesParse.h>
 #include <GraphMol/Substruct/SubstructMatch.h>
 #include <RDGeneral/types.h>
@@ -33,22 +34,23 @@ class ss_matcher {
     RDKit::RWMol *p = RDKit::SmartsToMol(pattern);
     m_matcher = p;
     POSTCONDITION(m_matcher, "no matcher");
+    if (!m_needCopies) {
+      m_engine.addPattern(pattern);
+    }
   };
   const RDKit::ROMol *getMatcher() const { return m_matcher; };
   unsigned int countMatches(const RDKit::ROMol &mol) const {
     PRECONDITION(m_matcher, "no matcher");
-    std::vector<RDKit::MatchVectType> matches;
     // This is an ugly one. Recursive queries aren't thread safe.
     // Unfortunately we have to take a performance hit here in order
     // to guarantee thread safety
     if (m_needCopies) {
+      std::vector<RDKit::MatchVectType> matches;
       const RDKit::ROMol nm(*(m_matcher), true);
       RDKit::SubstructMatch(mol, nm, matches);
-    } else {
-      const RDKit::ROMol &nm = *m_matcher;
-      RDKit::SubstructMatch(mol, nm, matches);
+      return matches.size();
     }
-    return matches.size();
+    return m_engine.countMatches(mol, 0);
   }
   ~ss_matcher() { delete m_matcher; };
 
@@ -57,6 +59,7 @@ class ss_matcher {
   std::string m_pattern;
   bool m_needCopies{false};
   const RDKit::ROMol *m_matcher{nullptr};
+  RDKit::Descriptors::SubstructCountEngine m_engine;
 };
 }  // namespace
 
@@ -35,6 +35,7 @@
 
 #include "MORSE.h"
 #include "MolData3Ddescriptors.h"
+#include "Descriptors3DContext.h"
 
 #include <cmath>
 
@@ -47,126 +48,95 @@ namespace {
 
 MolData3Ddescriptors moldata3D;
 
-std::vector<double> getG(int n) {
-  std::vector<double> res(n);
-  for (int i = 0; i < n; i++) {
-    res[i] = i;
+const unsigned int numMORSESteps = 32;
+
+// the MORSE contribution of each pair of atoms at scattering step i
+void getMORSETerms(const std::vector<double> &pairDists, unsigned int i,
+                   std::vector<double> &terms) {
+  if (i == 0) {
+    std::fill(terms.begin(), terms.end(), 1.0);
+    return;
+  }
+  double R = i;
+  for (unsigned int p = 0; p < pairDists.size(); ++p) {
+    terms[p] = sin(R * pairDists[p]) / (R * pairDists[p]);
+  }
+}
+
+// sums the products of the pair terms with the pair weights
+double sumPairTerms(const std::vector<double> &terms,
+                    const std::vector<double> &weights) {
+  double res = 0.0;
+  for (unsigned int p = 0; p < terms.size(); ++p) {
+    res += weights[p] * terms[p];
   }
   return res;
 }
 
-std::vector<double> prepareIState(const ROMol &mol) {
-  std::vector<double> IState = moldata3D.GetIState(mol);
-  return IState;
+double sumPairTerms(const std::vector<double> &terms) {
+  double res = 0.0;
+  for (double term : terms) {
+    res += term;
+  }
+  return res;
 }
 
-void getMORSEDesc(const double *DM, const ROMol &mol, const Conformer &conf,
+void getMORSEDesc(const Descriptors3DContext &context,
                   std::vector<double> &res) {
-  int numAtoms = conf.getNumAtoms();
-
-  std::vector<double> R = getG(32);
-  std::vector<double> R1(224);
-  std::vector<double> R2(32);
-  std::vector<double> R3(32);
-  std::vector<double> R4(32);
-  std::vector<double> R5(32);
-  std::vector<double> R6(32);
-  std::vector<double> R7(32);
-
-  std::vector<double> Mass = moldata3D.GetRelativeMW(mol);
-  std::vector<double> RelativePol = moldata3D.GetRelativePol(mol);
-  std::vector<double> IonPol = moldata3D.GetRelativeIonPol(mol);
-  std::vector<double> RelativeElectroNeg = moldata3D.GetRelativeENeg(mol);
-  std::vector<double> RelativeVdW = moldata3D.GetRelativeVdW(mol);
-  std::vector<double> IState = prepareIState(mol);
-
-  double p;
-  for (size_t i = 0; i < R.size(); i++) {
-    double res1 = 0.0;
-    double res2 = 0.0;
-    double res3 = 0.0;
-    double res4 = 0.0;
-    double res5 = 0.0;
-    double res6 = 0.0;
-    double res7 = 0.0;
-
-    for (int j = 0; j < numAtoms - 1; j++) {
-      for (int k = j + 1; k < numAtoms; k++) {
-        if (i == 0) {
-          p = 1;
-        } else {
-          p = sin(R[i] * DM[j * numAtoms + k]) / (R[i] * DM[j * numAtoms + k]);
-        }
-        res1 += p;
-        res2 += Mass[j] * Mass[k] * p;
-        res3 += RelativeVdW[j] * RelativeVdW[k] * p;
-        res4 += RelativeElectroNeg[j] * RelativeElectroNeg[k] * p;
-        res5 += RelativePol[j] * RelativePol[k] * p;
-        res6 += IonPol[j] * IonPol[k] * p;
-        res7 += IState[j] * IState[k] * p;
-      }
+  // the "u" values are all 1 and are handled separately below
+  const AtomProperty3D props[] = {
+      AtomProperty3D::RelativeMW,     AtomProperty3D::RelativeVdW,
+      AtomProperty3D::RelativeENeg,   AtomProperty3D::RelativePol,
+      AtomProperty3D::RelativeIonPol, AtomProperty3D::IState};
+  const auto &pairDists = context.getPairDistances();
+  std::vector<double> terms(pairDists.size());
+  res.resize(7 * numMORSESteps);
+  for (unsigned int i = 0; i < numMORSESteps; i++) {
+    getMORSETerms(pairDists, i, terms);
+    res[i] = std::round(1000 * sumPairTerms(terms)) / 1000;  // "u"
+    // "m", "v", "e", "p", "i", "s"
+    for (unsigned int w = 0; w < 6; ++w) {
+      double val = sumPairTerms(terms, context.getPairProducts(props[w]));
+      res[(w + 1) * numMORSESteps + i] = std::round(1000 * val) / 1000;
     }
-    R1[i] = std::round(1000 * res1) / 1000;
-    R2[i] = std::round(1000 * res2) / 1000;
-    R3[i] = std::round(1000 * res3) / 1000;
-    R4[i] = std::round(1000 * res4) / 1000;
-    R5[i] = std::round(1000 * res5) / 1000;
-    R6[i] = std::round(1000 * res6) / 1000;
-    R7[i] = std::round(1000 * res7) / 1000;
   }
-
-  std::copy(R2.begin(), R2.end(), R1.begin() + 32);
-  std::copy(R3.begin(), R3.end(), R1.begin() + 64);
-  std::copy(R4.begin(), R4.end(), R1.begin() + 96);
-  std::copy(R5.begin(), R5.end(), R1.begin() + 128);
-  std::copy(R6.begin(), R6.end(), R1.begin() + 160);
-  std::copy(R7.begin(), R7.end(), R1.begin() + 192);
-
-  res = R1;
 }
 
-void getMORSEDescCustom(const double *DM, const ROMol &mol,
-                        const Conformer &conf, std::vector<double> &res,
+void getMORSEDescCustom(const Descriptors3DContext &context,
+                        std::vector<double> &res,
                         const std::string &customAtomPropName) {
-  int numAtoms = conf.getNumAtoms();
-
-  std::vector<double> R = getG(32);
-  std::vector<double> R1(32);
+  auto numAtoms = context.getNumAtoms();
   std::vector<double> customAtomArray =
-      moldata3D.GetCustomAtomProp(mol, customAtomPropName);
-
-  double p;
-  for (size_t i = 0; i < R.size(); i++) {
-    double res1 = 0.0;
-
-    for (int j = 0; j < numAtoms - 1; j++) {
-      for (int k = j + 1; k < numAtoms; k++) {
-        if (i == 0) {
-          p = 1;
-        } else {
-          p = sin(R[i] * DM[j * numAtoms + k]) / (R[i] * DM[j * numAtoms + k]);
-        }
-        res1 += customAtomArray[j] * customAtomArray[k] * p;  // "custom"
-      }
+      moldata3D.GetCustomAtomProp(context.getMol(), customAtomPropName);
+  std::vector<double> weights;
+  weights.reserve(context.getNumPairs());
+  for (unsigned int j = 0; j + 1 < numAtoms; j++) {
+    for (unsigned int k = j + 1; k < numAtoms; k++) {
+      weights.push_back(customAtomArray[j] * customAtomArray[k]);
     }
-    R1[i] = std::round(1000 * res1) / 1000;
   }
-  res = R1;
-}
-
-void GetMORSE(double *dist3D, const ROMol &mol, const Conformer &conf,
-              std::vector<double> &res) {
-  getMORSEDesc(dist3D, mol, conf, res);
-}
 
-void GetMORSEone(double *dist3D, const ROMol &mol, const Conformer &conf,
-                 std::vector<double> &res,
-                 const std::string &customAtomPropName) {
-  getMORSEDescCustom(dist3D, mol, conf, res, customAtomPropName);
+  const auto &pairDists = context.getPairDistances();
+  std::vector<double> terms(pairDists.size());
+  res.resize(numMORSESteps);
+  for (unsigned int i = 0; i < numMORSESteps; i++) {
+    getMORSETerms(pairDists, i, terms);
+    res[i] = std::round(1000 * sumPairTerms(terms, weights)) / 1000;
+  }
 }
 
 }  // end of anonymous namespace
 
+void MORSE(const Descriptors3DContext &context, std::vector<double> &res,
+           const std::string &customAtomPropName) {
+  res.clear();
+  if (!customAtomPropName.empty()) {
+    getMORSEDescCustom(context, res, customAtomPropName);
+  } else {
+    getMORSEDesc(context, res);
+  }
+}
+
 void MORSE(const ROMol &mol, std::vector<double> &res, int confId,
            const std::string &customAtomPropName) {
   PRECONDITION(mol.getNumConformers() >= 1, "molecule has no conformers")
@@ -200,20 +170,7 @@ void MORSE(const ROMol &mol, std::vector<double> &res, int confId,
   // Mor19s  Mor20s  Mor21s  Mor22s  Mor23s  Mor24s  Mor25s  Mor26s  Mor27s
   // Mor28s  Mor29s  Mor30s  Mor31s  Mor32s
 
-  const Conformer &conf = mol.getConformer(confId);
-
-  double *dist3D =
-      MolOps::get3DDistanceMat(mol, confId, false, true);  // 3D distance matrix
-  if (!customAtomPropName.empty()) {
-    res.clear();
-    res.resize(32);  // 7 * 32
-    GetMORSEone(dist3D, mol, conf, res, customAtomPropName);
-
-  } else {
-    res.clear();
-    res.resize(224);  // 7 * 32
-    GetMORSE(dist3D, mol, conf, res);
-  }
+  MORSE(Descriptors3DContext(mol, confId), res, customAtomPropName);
 }
 
 }  // namespace Descriptors
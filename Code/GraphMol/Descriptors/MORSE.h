@@ -39,10 +39,15 @@
 namespace RDKit {
 class ROMol;
 namespace Descriptors {
+class Descriptors3DContext;
 const std::string MORSEVersion = "1.0.0";
 RDKIT_DESCRIPTORS_EXPORT void MORSE(const ROMol &, std::vector<double> &res,
                                     int confId = -1,
                                     const std::string &customAtomPropName = "");
+//! \overload
+RDKIT_DESCRIPTORS_EXPORT void MORSE(const Descriptors3DContext &context,
+                                    std::vector<double> &res,
+                                    const std::string &customAtomPropName = "");
 
 }  // namespace Descriptors
 }  // namespace RDKit
@@ -19,6 +19,12 @@ namespace RDKit {
 namespace Descriptors {
 std::vector<unsigned int> calcMQNs(const ROMol& mol, bool) {
   // FIX: use force value to enable caching
+  return detail::calcMQNs(mol, calcNumRotatableBonds(mol));
+}
+
+namespace detail {
+std::vector<unsigned int> calcMQNs(const ROMol& mol,
+                                   unsigned int numRotatableBonds) {
   std::vector<unsigned int> res(42, 0);
 
   // ---------------------------------------------------
@@ -185,7 +191,7 @@ std::vector<unsigned int> calcMQNs(const ROMol& mol, bool) {
   if (nAromatic % 2) {
     res[15]++;
   }
-  res[18] = calcNumRotatableBonds(mol);
+  res[18] = numRotatableBonds;
 
   // ---------------------------------------------------
   //  ring size counts
@@ -199,5 +205,6 @@ std::vector<unsigned int> calcMQNs(const ROMol& mol, bool) {
 
   return res;
 }
+}  // namespace detail
 }  // end of namespace Descriptors
 }  // end of namespace RDKit
@@ -41,6 +41,13 @@ const std::string MQNVersion = "1.0.0";
 RDKIT_DESCRIPTORS_EXPORT std::vector<unsigned int> calcMQNs(const ROMol &mol,
                                                             bool force = false);
 
+namespace detail {
+//! calculates the MQN descriptors using a precomputed number of rotatable
+//! bonds (as returned by calcNumRotatableBonds() with the default options)
+RDKIT_DESCRIPTORS_EXPORT std::vector<unsigned int> calcMQNs(
+    const ROMol &mol, unsigned int numRotatableBonds);
+}  // namespace detail
+
 }  // end of namespace Descriptors
 }  // end of namespace RDKit
 
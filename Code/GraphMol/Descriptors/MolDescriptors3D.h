@@ -21,5 +21,6 @@
 #include <GraphMol/Descriptors/GETAWAY.h>
 #include <GraphMol/Descriptors/AUTOCORR3D.h>
 #include <GraphMol/Descriptors/PMI.h>
+#include <GraphMol/Descriptors/Descriptors3DContext.h>
 
 #endif
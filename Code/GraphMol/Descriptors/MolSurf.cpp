@@ -430,6 +430,16 @@ std::vector<double> calcSMR_VSA(const ROMol &mol, std::vector<double> *bins,
 
 std::vector<double> calcPEOE_VSA(const ROMol &mol, std::vector<double> *bins,
                                  bool force) {
+  std::vector<double> chgs(mol.getNumAtoms(), 0.0);
+  computeGasteigerCharges(mol, chgs);
+  return detail::calcPEOE_VSA(mol, chgs, bins, force);
+}
+
+namespace detail {
+std::vector<double> calcPEOE_VSA(const ROMol &mol,
+                                 const std::vector<double> &charges,
+                                 std::vector<double> *bins, bool force) {
+  PRECONDITION(charges.size() == mol.getNumAtoms(), "bad charges vector");
   std::vector<double> lbins;
   if (!bins) {
     double blist[13] = {-.3, -.25, -.20, -.15, -.10, -.05, 0,
@@ -445,13 +455,11 @@ std::vector<double> calcPEOE_VSA(const ROMol &mol, std::vector<double> *bins,
   std::vector<double> vsaContribs(mol.getNumAtoms());
   double tmp;
   getLabuteAtomContribs(mol, vsaContribs, tmp, true, force);
-
-  std::vector<double> chgs(mol.getNumAtoms(), 0.0);
-  computeGasteigerCharges(mol, chgs);
-  assignContribsToBins(vsaContribs, chgs, lbins, res);
+  assignContribsToBins(vsaContribs, charges, lbins, res);
 
   return res;
 }
+}  // namespace detail
 
 std::vector<double> calcCustomProp_VSA(const ROMol &mol,
                                        const std::string &customPropName,
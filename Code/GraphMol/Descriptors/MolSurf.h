@@ -114,6 +114,13 @@ RDKIT_DESCRIPTORS_EXPORT std::vector<double> calcCustomProp_VSA(
     const ROMol &mol, const std::string &customPropName,
     const std::vector<double> &bins, bool force = false);
 
+namespace detail {
+//! calculates the PEOE_VSA descriptors using precomputed Gasteiger charges
+RDKIT_DESCRIPTORS_EXPORT std::vector<double> calcPEOE_VSA(
+    const ROMol &mol, const std::vector<double> &charges,
+    std::vector<double> *bins = nullptr, bool force = false);
+}  // namespace detail
+
 }  // end of namespace Descriptors
 }  // end of namespace RDKit
 
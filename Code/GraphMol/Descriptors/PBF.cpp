@@ -96,7 +96,7 @@ bool getBestFitPlane(const Conformer &conf,
   Eigen::Matrix3d evects;
   Eigen::Vector3d evals;
   MolTransforms::computePrincipalAxesAndMomentsFromGyrationMatrix(
-      conf, evects, evals, false, weights);
+      conf, evects, evals, false, true, weights);
   RDGeom::Point3D normal;
   normal.x = evects(0, 0);
   normal.y = evects(1, 0);
@@ -130,7 +130,10 @@ double PBF(const ROMol &mol, int confId) {
   }
 
   std::vector<double> plane(4);
-  if (!getBestFitPlane(conf, points, plane, nullptr)) {
+  // with explicit weights nothing is cached on the molecule, so this can be
+  // called for different conformers of a molecule at the same time
+  std::vector<double> weights(numAtoms, 1.0);
+  if (!getBestFitPlane(conf, points, plane, &weights)) {
     // the eigenvalue calculation failed, return 0
     // FIX: throw an exception here?
     return 0.0;
@@ -12,6 +12,7 @@
 #include <Geometry/point.h>
 
 #include "PMI.h"
+#include "Descriptors3DContext.h"
 
 #include <Eigen/Dense>
 
@@ -106,6 +107,51 @@ bool getMomentsFromGyration(const ROMol& mol, int confId, bool useAtomicMasses,
   return res;
 }
 
+double nprFromMoments(double pm, double pm3) {
+  if (pm3 < 1e-8) {
+    return 0.0;
+  }
+  return pm / pm3;
+}
+double radiusOfGyrationFromMoments(double pm1, double pm2, double pm3) {
+  return sqrt(pm1 + pm2 + pm3);
+}
+double inertialShapeFactorFromMoments(double pm1, double pm2, double pm3) {
+  if (pm1 < 1e-4 || pm3 < 1e-4) {
+    // planar or no coordinates
+    return 0.0;
+  } else {
+    return pm2 / (pm1 * pm3);
+  }
+}
+double eccentricityFromMoments(double pm1, double pm3) {
+  if (pm3 < 1e-4 || (pm3 * pm3 - pm1 * pm1) < 1e-4) {
+    // no coordinates or very close to degeneracy
+    return 0.0;
+  } else {
+    return sqrt(pm3 * pm3 - pm1 * pm1) / pm3;
+  }
+}
+double asphericityFromMoments(double pm1, double pm2, double pm3) {
+  if (pm3 < 1e-4) {
+    // no coordinates
+    return 0.0;
+  } else {
+    double denom = pm1 + pm2 + pm3;
+
+    return 0.5 * (pow(pm1 - pm2, 2) + pow(pm1 - pm3, 2) + pow(pm2 - pm3, 2)) /
+           (denom * denom);
+  }
+}
+double spherocityIndexFromMoments(double pm1, double pm2, double pm3) {
+  if (pm3 < 1e-4) {
+    // no coordinates
+    return 0.0;
+  } else {
+    return 3. * pm1 / (pm1 + pm2 + pm3);
+  }
+}
+
 }  // end of anonymous namespace
 
 double NPR1(const ROMol& mol, int confId, bool useAtomicMasses, bool force) {
@@ -115,10 +161,7 @@ double NPR1(const ROMol& mol, int confId, bool useAtomicMasses, bool force) {
     // the eigenvector calculation failed
     return 0.0;  // FIX: throw an exception here?
   }
-  if (pm3 < 1e-8) {
-    return 0.0;
-  }
-  return pm1 / pm3;
+  return nprFromMoments(pm1, pm3);
 }
 double NPR2(const ROMol& mol, int confId, bool useAtomicMasses, bool force) {
   PRECONDITION(mol.getNumConformers() >= 1, "molecule has no conformers");
@@ -127,10 +170,7 @@ double NPR2(const ROMol& mol, int confId, bool useAtomicMasses, bool force) {
     // the eigenvector calculation failed
     return 0.0;  // FIX: throw an exception here?
   }
-  if (pm3 < 1e-8) {
-    return 0.0;
-  }
-  return pm2 / pm3;
+  return nprFromMoments(pm2, pm3);
 }
 double PMI1(const ROMol& mol, int confId, bool useAtomicMasses, bool force) {
   PRECONDITION(mol.getNumConformers() >= 1, "molecule has no conformers");
@@ -169,7 +209,7 @@ double radiusOfGyration(const ROMol& mol, int confId, bool useAtomicMasses,
     // the eigenvector calculation failed
     return 0.0;  // FIX: throw an exception here?
   }
-  return sqrt(pm1 + pm2 + pm3);
+  return radiusOfGyrationFromMoments(pm1, pm2, pm3);
 }
 
 double inertialShapeFactor(const ROMol& mol, int confId, bool useAtomicMasses,
@@ -180,12 +220,7 @@ double inertialShapeFactor(const ROMol& mol, int confId, bool useAtomicMasses,
     // the eigenvector calculation failed
     return 0.0;  // FIX: throw an exception here?
   }
-  if (pm1 < 1e-4 || pm3 < 1e-4) {
-    // planar or no coordinates
-    return 0.0;
-  } else {
-    return pm2 / (pm1 * pm3);
-  }
+  return inertialShapeFactorFromMoments(pm1, pm2, pm3);
 }
 double eccentricity(const ROMol& mol, int confId, bool useAtomicMasses,
                     bool force) {
@@ -195,12 +230,7 @@ double eccentricity(const ROMol& mol, int confId, bool useAtomicMasses,
     // the eigenvector calculation failed
     return 0.0;  // FIX: throw an exception here?
   }
-  if (pm3 < 1e-4 || (pm3 * pm3 - pm1 * pm1) < 1e-4) {
-    // no coordinates or very close to degeneracy
-    return 0.0;
-  } else {
-    return sqrt(pm3 * pm3 - pm1 * pm1) / pm3;
-  }
+  return eccentricityFromMoments(pm1, pm3);
 }
 
 double asphericity(const ROMol& mol, int confId, bool useAtomicMasses,
@@ -212,15 +242,7 @@ double asphericity(const ROMol& mol, int confId, bool useAtomicMasses,
     // the eigenvector calculation failed
     return 0.0;  // FIX: throw an exception here?
   }
-  if (pm3 < 1e-4) {
-    // no coordinates
-    return 0.0;
-  } else {
-    double denom = pm1 + pm2 + pm3;
-
-    return 0.5 * (pow(pm1 - pm2, 2) + pow(pm1 - pm3, 2) + pow(pm2 - pm3, 2)) /
-           (denom * denom);
-  }
+  return asphericityFromMoments(pm1, pm2, pm3);
 }
 double spherocityIndex(const ROMol& mol, int confId, bool force) {
   PRECONDITION(mol.getNumConformers() >= 1, "molecule has no conformers");
@@ -231,11 +253,50 @@ double spherocityIndex(const ROMol& mol, int confId, bool force) {
     // the eigenvector calculation failed
     return 0.0;  // FIX: throw an exception here?
   }
-  if (pm3 < 1e-4) {
-    // no coordinates
-    return 0.0;
-  } else {
-    return 3. * pm1 / (pm1 + pm2 + pm3);
+  return spherocityIndexFromMoments(pm1, pm2, pm3);
+}
+
+void calcPMIDescriptors(const Descriptors3DContext& context,
+                        std::vector<double>& res) {
+  const auto& mol = context.getMol();
+  const auto& conf = context.getConformer();
+  std::vector<double> masses(mol.getNumAtoms());
+  for (const auto atom : mol.atoms()) {
+    masses[atom->getIdx()] = atom->getMass();
+  }
+  // explicit unit weights keep the unweighted moments from being cached
+  std::vector<double> unitWeights(mol.getNumAtoms(), 1.0);
+  const bool ignoreHs = false;
+  const bool force = true;
+
+  res.clear();
+  res.resize(10, 0.0);
+  Eigen::Matrix3d axes;
+  Eigen::Vector3d moments;
+  if (MolTransforms::computePrincipalAxesAndMoments(conf, axes, moments,
+                                                    ignoreHs, force, &masses)) {
+    double pm1 = moments(0);
+    double pm2 = moments(1);
+    double pm3 = moments(2);
+    res[0] = nprFromMoments(pm1, pm3);
+    res[1] = nprFromMoments(pm2, pm3);
+    res[2] = pm1;
+    res[3] = pm2;
+    res[4] = pm3;
+    res[6] = inertialShapeFactorFromMoments(pm1, pm2, pm3);
+    res[7] = eccentricityFromMoments(pm1, pm3);
+  }
+  if (MolTransforms::computePrincipalAxesAndMomentsFromGyrationMatrix(
+          conf, axes, moments, ignoreHs, force, &masses)) {
+    double pm1 = moments(0);
+    double pm2 = moments(1);
+    double pm3 = moments(2);
+    res[5] = radiusOfGyrationFromMoments(pm1, pm2, pm3);
+    res[8] = asphericityFromMoments(pm1, pm2, pm3);
+  }
+  if (MolTransforms::computePrincipalAxesAndMomentsFromGyrationMatrix(
+          conf, axes, moments, ignoreHs, force, &unitWeights)) {
+    res[9] = spherocityIndexFromMoments(moments(0), moments(1), moments(2));
   }
 }
 
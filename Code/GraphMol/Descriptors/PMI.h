@@ -122,6 +122,19 @@ const std::string asphericityVersion = "1.0.0";
 RDKIT_DESCRIPTORS_EXPORT double spherocityIndex(const ROMol&, int confId = -1,
                                                 bool force = false);
 const std::string spherocityIndexVersion = "1.0.0";
+
+class Descriptors3DContext;
+//! calculates all of the descriptors above for a conformer
+/*!
+  The values are, in order: NPR1, NPR2, PMI1, PMI2, PMI3, radiusOfGyration,
+  inertialShapeFactor, eccentricity, asphericity and spherocityIndex. All
+  but the last use atomic masses.
+
+  The moments are always recalculated and nothing is cached on the
+  molecule.
+*/
+RDKIT_DESCRIPTORS_EXPORT void calcPMIDescriptors(
+    const Descriptors3DContext &context, std::vector<double> &res);
 }  // namespace Descriptors
 }  // namespace RDKit
 #endif
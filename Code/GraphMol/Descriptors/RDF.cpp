@@ -35,6 +35,7 @@
 
 #include "RDF.h"
 #include "MolData3Ddescriptors.h"
+#include "Descriptors3DContext.h"
 
 #include <cmath>
 
@@ -43,121 +44,99 @@ namespace Descriptors {
 namespace {
 MolData3Ddescriptors moldata3D;
 
-std::vector<double> getG(int n) {
-  std::vector<double> res(n);
-  for (int i = 0; i < n; i++) {
-    res[i] = 1 + i * 0.5;
+const unsigned int numRDFSteps = 30;
+
+double getRDFRadius(unsigned int step) { return 1 + step * 0.5; }
+
+// the RDF contribution of each pair of atoms at radius R.
+// exp() underflows to zero for pairs which are far enough from R, so those
+// don't need to be evaluated.
+void getRDFTerms(const std::vector<double>& pairDists, double R,
+                 std::vector<double>& terms) {
+  for (unsigned int p = 0; p < pairDists.size(); ++p) {
+    double delta = R - pairDists[p];
+    if (delta * delta > 7.5) {
+      terms[p] = 0.0;
+    } else {
+      terms[p] = exp(-100 * pow(delta, 2));
+    }
+  }
+}
+
+// sums the products of the pair terms with the pair weights
+double sumPairTerms(const std::vector<double>& terms,
+                    const std::vector<double>& weights) {
+  double res = 0.0;
+  for (unsigned int p = 0; p < terms.size(); ++p) {
+    res += weights[p] * terms[p];
   }
   return res;
 }
 
-std::vector<double> prepareIState(const ROMol& mol) {
-  std::vector<double> IState = moldata3D.GetIStateDrag(
-      mol);  // get the real IState value not the EState!
-  return IState;
+double sumPairTerms(const std::vector<double>& terms) {
+  double res = 0.0;
+  for (double term : terms) {
+    res += term;
+  }
+  return res;
 }
 
-void getRDFDesc(double* DM, const ROMol& mol, const Conformer& conf,
+void getRDFDesc(const Descriptors3DContext& context,
                 std::vector<double>& res) {
-  // std::vector<double> reserror(210, 0); need to avoid the res NaNs
-  // if (numAtoms < 4) return reserror;
-  // if (!conf.is3D()) return reserror;
-
-  int numAtoms = conf.getNumAtoms();
-
-  std::vector<double> R = getG(30);
-  std::vector<double> R1(210);
-  std::vector<double> R2(30);
-  std::vector<double> R3(30);
-  std::vector<double> R4(30);
-  std::vector<double> R5(30);
-  std::vector<double> R6(30);
-  std::vector<double> R7(30);
-
-  std::vector<double> Mass = moldata3D.GetRelativeMW(mol);
-  std::vector<double> RelativePol = moldata3D.GetRelativePol(mol);
-  std::vector<double> IonPol = moldata3D.GetRelativeIonPol(mol);
-  std::vector<double> RelativeElectroNeg = moldata3D.GetRelativeENeg(mol);
-  std::vector<double> RelativeVdW = moldata3D.GetRelativeVdW(mol);
-  std::vector<double> IState = prepareIState(mol);
-
-  double p;
-  for (size_t i = 0; i < R.size(); i++) {
-    double res1 = 0.0;
-    double res2 = 0.0;
-    double res3 = 0.0;
-    double res4 = 0.0;
-    double res5 = 0.0;
-    double res6 = 0.0;
-    double res7 = 0.0;
-
-    for (int j = 0; j < numAtoms - 1; j++) {
-      for (int k = j + 1; k < numAtoms; k++) {
-        p = exp(-100 * pow(R[i] - DM[j * numAtoms + k], 2));
-        res1 += p;                                                  // "u"
-        res2 += Mass[j] * Mass[k] * p;                              // "m"
-        res3 += RelativeVdW[j] * RelativeVdW[k] * p;                // "v"
-        res4 += RelativeElectroNeg[j] * RelativeElectroNeg[k] * p;  //"e"
-        res5 += RelativePol[j] * RelativePol[k] * p;                // "p"
-        res6 += IonPol[j] * IonPol[k] * p;                          // "i"
-        res7 += IState[j] * IState[k] * p;                          // "s"
-      }
+  // the "u" values are all 1 and are handled separately below
+  const AtomProperty3D props[] = {
+      AtomProperty3D::RelativeMW,     AtomProperty3D::RelativeVdW,
+      AtomProperty3D::RelativeENeg,   AtomProperty3D::RelativePol,
+      AtomProperty3D::RelativeIonPol, AtomProperty3D::IStateDrag};
+  const auto& pairDists = context.getPairDistances();
+  std::vector<double> terms(pairDists.size());
+  res.resize(7 * numRDFSteps);
+  for (unsigned int i = 0; i < numRDFSteps; i++) {
+    getRDFTerms(pairDists, getRDFRadius(i), terms);
+    res[i] = std::round(1000 * sumPairTerms(terms)) / 1000;  // "u"
+    // "m", "v", "e", "p", "i", "s"
+    for (unsigned int w = 0; w < 6; ++w) {
+      double val = sumPairTerms(terms, context.getPairProducts(props[w]));
+      res[(w + 1) * numRDFSteps + i] = std::round(1000 * val) / 1000;
     }
-    R1[i] = std::round(1000 * res1) / 1000;
-    R2[i] = std::round(1000 * res2) / 1000;
-    R3[i] = std::round(1000 * res3) / 1000;
-    R4[i] = std::round(1000 * res4) / 1000;
-    R5[i] = std::round(1000 * res5) / 1000;
-    R6[i] = std::round(1000 * res6) / 1000;
-    R7[i] = std::round(1000 * res7) / 1000;
   }
-
-  std::copy(R2.begin(), R2.end(), R1.begin() + 30);
-  std::copy(R3.begin(), R3.end(), R1.begin() + 60);
-  std::copy(R4.begin(), R4.end(), R1.begin() + 90);
-  std::copy(R5.begin(), R5.end(), R1.begin() + 120);
-  std::copy(R6.begin(), R6.end(), R1.begin() + 150);
-  std::copy(R7.begin(), R7.end(), R1.begin() + 180);
-
-  res = R1;
 }
 
-void getRDFDescCustom(double* DM, const ROMol& mol, const Conformer& conf,
+void getRDFDescCustom(const Descriptors3DContext& context,
                       std::vector<double>& res,
                       const std::string& customAtomPropName) {
-  int numAtoms = conf.getNumAtoms();
-
-  std::vector<double> R = getG(30);
-  std::vector<double> R1(30);
+  auto numAtoms = context.getNumAtoms();
   std::vector<double> customAtomArray =
-      moldata3D.GetCustomAtomProp(mol, customAtomPropName);
-
-  double p;
-  for (size_t i = 0; i < R.size(); i++) {
-    double res = 0.0;
-    for (int j = 0; j < numAtoms - 1; j++) {
-      for (int k = j + 1; k < numAtoms; k++) {
-        p = exp(-100 * pow(R[i] - DM[j * numAtoms + k], 2));
-        res += customAtomArray[j] * customAtomArray[k] * p;  // "custom"
-      }
+      moldata3D.GetCustomAtomProp(context.getMol(), customAtomPropName);
+  std::vector<double> weights;
+  weights.reserve(context.getNumPairs());
+  for (unsigned int j = 0; j + 1 < numAtoms; j++) {
+    for (unsigned int k = j + 1; k < numAtoms; k++) {
+      weights.push_back(customAtomArray[j] * customAtomArray[k]);
     }
-    R1[i] = std::round(1000 * res) / 1000;
   }
-  res = R1;
-}
 
-void GetRDF(double* dist3D, const ROMol& mol, const Conformer& conf,
-            std::vector<double>& res) {
-  getRDFDesc(dist3D, mol, conf, res);
-}
-
-void GetRDFone(double* dist3D, const ROMol& mol, const Conformer& conf,
-               std::vector<double>& res, const std::string customAtomPropName) {
-  getRDFDescCustom(dist3D, mol, conf, res, customAtomPropName);
+  const auto& pairDists = context.getPairDistances();
+  std::vector<double> terms(pairDists.size());
+  res.resize(numRDFSteps);
+  for (unsigned int i = 0; i < numRDFSteps; i++) {
+    getRDFTerms(pairDists, getRDFRadius(i), terms);
+    res[i] = std::round(1000 * sumPairTerms(terms, weights)) / 1000;
+  }
 }
 
 }  // end of anonymous namespace
 
+void RDF(const Descriptors3DContext& context, std::vector<double>& res,
+         const std::string& customAtomPropName) {
+  res.clear();
+  if (customAtomPropName != "") {
+    getRDFDescCustom(context, res, customAtomPropName);
+  } else {
+    getRDFDesc(context, res);
+  }
+}
+
 void RDF(const ROMol& mol, std::vector<double>& res, int confId,
          const std::string& customAtomPropName) {
   // RDF010u RDF015u RDF020u RDF025u RDF030u RDF035u RDF040u RDF045u RDF050u
@@ -190,26 +169,7 @@ void RDF(const ROMol& mol, std::vector<double>& res, int confId,
   // RDF145s RDF150s RDF155s
 
   PRECONDITION(mol.getNumConformers() >= 1, "molecule has no conformers")
-  // int numAtoms = mol.getNumAtoms();
-  // if (numAtoms < 4) return reserror;
-
-  const Conformer& conf = mol.getConformer(confId);
-  // if (!conf.is3D()) return reserror;
-
-  double* dist3D =
-      MolOps::get3DDistanceMat(mol, confId, false, true);  // 3D distance matrix
-
-  if (customAtomPropName != "") {
-    // std::cout << " Using CustomAtomPropertie\n";
-    // do something
-    res.clear();
-    res.resize(30);  // 7 * 30
-    GetRDFone(dist3D, mol, conf, res, customAtomPropName);
-  } else {
-    res.clear();
-    res.resize(210);  // 7 * 30
-    GetRDF(dist3D, mol, conf, res);
-  }
+  RDF(Descriptors3DContext(mol, confId), res, customAtomPropName);
 }
 }  // namespace Descriptors
 }  // namespace RDKit
@@ -41,10 +41,15 @@
 namespace RDKit {
 class ROMol;
 namespace Descriptors {
+class Descriptors3DContext;
 const std::string RDFVersion = "1.0.0";
 RDKIT_DESCRIPTORS_EXPORT void RDF(const ROMol &, std::vector<double> &res,
                                   int confId = -1,
                                   const std::string &customAtomPropName = "");
+//! \overload
+RDKIT_DESCRIPTORS_EXPORT void RDF(const Descriptors3DContext &context,
+                                  std::vector<double> &res,
+                                  const std::string &customAtomPropName = "");
 
 }  // namespace Descriptors
 }  // namespace RDKit
@@ -0,0 +1,359 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "SubstructCountEngine.h"
+#include <GraphMol/RDKitBase.h>
+#include <GraphMol/QueryAtom.h>
+#include <GraphMol/QueryBond.h>
+#include <GraphMol/SmilesParse/SmilesParse.h>
+#include <GraphMol/SmilesParse/SmartsWrite.h>
+#include <GraphMol/Substruct/SubstructMatch.h>
+
+#include <boost/dynamic_bitset.hpp>
+#include <deque>
+#include <limits>
+#include <set>
+
+namespace RDKit {
+namespace Descriptors {
+
+struct SubstructCountEngine::CompiledPattern {
+  std::shared_ptr<const ROMol> pattern;
+  // patterns which need SubstructMatch() don't have the other fields set
+  bool useSubstructMatch = false;
+  // the query atoms in the order they are matched, the first atom of the
+  // pattern is always first
+  std::vector<unsigned int> order;
+  // index of the atom query for each position in order
+  std::vector<unsigned int> atomQueries;
+  // position of the atom each atom is reached from, -1 for the first atom
+  // of each fragment
+  std::vector<int> parents;
+  std::vector<const Bond *> parentBonds;
+  // the other bonds to atoms earlier in the order
+  std::vector<std::vector<std::pair<unsigned int, const Bond *>>> closures;
+};
+
+namespace {
+const unsigned int maxMatches = SubstructMatchParameters().maxMatches;
+
+bool hasRecursiveQuery(const QueryAtom::QUERYATOM_QUERY *query) {
+  if (query->getDescription() == "RecursiveStructure") {
+    return true;
+  }
+  for (auto child = query->beginChildren(); child != query->endChildren();
+       ++child) {
+    if (hasRecursiveQuery(child->get())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool needsSubstructMatch(const ROMol &pattern) {
+  for (const auto atom : pattern.atoms()) {
+    if (!atom->hasQuery() || hasRecursiveQuery(atom->getQuery())) {
+      return true;
+    }
+  }
+  for (const auto bond : pattern.bonds()) {
+    // dative bonds need a check of the direction
+    if (!bond->hasQuery() || bond->getBondType() == Bond::DATIVE) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// the atom matches for one molecule, each atom query is evaluated the first
+// time it's needed
+class AtomMatchCache {
+ public:
+  AtomMatchCache(const ROMol &mol, const std::vector<const Atom *> &queries)
+      : d_mol(mol),
+        d_queries(queries),
+        d_matches(queries.size()),
+        d_done(queries.size(), false) {}
+
+  const boost::dynamic_bitset<> &getMatches(unsigned int queryIdx) {
+    if (!d_done[queryIdx]) {
+      auto &bits = d_matches[queryIdx];
+      bits.resize(d_mol.getNumAtoms());
+      const auto query = d_queries[queryIdx];
+      for (const auto atom : d_mol.atoms()) {
+        if (query->Match(atom)) {
+          bits.set(atom->getIdx());
+        }
+      }
+      d_done[queryIdx] = true;
+    }
+    return d_matches[queryIdx];
+  }
+  const ROMol &getMol() const { return d_mol; }
+
+ private:
+  const ROMol &d_mol;
+  const std::vector<const Atom *> &d_queries;
+  std::vector<boost::dynamic_bitset<>> d_matches;
+  std::vector<bool> d_done;
+};
+
+// finds the matches of a pattern, calling onMatch with the mapping (indexed
+// by position in the pattern's order) for each one. The search stops if
+// onMatch returns true, in which case this returns true.
+template <typename T>
+bool searchMatches(const SubstructCountEngine::CompiledPattern &cp,
+                   AtomMatchCache &cache, unsigned int pos,
+                   std::vector<unsigned int> &mapping,
+                   boost::dynamic_bitset<> &used, T &onMatch) {
+  if (pos == cp.order.size()) {
+    return onMatch(mapping);
+  }
+  const auto &mol = cache.getMol();
+  const auto &candidates = cache.getMatches(cp.atomQueries[pos]);
+  auto tryAtom = [&](unsigned int aidx) {
+    if (used[aidx] || !candidates[aidx]) {
+      return false;
+    }
+    for (const auto &closure : cp.closures[pos]) {
+      const auto bond = mol.getBondBetweenAtoms(aidx, mapping[closure.first]);
+      if (!bond || !closure.second->Match(bond)) {
+        return false;
+      }
+    }
+    mapping[pos] = aidx;
+    used.set(aidx);
+    auto stop = searchMatches(cp, cache, pos + 1, mapping, used, onMatch);
+    used.reset(aidx);
+    return stop;
+  };
+
+  if (cp.parents[pos] >= 0) {
+    const auto parentBond = cp.parentBonds[pos];
+    const auto parentAtom = mol.getAtomWithIdx(mapping[cp.parents[pos]]);
+    for (const auto bond : mol.atomBonds(parentAtom)) {
+      if (parentBond->Match(bond) &&
+          tryAtom(bond->getOtherAtomIdx(parentAtom->getIdx()))) {
+        return true;
+      }
+    }
+  } else if (pos == 0 && mapping[0] < mol.getNumAtoms()) {
+    // the search is anchored at a particular atom
+    return tryAtom(mapping[0]);
+  } else {
+    for (auto aidx = candidates.find_first();
+         aidx != boost::dynamic_bitset<>::npos;
+         aidx = candidates.find_next(aidx)) {
+      if (tryAtom(aidx)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool canMatch(const SubstructCountEngine::CompiledPattern &cp,
+              AtomMatchCache &cache) {
+  for (auto queryIdx : cp.atomQueries) {
+    if (cache.getMatches(queryIdx).none()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+unsigned int countPatternMatches(
+    const SubstructCountEngine::CompiledPattern &cp, AtomMatchCache &cache) {
+  const auto &mol = cache.getMol();
+  if (!mol.getNumAtoms() || !cp.pattern->getNumAtoms()) {
+    return 0;
+  }
+  if (cp.useSubstructMatch) {
+    std::vector<MatchVectType> matches;
+    return SubstructMatch(mol, *cp.pattern, matches);
+  }
+  if (!canMatch(cp, cache)) {
+    return 0;
+  }
+  if (cp.order.size() == 1) {
+    return std::min(
+        static_cast<unsigned int>(cache.getMatches(cp.atomQueries[0]).count()),
+        maxMatches);
+  }
+  // the matches are uniquified by the set of atoms they cover
+  std::set<std::vector<unsigned int>> seen;
+  auto onMatch = [&seen](const std::vector<unsigned int> &mapping) {
+    std::vector<unsigned int> atoms(mapping);
+    std::sort(atoms.begin(), atoms.end());
+    seen.insert(std::move(atoms));
+    return seen.size() >= maxMatches;
+  };
+  std::vector<unsigned int> mapping(cp.order.size(), mol.getNumAtoms());
+  boost::dynamic_bitset<> used(mol.getNumAtoms());
+  searchMatches(cp, cache, 0, mapping, used, onMatch);
+  return static_cast<unsigned int>(seen.size());
+}
+}  // namespace
+
+SubstructCountEngine::SubstructCountEngine() = default;
+
+SubstructCountEngine::SubstructCountEngine(
+    const std::vector<std::string> &smarts) {
+  for (const auto &sma : smarts) {
+    addPattern(sma);
+  }
+}
+
+SubstructCountEngine::~SubstructCountEngine() = default;
+
+unsigned int SubstructCountEngine::addPattern(const std::string &smarts) {
+  std::shared_ptr<const ROMol> pattern(SmartsToMol(smarts));
+  if (!pattern) {
+    throw ValueErrorException("could not parse SMARTS: " + smarts);
+  }
+  return addPattern(pattern);
+}
+
+unsigned int SubstructCountEngine::addPattern(
+    const std::shared_ptr<const ROMol> &pattern) {
+  PRECONDITION(pattern, "bad pattern");
+  auto cp = std::make_shared<CompiledPattern>();
+  cp->pattern = pattern;
+  cp->useSubstructMatch = needsSubstructMatch(*pattern);
+  if (!cp->useSubstructMatch) {
+    auto nAtoms = pattern->getNumAtoms();
+    std::vector<int> positions(nAtoms, -1);
+    std::deque<unsigned int> queue;
+    for (unsigned int root = 0; root < nAtoms; ++root) {
+      if (positions[root] >= 0) {
+        continue;
+      }
+      positions[root] = cp->order.size();
+      cp->order.push_back(root);
+      cp->parents.push_back(-1);
+      cp->parentBonds.push_back(nullptr);
+      queue.push_back(root);
+      while (!queue.empty()) {
+        const auto atom = pattern->getAtomWithIdx(queue.front());
+        queue.pop_front();
+        for (const auto bond : pattern->atomBonds(atom)) {
+          auto nbrIdx = bond->getOtherAtomIdx(atom->getIdx());
+          if (positions[nbrIdx] >= 0) {
+            continue;
+          }
+          positions[nbrIdx] = cp->order.size();
+          cp->order.push_back(nbrIdx);
+          cp->parents.push_back(positions[atom->getIdx()]);
+          cp->parentBonds.push_back(bond);
+          queue.push_back(nbrIdx);
+        }
+      }
+    }
+    cp->closures.resize(nAtoms);
+    for (const auto bond : pattern->bonds()) {
+      auto p1 = positions[bond->getBeginAtomIdx()];
+      auto p2 = positions[bond->getEndAtomIdx()];
+      if (p1 > p2) {
+        std::swap(p1, p2);
+      }
+      if (cp->parentBonds[p2] != bond) {
+        cp->closures[p2].emplace_back(p1, bond);
+      }
+    }
+    for (auto aidx : cp->order) {
+      const auto atom = pattern->getAtomWithIdx(aidx);
+      auto smarts = SmartsWrite::GetAtomSmarts(atom);
+      auto iter = d_atomQueryIndices.find(smarts);
+      if (iter == d_atomQueryIndices.end()) {
+        iter = d_atomQueryIndices.emplace(smarts, d_atomQueries.size()).first;
+        d_atomQueries.push_back(atom);
+      }
+      cp->atomQueries.push_back(iter->second);
+    }
+  }
+  d_patterns.push_back(std::move(cp));
+  return getNumPatterns() - 1;
+}
+
+const ROMol &SubstructCountEngine::getPattern(unsigned int idx) const {
+  URANGE_CHECK(idx, d_patterns.size());
+  return *d_patterns[idx]->pattern;
+}
+
+std::vector<unsigned int> SubstructCountEngine::countMatches(
+    const ROMol &mol) const {
+  std::vector<unsigned int> res;
+  res.reserve(d_patterns.size());
+  AtomMatchCache cache(mol, d_atomQueries);
+  for (const auto &cp : d_patterns) {
+    res.push_back(countPatternMatches(*cp, cache));
+  }
+  return res;
+}
+
+unsigned int SubstructCountEngine::countMatches(const ROMol &mol,
+                                                unsigned int idx) const {
+  URANGE_CHECK(idx, d_patterns.size());
+  AtomMatchCache cache(mol, d_atomQueries);
+  return countPatternMatches(*d_patterns[idx], cache);
+}
+
+std::vector<int> SubstructCountEngine::assignAtomsToPatterns(
+    const ROMol &mol) const {
+  auto nAtoms = mol.getNumAtoms();
+  std::vector<int> res(nAtoms, -1);
+  boost::dynamic_bitset<> atomNeeded(nAtoms);
+  atomNeeded.set();
+  AtomMatchCache cache(mol, d_atomQueries);
+  for (unsigned int pidx = 0; pidx < d_patterns.size() && atomNeeded.any();
+       ++pidx) {
+    const auto &cp = *d_patterns[pidx];
+    if (!cp.pattern->getNumAtoms()) {
+      continue;
+    }
+    if (cp.useSubstructMatch) {
+      SubstructMatchParameters ps;
+      ps.uniquify = false;
+      ps.recursionPossible = true;
+      // every atom is checked, as in the search below
+      ps.maxMatches = std::numeric_limits<unsigned int>::max();
+      for (const auto &match : SubstructMatch(mol, *cp.pattern, ps)) {
+        auto aidx = match[0].second;
+        if (atomNeeded[aidx]) {
+          atomNeeded.reset(aidx);
+          res[aidx] = pidx;
+        }
+      }
+      continue;
+    }
+    if (!canMatch(cp, cache)) {
+      continue;
+    }
+    auto candidates = cache.getMatches(cp.atomQueries[0]) & atomNeeded;
+    if (candidates.none()) {
+      continue;
+    }
+    std::vector<unsigned int> mapping(cp.order.size());
+    boost::dynamic_bitset<> used(nAtoms);
+    auto onMatch = [](const std::vector<unsigned int> &) { return true; };
+    for (auto aidx = candidates.find_first();
+         aidx != boost::dynamic_bitset<>::npos;
+         aidx = candidates.find_next(aidx)) {
+      mapping[0] = aidx;
+      if (searchMatches(cp, cache, 0, mapping, used, onMatch)) {
+        atomNeeded.reset(aidx);
+        res[aidx] = pidx;
+      }
+    }
+  }
+  return res;
+}
+
+}  // namespace Descriptors
+}  // namespace RDKit
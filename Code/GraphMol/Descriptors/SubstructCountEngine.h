@@ -0,0 +1,109 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+
+/*! \file SubstructCountEngine.h
+
+  \brief Defines the SubstructCountEngine class.
+
+*/
+#include <RDGeneral/export.h>
+#ifndef RD_SUBSTRUCTCOUNTENGINE_H
+#define RD_SUBSTRUCTCOUNTENGINE_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace RDKit {
+class Atom;
+class Bond;
+class ROMol;
+namespace Descriptors {
+
+//! Matches a set of SMARTS patterns against molecules
+/*!
+  This is intended for descriptors which are based on a collection of
+  SMARTS patterns, like the Crippen atom types.
+
+  <b>Notes:</b>
+    - The atom queries of all of the patterns are collected when the patterns
+      are added; queries which are used in more than one place (like [CH3] or
+      [#7]) are only evaluated once for each atom in a molecule.
+    - Patterns which can't match a molecule because one of their atom queries
+      doesn't match any atom are skipped without doing a substructure search.
+    - Patterns with recursive SMARTS or dative bonds are matched with
+      SubstructMatch(), the others use a simple backtracking search over the
+      precomputed atom matches.
+    - The results are the same as those from SubstructMatch() with the default
+      SubstructMatchParameters.
+*/
+class RDKIT_DESCRIPTORS_EXPORT SubstructCountEngine {
+ public:
+  SubstructCountEngine();
+  //! construct an engine from SMARTS patterns
+  SubstructCountEngine(const std::vector<std::string> &smarts);
+  ~SubstructCountEngine();
+
+  //! adds a pattern from SMARTS and returns its index
+  /*!
+    a ValueErrorException is thrown if the SMARTS can't be parsed
+  */
+  unsigned int addPattern(const std::string &smarts);
+  //! adds a pattern and returns its index
+  unsigned int addPattern(const std::shared_ptr<const ROMol> &pattern);
+
+  //! returns the number of patterns
+  unsigned int getNumPatterns() const {
+    return static_cast<unsigned int>(d_patterns.size());
+  }
+  //! returns one of the patterns
+  const ROMol &getPattern(unsigned int idx) const;
+
+  //! returns the number of matches of each pattern in a molecule
+  /*!
+    The counts are the same as the number of results from SubstructMatch()
+    with the default parameters, so they are uniquified and limited to
+    1000.
+  */
+  std::vector<unsigned int> countMatches(const ROMol &mol) const;
+  //! returns the number of matches of a single pattern in a molecule
+  unsigned int countMatches(const ROMol &mol, unsigned int idx) const;
+
+  //! assigns each atom to the first pattern which matches at that atom
+  /*!
+    An atom is assigned to a pattern if it is matched by the pattern's first
+    atom. The patterns are checked in order, the first one that matches an
+    atom wins. This is how the Crippen atom types are assigned.
+
+    Unlike countMatches(), this is not limited to 1000 matches per pattern:
+    every atom is checked. The Crippen typing used to call SubstructMatch()
+    with the default maxMatches, so in molecules where a pattern has more
+    than 1000 matches, atoms past that limit were given a later (or no)
+    type. They now get the same type as the other atoms.
+
+    \return the index of the pattern for each atom, -1 for atoms which
+            aren't matched by any pattern
+  */
+  std::vector<int> assignAtomsToPatterns(const ROMol &mol) const;
+
+  //! the compiled form of a pattern
+  struct CompiledPattern;
+
+ private:
+  std::vector<std::shared_ptr<const CompiledPattern>> d_patterns;
+  // the distinct atom queries, indexed by their SMARTS
+  std::vector<const Atom *> d_atomQueries;
+  std::unordered_map<std::string, unsigned int> d_atomQueryIndices;
+};
+
+}  // namespace Descriptors
+}  // namespace RDKit
+#endif
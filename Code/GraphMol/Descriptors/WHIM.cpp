@@ -35,6 +35,7 @@
 
 #include "WHIM.h"
 #include "MolData3Ddescriptors.h"
+#include "Descriptors3DContext.h"
 
 #include <cmath>
 #include <Eigen/Dense>
@@ -52,13 +53,7 @@ double roundn(double in, int factor) {
   return std::round(in * pow(10., factor)) / pow(10., factor);
 }
 
-MatrixXd GetCenterMatrix(MatrixXd &Mat) {
-  VectorXd v = Mat.colwise().mean();
-  MatrixXd X = Mat.rowwise() - v.transpose();
-  return X;
-}
-
-MatrixXd GetCovMatrix(MatrixXd &X, MatrixXd &Weight, double weight) {
+MatrixXd GetCovMatrix(const MatrixXd &X, MatrixXd &Weight, double weight) {
   return X.transpose() * Weight * X / weight;
 }
 
@@ -68,7 +63,7 @@ JacobiSVD<MatrixXd> *getSVD(MatrixXd &Mat) {
 }
 
 std::vector<double> getWhimD(std::vector<double> weightvector,
-                             MatrixXd MatOrigin, int numAtoms, double th) {
+                             const MatrixXd &Xmean, int numAtoms, double th) {
   double *weightarray = &weightvector[0];
 
   Map<VectorXd> Weight(weightarray, numAtoms);
@@ -84,9 +79,6 @@ std::vector<double> getWhimD(std::vector<double> weightvector,
     // std::cerr << "fix weight sum:\n";
   }
 
-  MatrixXd Xmean = GetCenterMatrix(MatOrigin);
-  // std::cerr << "Xmean:\n" << Xmean << "\n";
-
   MatrixXd covmat = GetCovMatrix(Xmean, WeightMat, weight);
 
   JacobiSVD<MatrixXd> *svd = getSVD(covmat);
@@ -216,105 +208,47 @@ std::vector<double> getWhimD(std::vector<double> weightvector,
   return w;
 }
 
-void GetWHIMs(const Conformer &conf, std::vector<double> &result,
-              double *Vpoints, double th) {
-  std::vector<double> wu(18);
-  std::vector<double> wm(18);
-  std::vector<double> wv(18);
-  std::vector<double> we(18);
-  std::vector<double> wp(18);
-  std::vector<double> wi(18);
-  std::vector<double> ws(18);
-
-  int numAtoms = conf.getNumAtoms();
-  Map<MatrixXd> matorigin(Vpoints, 3, numAtoms);
-  MatrixXd MatOrigin = matorigin.transpose();
-  std::vector<double> weightvector;
+void GetWHIMs(const Descriptors3DContext &context, std::vector<double> &result,
+              double th) {
+  int numAtoms = context.getNumAtoms();
+  const MatrixXd &Xmean = context.getCenteredCoordinates();
 
   // intermediate 18 values stored in this order per weighted vector :
   // "L1","L2","L3","T","A","V","P1","P2","P3","K","E1","E2","E3","D","G1","G2","G3","G"
-  weightvector = moldata3D.GetUn(numAtoms);
-  wu = getWhimD(weightvector, MatOrigin, numAtoms, th);
-
-  weightvector = moldata3D.GetRelativeMW(conf.getOwningMol());
-  wm = getWhimD(weightvector, MatOrigin, numAtoms, th);
-
-  weightvector = moldata3D.GetRelativeVdW(conf.getOwningMol());
-  wv = getWhimD(weightvector, MatOrigin, numAtoms, th);
-
-  weightvector = moldata3D.GetRelativeENeg(conf.getOwningMol());
-  we = getWhimD(weightvector, MatOrigin, numAtoms, th);
-
-  weightvector = moldata3D.GetRelativePol(conf.getOwningMol());
-  wp = getWhimD(weightvector, MatOrigin, numAtoms, th);
-
-  weightvector = moldata3D.GetRelativeIonPol(conf.getOwningMol());
-  wi = getWhimD(weightvector, MatOrigin, numAtoms, th);
-
-  weightvector = moldata3D.GetIState(conf.getOwningMol());
-  ws = getWhimD(weightvector, MatOrigin, numAtoms, th);
+  // the weights are "u", "m", "v", "e", "p", "i", "s"
+  const AtomProperty3D props[] = {
+      AtomProperty3D::Unit,         AtomProperty3D::RelativeMW,
+      AtomProperty3D::RelativeVdW,  AtomProperty3D::RelativeENeg,
+      AtomProperty3D::RelativePol,  AtomProperty3D::RelativeIonPol,
+      AtomProperty3D::IState};
 
   result.clear();
   result.resize(126);
-
-  for (int i = 0; i < 18; i++) {
-    result[i + 18 * 0] = wu[i];
-    result[i + 18 * 1] = wm[i];
-    result[i + 18 * 2] = wv[i];
-    result[i + 18 * 3] = we[i];
-    result[i + 18 * 4] = wp[i];
-    result[i + 18 * 5] = wi[i];
-    result[i + 18 * 6] = ws[i];
+  for (int k = 0; k < 7; k++) {
+    std::vector<double> w =
+        getWhimD(context.getAtomProperty(props[k]), Xmean, numAtoms, th);
+    std::copy(w.begin(), w.end(), result.begin() + 18 * k);
   }
-  wu.clear();
-  wm.clear();
-  wv.clear();
-  we.clear();
-  wp.clear();
-  wi.clear();
-  ws.clear();
 }
 
-void GetWHIMsCustom(const Conformer &conf, std::vector<double> &result,
-                    double *Vpoints, double th,
+void GetWHIMsCustom(const Descriptors3DContext &context,
+                    std::vector<double> &result, double th,
                     const std::string &customAtomPropName) {
-  std::vector<double> wc(18);
-
-  result.clear();
-  result.resize(18);
-
-  int numAtoms = conf.getNumAtoms();
-  Map<MatrixXd> matorigin(Vpoints, 3, numAtoms);
-  MatrixXd MatOrigin = matorigin.transpose();
+  int numAtoms = context.getNumAtoms();
 
   // intermediate 18 values stored in this order per weighted vector :
   // "L1","L2","L3","T","A","V","P1","P2","P3","K","E1","E2","E3","D","G1","G2","G3","G"
   std::vector<double> weightvector =
-      moldata3D.GetCustomAtomProp(conf.getOwningMol(), customAtomPropName);
+      moldata3D.GetCustomAtomProp(context.getMol(), customAtomPropName);
 
-  wc = getWhimD(weightvector, MatOrigin, numAtoms, th);
-
-  for (int i = 0; i < 18; i++) {
-    result[i] = wc[i];
-  }
-  wc.clear();
+  result = getWhimD(weightvector, context.getCenteredCoordinates(), numAtoms,
+                    th);
 }
 
-void getWHIM(const ROMol &mol, std::vector<double> &res, int confId,
+void getWHIM(const Descriptors3DContext &context, std::vector<double> &res,
              double th) {
-  int numAtoms = mol.getNumAtoms();
-  const Conformer &conf = mol.getConformer(confId);
-  auto *Vpoints = new double[3 * numAtoms];
-
-  for (int i = 0; i < numAtoms; ++i) {
-    Vpoints[3 * i] = conf.getAtomPos(i).x;
-    Vpoints[3 * i + 1] = conf.getAtomPos(i).y;
-    Vpoints[3 * i + 2] = conf.getAtomPos(i).z;
-  }
-
   std::vector<double> w(126);
-  GetWHIMs(conf, w, Vpoints, th);
-  delete[] Vpoints;
+  GetWHIMs(context, w, th);
 
   // Dragon extract only this list in this order : L1 L2 L3 P1 P2 G1 G2 G3 E1 E2
   // E3
@@ -349,21 +283,10 @@ void getWHIM(const ROMol &mol, std::vector<double> &res, int confId,
   }
 }
 
-void getWHIMone(const ROMol &mol, std::vector<double> &res, int confId,
+void getWHIMone(const Descriptors3DContext &context, std::vector<double> &res,
                 double th, const std::string &customAtomPropName) {
-  int numAtoms = mol.getNumAtoms();
-  const Conformer &conf = mol.getConformer(confId);
-  auto *Vpoints = new double[3 * numAtoms];
-
-  for (int i = 0; i < numAtoms; ++i) {
-    Vpoints[3 * i] = conf.getAtomPos(i).x;
-    Vpoints[3 * i + 1] = conf.getAtomPos(i).y;
-    Vpoints[3 * i + 2] = conf.getAtomPos(i).z;
-  }
-
   std::vector<double> w(18);
-  GetWHIMsCustom(conf, w, Vpoints, th, customAtomPropName);
-  delete[] Vpoints;
+  GetWHIMsCustom(context, w, th, customAtomPropName);
 
   // Dragon extract only this list in this order : L1 L2 L3 P1 P2 G1 G2 G3 E1 E2
   // E3
@@ -377,20 +300,25 @@ void getWHIMone(const ROMol &mol, std::vector<double> &res, int confId,
 
 }  // end of anonymous namespace
 
-void WHIM(const ROMol &mol, std::vector<double> &res, int confId, double th,
-          const std::string &customAtomPropName) {
-  PRECONDITION(mol.getNumConformers() >= 1, "molecule has no conformers")
+void WHIM(const Descriptors3DContext &context, std::vector<double> &res,
+          double th, const std::string &customAtomPropName) {
   // Dragon final list is: L1u L2u L3u P1u P2u G1u G2u G3u E1u E2u E3u
   // Tu   Au    Gu   Ku    Du   Vu
   if (customAtomPropName != "") {
     res.clear();
     res.resize(17);
-    getWHIMone(mol, res, confId, th, customAtomPropName);
+    getWHIMone(context, res, th, customAtomPropName);
   } else {
     res.clear();
     res.resize(114);
-    getWHIM(mol, res, confId, th);
+    getWHIM(context, res, th);
   }
 }
+
+void WHIM(const ROMol &mol, std::vector<double> &res, int confId, double th,
+          const std::string &customAtomPropName) {
+  PRECONDITION(mol.getNumConformers() >= 1, "molecule has no conformers")
+  WHIM(Descriptors3DContext(mol, confId), res, th, customAtomPropName);
+}
 }  // namespace Descriptors
 }  // namespace RDKit
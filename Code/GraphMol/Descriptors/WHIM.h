@@ -41,10 +41,15 @@
 namespace RDKit {
 class ROMol;
 namespace Descriptors {
+class Descriptors3DContext;
 const std::string WHIMVersion = "1.0.0";
 RDKIT_DESCRIPTORS_EXPORT void WHIM(const ROMol &, std::vector<double> &res,
                                    int confId = -1, double th = 0.001,
                                    const std::string &customAtomPropName = "");
+//! \overload
+RDKIT_DESCRIPTORS_EXPORT void WHIM(const Descriptors3DContext &context,
+                                   std::vector<double> &res, double th = 0.001,
+                                   const std::string &customAtomPropName = "");
 }  // namespace Descriptors
 }  // namespace RDKit
 #endif
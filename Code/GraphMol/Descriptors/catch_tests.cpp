@@ -20,6 +20,21 @@
 #include <GraphMol/Descriptors/OxidationNumbers.h>
 #include <GraphMol/Descriptors/PMI.h>
 #include <GraphMol/Descriptors/DCLV.h>
+#include <GraphMol/Descriptors/BCUT.h>
+#include <GraphMol/Descriptors/Property.h>
+#include <GraphMol/Descriptors/DescriptorCalculator.h>
+#include <GraphMol/Descriptors/SubstructCountEngine.h>
+#ifdef RDK_BUILD_DESCRIPTORS3D
+#include <GraphMol/Descriptors/MolDescriptors3D.h>
+#endif
+#include <GraphMol/Substruct/SubstructMatch.h>
+#include <GraphMol/test_fixtures.h>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
 
 using namespace RDKit;
 
@@ -605,3 +620,616 @@ TEST_CASE("DCLV") {
     CHECK(dclv.getVDWVolume() == Catch::Approx(139.97).epsilon(0.05));
   }
 }
+
+namespace {
+// the values of all of the descriptors DescriptorCalculator knows about,
+// calculated using the individual descriptor functions
+std::map<std::string, double> referenceDescriptorValues(const ROMol &mol) {
+  std::map<std::string, double> res;
+  auto nan = std::numeric_limits<double>::quiet_NaN();
+  for (const auto &name : Descriptors::Properties::getAvailableProperties()) {
+    try {
+      res[name] = (*Descriptors::Properties::getProperty(name))(mol);
+    } catch (const std::exception &) {
+      res[name] = nan;
+    }
+  }
+  auto addFamily = [&res, nan](const std::vector<std::string> &names,
+                               const auto &func) {
+    std::vector<double> vals(names.size(), nan);
+    try {
+      auto fvals = func();
+      REQUIRE(fvals.size() == names.size());
+      std::copy(fvals.begin(), fvals.end(), vals.begin());
+    } catch (const std::exception &) {
+    }
+    for (unsigned int i = 0; i < names.size(); ++i) {
+      res[names[i]] = vals[i];
+    }
+  };
+  auto numbered = [](const std::string &prefix, unsigned int count) {
+    std::vector<std::string> names;
+    for (unsigned int i = 1; i <= count; ++i) {
+      names.push_back(prefix + std::to_string(i));
+    }
+    return names;
+  };
+  addFamily(numbered("SlogP_VSA", 12),
+            [&mol]() { return Descriptors::calcSlogP_VSA(mol); });
+  addFamily(numbered("SMR_VSA", 10),
+            [&mol]() { return Descriptors::calcSMR_VSA(mol); });
+  addFamily(numbered("PEOE_VSA", 14),
+            [&mol]() { return Descriptors::calcPEOE_VSA(mol); });
+  addFamily(numbered("MQN", 42), [&mol]() {
+    auto mqns = Descriptors::calcMQNs(mol);
+    return std::vector<double>(mqns.begin(), mqns.end());
+  });
+  addFamily(numbered("AUTOCORR2D_", 192), [&mol]() {
+    std::vector<double> vals;
+    Descriptors::AUTOCORR2D(mol, vals);
+    return vals;
+  });
+#ifdef RDK_HAS_EIGEN3
+  addFamily({"BCUT2D_MWHI", "BCUT2D_MWLOW", "BCUT2D_CHGHI", "BCUT2D_CHGLO",
+             "BCUT2D_LOGPHI", "BCUT2D_LOGPLOW", "BCUT2D_MRHI", "BCUT2D_MRLOW"},
+            [&mol]() { return Descriptors::BCUT2D(mol); });
+#endif
+  return res;
+}
+}  // namespace
+
+TEST_CASE("DescriptorCalculator") {
+  std::vector<std::string> smis = {
+      "CC(=O)Oc1ccccc1C(=O)O",
+      "CN1CCC[C@H]1c1cccnc1",
+      "O=C(O)C1CC2(C1)CC(C2)c1ccc2OCOc2c1",
+      "C[N+](C)(C)CC(=O)[O-]",
+      "CC[Hg]CC",  // no Gasteiger parameters for Hg
+      "[Na+].[Cl-]",
+      "C",
+  };
+  SECTION("all descriptors") {
+    Descriptors::DescriptorCalculator calc;
+    auto names = calc.getDescriptorNames();
+    CHECK(names ==
+          Descriptors::DescriptorCalculator::getAvailableDescriptors());
+    CHECK(std::find(names.begin(), names.end(), "MQN42") != names.end());
+    CHECK(std::find(names.begin(), names.end(), "tpsa") != names.end());
+    // one of the test molecules has explicit Hs
+    std::vector<std::unique_ptr<ROMol>> mols;
+    for (const auto &smi : smis) {
+      mols.emplace_back(SmilesToMol(smi));
+      REQUIRE(mols.back());
+    }
+    mols.emplace_back(MolOps::addHs(*mols[0]));
+    for (const auto &mol : mols) {
+      INFO(MolToSmiles(*mol));
+      // use a copy so that cached values don't influence the results
+      ROMol ref(*mol);
+      auto expected = referenceDescriptorValues(ref);
+      auto vals = calc.computeDescriptors(*mol);
+      REQUIRE(vals.size() == names.size());
+      for (unsigned int i = 0; i < names.size(); ++i) {
+        INFO(names[i]);
+        REQUIRE(expected.find(names[i]) != expected.end());
+        if (std::isnan(expected[names[i]])) {
+          CHECK(std::isnan(vals[i]));
+        } else {
+          CHECK(vals[i] == expected[names[i]]);
+        }
+      }
+    }
+  }
+  SECTION("subsets") {
+    std::vector<std::string> names = {"MQN3", "CrippenMR", "chi2v",
+                                      "PEOE_VSA2", "kappa2", "MQN1"};
+    Descriptors::DescriptorCalculator calc(names);
+    CHECK(calc.getNumDescriptors() == names.size());
+    CHECK(calc.getDescriptorNames() == names);
+    std::unique_ptr<ROMol> m(SmilesToMol("CC(=O)Oc1ccccc1C(=O)O"));
+    REQUIRE(m);
+    auto vals = calc.computeDescriptors(*m);
+    ROMol ref(*m);
+    auto mqns = Descriptors::calcMQNs(ref);
+    CHECK(vals[0] == mqns[2]);
+    CHECK(vals[1] == Descriptors::calcMR(ref));
+    CHECK(vals[2] == Descriptors::calcChi2v(ref));
+    CHECK(vals[3] == Descriptors::calcPEOE_VSA(ref)[1]);
+    CHECK(vals[4] == Descriptors::calcKappa2(ref));
+    CHECK(vals[5] == mqns[0]);
+
+    CHECK_THROWS_AS(Descriptors::DescriptorCalculator({"tpsa", "bogus"}),
+                    KeyErrorException);
+  }
+  SECTION("batches") {
+    Descriptors::DescriptorCalculator calc;
+    std::vector<std::unique_ptr<ROMol>> mols;
+    std::vector<const ROMol *> batch;
+    for (const auto &smi : smis) {
+      mols.emplace_back(SmilesToMol(smi));
+      batch.push_back(mols.back().get());
+    }
+    batch.insert(batch.begin() + 2, nullptr);
+    auto nDescs = calc.getNumDescriptors();
+    for (auto numThreads : {1, 4}) {
+      auto res = calc.computeDescriptors(batch, numThreads);
+      REQUIRE(res.size() == batch.size() * nDescs);
+      for (unsigned int i = 0; i < batch.size(); ++i) {
+        if (!batch[i]) {
+          for (unsigned int j = 0; j < nDescs; ++j) {
+            CHECK(std::isnan(res[i * nDescs + j]));
+          }
+          continue;
+        }
+        auto vals = calc.computeDescriptors(*batch[i]);
+        for (unsigned int j = 0; j < nDescs; ++j) {
+          INFO(calc.getDescriptorNames()[j]);
+          if (std::isnan(vals[j])) {
+            CHECK(std::isnan(res[i * nDescs + j]));
+          } else {
+            CHECK(res[i * nDescs + j] == static_cast<float>(vals[j]));
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("DescriptorCalculator benchmark", "[.][benchmark]") {
+  auto smis = readChemblTestSmiles();
+  // the descriptors are cached on the molecules, so each method needs its
+  // own copies
+  auto getMols = [&smis]() {
+    std::vector<std::unique_ptr<ROMol>> mols;
+    for (const auto &smi : smis) {
+      mols.emplace_back(SmilesToMol(smi));
+    }
+    return mols;
+  };
+  auto report = [&smis](const std::string &label, const auto &t1) {
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "TIMING : " << label << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << smis.size() << " molecules"
+              << std::endl;
+  };
+  Descriptors::DescriptorCalculator calc;
+
+  {
+    auto mols = getMols();
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (const auto &mol : mols) {
+      referenceDescriptorValues(*mol);
+    }
+    report("individual descriptor functions", t1);
+  }
+  std::vector<float> res1;
+  {
+    auto mols = getMols();
+    std::vector<const ROMol *> batch;
+    for (const auto &mol : mols) {
+      batch.push_back(mol.get());
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    res1 = calc.computeDescriptors(batch);
+    report("DescriptorCalculator, 1 thread", t1);
+  }
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  {
+    auto mols = getMols();
+    std::vector<const ROMol *> batch;
+    for (const auto &mol : mols) {
+      batch.push_back(mol.get());
+    }
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto res2 = calc.computeDescriptors(batch, -1);
+    report("DescriptorCalculator, all threads", t1);
+    CHECK(res2.size() == res1.size());
+  }
+#endif
+}
+
+namespace {
+// the way the Crippen atom types were assigned before SubstructCountEngine
+std::vector<int> assignCrippenTypesWithSubstructMatch(const ROMol &mol) {
+  std::vector<int> res(mol.getNumAtoms(), -1);
+  const auto params = Descriptors::CrippenParamCollection::getParams();
+  for (const auto &param : *params) {
+    std::vector<MatchVectType> matches;
+    SubstructMatch(mol, *param.dp_pattern, matches, false, true);
+    for (const auto &match : matches) {
+      if (res[match[0].second] < 0) {
+        res[match[0].second] = param.idx;
+      }
+    }
+  }
+  return res;
+}
+}  // namespace
+
+TEST_CASE("SubstructCountEngine") {
+  std::vector<std::string> smis = {
+      "CC(=O)Oc1ccccc1C(=O)O",
+      "CN1CCC[C@H]1c1cccnc1",
+      "O=C(O)C1CC2(C1)CC(C2)c1ccc2OCOc2c1",
+      "C[N+](C)(C)CC(=O)[O-]",
+      "c1ccc2ccccc2c1.OCCO",
+      "C1CC2CCC1CC2",
+      "[Na+].[Cl-]",
+      "C",
+  };
+  std::vector<std::string> smarts = {
+      "[#6]",
+      "C",
+      "c",
+      "[#6]~[#6]",
+      "C=O",
+      "C(=O)O",
+      "c1ccccc1",
+      "[R]@[R]",
+      "[CH2;R]",
+      "[$(C=O)]O",
+      "[#8].[#8]",
+      "*~*~*",
+      "C1CC1",
+      "[!#6;!#1]",
+      "[N+,n]",
+      "[#6]1~[#6]~[#6]~[#6]~[#6]~[#6]~1",
+  };
+  std::vector<std::unique_ptr<ROMol>> mols;
+  for (const auto &smi : smis) {
+    mols.emplace_back(SmilesToMol(smi));
+    REQUIRE(mols.back());
+  }
+  mols.emplace_back(MolOps::addHs(*mols[0]));
+  mols.emplace_back(new ROMol());
+
+  SECTION("counts") {
+    Descriptors::SubstructCountEngine engine(smarts);
+    REQUIRE(engine.getNumPatterns() == smarts.size());
+    for (const auto &mol : mols) {
+      auto counts = engine.countMatches(*mol);
+      REQUIRE(counts.size() == smarts.size());
+      for (unsigned int i = 0; i < smarts.size(); ++i) {
+        INFO(MolToSmiles(*mol) << " " << smarts[i]);
+        std::vector<MatchVectType> matches;
+        auto expected = SubstructMatch(*mol, engine.getPattern(i), matches);
+        CHECK(counts[i] == expected);
+        CHECK(engine.countMatches(*mol, i) == expected);
+      }
+    }
+  }
+  SECTION("maxMatches") {
+    std::unique_ptr<ROMol> mol(SmilesToMol(std::string(1200, 'C')));
+    REQUIRE(mol);
+    Descriptors::SubstructCountEngine engine({"C", "CC"});
+    auto counts = engine.countMatches(*mol);
+    CHECK(counts[0] == 1000);
+    CHECK(counts[1] == 1000);
+  }
+  SECTION("errors") {
+    Descriptors::SubstructCountEngine engine;
+    CHECK_THROWS_AS(engine.addPattern("C)C"), ValueErrorException);
+    CHECK(engine.getNumPatterns() == 0);
+  }
+  SECTION("Crippen atom types") {
+    const auto params = Descriptors::CrippenParamCollection::getParams();
+    for (const auto &mol : mols) {
+      INFO(MolToSmiles(*mol));
+      CHECK(params->getEngine().assignAtomsToPatterns(*mol) ==
+            assignCrippenTypesWithSubstructMatch(*mol));
+    }
+  }
+  SECTION("Crippen atom types are not limited to 1000 matches") {
+    std::unique_ptr<ROMol> mol(SmilesToMol(std::string(1200, 'C')));
+    REQUIRE(mol);
+    std::vector<double> logp, mr;
+    std::vector<std::string> labels;
+    Descriptors::getCrippenAtomContribs(*mol, logp, mr, true, nullptr,
+                                        &labels);
+    for (unsigned int i = 0; i < mol->getNumAtoms(); ++i) {
+      INFO(i);
+      CHECK(labels[i] == "C1");
+      CHECK(logp[i] == logp[0]);
+    }
+    // [CH2](C)C has two ununiquified matches per CH2, so SubstructMatch()
+    // with the default parameters stops before reaching all of them
+    const auto params = Descriptors::CrippenParamCollection::getParams();
+    CHECK(assignCrippenTypesWithSubstructMatch(*mol) !=
+          params->getEngine().assignAtomsToPatterns(*mol));
+  }
+}
+
+TEST_CASE("SubstructCountEngine benchmark", "[.][benchmark]") {
+  std::vector<std::unique_ptr<ROMol>> mols;
+  for (const auto &smi : readChemblTestSmiles()) {
+    mols.emplace_back(SmilesToMol(smi));
+    REQUIRE(mols.back());
+  }
+  auto report = [&mols](const std::string &label, const auto &t1) {
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "TIMING : " << label << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << mols.size() << " molecules"
+              << std::endl;
+  };
+
+  std::vector<std::vector<int>> res1;
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (const auto &mol : mols) {
+    res1.push_back(assignCrippenTypesWithSubstructMatch(*mol));
+  }
+  report("Crippen types with SubstructMatch", t1);
+
+  const auto params = Descriptors::CrippenParamCollection::getParams();
+  std::vector<std::vector<int>> res2;
+  t1 = std::chrono::high_resolution_clock::now();
+  for (const auto &mol : mols) {
+    res2.push_back(params->getEngine().assignAtomsToPatterns(*mol));
+  }
+  report("Crippen types with SubstructCountEngine", t1);
+  CHECK(res1 == res2);
+}
+
+#ifdef RDK_BUILD_DESCRIPTORS3D
+namespace {
+// reads the molecules from EGFR_first10_10confs.sdf, combining the conformers
+std::vector<std::unique_ptr<ROMol>> readMultiConformerMols() {
+  std::string pathName = getenv("RDBASE");
+  std::string sdfName = pathName +
+                        "/Code/GraphMol/Descriptors/test_data/"
+                        "EGFR_first10_10confs.sdf";
+  bool sanitize = true;
+  bool removeHs = false;
+  RDKit::SDMolSupplier reader(sdfName, sanitize, removeHs);
+  std::vector<std::unique_ptr<ROMol>> res;
+  std::string lastName;
+  while (!reader.atEnd()) {
+    std::unique_ptr<ROMol> mol(reader.next());
+    REQUIRE(mol);
+    auto name = mol->getProp<std::string>(common_properties::_Name);
+    if (!res.empty() && name == lastName) {
+      res.back()->addConformer(new Conformer(mol->getConformer()), true);
+    } else {
+      res.push_back(std::move(mol));
+      lastName = name;
+    }
+  }
+  return res;
+}
+
+// reads one of the tab-separated reference files for PBF_egfr.sdf, the first
+// column is the molecule name
+std::vector<std::pair<std::string, std::vector<double>>> readReferenceValues(
+    const std::string &name) {
+  std::string pathName = getenv("RDBASE");
+  std::ifstream instrm(pathName + "/Code/GraphMol/Descriptors/test_data/" +
+                       name);
+  REQUIRE(instrm);
+  std::vector<std::pair<std::string, std::vector<double>>> res;
+  std::string line;
+  while (std::getline(instrm, line)) {
+    std::stringstream ss(line);
+    std::string field;
+    std::getline(ss, field, '\t');
+    res.emplace_back(field, std::vector<double>());
+    while (std::getline(ss, field, '\t')) {
+      res.back().second.push_back(atof(field.c_str()));
+    }
+  }
+  return res;
+}
+
+std::vector<double> calcDescriptors3DSeparately(const ROMol &mol, int confId) {
+  std::vector<double> res;
+  std::vector<double> vals;
+  Descriptors::RDF(mol, vals, confId);
+  res.insert(res.end(), vals.begin(), vals.end());
+  Descriptors::MORSE(mol, vals, confId);
+  res.insert(res.end(), vals.begin(), vals.end());
+  Descriptors::WHIM(mol, vals, confId);
+  res.insert(res.end(), vals.begin(), vals.end());
+  Descriptors::GETAWAY(mol, vals, confId);
+  res.insert(res.end(), vals.begin(), vals.end());
+  Descriptors::AUTOCORR3D(mol, vals, confId);
+  res.insert(res.end(), vals.begin(), vals.end());
+  bool useAtomicMasses = true;
+  bool force = true;
+  res.push_back(Descriptors::NPR1(mol, confId, useAtomicMasses, force));
+  res.push_back(Descriptors::NPR2(mol, confId, useAtomicMasses, force));
+  res.push_back(Descriptors::PMI1(mol, confId, useAtomicMasses, force));
+  res.push_back(Descriptors::PMI2(mol, confId, useAtomicMasses, force));
+  res.push_back(Descriptors::PMI3(mol, confId, useAtomicMasses, force));
+  res.push_back(
+      Descriptors::radiusOfGyration(mol, confId, useAtomicMasses, force));
+  res.push_back(
+      Descriptors::inertialShapeFactor(mol, confId, useAtomicMasses, force));
+  res.push_back(Descriptors::eccentricity(mol, confId, useAtomicMasses, force));
+  res.push_back(Descriptors::asphericity(mol, confId, useAtomicMasses, force));
+  res.push_back(Descriptors::spherocityIndex(mol, confId, force));
+  return res;
+}
+}  // namespace
+
+TEST_CASE("Descriptors3DContext", "[3D]") {
+  auto mols = readMultiConformerMols();
+  REQUIRE(mols.size() == 10);
+  REQUIRE(mols[0]->getNumConformers() == 10);
+
+  SECTION("intermediates") {
+    const auto &mol = *mols[0];
+    Descriptors::Descriptors3DContext context(mol, 3);
+    auto numAtoms = mol.getNumAtoms();
+    CHECK(context.getConfId() == 3);
+    CHECK(context.getNumAtoms() == numAtoms);
+    CHECK(context.getNumPairs() == numAtoms * (numAtoms - 1) / 2);
+    const auto &conf = mol.getConformer(3);
+    const auto &dists = context.getDistanceMatrix();
+    const auto &pairDists = context.getPairDistances();
+    REQUIRE(dists.size() == numAtoms * numAtoms);
+    REQUIRE(pairDists.size() == context.getNumPairs());
+    unsigned int pairIdx = 0;
+    for (unsigned int i = 0; i < numAtoms; ++i) {
+      for (unsigned int j = i + 1; j < numAtoms; ++j) {
+        auto d = (conf.getAtomPos(i) - conf.getAtomPos(j)).length();
+        CHECK(dists[i * numAtoms + j] == Catch::Approx(d));
+        CHECK(pairDists[pairIdx++] == dists[i * numAtoms + j]);
+      }
+    }
+    const auto &centered = context.getCenteredCoordinates();
+    CHECK(centered.rows() == numAtoms);
+    CHECK(centered.colwise().sum().norm() < 1e-8);
+    // the leverage matrix is a projection
+    const auto &H = context.getLeverageMatrix();
+    CHECK((H * H - H).norm() < 1e-6);
+    // nothing is cached on the molecule
+    CHECK(!mol.hasProp("_3DDistanceMatrix_Conf3"));
+    CHECK(!mol.hasProp("_PMI1_mass"));
+
+    auto other = context.forConformer(5);
+    CHECK(other.getConfId() == 5);
+    CHECK(&other.getTopologicalDistanceMatrix() ==
+          &context.getTopologicalDistanceMatrix());
+    CHECK(other.getPairDistances() != context.getPairDistances());
+  }
+  SECTION("same results as the individual functions") {
+    Descriptors::Descriptors3DParams params;
+    auto numDescriptors = Descriptors::getNumDescriptors3D(params);
+    CHECK(numDescriptors == 911);
+    for (const auto &mol : mols) {
+      for (auto numThreads : {1, 4}) {
+        auto res = Descriptors::calcDescriptors3D(*mol, std::vector<int>(),
+                                                  params, numThreads);
+        REQUIRE(res.size() == mol->getNumConformers());
+        for (auto cit = mol->beginConformers(); cit != mol->endConformers();
+             ++cit) {
+          auto confId = static_cast<int>((*cit)->getId());
+          const auto &vals = res[confId];
+          REQUIRE(vals.size() == numDescriptors);
+          auto ref = calcDescriptors3DSeparately(*mol, confId);
+          REQUIRE(ref.size() == numDescriptors);
+          for (unsigned int i = 0; i < numDescriptors; ++i) {
+            CHECK(vals[i] == Catch::Approx(ref[i]).margin(1e-8));
+          }
+        }
+      }
+    }
+  }
+  SECTION("stored reference values") {
+    // the individual functions use the context too, so compare against the
+    // values their own tests use, with the same tolerances
+    std::string pathName = getenv("RDBASE");
+    SDMolSupplier reader(
+        pathName + "/Code/GraphMol/Descriptors/test_data/PBF_egfr.sdf", true,
+        false);
+    const auto rdf = readReferenceValues("RDF.out");
+    const auto morse = readReferenceValues("MORSE.out");
+    const auto whim = readReferenceValues("whim.new.out");
+    const auto getaway = readReferenceValues("GETAWAY.new.out");
+    const auto autocorr = readReferenceValues("auto3D_dragon.out");
+    Descriptors::Descriptors3DParams params;
+    params.whimThreshold = 0.01;
+    params.includePMI = false;
+    REQUIRE(Descriptors::getNumDescriptors3D(params) == 901);
+    unsigned int nDone = 0;
+    while (!reader.atEnd()) {
+      std::unique_ptr<ROMol> mol(reader.next());
+      REQUIRE(mol);
+      auto name = mol->getProp<std::string>(common_properties::_Name);
+      auto res = Descriptors::calcDescriptors3D(*mol, std::vector<int>(),
+                                                params);
+      REQUIRE(res.size() == 1);
+      const auto &vals = res[0];
+      REQUIRE(vals.size() == 901);
+      unsigned int offset = 0;
+      REQUIRE(rdf[nDone].first == name);
+      for (unsigned int i = 0; i < 210; ++i) {
+        auto ref = rdf[nDone].second[i];
+        CHECK((ref < 0.5 || fabs(ref - vals[offset + i]) / ref < 0.02));
+      }
+      offset += 210;
+      REQUIRE(morse[nDone].first == name);
+      for (unsigned int i = 0; i < 224; ++i) {
+        auto ref = morse[nDone].second[i];
+        CHECK((ref < 1 || fabs(ref - vals[offset + i]) / ref < 0.02));
+      }
+      offset += 224;
+      REQUIRE(whim[nDone].first == name);
+      for (unsigned int i = 0; i < 114; ++i) {
+        CHECK(fabs(whim[nDone].second[i] - vals[offset + i]) < 0.01);
+      }
+      offset += 114;
+      REQUIRE(getaway[nDone].first == name);
+      for (unsigned int i = 0; i < 273; ++i) {
+        CHECK(fabs(getaway[nDone].second[i] - vals[offset + i]) < 0.05);
+      }
+      offset += 273;
+      REQUIRE(autocorr[nDone].first == name);
+      for (unsigned int i = 0; i < 80; ++i) {
+        CHECK(fabs(autocorr[nDone].second[i] - vals[offset + i]) < 0.0015);
+      }
+      ++nDone;
+    }
+    CHECK(nDone == 365);
+  }
+  SECTION("subsets") {
+    const auto &mol = *mols[1];
+    Descriptors::Descriptors3DParams params;
+    params.includeRDF = false;
+    params.includeMORSE = false;
+    params.includeGETAWAY = false;
+    params.includeAUTOCORR3D = false;
+    CHECK(Descriptors::getNumDescriptors3D(params) == 124);
+    auto res = Descriptors::calcDescriptors3D(mol, {2, 7}, params);
+    REQUIRE(res.size() == 2);
+    std::vector<double> whim;
+    Descriptors::WHIM(mol, whim, 7);
+    REQUIRE(res[1].size() == 124);
+    CHECK(std::vector<double>(res[1].begin(), res[1].begin() + 114) == whim);
+    CHECK(res[1][123] ==
+          Catch::Approx(Descriptors::spherocityIndex(mol, 7, true)));
+  }
+}
+
+TEST_CASE("Descriptors3DContext benchmark", "[.][benchmark]") {
+  auto mols = readMultiConformerMols();
+  unsigned int numConfs = 0;
+  for (const auto &mol : mols) {
+    numConfs += mol->getNumConformers();
+  }
+  auto report = [numConfs](const std::string &label, const auto &t1) {
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "TIMING : " << label << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << numConfs << " conformers"
+              << std::endl;
+  };
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (const auto &mol : mols) {
+    for (auto cit = mol->beginConformers(); cit != mol->endConformers();
+         ++cit) {
+      calcDescriptors3DSeparately(*mol, (*cit)->getId());
+    }
+  }
+  report("individual functions", t1);
+
+  t1 = std::chrono::high_resolution_clock::now();
+  for (const auto &mol : mols) {
+    Descriptors::calcDescriptors3D(*mol);
+  }
+  report("calcDescriptors3D", t1);
+
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  t1 = std::chrono::high_resolution_clock::now();
+  for (const auto &mol : mols) {
+    Descriptors::calcDescriptors3D(*mol, std::vector<int>(),
+                                   Descriptors::Descriptors3DParams(), -1);
+  }
+  report("calcDescriptors3D, all threads", t1);
+#endif
+}
+#endif
@@ -13,10 +13,14 @@
 #ifdef RDK_BUILD_YAEHMOP_SUPPORT
 #include <YAeHMOP/EHTTools.h>
 #endif
+#include <RDGeneral/RDThreads.h>
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <numeric>
 #include <cmath>
+#include <set>
 #include <unordered_map>
 
 #include <RDGeneral/BoostStartInclude.h>
@@ -98,8 +102,9 @@ std::vector<unsigned int> possibleValences(
   return possible;
 }
 
-LazyCartesianProduct<unsigned int> getValenceCombinations(
-    const RDKit::RWMol &mol) {
+// returns the valences which are tried for each atom
+std::vector<std::vector<unsigned int>> getPossibleValences(
+    const RDKit::ROMol &mol) {
   auto numAtoms = mol.getNumAtoms();
   const std::unordered_map<int, std::vector<unsigned int>> atomicValence = {
       {1, {1}},  {5, {3, 4}}, {6, {4}},     {7, {3, 4}},     {8, {2, 1, 3}},
@@ -120,7 +125,226 @@ LazyCartesianProduct<unsigned int> getValenceCombinations(
     }
   }
 
-  return LazyCartesianProduct<unsigned int>(possible);
+  // Multiple bonds can only be added between neighboring atoms which both
+  // have a valence larger than their degree, so only the atoms in these
+  // conjugated subsystems need to be enumerated. For an atom outside of them
+  // only a valence equal to its degree can ever be saturated, and the choice
+  // has no effect on the bond orders, so we only keep one choice.
+  std::vector<bool> canBeUnsaturated(numAtoms);
+  for (unsigned int i = 0; i < numAtoms; i++) {
+    canBeUnsaturated[i] =
+        *std::max_element(possible[i].begin(), possible[i].end()) >
+        mol.getAtomWithIdx(i)->getDegree();
+  }
+  for (unsigned int i = 0; i < numAtoms; i++) {
+    if (possible[i].size() < 2) {
+      continue;
+    }
+    const auto atom = mol.getAtomWithIdx(i);
+    bool inSubsystem = false;
+    for (const auto nbr : mol.atomNeighbors(atom)) {
+      if (canBeUnsaturated[nbr->getIdx()]) {
+        inSubsystem = true;
+        break;
+      }
+    }
+    if (!inSubsystem) {
+      auto degree = std::find(possible[i].begin(), possible[i].end(),
+                              atom->getDegree());
+      possible[i] = {degree != possible[i].end() ? *degree : possible[i][0]};
+    }
+  }
+
+  return possible;
+}
+
+// returns the conjugated subsystems: the groups of connected atoms which can
+// have a valence larger than their degree. The atoms of each subsystem are
+// sorted.
+std::vector<std::vector<unsigned int>> getConjugatedSubsystems(
+    const RDKit::ROMol &mol,
+    const std::vector<std::vector<unsigned int>> &possible) {
+  auto numAtoms = mol.getNumAtoms();
+  std::vector<bool> canBeUnsaturated(numAtoms);
+  for (unsigned int i = 0; i < numAtoms; i++) {
+    canBeUnsaturated[i] =
+        *std::max_element(possible[i].begin(), possible[i].end()) >
+        mol.getAtomWithIdx(i)->getDegree();
+  }
+  std::vector<std::vector<unsigned int>> res;
+  std::vector<bool> done(numAtoms, false);
+  for (unsigned int i = 0; i < numAtoms; i++) {
+    if (!canBeUnsaturated[i] || done[i]) {
+      continue;
+    }
+    std::vector<unsigned int> atoms{i};
+    done[i] = true;
+    for (size_t next = 0; next < atoms.size(); ++next) {
+      for (const auto nbr :
+           mol.atomNeighbors(mol.getAtomWithIdx(atoms[next]))) {
+        auto nbrIdx = nbr->getIdx();
+        if (canBeUnsaturated[nbrIdx] && !done[nbrIdx]) {
+          done[nbrIdx] = true;
+          atoms.push_back(nbrIdx);
+        }
+      }
+    }
+    std::sort(atoms.begin(), atoms.end());
+    res.push_back(std::move(atoms));
+  }
+  return res;
+}
+
+// the result of the bond order search on a conjugated subsystem for a
+// combination of the valences of its atoms
+struct SubsystemResult {
+  std::vector<unsigned int> valency;     // for each atom of the subsystem
+  std::vector<unsigned int> bondOrders;  // for each bond of the subsystem
+  bool valencyValid = false;
+  bool saturationValid = false;
+};
+
+// Runs the xyz2mol search on the valence combinations of one conjugated
+// subsystem. Multiple bonds are only added between atoms of the same
+// subsystem, so the bond orders found for a subsystem don't depend on the
+// valences of the atoms outside of it. Only the distinct results are kept, in
+// the order in which they are found.
+class SubsystemSearch {
+ public:
+  SubsystemSearch(const RDKit::ROMol &mol, std::vector<unsigned int> atoms,
+                  const std::vector<std::vector<unsigned int>> &possible,
+                  const std::vector<unsigned int> &origValency);
+
+  const std::vector<unsigned int> &getAtoms() const { return d_atoms; }
+  const std::vector<unsigned int> &getBonds() const { return d_bonds; }
+  const std::vector<SubsystemResult> &getResults() const { return d_results; }
+
+  // continues the search until a new saturated result is found, returns
+  // false if there isn't one
+  bool findSaturated() {
+    while (!d_combos.atEnd()) {
+      if (tryNext()) {
+        return true;
+      }
+    }
+    return false;
+  }
+  // tries all of the remaining valence combinations
+  void finish() {
+    while (!d_combos.atEnd()) {
+      tryNext();
+    }
+  }
+
+ private:
+  // tries the next valence combination, returns whether or not this gave a
+  // new saturated result
+  bool tryNext();
+
+  std::vector<unsigned int> d_atoms;
+  // the bonds of the subsystem and their atoms as (sorted) pairs of indices
+  // into d_atoms
+  std::vector<unsigned int> d_bonds;
+  std::vector<std::pair<unsigned int, unsigned int>> d_pairs;
+  std::vector<unsigned int> d_origValency;
+  LazyCartesianProduct<unsigned int> d_combos;
+  std::vector<SubsystemResult> d_results;
+  std::set<std::vector<unsigned int>> d_seen;
+};
+
+std::vector<std::vector<unsigned int>> selectAtoms(
+    const std::vector<std::vector<unsigned int>> &possible,
+    const std::vector<unsigned int> &atoms) {
+  std::vector<std::vector<unsigned int>> res;
+  res.reserve(atoms.size());
+  for (auto idx : atoms) {
+    res.push_back(possible[idx]);
+  }
+  return res;
+}
+
+SubsystemSearch::SubsystemSearch(
+    const RDKit::ROMol &mol, std::vector<unsigned int> atoms,
+    const std::vector<std::vector<unsigned int>> &possible,
+    const std::vector<unsigned int> &origValency)
+    : d_atoms(std::move(atoms)), d_combos(selectAtoms(possible, d_atoms)) {
+  std::unordered_map<unsigned int, unsigned int> localIdx;
+  for (unsigned int i = 0; i < d_atoms.size(); i++) {
+    localIdx[d_atoms[i]] = i;
+    d_origValency.push_back(origValency[d_atoms[i]]);
+  }
+  for (unsigned int i = 0; i < d_atoms.size(); i++) {
+    for (const auto nbr : mol.atomNeighbors(mol.getAtomWithIdx(d_atoms[i]))) {
+      auto j = localIdx.find(nbr->getIdx());
+      if (j != localIdx.end() && j->second > i) {
+        d_pairs.emplace_back(i, j->second);
+      }
+    }
+  }
+  std::sort(d_pairs.begin(), d_pairs.end());
+  for (const auto &[i, j] : d_pairs) {
+    d_bonds.push_back(
+        mol.getBondBetweenAtoms(d_atoms[i], d_atoms[j])->getIdx());
+  }
+}
+
+bool SubsystemSearch::tryNext() {
+  auto order = d_combos.next();
+  auto numAtoms = d_atoms.size();
+  std::vector<unsigned int> ordMat(d_pairs.size(), 1);
+  std::vector<unsigned int> currValency(d_origValency);
+  bool newBonds = false;
+  do {
+    newBonds = false;
+    std::vector<unsigned int> unsatPairs;
+    for (unsigned int k = 0; k < d_pairs.size(); ++k) {
+      const auto &[i, j] = d_pairs[k];
+      if (order[i] > currValency[i] && order[j] > currValency[j]) {
+        unsatPairs.push_back(k);
+      }
+    }
+    if (unsatPairs.empty()) {
+      break;
+    }
+    Graph graph(numAtoms);
+    for (auto k : unsatPairs) {
+      boost::add_edge(d_pairs[k].first, d_pairs[k].second, graph);
+    }
+    std::vector<boost::graph_traits<Graph>::vertex_descriptor> mate(numAtoms);
+    edmonds_maximum_cardinality_matching(graph, &mate[0]);
+    for (auto k : unsatPairs) {
+      const auto &[i, j] = d_pairs[k];
+      if (mate[i] == j) {
+        newBonds = true;
+        ordMat[k]++;
+        currValency[i]++;
+        currValency[j]++;
+      }
+    }
+  } while (newBonds);
+
+  SubsystemResult res;
+  res.valencyValid = true;
+  res.saturationValid = true;
+  for (unsigned int i = 0; i < numAtoms; i++) {
+    if (currValency[i] > order[i]) {
+      res.valencyValid = false;
+    } else if (currValency[i] < order[i]) {
+      res.saturationValid = false;
+    }
+  }
+  // the charges only depend on the valences, so results with the same
+  // valences are interchangeable and we keep the first one
+  auto key = currValency;
+  key.push_back(res.valencyValid);
+  key.push_back(res.saturationValid);
+  if (!d_seen.insert(std::move(key)).second) {
+    return false;
+  }
+  res.valency = std::move(currValency);
+  res.bondOrders = std::move(ordMat);
+  d_results.push_back(std::move(res));
+  return d_results.back().valencyValid && d_results.back().saturationValid;
 }
 
 }  // namespace
@@ -155,20 +379,65 @@ void connectivityHueckel(RWMol &, int) {
 
 void connectivityVdW(RWMol &mol, double covFactor) {
   auto numAtoms = mol.getNumAtoms();
-  double *distMat = MolOps::get3DDistanceMat(mol);
+  const auto &conf = mol.getConformer();
 
   std::vector<double> rcov(numAtoms);
+  double maxRcov = 0.0;
   for (unsigned int i = 0; i < numAtoms; i++) {
     rcov[i] = covFactor * PeriodicTable::getTable()->getRcovalent(
                               mol.getAtomWithIdx(i)->getAtomicNum());
+    maxRcov = std::max(maxRcov, rcov[i]);
+  }
+  if (maxRcov <= 0.0) {
+    return;
   }
+
+  // put the atoms on a grid with cells large enough that bonded atoms are
+  // always in the same or in neighboring cells
+  const double cellSize = 2 * maxRcov;
+  auto cellIndex = [cellSize](double v) {
+    return static_cast<std::int64_t>(std::floor(v / cellSize));
+  };
+  auto cellKey = [](std::int64_t x, std::int64_t y, std::int64_t z) {
+    return ((x & 0x1FFFFF) << 42) | ((y & 0x1FFFFF) << 21) | (z & 0x1FFFFF);
+  };
+  std::vector<std::int64_t> cx(numAtoms), cy(numAtoms), cz(numAtoms);
+  std::unordered_map<std::int64_t, std::vector<unsigned int>> cells;
   for (unsigned int i = 0; i < numAtoms; i++) {
-    for (unsigned int j = i + 1; j < numAtoms; j++) {
-      if (distMat[i * numAtoms + j] <= (rcov[i] + rcov[j])) {
-        mol.addBond(i, j, Bond::BondType::SINGLE);
+    const auto &pos = conf.getAtomPos(i);
+    cx[i] = cellIndex(pos.x);
+    cy[i] = cellIndex(pos.y);
+    cz[i] = cellIndex(pos.z);
+    cells[cellKey(cx[i], cy[i], cz[i])].push_back(i);
+  }
+
+  std::vector<std::pair<unsigned int, unsigned int>> bonded;
+  for (unsigned int i = 0; i < numAtoms; i++) {
+    const auto &pos = conf.getAtomPos(i);
+    for (int dx = -1; dx <= 1; dx++) {
+      for (int dy = -1; dy <= 1; dy++) {
+        for (int dz = -1; dz <= 1; dz++) {
+          auto cell = cells.find(cellKey(cx[i] + dx, cy[i] + dy, cz[i] + dz));
+          if (cell == cells.end()) {
+            continue;
+          }
+          for (auto j : cell->second) {
+            if (j > i &&
+                (pos - conf.getAtomPos(j)).length() <= (rcov[i] + rcov[j])) {
+              bonded.emplace_back(i, j);
+            }
+          }
+        }
       }
     }
   }
+  // the cell keys wrap around for very distant atoms, so the same pair can
+  // show up more than once
+  std::sort(bonded.begin(), bonded.end());
+  bonded.erase(std::unique(bonded.begin(), bonded.end()), bonded.end());
+  for (const auto &[i, j] : bonded) {
+    mol.addBond(i, j, Bond::BondType::SINGLE);
+  }
 }  // connectivityVdW()
 
 void determineConnectivity(RWMol &mol, bool useHueckel, int charge,
@@ -179,12 +448,14 @@ void determineConnectivity(RWMol &mol, bool useHueckel, int charge,
         "The RDKit was not compiled with YAeHMOP support");
   }
 #endif
-  auto numAtoms = mol.getNumAtoms();
-  for (unsigned int i = 0; i < numAtoms; i++) {
-    for (unsigned int j = i + 1; j < numAtoms; j++) {
-      mol.removeBond(i, j);
-      mol.getAtomWithIdx(i)->setNoImplicit(true);
-      mol.getAtomWithIdx(j)->setNoImplicit(true);
+  if (mol.getNumAtoms() > 1) {
+    mol.beginBatchEdit();
+    for (const auto bond : mol.bonds()) {
+      mol.removeBond(bond->getBeginAtomIdx(), bond->getEndAtomIdx());
+    }
+    mol.commitBatchEdit();
+    for (auto atom : mol.atoms()) {
+      atom->setNoImplicit(true);
     }
   }
   if (useHueckel) {
@@ -196,39 +467,6 @@ void determineConnectivity(RWMol &mol, bool useHueckel, int charge,
   }
 }  // determineConnectivity()
 
-void getUnsaturated(const std::vector<unsigned int> &order,
-                    const std::vector<unsigned int> &valency,
-                    std::vector<unsigned int> &unsat) {
-  for (unsigned int i = 0; i < order.size(); i++) {
-    if (order[i] > valency[i]) {
-      unsat.push_back(i);
-    }
-  }
-}
-
-void getUnsaturatedPairs(
-    const std::vector<std::vector<unsigned int>> &ordMat,
-    const std::vector<unsigned int> &unsat,
-    std::vector<std::pair<unsigned int, unsigned int>> &unsatPairs) {
-  for (unsigned int i = 0; i < unsat.size(); i++) {
-    for (unsigned int j = i + 1; j < unsat.size(); j++) {
-      if (ordMat[unsat[i]][unsat[j]]) {
-        unsatPairs.push_back(std::make_pair(unsat[i], unsat[j]));
-      }
-    }
-  }
-}
-
-bool checkValency(const std::vector<unsigned int> &order,
-                  const std::vector<unsigned int> &valency) {
-  for (unsigned int i = 0; i < valency.size(); i++) {
-    if (valency[i] > order[i]) {
-      return false;
-    }
-  }
-  return true;
-}
-
 int getAtomicCharge(int atom, unsigned int valence) {
   if (atom == 1) {
     return 1 - valence;
@@ -243,7 +481,7 @@ int getAtomicCharge(int atom, unsigned int valence) {
   }
 }
 
-bool checkCharge(RWMol &mol, const std::vector<unsigned int> &valency,
+bool checkCharge(const ROMol &mol, const std::vector<unsigned int> &valency,
                  int charge) {
   int molCharge = 0;
   for (unsigned int i = 0; i < mol.getNumAtoms(); i++) {
@@ -297,13 +535,6 @@ void setAtomicRadicals(RWMol &mol, const std::vector<unsigned int> &valency,
   }
 }
 
-bool checkSaturation(const std::vector<unsigned int> &order,
-                     const std::vector<unsigned int> &valency) {
-  std::vector<unsigned int> unsat;
-  getUnsaturated(order, valency, unsat);
-  return unsat.empty();
-}
-
 void setAtomMap(RWMol &mol) {
   for (unsigned int i = 0; i < mol.getNumAtoms(); i++) {
     auto atom = mol.getAtomWithIdx(i);
@@ -317,26 +548,18 @@ void setChirality(RWMol &mol) {
   MolOps::assignStereochemistryFrom3D(mol);
 }
 
-void addBondOrdering(RWMol &mol,
-                     const std::vector<std::vector<unsigned int>> &ordMat,
+void addBondOrdering(RWMol &mol, const std::vector<unsigned int> &bondOrders,
                      const std::vector<unsigned int> &valency,
                      bool allowChargedFragments, bool embedChiral,
                      bool useAtomMap, int charge) {
-  auto numAtoms = mol.getNumAtoms();
-
-  for (unsigned int i = 0; i < numAtoms; i++) {
-    for (unsigned int j = i + 1; j < numAtoms; j++) {
-      if (ordMat[i][j] == 0) {
-        continue;
-      } else if (ordMat[i][j] == 1) {
-        mol.getBondBetweenAtoms(i, j)->setBondType(Bond::BondType::SINGLE);
-      } else if (ordMat[i][j] == 2) {
-        mol.getBondBetweenAtoms(i, j)->setBondType(Bond::BondType::DOUBLE);
-      } else if (ordMat[i][j] == 3) {
-        mol.getBondBetweenAtoms(i, j)->setBondType(Bond::BondType::TRIPLE);
-      } else {
-        mol.getBondBetweenAtoms(i, j)->setBondType(Bond::BondType::SINGLE);
-      }
+  for (auto bond : mol.bonds()) {
+    auto order = bondOrders[bond->getIdx()];
+    if (order == 2) {
+      bond->setBondType(Bond::BondType::DOUBLE);
+    } else if (order == 3) {
+      bond->setBondType(Bond::BondType::TRIPLE);
+    } else {
+      bond->setBondType(Bond::BondType::SINGLE);
     }
   }
 
@@ -364,118 +587,209 @@ void addBondOrdering(RWMol &mol,
   }
 }
 
-void determineBondOrders(RWMol &mol, int charge, bool allowChargedFragments,
-                         bool embedChiral, bool useAtomMap) {
+// the xyz2mol search: returns whether or not a valid, fully saturated,
+// bond ordering was found. If not, the best partial result is returned.
+//
+// The valence combinations of each conjugated subsystem are enumerated
+// separately. The charge check needs the valences of the whole molecule
+// (checkCharge() and setAtomicCharges() assign the charges in atom order), so
+// the distinct results of the subsystems are then combined in a final pass
+// over the whole molecule.
+bool findBondOrders(const ROMol &mol, int charge,
+                    std::vector<unsigned int> &bondOrders,
+                    std::vector<unsigned int> &valency) {
   auto numAtoms = mol.getNumAtoms();
 
-  std::vector<std::vector<unsigned int>> conMat(
-      numAtoms, std::vector<unsigned int>(numAtoms, 0));
   std::vector<unsigned int> origValency(numAtoms, 0);
-  for (unsigned int i = 0; i < numAtoms; i++) {
-    for (unsigned int j = i + 1; j < numAtoms; j++) {
-      if (mol.getBondBetweenAtoms(i, j)) {
-        conMat[i][j]++;
-        origValency[i]++;
-        origValency[j]++;
-      }
-    }
+  for (const auto bond : mol.bonds()) {
+    origValency[bond->getBeginAtomIdx()]++;
+    origValency[bond->getEndAtomIdx()]++;
   }
+  const std::vector<unsigned int> singleBonds(mol.getNumBonds(), 1);
 
-  std::vector<std::vector<unsigned int>> best(conMat);
-  std::vector<unsigned int> bestValency(origValency);
+  bondOrders = singleBonds;
+  valency = origValency;
   int bestSum = std::accumulate(origValency.begin(), origValency.end(), 0);
 
-  auto valenceCombos = getValenceCombinations(mol);
-
-  bool valencyValid = false;
-  bool chargeValid = false;
-  bool saturationValid = false;
+  auto possible = getPossibleValences(mol);
+  std::vector<SubsystemSearch> searches;
+  for (auto &atoms : getConjugatedSubsystems(mol, possible)) {
+    searches.emplace_back(mol, std::move(atoms), possible, origValency);
+  }
 
-  while (!valenceCombos.atEnd()) {
-    auto order = valenceCombos.next();
-    std::vector<unsigned int> unsat;
-    getUnsaturated(order, origValency, unsat);
-    // checks whether the atomic connectivity is valid for the current set of
-    // atomic valences
-    if (unsat.empty()) {
-      valencyValid = checkValency(order, origValency);
-      chargeValid = checkCharge(mol, origValency, charge);
-      saturationValid = checkSaturation(order, origValency);
-
-      if (valencyValid && chargeValid && saturationValid) {
-        addBondOrdering(mol, conMat, origValency, allowChargedFragments,
-                        embedChiral, useAtomMap, charge);
-        return;
-      } else {
-        continue;
+  // choice has the index of a result for each subsystem
+  auto setValency = [&](const std::vector<unsigned int> &choice,
+                        std::vector<unsigned int> &currValency) {
+    currValency = origValency;
+    for (unsigned int s = 0; s < searches.size(); ++s) {
+      const auto &atoms = searches[s].getAtoms();
+      const auto &result = searches[s].getResults()[choice[s]];
+      for (unsigned int i = 0; i < atoms.size(); ++i) {
+        currValency[atoms[i]] = result.valency[i];
       }
     }
+  };
+  auto setBondOrders = [&](const std::vector<unsigned int> &choice) {
+    bondOrders = singleBonds;
+    for (unsigned int s = 0; s < searches.size(); ++s) {
+      const auto &bonds = searches[s].getBonds();
+      const auto &result = searches[s].getResults()[choice[s]];
+      for (unsigned int i = 0; i < bonds.size(); ++i) {
+        bondOrders[bonds[i]] = result.bondOrders[i];
+      }
+    }
+    setValency(choice, valency);
+  };
+
+  // most of the time the first saturated result of each subsystem works, so
+  // try that before searching all of the combinations
+  std::vector<unsigned int> choice;
+  for (auto &search : searches) {
+    if (!search.findSaturated()) {
+      break;
+    }
+    choice.push_back(search.getResults().size() - 1);
+  }
+  std::vector<unsigned int> currValency;
+  if (choice.size() == searches.size()) {
+    setValency(choice, currValency);
+    if (checkCharge(mol, currValency, charge)) {
+      setBondOrders(choice);
+      return true;
+    }
+  }
 
-    std::vector<std::vector<unsigned int>> ordMat(conMat);
-    std::vector<unsigned int> valency(origValency);
-    bool newBonds = false;
-    do {
-      newBonds = false;
-      std::vector<unsigned int> unsat;
-      getUnsaturated(order, valency, unsat);
-      std::vector<std::pair<unsigned int, unsigned int>> unsatPairs;
-      getUnsaturatedPairs(conMat, unsat, unsatPairs);
-
-      if (!unsatPairs.empty()) {
-        Graph graph(unsatPairs.begin(), unsatPairs.end(), numAtoms);
-        std::vector<boost::graph_traits<Graph>::vertex_descriptor> mate(
-            numAtoms);
-        edmonds_maximum_cardinality_matching(graph, &mate[0]);
-
-        boost::graph_traits<Graph>::vertex_iterator vi, viEnd;
-        for (boost::tie(vi, viEnd) = vertices(graph); vi != viEnd; ++vi) {
-          if (mate[*vi] != boost::graph_traits<Graph>::null_vertex() &&
-              *vi < mate[*vi]) {
-            newBonds = true;
-            ordMat[*vi][mate[*vi]]++;
-            valency[*vi]++;
-            valency[mate[*vi]]++;
-          }
-        }
+  std::vector<std::vector<unsigned int>> validResults(searches.size());
+  for (unsigned int s = 0; s < searches.size(); ++s) {
+    searches[s].finish();
+    const auto &results = searches[s].getResults();
+    for (unsigned int i = 0; i < results.size(); ++i) {
+      if (results[i].valencyValid) {
+        validResults[s].push_back(i);
       }
+    }
+  }
+  LazyCartesianProduct<unsigned int> combos(validResults);
+  std::vector<unsigned int> bestChoice;
+  bool haveBest = false;
+  while (!combos.atEnd()) {
+    choice = combos.next();
+    setValency(choice, currValency);
+    if (!checkCharge(mol, currValency, charge)) {
+      continue;
+    }
+    bool saturationValid = true;
+    for (unsigned int s = 0; s < searches.size(); ++s) {
+      saturationValid &= searches[s].getResults()[choice[s]].saturationValid;
+    }
+    if (saturationValid) {
+      setBondOrders(choice);
+      return true;
+    }
+    int sum = std::accumulate(currValency.begin(), currValency.end(), 0);
+    if (sum > bestSum) {
+      bestSum = sum;
+      bestChoice = choice;
+      haveBest = true;
+    }
+  }
+  if (haveBest) {
+    setBondOrders(bestChoice);
+  }
+  return false;
+}
 
-    } while (newBonds == true);
-
-    valencyValid = checkValency(order, valency);
-    chargeValid = checkCharge(mol, valency, charge);
-    saturationValid = checkSaturation(order, valency);
-
-    if (valencyValid && chargeValid) {
-      if (saturationValid) {
-        addBondOrdering(mol, ordMat, valency, allowChargedFragments,
-                        embedChiral, useAtomMap, charge);
-        return;
-      } else {
-        int sum = std::accumulate(valency.begin(), valency.end(), 0);
-        ;
-        if (sum > bestSum) {
-          best = ordMat;
-          bestSum = sum;
-          bestValency = valency;
-        }
+// Runs findBondOrders() separately on each fragment of the molecule. The
+// fragments are assumed to be neutral, apart from at most one which carries
+// all of the charge. Returns false if that doesn't lead to a valid bond
+// ordering for every fragment.
+bool findFragmentBondOrders(const ROMol &mol, int charge,
+                            std::vector<unsigned int> &bondOrders,
+                            std::vector<unsigned int> &valency,
+                            int numThreads) {
+  std::vector<std::vector<int>> fragAtoms;
+  const bool sanitizeFrags = false;
+  const bool copyConformers = false;
+  auto frags = MolOps::getMolFrags(mol, sanitizeFrags, nullptr, &fragAtoms,
+                                   copyConformers);
+  if (frags.size() < 2) {
+    return false;
+  }
+
+  std::vector<std::vector<unsigned int>> fragBondOrders(frags.size());
+  std::vector<std::vector<unsigned int>> fragValency(frags.size());
+  std::vector<int> fragCharges(frags.size(), 0);
+  std::vector<char> fragValid(frags.size(), 0);
+  auto func = [&](size_t i) {
+    fragValid[i] = findBondOrders(*frags[i], fragCharges[i], fragBondOrders[i],
+                                  fragValency[i]);
+  };
+
+  runOnIndices(func, frags.size(), numThreads);
+
+  auto numInvalid = std::count(fragValid.begin(), fragValid.end(), 0);
+  if (numInvalid > 1 || (numInvalid == 1 && !charge)) {
+    return false;
+  }
+  if (charge) {
+    // put the charge on the fragment that couldn't be made neutral, or try
+    // them all if every fragment could
+    bool found = false;
+    for (size_t i = 0; i < frags.size() && !found; ++i) {
+      if (numInvalid && fragValid[i]) {
+        continue;
+      }
+      std::vector<unsigned int> chargedBondOrders, chargedValency;
+      if (findBondOrders(*frags[i], charge, chargedBondOrders,
+                         chargedValency)) {
+        fragBondOrders[i] = std::move(chargedBondOrders);
+        fragValency[i] = std::move(chargedValency);
+        found = true;
       }
     }
+    if (!found) {
+      return false;
+    }
+  }
+
+  bondOrders.assign(mol.getNumBonds(), 1);
+  valency.assign(mol.getNumAtoms(), 0);
+  for (size_t i = 0; i < frags.size(); ++i) {
+    const auto &atomMap = fragAtoms[i];
+    for (unsigned int j = 0; j < atomMap.size(); ++j) {
+      valency[atomMap[j]] = fragValency[i][j];
+    }
+    for (const auto bond : frags[i]->bonds()) {
+      auto origBond = mol.getBondBetweenAtoms(
+          atomMap[bond->getBeginAtomIdx()], atomMap[bond->getEndAtomIdx()]);
+      bondOrders[origBond->getIdx()] = fragBondOrders[i][bond->getIdx()];
+    }
   }
+  // the charges are assigned in atom order across the whole molecule, make
+  // sure that still works out
+  return checkCharge(mol, valency, charge);
+}
 
-  addBondOrdering(mol, best, bestValency, allowChargedFragments, embedChiral,
+void determineBondOrders(RWMol &mol, int charge, bool allowChargedFragments,
+                         bool embedChiral, bool useAtomMap, int numThreads) {
+  std::vector<unsigned int> bondOrders;
+  std::vector<unsigned int> valency;
+  if (!findFragmentBondOrders(mol, charge, bondOrders, valency, numThreads)) {
+    findBondOrders(mol, charge, bondOrders, valency);
+  }
+  addBondOrdering(mol, bondOrders, valency, allowChargedFragments, embedChiral,
                   useAtomMap, charge);
-  return;
 }  // determineBondOrdering()
 
 void determineBonds(RWMol &mol, bool useHueckel, int charge, double covFactor,
                     bool allowChargedFragments, bool embedChiral,
-                    bool useAtomMap, bool useVdw) {
+                    bool useAtomMap, bool useVdw, int numThreads) {
   if (mol.getNumAtoms() <= 1) {
     return;
   }
   determineConnectivity(mol, useHueckel, charge, covFactor, useVdw);
   determineBondOrders(mol, charge, allowChargedFragments, embedChiral,
-                      useAtomMap);
+                      useAtomMap, numThreads);
 }  // determineBonds()
 
 }  // namespace RDKit
@@ -56,10 +56,25 @@ RDKIT_DETERMINEBONDS_EXPORT void determineConnectivity(RWMol &mol,
    sanitizeMol() when this is true
    \param useAtomMap (optional) if this is \c
    true, an atom map will be created for the molecule
+   \param numThreads (optional) the number of threads used to assign bond
+   orders to the fragments of the molecule; values <= 0 are interpreted as in
+   getNumThreadsToUse()
+
+   If the molecule has more than one fragment, the fragments are first handled
+   separately, with all but at most one of them neutral. The whole molecule is
+   only searched at once if that doesn't work.
+
+   The valences of the atoms in each conjugated subsystem (a group of
+   connected atoms which can take multiple bonds) are enumerated separately,
+   and only the distinct results of the subsystems are combined to check the
+   charge of the whole molecule. The search still grows exponentially with the
+   size of the largest conjugated subsystem, and the final check can take a
+   while for molecules with many subsystems which have several possible
+   charge states.
  */
 RDKIT_DETERMINEBONDS_EXPORT void determineBondOrders(
     RWMol &mol, int charge = 0, bool allowChargedFragments = true,
-    bool embedChiral = true, bool useAtomMap = false);
+    bool embedChiral = true, bool useAtomMap = false, int numThreads = 1);
 
 // ! assigns atomic connectivity to a molecule using atomic coordinates,
 // disregarding pre-existing bonds; it is recommended to sanitize the molecule
@@ -86,11 +101,13 @@ RDKIT_DETERMINEBONDS_EXPORT void determineBondOrders(
    for the molecule
    \param useVdw (optional) if this is  \c false, the connect-the-dots method
     will be used instead of the van der Waals method
+   \param numThreads (optional) the number of threads used to assign bond
+   orders, see determineBondOrders()
  */
 RDKIT_DETERMINEBONDS_EXPORT void determineBonds(
     RWMol &mol, bool useHueckel = false, int charge = 0, double covFactor = 1.3,
     bool allowChargedFragments = true, bool embedChiral = true,
-    bool useAtomMap = false, bool useVdw = false);
+    bool useAtomMap = false, bool useVdw = false, int numThreads = 1);
 
 }  // namespace RDKit
 
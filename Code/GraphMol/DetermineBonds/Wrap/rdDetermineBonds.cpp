@@ -25,17 +25,18 @@ void determineConnectivityHelper(ROMol &mol, bool useHueckel, int charge,
 }
 void determineBondOrdersHelper(ROMol &mol, int charge,
                                bool allowChargedFragments, bool embedChiral,
-                               bool useAtomMap) {
+                               bool useAtomMap, int numThreads) {
   auto &wmol = static_cast<RWMol &>(mol);
   determineBondOrders(wmol, charge, allowChargedFragments, embedChiral,
-                      useAtomMap);
+                      useAtomMap, numThreads);
 }
 void determineBondsHelper(ROMol &mol, bool useHueckel, int charge,
                           double covFactor, bool allowChargedFragments,
-                          bool embedChiral, bool useAtomMap, bool useVdw) {
+                          bool embedChiral, bool useAtomMap, bool useVdw,
+                          int numThreads) {
   auto &wmol = static_cast<RWMol &>(mol);
   determineBonds(wmol, useHueckel, charge, covFactor, allowChargedFragments,
-                 embedChiral, useAtomMap, useVdw);
+                 embedChiral, useAtomMap, useVdw, numThreads);
 }
 bool hueckelSupportEnabled() {
 #ifdef RDK_BUILD_YAEHMOP_SUPPORT
@@ -89,12 +90,15 @@ Args:
       sanitizeMol() when this is true
    useAtomMap : (optional) if this is true, an atom map will be created for the 
       molecule
+   numThreads : (optional) the number of threads used to assign bond orders
+      to the fragments of the molecule
 )DOC";
   python::def(
       "DetermineBondOrders", &determineBondOrdersHelper,
       (python::arg("mol"), python::arg("charge") = 0,
        python::arg("allowChargedFragments") = true,
-       python::arg("embedChiral") = true, python::arg("useAtomMap") = false),
+       python::arg("embedChiral") = true, python::arg("useAtomMap") = false,
+       python::arg("numThreads") = 1),
       docs.c_str());
 
   docs =
@@ -120,6 +124,8 @@ Args:
       molecule
    useVdw: (optional) if this is false, the connect-the-dots method
        will be used instead of the van der Waals method
+   numThreads : (optional) the number of threads used to assign bond orders
+      to the fragments of the molecule
 )DOC";
   python::def(
       "DetermineBonds", &determineBondsHelper,
@@ -127,7 +133,7 @@ Args:
        python::arg("charge") = 0, python::arg("covFactor") = 1.3,
        python ::arg("allowChargedFragments") = true,
        python::arg("embedChiral") = true, python::arg("useAtomMap") = false,
-       python::arg("useVdw") = false),
+       python::arg("useVdw") = false, python::arg("numThreads") = 1),
       docs.c_str());
   python::def("hueckelEnabled", &hueckelSupportEnabled,
               "whether or not the RDKit was compiled with YAeHMOP support");
@@ -11,6 +11,8 @@
 #include <iostream>
 #include <fstream>
 #include <GraphMol/Resonance.h>
+#include <GraphMol/DistGeomHelpers/Embedder.h>
+#include <chrono>
 
 using namespace RDKit;
 
@@ -476,4 +478,117 @@ TEST_CASE(
       }
     }
   }
-}
\ No newline at end of file
+}
+namespace {
+// a box of n x n x n water molecules, with the box centered on the origin
+std::unique_ptr<RWMol> waterBox(unsigned int n) {
+  std::unique_ptr<RWMol> res(new RWMol());
+  auto conf = new Conformer();
+  const double spacing = 3.1;
+  const std::vector<RDGeom::Point3D> water = {
+      {0.0, 0.0, 0.0}, {0.9572, 0.0, 0.0}, {-0.2399, 0.9266, 0.0}};
+  for (unsigned int i = 0; i < n; ++i) {
+    for (unsigned int j = 0; j < n; ++j) {
+      for (unsigned int k = 0; k < n; ++k) {
+        RDGeom::Point3D offset((i - n / 2.0) * spacing, (j - n / 2.0) * spacing,
+                               (k - n / 2.0) * spacing);
+        for (unsigned int a = 0; a < water.size(); ++a) {
+          auto idx = res->addAtom(new Atom(a ? 1 : 8), false, true);
+          conf->resize(idx + 1);
+          conf->setAtomPos(idx, water[a] + offset);
+        }
+      }
+    }
+  }
+  res->addConformer(conf, true);
+  return res;
+}
+}  // namespace
+
+TEST_CASE("large systems") {
+  SECTION("van der Waals connectivity") {
+    auto mol = waterBox(8);
+    determineConnectivity(*mol, false, 0, 1.3, true);
+    CHECK(mol->getNumBonds() == 2 * 8 * 8 * 8);
+    for (const auto bond : mol->bonds()) {
+      CHECK(bond->getBeginAtom()->getAtomicNum() == 8);
+      CHECK(bond->getEndAtom()->getAtomicNum() == 1);
+      CHECK(bond->getEndAtomIdx() - bond->getBeginAtomIdx() <= 2);
+    }
+  }
+  SECTION("bond orders for many fragments") {
+    auto mol = waterBox(6);
+    for (auto numThreads : {1, 4}) {
+      RWMol cp(*mol);
+      determineBonds(cp, false, 0, 1.3, true, true, false, false, numThreads);
+      CHECK(cp.getNumBonds() == 2 * 6 * 6 * 6);
+      for (const auto bond : cp.bonds()) {
+        CHECK(bond->getBondType() == Bond::BondType::SINGLE);
+      }
+      CHECK(MolOps::getFormalCharge(cp) == 0);
+    }
+  }
+  SECTION("charged fragments") {
+    auto m = "CC(=O)[O-].O.c1ccccc1"_smiles;
+    REQUIRE(m);
+    SmilesWriteParams params = {false, false, true, false, false, false, -1};
+    auto expected = MolToSmiles(*m, params);
+    MolOps::addHs(*m);
+    REQUIRE(DGeomHelpers::EmbedMolecule(*m, 0, 0xf00d) == 0);
+    for (auto numThreads : {1, 4}) {
+      RWMol cp(*m);
+      for (auto atom : cp.atoms()) {
+        atom->setFormalCharge(0);
+        atom->setIsAromatic(false);
+      }
+      determineBonds(cp, false, -1, 1.3, true, true, false, false, numThreads);
+      MolOps::removeAllHs(cp, false);
+      MolOps::setAromaticity(cp);
+      CHECK(MolToSmiles(cp, params) == expected);
+    }
+  }
+  SECTION("separate conjugated subsystems") {
+    // each peptide bond and the carboxylate are separate subsystems
+    auto m =
+        "NCC(=O)NCC(=O)NCC(=O)NCC(=O)NCC(=O)NCC(=O)NCC(=O)NCC(=O)[O-]"_smiles;
+    REQUIRE(m);
+    SmilesWriteParams params = {false, false, true, false, false, false, -1};
+    auto expected = MolToSmiles(*m, params);
+    MolOps::addHs(*m);
+    REQUIRE(DGeomHelpers::EmbedMolecule(*m, 0, 0xf00d) == 0);
+    RWMol cp(*m);
+    for (auto atom : cp.atoms()) {
+      atom->setFormalCharge(0);
+    }
+    determineBonds(cp, false, -1);
+    MolOps::removeAllHs(cp, false);
+    CHECK(MolToSmiles(cp, params) == expected);
+  }
+}
+
+TEST_CASE("DetermineBonds benchmark", "[.][benchmark]") {
+  auto mol = waterBox(20);
+  auto report = [&mol](const std::string &label, const auto &t1) {
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "TIMING : " << label << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << mol->getNumAtoms() << " atoms"
+              << std::endl;
+  };
+  for (auto useVdw : {false, true}) {
+    RWMol cp(*mol);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    determineConnectivity(cp, false, 0, 1.3, useVdw);
+    report(useVdw ? "determineConnectivity vdW" : "determineConnectivity", t1);
+    CHECK(cp.getNumBonds() == 2 * 20 * 20 * 20);
+  }
+  for (auto numThreads : {1, -1}) {
+    RWMol cp(*mol);
+    determineConnectivity(cp);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    determineBondOrders(cp, 0, true, false, false, numThreads);
+    report("determineBondOrders numThreads=" + std::to_string(numThreads),
+           t1);
+  }
+}
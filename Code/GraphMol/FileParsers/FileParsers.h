@@ -368,6 +368,12 @@ struct RDKIT_FILEPARSERS_EXPORT PDBParserParams {
   bool proximityBonding = true; /**< if set to true, proximity bonding will be
                                    performed */
   unsigned int flavor = 0;      /**< flavor to use */
+  int numThreads = 1; /**< number of threads used to parse the atom records and
+                         to find proximity bonds. If this is <= 0, the number
+                         of hardware threads plus this value is used. */
+  bool buildResidueTable =
+      false; /**< store the residue info of the atoms in a PDBResidueTable,
+                see ROMol::buildPDBResidueTable() */
 };
 
 RDKIT_FILEPARSERS_EXPORT std::unique_ptr<RWMol> MolFromPDBDataStream(
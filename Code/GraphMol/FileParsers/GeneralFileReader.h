@@ -10,17 +10,22 @@
 #ifndef GENERAL_FILE_READER_H
 #define GENERAL_FILE_READER_H
 #include <RDGeneral/BadFileException.h>
+#include <RDStreams/bgzf.h>
 #include <RDStreams/streams.h>
 
 #include <boost/algorithm/string.hpp>
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "MolSupplier.h"
+#include "MultithreadedMaeMolSupplier.h"
+#include "MultithreadedPDBMolSupplier.h"
 #include "MultithreadedSDMolSupplier.h"
 #include "MultithreadedSmilesMolSupplier.h"
+#include "MultithreadedTDTMolSupplier.h"
 
 namespace RDKit {
 namespace GeneralMolSupplier {
@@ -39,13 +44,27 @@ struct SupplierOptions {
   int confId2D = -1;
   int confId3D = 0;
 
+  unsigned int pdbFlavor = 0;
+  bool proximityBonding = true;
+
+  //! if this is > 0, the multithreaded suppliers are used
   unsigned int numWriterThreads = 0;
+  //! the number of threads used to decompress BGZF (block gzip) files,
+  //! if this is 0 numWriterThreads is used
+  unsigned int numDecompressionThreads = 0;
 };
 //! current supported file formats
+//! PDB files need the multithreaded supplier, so they are only supported if
+//! the RDKit is built with thread support
 const std::vector<std::string> supportedFileFormats{
-    "sdf", "mae", "maegz", "sdfgz", "smi", "csv", "txt", "tsv", "tdt"};
+    "sdf", "mae", "maegz", "sdfgz", "smi", "csv", "txt", "tsv", "tdt",
+#ifdef RDK_BUILD_THREADSAFE_SSS
+    "pdb"
+#endif
+};
 //! current supported compression formats
-const std::vector<std::string> supportedCompressionFormats{"gz"};
+//! BGZF files can have either a .gz or a .bgz extension
+const std::vector<std::string> supportedCompressionFormats{"gz", "bgz"};
 
 //! given file path determines the file and compression format
 //! returns true on success, otherwise false
@@ -68,6 +87,9 @@ void determineFormat(const std::string path, std::string& fileFormat,
   } else if (boost::algorithm::iends_with(path, ".gz")) {
     compressionFormat = "gz";
     basename = path.substr(0, path.size() - 3);
+  } else if (boost::algorithm::iends_with(path, ".bgz")) {
+    compressionFormat = "bgz";
+    basename = path.substr(0, path.size() - 4);
   } else if (boost::algorithm::iends_with(path, ".zst") ||
              boost::algorithm::iends_with(path, ".bz2") ||
              boost::algorithm::iends_with(path, ".7z")) {
@@ -107,7 +129,15 @@ std::unique_ptr<MolSupplier> getSupplier(const std::string& path,
     strm = new std::ifstream(path.c_str(), std::ios::in | std::ios::binary);
   } else {
 #ifdef RDK_USE_BOOST_IOSTREAMS
-    strm = new gzstream(path);
+    //! BGZF files can be decompressed in parallel
+    if (compressionFormat == "bgz" || isBGZFFile(path)) {
+      unsigned int numThreads = opt.numDecompressionThreads
+                                    ? opt.numDecompressionThreads
+                                    : opt.numWriterThreads;
+      strm = new bgzfstream(path, static_cast<int>(std::max(1u, numThreads)));
+    } else {
+      strm = new gzstream(path);
+    }
 #else
     throw BadFileException(
         "compressed files are only supported if the RDKit is built with boost::iostreams support");
@@ -151,6 +181,14 @@ std::unique_ptr<MolSupplier> getSupplier(const std::string& path,
   }
 #ifdef RDK_BUILD_MAEPARSER_SUPPORT
   else if (fileFormat == "mae") {
+#ifdef RDK_BUILD_THREADSAFE_SSS
+    if (opt.numWriterThreads > 0) {
+      MultithreadedMaeMolSupplier* maesup = new MultithreadedMaeMolSupplier(
+          strm, true, opt.sanitize, opt.removeHs, opt.numWriterThreads);
+      std::unique_ptr<MolSupplier> p(maesup);
+      return p;
+    }
+#endif
     MaeMolSupplier* maesup =
         new MaeMolSupplier(strm, true, opt.sanitize, opt.removeHs);
     std::unique_ptr<MolSupplier> p(maesup);
@@ -158,11 +196,30 @@ std::unique_ptr<MolSupplier> getSupplier(const std::string& path,
   }
 #endif
   else if (fileFormat == "tdt") {
+#ifdef RDK_BUILD_THREADSAFE_SSS
+    if (opt.numWriterThreads > 0) {
+      MultithreadedTDTMolSupplier* tdtsup = new MultithreadedTDTMolSupplier(
+          strm, true, opt.nameRecord, opt.confId2D, opt.confId3D,
+          opt.sanitize, opt.numWriterThreads);
+      std::unique_ptr<MolSupplier> p(tdtsup);
+      return p;
+    }
+#endif
     TDTMolSupplier* tdtsup = new TDTMolSupplier(
         strm, true, opt.nameRecord, opt.confId2D, opt.confId3D, opt.sanitize);
     std::unique_ptr<MolSupplier> p(tdtsup);
     return p;
   }
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  else if (fileFormat == "pdb") {
+    //! there's no single threaded supplier for PDB files
+    MultithreadedPDBMolSupplier* pdbsup = new MultithreadedPDBMolSupplier(
+        strm, true, opt.sanitize, opt.removeHs, opt.pdbFlavor,
+        opt.proximityBonding, std::max(1u, opt.numWriterThreads));
+    std::unique_ptr<MolSupplier> p(pdbsup);
+    return p;
+  }
+#endif
   throw BadFileException("Unsupported file format: " + fileFormat);
 }
 
@@ -51,6 +51,44 @@ using std::smatch;
 
 namespace RDKit {
 
+namespace {
+// like atof(), but never reads past the end of the view and always uses
+// "." as the decimal separator
+double viewToDouble(std::string_view txt) {
+  size_t start = 0;
+  while (start < txt.size() && (txt[start] == ' ' || txt[start] == '\t')) {
+    ++start;
+  }
+  if (start < txt.size() && txt[start] == '+') {
+    ++start;
+  }
+  txt.remove_prefix(start);
+  double res = 0.0;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+  std::from_chars(txt.data(), txt.data() + txt.size(), res);
+#else
+  // from_chars() for doubles isn't available, copy to a null-terminated
+  // buffer on the stack to avoid an allocation
+  char buf[64];
+  auto sz = std::min(txt.size(), sizeof(buf) - 1);
+  std::copy_n(txt.data(), sz, buf);
+  buf[sz] = '\0';
+  res = strtod(buf, nullptr);
+#endif
+  return res;
+}
+
+// like atoi(), but never reads past the end of the view
+int viewToInt(std::string_view txt) {
+  if (!txt.empty() && txt.front() == '+') {
+    txt.remove_prefix(1);
+  }
+  int res = 0;
+  std::from_chars(txt.data(), txt.data() + txt.size(), res);
+  return res;
+}
+}  // namespace
+
 namespace FileParserUtils {
 
 int toInt(const std::string_view input, bool acceptSpaces) {
@@ -86,7 +124,7 @@ int toInt(const std::string_view input, bool acceptSpaces) {
   return res;
 }
 int toInt(const std::string &input, bool acceptSpaces) {
-  return toInt(std::string_view(input.c_str()), acceptSpaces);
+  return toInt(std::string_view(input), acceptSpaces);
 }
 unsigned int toUnsigned(const std::string_view input, bool acceptSpaces) {
   // don't need to worry about locale stuff here because
@@ -120,7 +158,7 @@ unsigned int toUnsigned(const std::string_view input, bool acceptSpaces) {
   return res;
 }
 unsigned int toUnsigned(const std::string &input, bool acceptSpaces) {
-  return toUnsigned(std::string_view(input.c_str()), acceptSpaces);
+  return toUnsigned(std::string_view(input), acceptSpaces);
 }
 double toDouble(const std::string_view input, bool acceptSpaces) {
   // sanity check on the input since strtol doesn't do it for us:
@@ -134,14 +172,14 @@ double toDouble(const std::string_view input, bool acceptSpaces) {
       throw boost::bad_lexical_cast();
     }
   }
-  // unfortunately from_chars() with doubles didn't work on g++ until v11.1
-  // and the status with clang is hard to figure out... we remain old-school
-  // remove leading spaces
+  // this intentionally keeps reading past the end of the view: V2000
+  // coordinates which overflow their 10 character field are found in the
+  // wild and are parsed correctly this way
   double res = atof(input.data());
   return res;
 }
 double toDouble(const std::string &input, bool acceptSpaces) {
-  return toDouble(std::string_view(input.c_str()), acceptSpaces);
+  return toDouble(std::string_view(input), acceptSpaces);
 }
 std::string getV3000Line(std::istream *inStream, unsigned int &line) {
   // FIX: technically V3K blocks are case-insensitive. We should really be
@@ -156,6 +194,11 @@ std::string getV3000Line(std::istream *inStream, unsigned int &line) {
     errout << "Line " << line << " does not start with 'M  V30 '" << std::endl;
     throw FileParseException(errout.str());
   }
+  if (tempStr.back() != '-') {
+    // the usual case, no continuation lines: strip the prefix in place
+    inl.erase(0, 7);
+    return inl;
+  }
   // FIX: do we need to handle trailing whitespace after a -?
   while (tempStr.back() == '-') {
     // continuation character, append what we read:
@@ -1820,9 +1863,10 @@ void ParseMolBlockAtoms(std::istream *inStream, unsigned int &line,
   PRECONDITION(inStream, "bad stream");
   PRECONDITION(mol, "bad molecule");
   PRECONDITION(conf, "bad conformer");
+  std::string tempStr;
   for (unsigned int i = 1; i <= nAtoms; ++i) {
     ++line;
-    std::string tempStr = getLine(inStream);
+    getLine(inStream, tempStr);
     if (inStream->eof()) {
       throw FileParseException("EOF hit while reading atoms");
     }
@@ -1839,9 +1883,10 @@ void ParseMolBlockBonds(std::istream *inStream, unsigned int &line,
                         bool &chiralityPossible) {
   PRECONDITION(inStream, "bad stream");
   PRECONDITION(mol, "bad molecule");
+  std::string tempStr;
   for (unsigned int i = 1; i <= nBonds; ++i) {
     ++line;
-    std::string tempStr = getLine(inStream);
+    getLine(inStream, tempStr);
     if (inStream->eof()) {
       throw FileParseException("EOF hit while reading bonds");
     }
@@ -2481,7 +2526,6 @@ void ParseV3000AtomBlock(std::istream *inStream, unsigned int &line,
   PRECONDITION(nAtoms > 0, "bad atom count");
   PRECONDITION(mol, "bad molecule");
   PRECONDITION(conf, "bad conformer");
-  std::vector<std::string> splitLine;
 
   auto inl = getV3000Line(inStream, line);
   std::string_view tempStr = inl;
@@ -2490,12 +2534,12 @@ void ParseV3000AtomBlock(std::istream *inStream, unsigned int &line,
     errout << "BEGIN ATOM line not found on line " << line;
     throw FileParseException(errout.str());
   }
+  std::vector<std::string_view> tokens;
   for (unsigned int i = 0; i < nAtoms; ++i) {
     inl = getV3000Line(inStream, line);
     tempStr = inl;
     auto trimmed = FileParserUtils::strip(tempStr);
 
-    std::vector<std::string_view> tokens;
     std::vector<std::string_view>::iterator token;
 
     tokenizeV3000Line(trimmed, tokens);
@@ -2528,7 +2572,7 @@ void ParseV3000AtomBlock(std::istream *inStream, unsigned int &line,
       throw FileParseException(errout.str());
     }
 
-    pos.x = atof(std::string(*token).c_str());
+    pos.x = viewToDouble(*token);
     ++token;
     if (token == tokens.end()) {
       delete atom;
@@ -2536,7 +2580,7 @@ void ParseV3000AtomBlock(std::istream *inStream, unsigned int &line,
       errout << "Bad atom line : '" << tempStr << "' on line " << line;
       throw FileParseException(errout.str());
     }
-    pos.y = atof(std::string(*token).c_str());
+    pos.y = viewToDouble(*token);
     ++token;
     if (token == tokens.end()) {
       delete atom;
@@ -2544,7 +2588,7 @@ void ParseV3000AtomBlock(std::istream *inStream, unsigned int &line,
       errout << "Bad atom line : '" << tempStr << "' on line " << line;
       throw FileParseException(errout.str());
     }
-    pos.z = atof(std::string(*token).c_str());
+    pos.z = viewToDouble(*token);
     // the map number:
     ++token;
     if (token == tokens.end()) {
@@ -2553,7 +2597,7 @@ void ParseV3000AtomBlock(std::istream *inStream, unsigned int &line,
       errout << "Bad atom line : '" << tempStr << "' on line " << line;
       throw FileParseException(errout.str());
     }
-    int mapNum = atoi(std::string(*token).c_str());
+    int mapNum = viewToInt(*token);
     if (mapNum > 0) {
       atom->setProp(common_properties::molAtomMapNumber, mapNum);
     }
@@ -2589,11 +2633,11 @@ void ParseV3000BondBlock(std::istream *inStream, unsigned int &line,
   if (tempStr.length() < 10 || tempStr.substr(0, 10) != "BEGIN BOND") {
     throw FileParseException("BEGIN BOND line not found");
   }
+  std::vector<std::string_view> splitLine;
   for (unsigned int i = 0; i < nBonds; ++i) {
     inl = getV3000Line(inStream, line);
     tempStr = inl;
     tempStr = FileParserUtils::strip(tempStr);
-    std::vector<std::string_view> splitLine;
     tokenizeV3000Line(tempStr, splitLine);
     if (splitLine.size() < 4) {
       std::ostringstream errout;
@@ -3601,7 +3645,7 @@ std::unique_ptr<RWMol> MolFromMolDataStream(std::istream &inStream,
 //------------------------------------------------
 std::unique_ptr<RWMol> MolFromMolBlock(const std::string &molBlock,
                                        const MolFileParserParams &params) {
-  std::istringstream inStream(molBlock);
+  StringViewInStream inStream(molBlock);
   unsigned int line = 0;
   return MolFromMolDataStream(inStream, line, params);
 }
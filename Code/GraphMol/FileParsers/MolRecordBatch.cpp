@@ -0,0 +1,842 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "MolRecordBatch.h"
+
+#include <GraphMol/MolPickler.h>
+#include <GraphMol/SmilesParse/SmilesParse.h>
+#include <GraphMol/SmilesParse/SmilesWrite.h>
+#include <RDGeneral/BadFileException.h>
+#include <RDGeneral/Exceptions.h>
+#include <RDGeneral/FileParseException.h>
+#include <RDGeneral/StreamOps.h>
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace RDKit {
+namespace {
+const char fileMagic[] = "RDKRB";  // the terminating null is written too
+const std::uint32_t fileVersion = 1;
+
+using ColumnType = MolRecordBatch::ColumnType;
+
+void appendValidity(MolRecordBatch::Column &col, size_t row, bool valid) {
+  if (row % 8 == 0) {
+    col.validity.push_back(0);
+  }
+  if (valid) {
+    col.validity[row / 8] |= static_cast<std::uint8_t>(1u << (row % 8));
+  }
+}
+
+void appendBytes(MolRecordBatch::Column &col, std::string_view bytes) {
+  if (col.data.size() + bytes.size() >
+      static_cast<size_t>(std::numeric_limits<std::int32_t>::max())) {
+    throw ValueErrorException("too much data for a single MolRecordBatch");
+  }
+  col.data.insert(col.data.end(), bytes.begin(), bytes.end());
+  col.offsets.push_back(static_cast<std::int32_t>(col.data.size()));
+}
+
+template <typename T>
+void appendLittleEndian(std::vector<std::uint8_t> &data, T val) {
+  val = EndianSwapBytes<HOST_ENDIAN_ORDER, LITTLE_ENDIAN_ORDER>(val);
+  auto sz = data.size();
+  data.resize(sz + sizeof(T));
+  std::memcpy(data.data() + sz, &val, sizeof(T));
+}
+
+template <typename T>
+T readLittleEndian(const std::vector<std::uint8_t> &data, size_t idx) {
+  PRECONDITION((idx + 1) * sizeof(T) <= data.size(), "bad index");
+  T val;
+  std::memcpy(&val, data.data() + idx * sizeof(T), sizeof(T));
+  return EndianSwapBytes<LITTLE_ENDIAN_ORDER, HOST_ENDIAN_ORDER>(val);
+}
+
+void writeBuffer(std::ostream &ss, const std::vector<std::uint8_t> &buffer) {
+  streamWrite(ss, static_cast<std::uint64_t>(buffer.size()));
+  ss.write(reinterpret_cast<const char *>(buffer.data()), buffer.size());
+}
+
+// returns the number of bytes left in the stream, or the largest possible
+// value if the stream can't seek
+std::uint64_t remainingBytes(std::istream &ss) {
+  auto pos = ss.tellg();
+  if (pos < 0) {
+    ss.clear();
+    return std::numeric_limits<std::uint64_t>::max();
+  }
+  ss.seekg(0, std::ios_base::end);
+  auto end = ss.tellg();
+  ss.clear();
+  ss.seekg(pos);
+  if (end < pos) {
+    return std::numeric_limits<std::uint64_t>::max();
+  }
+  return static_cast<std::uint64_t>(end - pos);
+}
+
+// resizes a buffer that is about to be filled with nElements elements of
+// elementSize bytes from the stream, without trusting nElements
+template <typename T>
+void resizeForRead(std::istream &ss, std::vector<T> &buffer,
+                   std::uint64_t nElements) {
+  if (nElements > remainingBytes(ss) / sizeof(T)) {
+    throw FileParseException("buffer size in MolRecordBatch exceeds the input");
+  }
+  try {
+    buffer.resize(nElements);
+  } catch (const std::bad_alloc &) {
+    throw FileParseException("buffer size in MolRecordBatch is too large");
+  } catch (const std::length_error &) {
+    throw FileParseException("buffer size in MolRecordBatch is too large");
+  }
+}
+
+void readBuffer(std::istream &ss, std::vector<std::uint8_t> &buffer) {
+  std::uint64_t sz;
+  streamRead(ss, sz);
+  resizeForRead(ss, buffer, sz);
+  ss.read(reinterpret_cast<char *>(buffer.data()), sz);
+  if (ss.fail()) {
+    throw std::runtime_error("failed to read from stream");
+  }
+}
+
+void writeOffsets(std::ostream &ss, const std::vector<std::int32_t> &offsets) {
+  streamWrite(ss, static_cast<std::uint64_t>(offsets.size()));
+  if (HOST_ENDIAN_ORDER == LITTLE_ENDIAN_ORDER) {
+    ss.write(reinterpret_cast<const char *>(offsets.data()),
+             offsets.size() * sizeof(std::int32_t));
+  } else {
+    for (auto offset : offsets) {
+      streamWrite(ss, offset);
+    }
+  }
+}
+
+void readOffsets(std::istream &ss, std::vector<std::int32_t> &offsets) {
+  std::uint64_t sz;
+  streamRead(ss, sz);
+  resizeForRead(ss, offsets, sz);
+  if (HOST_ENDIAN_ORDER == LITTLE_ENDIAN_ORDER) {
+    ss.read(reinterpret_cast<char *>(offsets.data()),
+            sz * sizeof(std::int32_t));
+    if (ss.fail()) {
+      throw std::runtime_error("failed to read from stream");
+    }
+  } else {
+    for (auto &offset : offsets) {
+      streamRead(ss, offset);
+    }
+  }
+}
+
+// makes sure that the accessors of a column read from a stream stay within
+// its buffers
+void checkColumn(const MolRecordBatch::Column &col, std::uint64_t numRows) {
+  const auto error = [&col]() {
+    return FileParseException("inconsistent sizes in MolRecordBatch column " +
+                              col.name);
+  };
+  // these are written to avoid overflows with bogus row counts
+  const auto bitmapSize = numRows / 8 + (numRows % 8 != 0);
+  if (col.validity.size() != bitmapSize) {
+    throw error();
+  }
+  switch (col.type) {
+    case ColumnType::Int64:
+    case ColumnType::Double:
+      if (col.data.size() / 8 != numRows || col.data.size() % 8) {
+        throw error();
+      }
+      break;
+    case ColumnType::Bool:
+      if (col.data.size() != bitmapSize) {
+        throw error();
+      }
+      break;
+    case ColumnType::String:
+    case ColumnType::Binary:
+      if (col.offsets.empty() || col.offsets.size() - 1 != numRows ||
+          col.offsets[0] < 0) {
+        throw error();
+      }
+      for (size_t i = 1; i < col.offsets.size(); ++i) {
+        if (col.offsets[i] < col.offsets[i - 1]) {
+          throw error();
+        }
+      }
+      if (static_cast<size_t>(col.offsets.back()) > col.data.size()) {
+        throw error();
+      }
+      break;
+    case ColumnType::Bits: {
+      const size_t nBytes = (static_cast<size_t>(col.width) + 7) / 8;
+      if (nBytes ? (col.data.size() % nBytes ||
+                    col.data.size() / nBytes != numRows)
+                 : !col.data.empty()) {
+        throw error();
+      }
+    } break;
+  }
+}
+
+const RDValue *findProp(const ROMol &mol, const std::string &name) {
+  for (const auto &pr : mol.getDict().getData()) {
+    if (pr.key == name) {
+      return &pr.val;
+    }
+  }
+  return nullptr;
+}
+
+std::string numberToString(RDValue val) {
+  std::string res;
+  rdvalue_tostring(val, res);
+  return res;
+}
+}  // namespace
+
+namespace detail {
+struct PropColumnBuilder {
+  std::string name;
+  ColumnType type = ColumnType::Int64;
+  bool typeSet = false;
+  std::vector<bool> valid;
+  // only the vector for the current type is used, Bool columns use ints
+  std::vector<std::int64_t> ints;
+  std::vector<double> doubles;
+  std::vector<std::string> strings;
+
+  void addNull() {
+    valid.push_back(false);
+    switch (type) {
+      case ColumnType::Double:
+        doubles.push_back(0.0);
+        break;
+      case ColumnType::String:
+        strings.emplace_back();
+        break;
+      default:
+        ints.push_back(0);
+    }
+  }
+
+  void convertTo(ColumnType newType) {
+    if (newType == ColumnType::Double) {
+      doubles.assign(ints.begin(), ints.end());
+    } else {
+      strings.clear();
+      strings.reserve(valid.size());
+      for (size_t i = 0; i < valid.size(); ++i) {
+        if (!valid[i]) {
+          strings.emplace_back();
+        } else if (type == ColumnType::Double) {
+          strings.push_back(numberToString(doubles[i]));
+        } else if (type == ColumnType::Bool) {
+          strings.push_back(numberToString(static_cast<bool>(ints[i])));
+        } else {
+          strings.push_back(std::to_string(ints[i]));
+        }
+      }
+      doubles.clear();
+    }
+    ints.clear();
+    type = newType;
+  }
+
+  void add(const RDValue &val) {
+    ColumnType valType;
+    switch (val.getTag()) {
+      case RDTypeTag::IntTag:
+      case RDTypeTag::UnsignedIntTag:
+        valType = ColumnType::Int64;
+        break;
+      case RDTypeTag::DoubleTag:
+      case RDTypeTag::FloatTag:
+        valType = ColumnType::Double;
+        break;
+      case RDTypeTag::BoolTag:
+        valType = ColumnType::Bool;
+        break;
+      default:
+        valType = ColumnType::String;
+    }
+    if (!typeSet) {
+      // the column only has nulls so far
+      typeSet = true;
+      ints.clear();
+      type = valType;
+      switch (type) {
+        case ColumnType::Double:
+          doubles.resize(valid.size(), 0.0);
+          break;
+        case ColumnType::String:
+          strings.resize(valid.size());
+          break;
+        default:
+          ints.resize(valid.size(), 0);
+      }
+    } else if (valType != type) {
+      if (type == ColumnType::Int64 && valType == ColumnType::Double) {
+        convertTo(ColumnType::Double);
+      } else if (!(type == ColumnType::Double &&
+                   valType == ColumnType::Int64) &&
+                 type != ColumnType::String) {
+        convertTo(ColumnType::String);
+      }
+    }
+    valid.push_back(true);
+    switch (type) {
+      case ColumnType::Int64:
+        ints.push_back(val.getTag() == RDTypeTag::IntTag
+                           ? rdvalue_cast<int>(val)
+                           : rdvalue_cast<unsigned int>(val));
+        break;
+      case ColumnType::Bool:
+        ints.push_back(rdvalue_cast<bool>(val));
+        break;
+      case ColumnType::Double:
+        if (valType == ColumnType::Int64) {
+          doubles.push_back(val.getTag() == RDTypeTag::IntTag
+                                ? rdvalue_cast<int>(val)
+                                : rdvalue_cast<unsigned int>(val));
+        } else {
+          doubles.push_back(val.getTag() == RDTypeTag::DoubleTag
+                                ? rdvalue_cast<double>(val)
+                                : rdvalue_cast<float>(val));
+        }
+        break;
+      default: {
+        std::string sval;
+        rdvalue_tostring(val, sval);
+        strings.push_back(std::move(sval));
+      }
+    }
+  }
+
+  MolRecordBatch::Column finish() const {
+    MolRecordBatch::Column res;
+    res.name = name;
+    res.type = type;
+    for (size_t i = 0; i < valid.size(); ++i) {
+      appendValidity(res, i, valid[i]);
+    }
+    switch (type) {
+      case ColumnType::Int64:
+        res.data.reserve(ints.size() * sizeof(std::int64_t));
+        for (auto v : ints) {
+          appendLittleEndian(res.data, v);
+        }
+        break;
+      case ColumnType::Double:
+        res.data.reserve(doubles.size() * sizeof(double));
+        for (auto v : doubles) {
+          appendLittleEndian(res.data, v);
+        }
+        break;
+      case ColumnType::Bool:
+        res.data.resize((ints.size() + 7) / 8, 0);
+        for (size_t i = 0; i < ints.size(); ++i) {
+          if (ints[i]) {
+            res.data[i / 8] |= static_cast<std::uint8_t>(1u << (i % 8));
+          }
+        }
+        break;
+      default:
+        res.offsets.reserve(strings.size() + 1);
+        res.offsets.push_back(0);
+        for (const auto &v : strings) {
+          appendBytes(res, v);
+        }
+    }
+    return res;
+  }
+};
+}  // namespace detail
+
+bool MolRecordBatch::Column::isValid(size_t row) const {
+  PRECONDITION(row / 8 < validity.size(), "row out of range");
+  return (validity[row / 8] >> (row % 8)) & 1;
+}
+
+std::int64_t MolRecordBatch::Column::getInt64(size_t row) const {
+  PRECONDITION(type == ColumnType::Int64, "not an Int64 column");
+  return readLittleEndian<std::int64_t>(data, row);
+}
+
+double MolRecordBatch::Column::getDouble(size_t row) const {
+  PRECONDITION(type == ColumnType::Double, "not a Double column");
+  return readLittleEndian<double>(data, row);
+}
+
+bool MolRecordBatch::Column::getBool(size_t row) const {
+  PRECONDITION(type == ColumnType::Bool, "not a Bool column");
+  PRECONDITION(row / 8 < data.size(), "row out of range");
+  return (data[row / 8] >> (row % 8)) & 1;
+}
+
+std::string_view MolRecordBatch::Column::getString(size_t row) const {
+  PRECONDITION(type == ColumnType::String || type == ColumnType::Binary,
+               "not a String or Binary column");
+  PRECONDITION(row + 1 < offsets.size(), "row out of range");
+  auto start = offsets[row];
+  return std::string_view(reinterpret_cast<const char *>(data.data()) + start,
+                          offsets[row + 1] - start);
+}
+
+bool MolRecordBatch::hasColumn(const std::string &name) const {
+  for (const auto &col : d_columns) {
+    if (col.name == name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+const MolRecordBatch::Column &MolRecordBatch::getColumn(
+    const std::string &name) const {
+  for (const auto &col : d_columns) {
+    if (col.name == name) {
+      return col;
+    }
+  }
+  throw KeyErrorException(name);
+}
+
+std::unique_ptr<RWMol> MolRecordBatch::getMol(size_t row) const {
+  PRECONDITION(row < d_numRows, "row out of range");
+  PRECONDITION(!d_columns.empty(), "no molecule column");
+  const auto &molCol = d_columns[0];
+  if (!molCol.isValid(row)) {
+    return nullptr;
+  }
+  std::unique_ptr<RWMol> res;
+  if (d_molFormat == MolRecordFormat::Pickle) {
+    res.reset(new RWMol());
+    // parse the pickle in place
+    StringViewInStream inStream(molCol.getString(row));
+    MolPickler::molFromPickle(inStream, *res);
+  } else {
+    res = v2::SmilesParse::MolFromSmiles(std::string(molCol.getString(row)));
+    if (!res) {
+      return res;
+    }
+  }
+  for (size_t i = 1; i < d_columns.size(); ++i) {
+    const auto &col = d_columns[i];
+    if (col.type == ColumnType::Binary || col.type == ColumnType::Bits ||
+        !col.isValid(row)) {
+      continue;
+    }
+    switch (col.type) {
+      case ColumnType::Int64: {
+        auto val = col.getInt64(row);
+        if (val >= std::numeric_limits<int>::min() &&
+            val <= std::numeric_limits<int>::max()) {
+          res->setProp(col.name, static_cast<int>(val));
+        } else {
+          res->setProp(col.name, val);
+        }
+      } break;
+      case ColumnType::Double:
+        res->setProp(col.name, col.getDouble(row));
+        break;
+      case ColumnType::Bool:
+        res->setProp(col.name, col.getBool(row));
+        break;
+      default:
+        res->setProp(col.name, std::string(col.getString(row)));
+    }
+  }
+  return res;
+}
+
+std::unique_ptr<ExplicitBitVect> MolRecordBatch::getFingerprint(
+    const std::string &name, size_t row) const {
+  PRECONDITION(row < d_numRows, "row out of range");
+  const auto &col = getColumn(name);
+  if (col.type != ColumnType::Bits) {
+    throw ValueErrorException("column " + name + " is not a Bits column");
+  }
+  if (!col.isValid(row)) {
+    return nullptr;
+  }
+  auto res = std::make_unique<ExplicitBitVect>(col.width);
+  const auto nBytes = (col.width + 7) / 8;
+  const auto *bytes = col.data.data() + row * nBytes;
+  for (unsigned int i = 0; i < nBytes; ++i) {
+    if (!bytes[i]) {
+      continue;
+    }
+    for (unsigned int j = 0; j < 8; ++j) {
+      if ((bytes[i] >> j) & 1) {
+        res->setBit(i * 8 + j);
+      }
+    }
+  }
+  return res;
+}
+
+void MolRecordBatch::toStream(std::ostream &ss) const {
+  streamWrite(ss, static_cast<std::uint64_t>(d_numRows));
+  streamWrite(ss, static_cast<std::uint8_t>(d_molFormat));
+  streamWrite(ss, static_cast<std::uint32_t>(d_columns.size()));
+  for (const auto &col : d_columns) {
+    streamWrite(ss, col.name);
+    streamWrite(ss, static_cast<std::uint8_t>(col.type));
+    streamWrite(ss, col.width);
+    writeBuffer(ss, col.validity);
+    writeOffsets(ss, col.offsets);
+    writeBuffer(ss, col.data);
+  }
+}
+
+void MolRecordBatch::initFromStream(std::istream &ss) {
+  std::uint64_t numRows;
+  std::uint8_t molFormat;
+  std::uint32_t numColumns;
+  streamRead(ss, numRows);
+  streamRead(ss, molFormat);
+  streamRead(ss, numColumns);
+  if (molFormat > static_cast<std::uint8_t>(MolRecordFormat::Pickle)) {
+    throw FileParseException("bad molecule format in MolRecordBatch");
+  }
+  d_numRows = numRows;
+  d_molFormat = static_cast<MolRecordFormat>(molFormat);
+  d_columns.clear();
+  // the column count isn't trusted either, so the columns are added as
+  // they are read
+  for (std::uint32_t i = 0; i < numColumns; ++i) {
+    d_columns.emplace_back();
+    auto &col = d_columns.back();
+    std::uint8_t type;
+    streamRead(ss, col.name, 0);
+    streamRead(ss, type);
+    if (type > static_cast<std::uint8_t>(ColumnType::Bits)) {
+      throw FileParseException("bad column type in MolRecordBatch");
+    }
+    col.type = static_cast<ColumnType>(type);
+    streamRead(ss, col.width);
+    readBuffer(ss, col.validity);
+    readOffsets(ss, col.offsets);
+    readBuffer(ss, col.data);
+    checkColumn(col, d_numRows);
+  }
+  if (d_columns.empty() || (d_columns[0].type != ColumnType::String &&
+                            d_columns[0].type != ColumnType::Binary)) {
+    throw FileParseException("no molecule column in MolRecordBatch");
+  }
+}
+
+MolRecordBatchBuilder::MolRecordBatchBuilder(const MolRecordBatchParams &params)
+    : d_params(params) {
+  d_molColumn.offsets.push_back(0);
+  if (d_params.molFormat == MolRecordFormat::Pickle) {
+    d_molColumn.name = "pickle";
+    d_molColumn.type = ColumnType::Binary;
+  } else {
+    d_molColumn.name = "smiles";
+    d_molColumn.type = ColumnType::String;
+  }
+  for (const auto &fp : d_params.fingerprints) {
+    MolRecordBatch::Column col;
+    col.name = fp.first;
+    col.type = ColumnType::Bits;
+    d_fpColumns.push_back(std::move(col));
+  }
+}
+
+MolRecordBatchBuilder::~MolRecordBatchBuilder() = default;
+
+void MolRecordBatchBuilder::addMol(const ROMol *mol) {
+  const auto row = d_numRows;
+  appendValidity(d_molColumn, row, mol != nullptr);
+  if (!mol) {
+    d_molColumn.offsets.push_back(d_molColumn.offsets.back());
+  } else if (d_params.molFormat == MolRecordFormat::Pickle) {
+    // the molecule properties go in their own columns
+    std::string pickle;
+    MolPickler::pickleMol(
+        *mol, pickle,
+        MolPickler::getDefaultPickleProperties() & ~PicklerOps::MolProps);
+    appendBytes(d_molColumn, pickle);
+  } else {
+    appendBytes(d_molColumn, MolToSmiles(*mol));
+  }
+
+  if (mol) {
+    auto addProp = [&](const std::string &name) {
+      const auto *val = findProp(*mol, name);
+      if (!val) {
+        return;
+      }
+      detail::PropColumnBuilder *col = nullptr;
+      for (auto &propCol : d_propColumns) {
+        if (propCol->name == name) {
+          col = propCol.get();
+          break;
+        }
+      }
+      if (!col) {
+        d_propColumns.emplace_back(new detail::PropColumnBuilder);
+        col = d_propColumns.back().get();
+        col->name = name;
+        for (size_t i = 0; i < row; ++i) {
+          col->addNull();
+        }
+      }
+      if (col->valid.size() == row) {
+        col->add(*val);
+      }
+    };
+    if (d_params.includeName) {
+      addProp(common_properties::_Name);
+    }
+    if (d_params.propNames.empty()) {
+      for (const auto &name : mol->getPropList(false, false)) {
+        addProp(name);
+      }
+    } else {
+      for (const auto &name : d_params.propNames) {
+        addProp(name);
+      }
+    }
+  }
+  for (auto &propCol : d_propColumns) {
+    if (propCol->valid.size() == row) {
+      propCol->addNull();
+    }
+  }
+
+  for (size_t i = 0; i < d_fpColumns.size(); ++i) {
+    auto &col = d_fpColumns[i];
+    std::unique_ptr<ExplicitBitVect> fp;
+    if (mol) {
+      fp = d_params.fingerprints[i].second(*mol);
+    }
+    appendValidity(col, row, fp != nullptr);
+    if (!fp) {
+      continue;
+    }
+    if (!col.width) {
+      col.width = fp->getNumBits();
+    } else if (col.width != fp->getNumBits()) {
+      throw ValueErrorException("fingerprint sizes in column " + col.name +
+                                " do not match");
+    }
+    const auto nBytes = (col.width + 7) / 8;
+    // this also pads the rows without fingerprints
+    col.data.resize((row + 1) * nBytes, 0);
+    auto *bytes = col.data.data() + row * nBytes;
+    for (auto bit = fp->dp_bits->find_first();
+         bit != boost::dynamic_bitset<>::npos;
+         bit = fp->dp_bits->find_next(bit)) {
+      bytes[bit / 8] |= static_cast<std::uint8_t>(1u << (bit % 8));
+    }
+  }
+  ++d_numRows;
+}
+
+MolRecordBatch MolRecordBatchBuilder::finish() {
+  MolRecordBatch res;
+  res.d_numRows = d_numRows;
+  res.d_molFormat = d_params.molFormat;
+  res.d_columns.reserve(1 + d_propColumns.size() + d_fpColumns.size());
+  res.d_columns.push_back(std::move(d_molColumn));
+  for (const auto &propCol : d_propColumns) {
+    res.d_columns.push_back(propCol->finish());
+  }
+  for (auto &fpCol : d_fpColumns) {
+    fpCol.data.resize(d_numRows * ((fpCol.width + 7) / 8), 0);
+    res.d_columns.push_back(std::move(fpCol));
+  }
+
+  // reset everything for the next batch
+  d_numRows = 0;
+  d_molColumn = MolRecordBatch::Column();
+  d_molColumn.name = res.d_columns[0].name;
+  d_molColumn.type = res.d_columns[0].type;
+  d_molColumn.offsets.push_back(0);
+  d_propColumns.clear();
+  for (size_t i = 0; i < d_fpColumns.size(); ++i) {
+    d_fpColumns[i] = MolRecordBatch::Column();
+    d_fpColumns[i].name = d_params.fingerprints[i].first;
+    d_fpColumns[i].type = ColumnType::Bits;
+  }
+  return res;
+}
+
+MolRecordBatch makeMolRecordBatch(const std::vector<const ROMol *> &mols,
+                                  const MolRecordBatchParams &params) {
+  MolRecordBatchBuilder builder(params);
+  for (const auto mol : mols) {
+    builder.addMol(mol);
+  }
+  return builder.finish();
+}
+
+MolRecordBatchWriter::MolRecordBatchWriter(const std::string &fileName,
+                                           const MolRecordBatchParams &params,
+                                           unsigned int batchSize)
+    : d_batchSize(batchSize), d_params(params) {
+  auto *tmpStream = new std::ofstream(fileName.c_str(),
+                                      std::ios_base::out | std::ios_base::binary);
+  if (!(*tmpStream) || (tmpStream->bad())) {
+    delete tmpStream;
+    std::ostringstream errout;
+    errout << "Bad output file " << fileName;
+    throw BadFileException(errout.str());
+  }
+  dp_ostream = static_cast<std::ostream *>(tmpStream);
+  df_owner = true;
+  init();
+}
+
+MolRecordBatchWriter::MolRecordBatchWriter(std::ostream *outStream,
+                                           bool takeOwnership,
+                                           const MolRecordBatchParams &params,
+                                           unsigned int batchSize)
+    : dp_ostream(outStream),
+      df_owner(takeOwnership),
+      d_batchSize(batchSize),
+      d_params(params) {
+  PRECONDITION(outStream, "null stream");
+  if (outStream->bad()) {
+    throw FileParseException("Bad output stream");
+  }
+  init();
+}
+
+void MolRecordBatchWriter::init() {
+  PRECONDITION(d_batchSize > 0, "batchSize must be positive");
+  dp_ostream->write(fileMagic, sizeof(fileMagic));
+  streamWrite(*dp_ostream, fileVersion);
+  dp_builder.reset(new MolRecordBatchBuilder(d_params));
+}
+
+MolRecordBatchWriter::~MolRecordBatchWriter() {
+  try {
+    close();
+  } catch (const std::runtime_error &) {
+  }
+}
+
+void MolRecordBatchWriter::setProps(const STR_VECT &propNames) {
+  PRECONDITION(dp_builder, "writer is closed");
+  if (dp_builder->getNumRows()) {
+    throw ValueErrorException(
+        "properties cannot be changed while a batch is being built");
+  }
+  d_params.propNames = propNames;
+  dp_builder.reset(new MolRecordBatchBuilder(d_params));
+}
+
+void MolRecordBatchWriter::writeCurrentBatch() {
+  if (dp_builder->getNumRows()) {
+    dp_builder->finish().toStream(*dp_ostream);
+  }
+}
+
+void MolRecordBatchWriter::write(const ROMol &mol, int confId) {
+  RDUNUSED_PARAM(confId);
+  PRECONDITION(dp_ostream, "no output stream");
+  dp_builder->addMol(&mol);
+  ++d_molid;
+  if (dp_builder->getNumRows() >= d_batchSize) {
+    writeCurrentBatch();
+  }
+}
+
+void MolRecordBatchWriter::write(const MolRecordBatch &batch) {
+  PRECONDITION(dp_ostream, "no output stream");
+  writeCurrentBatch();
+  batch.toStream(*dp_ostream);
+  d_molid += batch.getNumRows();
+}
+
+void MolRecordBatchWriter::flush() {
+  PRECONDITION(dp_ostream, "no output stream");
+  writeCurrentBatch();
+  dp_ostream->flush();
+}
+
+void MolRecordBatchWriter::close() {
+  if (dp_ostream) {
+    flush();
+  }
+  if (df_owner) {
+    delete dp_ostream;
+    df_owner = false;
+  }
+  dp_ostream = nullptr;
+}
+
+MolRecordBatchReader::MolRecordBatchReader(const std::string &fileName) {
+  auto *tmpStream = new std::ifstream(fileName.c_str(),
+                                      std::ios_base::in | std::ios_base::binary);
+  if (!(*tmpStream) || (tmpStream->bad())) {
+    delete tmpStream;
+    std::ostringstream errout;
+    errout << "Bad input file " << fileName;
+    throw BadFileException(errout.str());
+  }
+  dp_inStream = static_cast<std::istream *>(tmpStream);
+  df_owner = true;
+  init();
+}
+
+MolRecordBatchReader::MolRecordBatchReader(std::istream *inStream,
+                                           bool takeOwnership)
+    : dp_inStream(inStream), df_owner(takeOwnership) {
+  PRECONDITION(inStream, "null stream");
+  init();
+}
+
+MolRecordBatchReader::~MolRecordBatchReader() {
+  if (df_owner) {
+    delete dp_inStream;
+  }
+}
+
+void MolRecordBatchReader::init() {
+  char magic[sizeof(fileMagic)];
+  dp_inStream->read(magic, sizeof(magic));
+  if (dp_inStream->fail() || std::memcmp(magic, fileMagic, sizeof(magic))) {
+    throw FileParseException("not a MolRecordBatch file");
+  }
+  std::uint32_t version;
+  streamRead(*dp_inStream, version);
+  if (version > fileVersion) {
+    throw FileParseException("unsupported MolRecordBatch file version");
+  }
+}
+
+bool MolRecordBatchReader::atEnd() const {
+  return dp_inStream->peek() == std::istream::traits_type::eof();
+}
+
+std::unique_ptr<MolRecordBatch> MolRecordBatchReader::next() {
+  if (atEnd()) {
+    throw FileParseException("all batches have been read");
+  }
+  auto res = std::make_unique<MolRecordBatch>();
+  try {
+    res->initFromStream(*dp_inStream);
+  } catch (const std::runtime_error &e) {
+    throw FileParseException(e.what());
+  }
+  return res;
+}
+}  // namespace RDKit
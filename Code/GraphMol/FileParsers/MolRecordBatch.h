@@ -0,0 +1,224 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+
+/*! \file MolRecordBatch.h
+
+  \brief Column-wise storage of molecules, their properties and
+  fingerprints, along with a simple binary container format for it.
+
+*/
+#include <RDGeneral/export.h>
+#ifndef RD_MOLRECORDBATCH_H
+#define RD_MOLRECORDBATCH_H
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <DataStructs/ExplicitBitVect.h>
+#include <GraphMol/RWMol.h>
+#include "MolWriters.h"
+
+namespace RDKit {
+
+//! how the molecules are stored in a MolRecordBatch
+enum class MolRecordFormat : std::uint8_t {
+  SMILES = 0,  //!< canonical SMILES, stereo and coordinates are lost
+  Pickle = 1,  //!< binary pickles, including conformers
+};
+
+//! a batch of molecules stored column-wise
+/*!
+  The buffers of the columns use the same layout as Apache Arrow arrays,
+  so they can be handed to Arrow without being converted:
+    - validity: a bitmap with one bit per row (least significant bit
+      first), a set bit means the value is not null
+    - Int64 and Double columns: the values as 8 byte little endian numbers
+    - Bool columns: a bitmap with one bit per row
+    - String and Binary columns: numRows + 1 int32 offsets into the data
+    - Bits columns: (width + 7) / 8 bytes per row, the bits of each row are
+      stored least significant bit first
+
+  The first column holds the molecules: a String column named "smiles" or
+  a Binary column named "pickle". It is followed by the property columns
+  and the fingerprint (Bits) columns.
+*/
+class RDKIT_FILEPARSERS_EXPORT MolRecordBatch {
+ public:
+  enum class ColumnType : std::uint8_t {
+    Int64 = 0,
+    Double = 1,
+    Bool = 2,
+    String = 3,
+    Binary = 4,
+    Bits = 5,
+  };
+
+  struct RDKIT_FILEPARSERS_EXPORT Column {
+    std::string name;
+    ColumnType type = ColumnType::String;
+    std::uint32_t width = 0;  //!< the number of bits per row in Bits columns
+    std::vector<std::uint8_t> validity;
+    std::vector<std::int32_t> offsets;  //!< only used by String and Binary
+    std::vector<std::uint8_t> data;
+
+    bool isValid(size_t row) const;
+    std::int64_t getInt64(size_t row) const;
+    double getDouble(size_t row) const;
+    bool getBool(size_t row) const;
+    //! returns the value of a String or Binary column
+    std::string_view getString(size_t row) const;
+  };
+
+  size_t getNumRows() const { return d_numRows; }
+  MolRecordFormat getMolFormat() const { return d_molFormat; }
+  const std::vector<Column> &getColumns() const { return d_columns; }
+  bool hasColumn(const std::string &name) const;
+  //! throws a KeyErrorException if there's no column with this name
+  const Column &getColumn(const std::string &name) const;
+
+  //! returns the molecule in a row along with its properties, the result
+  //! is null if the row doesn't have a molecule
+  std::unique_ptr<RWMol> getMol(size_t row) const;
+  //! returns the fingerprint in a row of a Bits column, the result is null
+  //! if the row doesn't have a fingerprint
+  std::unique_ptr<ExplicitBitVect> getFingerprint(const std::string &name,
+                                                  size_t row) const;
+
+  //! writes the batch to a stream in binary form
+  void toStream(std::ostream &ss) const;
+  //! replaces the contents of the batch with data read from a stream
+  void initFromStream(std::istream &ss);
+
+ private:
+  friend class MolRecordBatchBuilder;
+  size_t d_numRows = 0;
+  MolRecordFormat d_molFormat = MolRecordFormat::Pickle;
+  std::vector<Column> d_columns;
+};
+
+using FingerprintColumnFunc =
+    std::function<std::unique_ptr<ExplicitBitVect>(const ROMol &)>;
+
+struct RDKIT_FILEPARSERS_EXPORT MolRecordBatchParams {
+  MolRecordFormat molFormat = MolRecordFormat::Pickle;
+  //! the molecule properties to store, if this is empty all public,
+  //! non-computed properties are stored
+  std::vector<std::string> propNames;
+  bool includeName = true;  //!< store the molecule names in a _Name column
+  //! the fingerprint columns, the functions are called once per molecule.
+  //! This is typically used with a FingerprintGenerator.
+  std::vector<std::pair<std::string, FingerprintColumnFunc>> fingerprints;
+};
+
+namespace detail {
+struct PropColumnBuilder;
+}
+
+//! builds MolRecordBatches one row at a time
+/*!
+  The type of each property column is set by the first value it receives.
+  Int64 columns are converted to Double columns if they receive floating
+  point values; any other combination of types results in a String column.
+*/
+class RDKIT_FILEPARSERS_EXPORT MolRecordBatchBuilder {
+ public:
+  explicit MolRecordBatchBuilder(
+      const MolRecordBatchParams &params = MolRecordBatchParams());
+  ~MolRecordBatchBuilder();
+
+  //! adds a row, the row is null if mol is null
+  void addMol(const ROMol *mol);
+  size_t getNumRows() const { return d_numRows; }
+  //! returns the batch and resets the builder
+  MolRecordBatch finish();
+
+ private:
+  MolRecordBatchParams d_params;
+  size_t d_numRows = 0;
+  MolRecordBatch::Column d_molColumn;
+  std::vector<std::unique_ptr<detail::PropColumnBuilder>> d_propColumns;
+  std::vector<MolRecordBatch::Column> d_fpColumns;
+};
+
+//! returns a batch with the molecules, null molecules result in null rows
+RDKIT_FILEPARSERS_EXPORT MolRecordBatch makeMolRecordBatch(
+    const std::vector<const ROMol *> &mols,
+    const MolRecordBatchParams &params = MolRecordBatchParams());
+
+//! writes molecules to a file with MolRecordBatches
+/*!
+  The file starts with a short header and is followed by the batches in the
+  format written by MolRecordBatch::toStream().
+  The confId argument of write() is ignored.
+*/
+class RDKIT_FILEPARSERS_EXPORT MolRecordBatchWriter : public MolWriter {
+ public:
+  MolRecordBatchWriter(
+      const std::string &fileName,
+      const MolRecordBatchParams &params = MolRecordBatchParams(),
+      unsigned int batchSize = 1000);
+  MolRecordBatchWriter(
+      std::ostream *outStream, bool takeOwnership = false,
+      const MolRecordBatchParams &params = MolRecordBatchParams(),
+      unsigned int batchSize = 1000);
+  ~MolRecordBatchWriter() override;
+
+  //! adds a molecule to the current batch, the batch is written once it is
+  //! full
+  void write(const ROMol &mol, int confId = defaultConfId) override;
+  //! writes a batch, the current batch is written first
+  void write(const MolRecordBatch &batch);
+  //! writes the current batch and flushes the stream
+  void flush() override;
+  void close() override;
+  //! sets the properties to be stored, this cannot be changed once the
+  //! current batch has rows
+  void setProps(const STR_VECT &propNames) override;
+  unsigned int numMols() const override { return d_molid; }
+
+ private:
+  void init();
+  void writeCurrentBatch();
+
+  std::ostream *dp_ostream = nullptr;
+  bool df_owner = false;
+  unsigned int d_batchSize = 1000;
+  unsigned int d_molid = 0;
+  MolRecordBatchParams d_params;
+  std::unique_ptr<MolRecordBatchBuilder> dp_builder;
+};
+
+//! reads the batches written by MolRecordBatchWriter
+class RDKIT_FILEPARSERS_EXPORT MolRecordBatchReader {
+ public:
+  explicit MolRecordBatchReader(const std::string &fileName);
+  explicit MolRecordBatchReader(std::istream *inStream,
+                                bool takeOwnership = false);
+  ~MolRecordBatchReader();
+
+  bool atEnd() const;
+  //! returns the next batch, throws a FileParseException if there is none
+  std::unique_ptr<MolRecordBatch> next();
+
+ private:
+  void init();
+
+  std::istream *dp_inStream = nullptr;
+  bool df_owner = false;
+};
+
+}  // namespace RDKit
+#endif
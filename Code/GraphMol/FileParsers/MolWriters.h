@@ -84,6 +84,24 @@ class RDKIT_FILEPARSERS_EXPORT SmilesWriter : public MolWriter {
   //! written out for each molecule
   void setProps(const STR_VECT &propNames) override;
 
+  //! \brief return the line that would be written to the file
+  /*!
+    \param mol            : the molecule
+    \param delimiter      : delimiter to use between the fields
+    \param includeName    : toggles inclusion of the molecule's name, molid is
+                            used if the molecule doesn't have a name
+    \param molid          : the index of the molecule in the file
+    \param propNames      : the properties to include
+    \param isomericSmiles : toggles generation of isomeric SMILES
+    \param kekuleSmiles   : toggles the generation of kekule SMILES
+   */
+  static std::string getText(const ROMol &mol,
+                             const std::string &delimiter = " ",
+                             bool includeName = true, unsigned int molid = 0,
+                             const STR_VECT &propNames = STR_VECT(),
+                             bool isomericSmiles = true,
+                             bool kekuleSmiles = false);
+
   //! \brief write a new molecule to the file
   void write(const ROMol &mol, int confId = defaultConfId) override;
 
@@ -0,0 +1,159 @@
+#if defined(RDK_BUILD_THREADSAFE_SSS) && defined(RDK_BUILD_MAEPARSER_SUPPORT)
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "MultithreadedMaeMolSupplier.h"
+
+#include <maeparser/MaeConstants.hpp>
+
+namespace RDKit {
+namespace v2 {
+namespace FileParsers {
+MultithreadedMaeMolSupplier::MultithreadedMaeMolSupplier(
+    const std::string &fileName, const Parameters &params,
+    const MaeMolSupplierParams &parseParams) {
+  dp_inStream = openAndCheckStream(fileName);
+  initFromSettings(true, params, parseParams);
+  POSTCONDITION(dp_inStream, "bad instream");
+  startThreads();
+}
+
+MultithreadedMaeMolSupplier::MultithreadedMaeMolSupplier(
+    std::istream *inStream, bool takeOwnership, const Parameters &params,
+    const MaeMolSupplierParams &parseParams) {
+  PRECONDITION(inStream, "bad stream");
+  dp_inStream = inStream;
+  initFromSettings(takeOwnership, params, parseParams);
+  POSTCONDITION(dp_inStream, "bad instream");
+  startThreads();
+}
+
+void MultithreadedMaeMolSupplier::initFromSettings(
+    bool takeOwnership, const Parameters &params,
+    const MaeMolSupplierParams &parseParams) {
+  df_owner = takeOwnership;
+  d_params = params;
+  d_parseParams = parseParams;
+  d_params.numWriterThreads = getNumThreadsToUse(params.numWriterThreads);
+  d_inputQueue =
+      new ConcurrentQueue<std::tuple<std::string, unsigned int, unsigned int>>(
+          d_params.sizeInputQueue);
+  d_outputQueue =
+      new ConcurrentQueue<std::tuple<RWMol *, std::string, unsigned int>>(
+          d_params.sizeOutputQueue);
+  df_end = false;
+  d_line = 0;
+}
+
+MultithreadedMaeMolSupplier::~MultithreadedMaeMolSupplier() {
+  if (df_owner && dp_inStream) {
+    delete dp_inStream;
+    df_owner = false;
+    dp_inStream = nullptr;
+  }
+}
+
+bool MultithreadedMaeMolSupplier::getEnd() const {
+  PRECONDITION(dp_inStream, "no stream");
+  return df_end;
+}
+
+bool MultithreadedMaeMolSupplier::extractNextRecord(std::string &record,
+                                                    unsigned int &lineNum,
+                                                    unsigned int &index) {
+  PRECONDITION(dp_inStream, "no stream");
+  // we only need to find where the top level blocks start and end, so
+  // the only things we have to keep track of are the nesting depth, quoted
+  // strings (which may contain braces) and comments
+  std::string tempStr;
+  std::string blockText;  // the text preceding the opening brace
+  std::string blockName;
+  unsigned int depth = 0;
+  bool inString = false;
+  bool inComment = false;
+  record.clear();
+  while (!dp_inStream->eof() && !dp_inStream->fail()) {
+    std::getline(*dp_inStream, tempStr);
+    if (dp_inStream->fail()) {
+      break;
+    }
+    if (!depth && !inComment && strip(blockText).empty()) {
+      record.clear();
+      lineNum = d_line;
+    }
+    ++d_line;
+    record += tempStr;
+    record += '\n';
+    bool closed = false;
+    for (size_t i = 0; i < tempStr.size() && !closed; ++i) {
+      const auto c = tempStr[i];
+      if (inComment) {
+        inComment = c != '#';
+      } else if (inString) {
+        if (c == '\\') {
+          ++i;
+        } else if (c == '"') {
+          inString = false;
+        }
+      } else if (c == '\\') {
+        ++i;
+      } else if (c == '"') {
+        inString = true;
+      } else if (c == '#') {
+        inComment = true;
+      } else if (c == '{') {
+        if (!depth) {
+          blockName = strip(blockText);
+        }
+        ++depth;
+      } else if (c == '}' && depth) {
+        --depth;
+        closed = !depth;
+      } else if (!depth) {
+        blockText += c;
+      }
+    }
+    if (closed) {
+      if (blockName == schrodinger::mae::CT_BLOCK) {
+        index = d_currentRecordId;
+        ++d_currentRecordId;
+        return true;
+      }
+      // not a structure, keep looking
+      blockText.clear();
+      blockName.clear();
+      record.clear();
+    }
+  }
+  df_end = true;
+  if (depth && blockName == schrodinger::mae::CT_BLOCK) {
+    // a truncated structure, this will produce a null molecule
+    index = d_currentRecordId;
+    ++d_currentRecordId;
+    return true;
+  }
+  return false;
+}
+
+RWMol *MultithreadedMaeMolSupplier::processMoleculeRecord(
+    const std::string &record, unsigned int lineNum) {
+  RDUNUSED_PARAM(lineNum);
+  // the record contains a single structure, so we let MaeMolSupplier do
+  // the actual parsing
+  MaeMolSupplier suppl;
+  suppl.setData(record, d_parseParams);
+  if (suppl.atEnd()) {
+    return nullptr;
+  }
+  return suppl.next().release();
+}
+}  // namespace FileParsers
+}  // namespace v2
+}  // namespace RDKit
+#endif
@@ -0,0 +1,117 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#if defined(RDK_BUILD_THREADSAFE_SSS) && defined(RDK_BUILD_MAEPARSER_SUPPORT)
+#ifndef MULTITHREADED_MAE_MOL_SUPPLIER
+#define MULTITHREADED_MAE_MOL_SUPPLIER
+#include "MultithreadedMolSupplier.h"
+namespace RDKit {
+namespace v2 {
+namespace FileParsers {
+
+//! concurrently parses the structures (f_m_ct blocks) of a Maestro file
+/*!
+  The reader thread only splits the input into blocks, the blocks are parsed
+  by maeparser in the writer threads. The molecules are the same as those
+  returned by MaeMolSupplier.
+
+  This class is still a bit experimental and the public API may change
+  in future releases.
+*/
+class RDKIT_FILEPARSERS_EXPORT MultithreadedMaeMolSupplier
+    : public MultithreadedMolSupplier {
+ public:
+  explicit MultithreadedMaeMolSupplier(
+      const std::string &fileName, const Parameters &params = Parameters(),
+      const MaeMolSupplierParams &parseParams = MaeMolSupplierParams());
+
+  explicit MultithreadedMaeMolSupplier(
+      std::istream *inStream, bool takeOwnership = true,
+      const Parameters &params = Parameters(),
+      const MaeMolSupplierParams &parseParams = MaeMolSupplierParams());
+
+  ~MultithreadedMaeMolSupplier() override;
+  void init() override {}
+
+  bool getEnd() const override;
+
+  //! reads next record and returns whether or not EOF was hit
+  bool extractNextRecord(std::string &record, unsigned int &lineNum,
+                         unsigned int &index) override;
+  //! parses the record and returns the resulting molecule
+  RWMol *processMoleculeRecord(const std::string &record,
+                               unsigned int lineNum) override;
+
+ private:
+  void initFromSettings(bool takeOwnership, const Parameters &params,
+                        const MaeMolSupplierParams &parseParams);
+
+  bool df_end = false;  //!< have we reached the end of the file?
+  int d_line = 0;       //!< line number we are currently on
+  unsigned int d_currentRecordId = 1;  //!< current record id
+  MaeMolSupplierParams d_parseParams;
+};
+}  // namespace FileParsers
+}  // namespace v2
+
+inline namespace v1 {
+class RDKIT_FILEPARSERS_EXPORT MultithreadedMaeMolSupplier
+    : public MolSupplier {
+ public:
+  using ContainedType = v2::FileParsers::MultithreadedMaeMolSupplier;
+  MultithreadedMaeMolSupplier() {}
+  explicit MultithreadedMaeMolSupplier(const std::string &fileName,
+                                       bool sanitize = true,
+                                       bool removeHs = true,
+                                       unsigned int numWriterThreads = 1,
+                                       size_t sizeInputQueue = 5,
+                                       size_t sizeOutputQueue = 5) {
+    v2::FileParsers::MultithreadedMaeMolSupplier::Parameters params;
+    params.numWriterThreads = numWriterThreads;
+    params.sizeInputQueue = sizeInputQueue;
+    params.sizeOutputQueue = sizeOutputQueue;
+    v2::FileParsers::MaeMolSupplierParams parseParams;
+    parseParams.sanitize = sanitize;
+    parseParams.removeHs = removeHs;
+
+    dp_supplier.reset(new v2::FileParsers::MultithreadedMaeMolSupplier(
+        fileName, params, parseParams));
+  }
+
+  explicit MultithreadedMaeMolSupplier(
+      std::istream *inStream, bool takeOwnership = true, bool sanitize = true,
+      bool removeHs = true, unsigned int numWriterThreads = 1,
+      size_t sizeInputQueue = 5, size_t sizeOutputQueue = 5) {
+    v2::FileParsers::MultithreadedMaeMolSupplier::Parameters params;
+    params.numWriterThreads = numWriterThreads;
+    params.sizeInputQueue = sizeInputQueue;
+    params.sizeOutputQueue = sizeOutputQueue;
+    v2::FileParsers::MaeMolSupplierParams parseParams;
+    parseParams.sanitize = sanitize;
+    parseParams.removeHs = removeHs;
+
+    dp_supplier.reset(new v2::FileParsers::MultithreadedMaeMolSupplier(
+        inStream, takeOwnership, params, parseParams));
+  }
+
+  //! returns the record id of the last extracted item
+  unsigned int getLastRecordId() const {
+    PRECONDITION(dp_supplier, "no supplier");
+    return static_cast<ContainedType *>(dp_supplier.get())->getLastRecordId();
+  }
+  //! returns the text block for the last extracted item
+  std::string getLastItemText() const {
+    PRECONDITION(dp_supplier, "no supplier");
+    return static_cast<ContainedType *>(dp_supplier.get())->getLastItemText();
+  }
+};
+}  // namespace v1
+}  // namespace RDKit
+#endif
+#endif
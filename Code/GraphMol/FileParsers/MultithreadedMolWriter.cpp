@@ -0,0 +1,170 @@
+#ifdef RDK_BUILD_THREADSAFE_SSS
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "MultithreadedMolWriter.h"
+
+#include <RDGeneral/BadFileException.h>
+#include <RDGeneral/FileParseException.h>
+#include <RDGeneral/RDLog.h>
+
+#include <fstream>
+#include <sstream>
+
+namespace RDKit {
+
+MultithreadedMolWriter::~MultithreadedMolWriter() {
+  close();
+  delete dp_inputQueue;
+  delete dp_outputQueue;
+}
+
+void MultithreadedMolWriter::openStream(const std::string &fileName) {
+  if (fileName != "-") {
+    auto *tmpStream = new std::ofstream(fileName.c_str());
+    if (!(*tmpStream) || (tmpStream->bad())) {
+      delete tmpStream;
+      std::ostringstream errout;
+      errout << "Bad output file " << fileName;
+      throw BadFileException(errout.str());
+    }
+    dp_ostream = static_cast<std::ostream *>(tmpStream);
+    df_owner = true;
+  } else {
+    dp_ostream = static_cast<std::ostream *>(&std::cout);
+    df_owner = false;
+  }
+}
+
+void MultithreadedMolWriter::setStream(std::ostream *outStream,
+                                       bool takeOwnership) {
+  PRECONDITION(outStream, "null stream");
+  if (outStream->bad()) {
+    throw FileParseException("Bad output stream");
+  }
+  dp_ostream = outStream;
+  df_owner = takeOwnership;
+}
+
+void MultithreadedMolWriter::formatter() {
+  const auto window = d_params.sizeOutputQueue + d_params.numWriterThreads;
+  std::tuple<ROMol *, int, unsigned int> r;
+  while (dp_inputQueue->pop(r)) {
+    std::unique_ptr<ROMol> mol(std::get<0>(r));
+    auto molid = std::get<2>(r);
+    {
+      // don't get too far ahead of the output thread, this is what keeps
+      // the number of records waiting to be written bounded
+      std::unique_lock<std::mutex> lock(d_orderMutex);
+      d_orderCond.wait(lock, [&] { return molid < d_numWritten + window; });
+    }
+    std::string text;
+    try {
+      text = formatRecord(*mol, std::get<1>(r), molid);
+    } catch (const std::exception &e) {
+      BOOST_LOG(rdErrorLog) << "ERROR: could not write molecule " << molid
+                            << ": " << e.what() << std::endl;
+    } catch (...) {
+      BOOST_LOG(rdErrorLog)
+          << "ERROR: could not write molecule " << molid << std::endl;
+    }
+    dp_outputQueue->push(std::tuple<std::string, unsigned int>{text, molid});
+  }
+}
+
+void MultithreadedMolWriter::outputWriter() {
+  // records which arrive before their predecessors are held here until
+  // they can be written
+  std::map<unsigned int, std::string> pending;
+  unsigned int nextId = 0;
+  std::tuple<std::string, unsigned int> r;
+  while (dp_outputQueue->pop(r)) {
+    pending.emplace(std::get<1>(r), std::move(std::get<0>(r)));
+    while (!pending.empty() && pending.begin()->first == nextId) {
+      if (nextId == 0) {
+        (*dp_ostream) << getHeaderText();
+      }
+      (*dp_ostream) << pending.begin()->second;
+      pending.erase(pending.begin());
+      ++nextId;
+      {
+        std::lock_guard<std::mutex> lock(d_orderMutex);
+        d_numWritten = nextId;
+      }
+      d_orderCond.notify_all();
+    }
+  }
+}
+
+void MultithreadedMolWriter::startThreads() {
+  PRECONDITION(!df_threadsRunning, "threads already started");
+  dp_inputQueue = new ConcurrentQueue<std::tuple<ROMol *, int, unsigned int>>(
+      d_params.sizeInputQueue);
+  dp_outputQueue = new ConcurrentQueue<std::tuple<std::string, unsigned int>>(
+      d_params.sizeOutputQueue);
+  for (unsigned int i = 0; i < d_params.numWriterThreads; i++) {
+    d_formatterThreads.emplace_back(&MultithreadedMolWriter::formatter, this);
+  }
+  d_outputThread = std::thread(&MultithreadedMolWriter::outputWriter, this);
+  df_threadsRunning = true;
+}
+
+void MultithreadedMolWriter::endThreads() {
+  dp_inputQueue->setDone();
+  for (auto &thread : d_formatterThreads) {
+    thread.join();
+  }
+  d_formatterThreads.clear();
+  dp_outputQueue->setDone();
+  d_outputThread.join();
+  df_threadsRunning = false;
+}
+
+void MultithreadedMolWriter::write(const ROMol &mol, int confId) {
+  PRECONDITION(dp_ostream, "no output stream");
+  PRECONDITION(df_threadsRunning, "threads not started");
+  dp_inputQueue->push(
+      std::tuple<ROMol *, int, unsigned int>{new ROMol(mol), confId, d_molid});
+  ++d_molid;
+}
+
+void MultithreadedMolWriter::flush() {
+  PRECONDITION(dp_ostream, "no output stream");
+  {
+    std::unique_lock<std::mutex> lock(d_orderMutex);
+    d_orderCond.wait(lock, [this] { return d_numWritten == d_molid; });
+  }
+  try {
+    dp_ostream->flush();
+  } catch (...) {
+    try {
+      if (dp_ostream->good()) {
+        dp_ostream->setstate(std::ios::badbit);
+      }
+    } catch (const std::runtime_error &) {
+    }
+  }
+}
+
+void MultithreadedMolWriter::close() {
+  if (df_threadsRunning) {
+    endThreads();
+  }
+  if (dp_ostream) {
+    flush();
+  }
+  if (df_owner) {
+    delete dp_ostream;
+    df_owner = false;
+  }
+  dp_ostream = nullptr;
+}
+
+}  // namespace RDKit
+#endif
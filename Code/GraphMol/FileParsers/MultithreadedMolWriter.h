@@ -0,0 +1,105 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#ifdef RDK_BUILD_THREADSAFE_SSS
+#ifndef MULTITHREADED_MOL_WRITER
+#define MULTITHREADED_MOL_WRITER
+
+#include <RDGeneral/ConcurrentQueue.h>
+#include <RDGeneral/RDThreads.h>
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+#include "MolWriters.h"
+
+namespace RDKit {
+//! this is an abstract base class to concurrently format molecules which are
+//! written to an output stream in the order they were passed to write()
+/*!
+  Each call to write() copies the molecule and adds it to an input queue.
+  The molecules are converted to text by a pool of worker threads and a
+  single output thread writes the results to the stream in input order.
+
+  <b>Notes:</b>
+    - the number of molecules which are formatted but not yet written is
+      limited to sizeOutputQueue + numWriterThreads, so the memory usage is
+      bounded even if a single molecule takes a long time to format.
+    - if formatting a molecule fails, an error is logged and nothing is written
+      for that molecule.
+    - flush() blocks until all molecules passed to write() have been written.
+    - write() should only be called from a single thread.
+*/
+class RDKIT_FILEPARSERS_EXPORT MultithreadedMolWriter : public MolWriter {
+ public:
+  struct Parameters {
+    unsigned int numWriterThreads = 1;  //!< threads used to format molecules
+    size_t sizeInputQueue = 5;
+    size_t sizeOutputQueue = 5;
+  };
+
+  MultithreadedMolWriter() {}
+  ~MultithreadedMolWriter() override;
+
+  //! queues a copy of the molecule to be written
+  void write(const ROMol &mol, int confId = defaultConfId) override;
+  //! waits until all queued molecules have been written and flushes the
+  //! stream
+  void flush() override;
+  //! writes all queued molecules and closes our stream (the writer cannot be
+  //! used again)
+  void close() override;
+  //! returns the number of molecules passed to write() so far
+  unsigned int numMols() const override { return d_molid; }
+
+ protected:
+  //! opens the output file ("-" means stdout)
+  void openStream(const std::string &fileName);
+  //! uses an existing output stream
+  void setStream(std::ostream *outStream, bool takeOwnership);
+  //! sets up the queues and starts the worker and output threads
+  void startThreads();
+  //! returns the text for a single molecule
+  virtual std::string formatRecord(const ROMol &mol, int confId,
+                                   unsigned int molid) = 0;
+  //! returns text to be written before the first molecule
+  virtual std::string getHeaderText() const { return ""; }
+
+  std::ostream *dp_ostream = nullptr;
+  bool df_owner = false;
+  unsigned int d_molid = 0;  //!< the number of molecules queued so far
+  Parameters d_params;
+
+ private:
+  //! formats molecules from the input queue, populating the output queue
+  void formatter();
+  //! writes records from the output queue to the stream in order
+  void outputWriter();
+  //! finalizes the worker and output threads
+  void endThreads();
+
+  std::vector<std::thread> d_formatterThreads;
+  std::thread d_outputThread;
+  bool df_threadsRunning = false;
+
+  ConcurrentQueue<std::tuple<ROMol *, int, unsigned int>> *dp_inputQueue =
+      nullptr;  //!< molecules waiting to be formatted
+  ConcurrentQueue<std::tuple<std::string, unsigned int>> *dp_outputQueue =
+      nullptr;  //!< formatted records waiting to be written
+
+  std::mutex d_orderMutex;
+  std::condition_variable d_orderCond;
+  unsigned int d_numWritten = 0;  //!< protected by d_orderMutex
+};
+}  // namespace RDKit
+#endif
+#endif
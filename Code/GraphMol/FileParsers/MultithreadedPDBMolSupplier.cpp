@@ -0,0 +1,126 @@
+#ifdef RDK_BUILD_THREADSAFE_SSS
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "MultithreadedPDBMolSupplier.h"
+
+namespace RDKit {
+namespace v2 {
+namespace FileParsers {
+namespace {
+bool isEndRecord(const std::string &line, bool splitModels) {
+  if (line.size() < 3 || line[0] != 'E' || line[1] != 'N' || line[2] != 'D') {
+    return false;
+  }
+  if (line.size() == 3 || line[3] == ' ' || line[3] == '\r') {
+    return true;
+  }
+  return splitModels && line.compare(3, 3, "MDL") == 0;
+}
+
+bool isAtomRecord(const std::string &line) {
+  return line.compare(0, 4, "ATOM") == 0 || line.compare(0, 6, "HETATM") == 0;
+}
+}  // namespace
+
+MultithreadedPDBMolSupplier::MultithreadedPDBMolSupplier(
+    const std::string &fileName, const Parameters &params,
+    const PDBParserParams &parseParams) {
+  dp_inStream = openAndCheckStream(fileName);
+  initFromSettings(true, params, parseParams);
+  POSTCONDITION(dp_inStream, "bad instream");
+  startThreads();
+}
+
+MultithreadedPDBMolSupplier::MultithreadedPDBMolSupplier(
+    std::istream *inStream, bool takeOwnership, const Parameters &params,
+    const PDBParserParams &parseParams) {
+  PRECONDITION(inStream, "bad stream");
+  dp_inStream = inStream;
+  initFromSettings(takeOwnership, params, parseParams);
+  POSTCONDITION(dp_inStream, "bad instream");
+  startThreads();
+}
+
+void MultithreadedPDBMolSupplier::initFromSettings(
+    bool takeOwnership, const Parameters &params,
+    const PDBParserParams &parseParams) {
+  df_owner = takeOwnership;
+  d_params = params;
+  d_parseParams = parseParams;
+  d_params.numWriterThreads = getNumThreadsToUse(params.numWriterThreads);
+  d_inputQueue =
+      new ConcurrentQueue<std::tuple<std::string, unsigned int, unsigned int>>(
+          d_params.sizeInputQueue);
+  d_outputQueue =
+      new ConcurrentQueue<std::tuple<RWMol *, std::string, unsigned int>>(
+          d_params.sizeOutputQueue);
+  df_end = false;
+  d_line = 0;
+}
+
+MultithreadedPDBMolSupplier::~MultithreadedPDBMolSupplier() {
+  if (df_owner && dp_inStream) {
+    delete dp_inStream;
+    df_owner = false;
+    dp_inStream = nullptr;
+  }
+}
+
+bool MultithreadedPDBMolSupplier::getEnd() const {
+  PRECONDITION(dp_inStream, "no stream");
+  return df_end;
+}
+
+bool MultithreadedPDBMolSupplier::extractNextRecord(std::string &record,
+                                                    unsigned int &lineNum,
+                                                    unsigned int &index) {
+  PRECONDITION(dp_inStream, "no stream");
+  const bool splitModels = (d_parseParams.flavor & 2) != 0;
+  std::string tempStr;
+  bool hasAtoms = false;
+  // entries without atoms (e.g. the END record which follows the last
+  // ENDMDL) don't produce a molecule, so we skip them
+  while (!hasAtoms) {
+    if (dp_inStream->eof() || dp_inStream->fail()) {
+      df_end = true;
+      return false;
+    }
+    record.clear();
+    lineNum = d_line;
+    while (!dp_inStream->eof()) {
+      std::getline(*dp_inStream, tempStr);
+      if (dp_inStream->fail()) {
+        break;
+      }
+      ++d_line;
+      record += tempStr;
+      record += '\n';
+      if (!hasAtoms && isAtomRecord(tempStr)) {
+        hasAtoms = true;
+      }
+      if (isEndRecord(tempStr, splitModels)) {
+        break;
+      }
+    }
+  }
+  index = d_currentRecordId;
+  ++d_currentRecordId;
+  return true;
+}
+
+RWMol *MultithreadedPDBMolSupplier::processMoleculeRecord(
+    const std::string &record, unsigned int lineNum) {
+  RDUNUSED_PARAM(lineNum);
+  return MolFromPDBBlock(record, d_parseParams).release();
+}
+}  // namespace FileParsers
+}  // namespace v2
+}  // namespace RDKit
+#endif
@@ -0,0 +1,123 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#ifdef RDK_BUILD_THREADSAFE_SSS
+#ifndef MULTITHREADED_PDB_MOL_SUPPLIER
+#define MULTITHREADED_PDB_MOL_SUPPLIER
+#include "MultithreadedMolSupplier.h"
+namespace RDKit {
+namespace v2 {
+namespace FileParsers {
+
+//! concurrently parses the entries of a PDB file with multiple entries
+/*!
+  Each entry ends at an END record or, if (parseParams.flavor & 2) is set,
+  at an ENDMDL record, so every MODEL is returned as a separate molecule.
+  This matches what repeated calls to MolFromPDBDataStream() on the same
+  stream return, except that entries without any ATOM or HETATM records
+  are skipped.
+
+  This class is still a bit experimental and the public API may change
+  in future releases.
+*/
+class RDKIT_FILEPARSERS_EXPORT MultithreadedPDBMolSupplier
+    : public MultithreadedMolSupplier {
+ public:
+  explicit MultithreadedPDBMolSupplier(
+      const std::string &fileName, const Parameters &params = Parameters(),
+      const PDBParserParams &parseParams = PDBParserParams());
+
+  explicit MultithreadedPDBMolSupplier(
+      std::istream *inStream, bool takeOwnership = true,
+      const Parameters &params = Parameters(),
+      const PDBParserParams &parseParams = PDBParserParams());
+
+  ~MultithreadedPDBMolSupplier() override;
+  void init() override {}
+
+  bool getEnd() const override;
+
+  //! reads next record and returns whether or not EOF was hit
+  bool extractNextRecord(std::string &record, unsigned int &lineNum,
+                         unsigned int &index) override;
+  //! parses the record and returns the resulting molecule
+  RWMol *processMoleculeRecord(const std::string &record,
+                               unsigned int lineNum) override;
+
+ private:
+  void initFromSettings(bool takeOwnership, const Parameters &params,
+                        const PDBParserParams &parseParams);
+
+  bool df_end = false;  //!< have we reached the end of the file?
+  int d_line = 0;       //!< line number we are currently on
+  unsigned int d_currentRecordId = 1;  //!< current record id
+  PDBParserParams d_parseParams;
+};
+}  // namespace FileParsers
+}  // namespace v2
+
+inline namespace v1 {
+class RDKIT_FILEPARSERS_EXPORT MultithreadedPDBMolSupplier
+    : public MolSupplier {
+ public:
+  using ContainedType = v2::FileParsers::MultithreadedPDBMolSupplier;
+  MultithreadedPDBMolSupplier() {}
+  explicit MultithreadedPDBMolSupplier(
+      const std::string &fileName, bool sanitize = true, bool removeHs = true,
+      unsigned int flavor = 0, bool proximityBonding = true,
+      unsigned int numWriterThreads = 1, size_t sizeInputQueue = 5,
+      size_t sizeOutputQueue = 5) {
+    v2::FileParsers::MultithreadedPDBMolSupplier::Parameters params;
+    params.numWriterThreads = numWriterThreads;
+    params.sizeInputQueue = sizeInputQueue;
+    params.sizeOutputQueue = sizeOutputQueue;
+    v2::FileParsers::PDBParserParams parseParams;
+    parseParams.sanitize = sanitize;
+    parseParams.removeHs = removeHs;
+    parseParams.flavor = flavor;
+    parseParams.proximityBonding = proximityBonding;
+
+    dp_supplier.reset(new v2::FileParsers::MultithreadedPDBMolSupplier(
+        fileName, params, parseParams));
+  }
+
+  explicit MultithreadedPDBMolSupplier(
+      std::istream *inStream, bool takeOwnership = true, bool sanitize = true,
+      bool removeHs = true, unsigned int flavor = 0,
+      bool proximityBonding = true, unsigned int numWriterThreads = 1,
+      size_t sizeInputQueue = 5, size_t sizeOutputQueue = 5) {
+    v2::FileParsers::MultithreadedPDBMolSupplier::Parameters params;
+    params.numWriterThreads = numWriterThreads;
+    params.sizeInputQueue = sizeInputQueue;
+    params.sizeOutputQueue = sizeOutputQueue;
+    v2::FileParsers::PDBParserParams parseParams;
+    parseParams.sanitize = sanitize;
+    parseParams.removeHs = removeHs;
+    parseParams.flavor = flavor;
+    parseParams.proximityBonding = proximityBonding;
+
+    dp_supplier.reset(new v2::FileParsers::MultithreadedPDBMolSupplier(
+        inStream, takeOwnership, params, parseParams));
+  }
+
+  //! returns the record id of the last extracted item
+  unsigned int getLastRecordId() const {
+    PRECONDITION(dp_supplier, "no supplier");
+    return static_cast<ContainedType *>(dp_supplier.get())->getLastRecordId();
+  }
+  //! returns the text block for the last extracted item
+  std::string getLastItemText() const {
+    PRECONDITION(dp_supplier, "no supplier");
+    return static_cast<ContainedType *>(dp_supplier.get())->getLastItemText();
+  }
+};
+}  // namespace v1
+}  // namespace RDKit
+#endif
+#endif
@@ -140,7 +140,7 @@ bool MultithreadedSDMolSupplier::extractNextRecord(std::string &record,
 }
 
 void MultithreadedSDMolSupplier::readMolProps(RWMol &mol,
-                                              std::istringstream &inStream) {
+                                              std::istream &inStream) {
   PRECONDITION(inStream, "no stream");
   bool hasProp = false;
   bool warningIssued = false;
@@ -243,7 +243,8 @@ void MultithreadedSDMolSupplier::readMolProps(RWMol &mol,
 RWMol *MultithreadedSDMolSupplier::processMoleculeRecord(
     const std::string &record, unsigned int lineNum) {
   PRECONDITION(dp_inStream, "no stream");
-  std::istringstream inStream(record);
+  // parse the record in place rather than copying it into a stringstream
+  StringViewInStream inStream(record);
   auto res =
       v2::FileParsers::MolFromMolDataStream(inStream, lineNum, d_parseParams);
   if (res) {
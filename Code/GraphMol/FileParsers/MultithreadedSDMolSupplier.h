@@ -42,7 +42,7 @@ class RDKIT_FILEPARSERS_EXPORT MultithreadedSDMolSupplier
   //! reads next record and returns whether or not EOF was hit
   bool extractNextRecord(std::string &record, unsigned int &lineNum,
                          unsigned int &index) override;
-  void readMolProps(RWMol &mol, std::istringstream &inStream);
+  void readMolProps(RWMol &mol, std::istream &inStream);
   //! parses the record and returns the resulting molecule
   RWMol *processMoleculeRecord(const std::string &record,
                                unsigned int lineNum) override;
@@ -51,7 +51,6 @@ class RDKIT_FILEPARSERS_EXPORT MultithreadedSDMolSupplier
   void initFromSettings(bool takeOwnership, const Parameters &params,
                         const MolFileParserParams &parseParams);
 
-  Parameters d_params;
   bool df_end = false;  //!< have we reached the end of the file?
   int d_line = 0;       //!< line number we are currently on
   bool df_processPropertyLists = true;
@@ -0,0 +1,57 @@
+#ifdef RDK_BUILD_THREADSAFE_SSS
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "MultithreadedSDWriter.h"
+
+#include <RDGeneral/RDLog.h>
+
+namespace RDKit {
+MultithreadedSDWriter::MultithreadedSDWriter(const std::string &fileName,
+                                             const Parameters &params) {
+  openStream(fileName);
+  initFromSettings(params);
+}
+
+MultithreadedSDWriter::MultithreadedSDWriter(std::ostream *outStream,
+                                             bool takeOwnership,
+                                             const Parameters &params) {
+  setStream(outStream, takeOwnership);
+  initFromSettings(params);
+}
+
+MultithreadedSDWriter::~MultithreadedSDWriter() {
+  // the threads use formatRecord(), so they need to be finished before we
+  // are destroyed
+  close();
+}
+
+void MultithreadedSDWriter::initFromSettings(const Parameters &params) {
+  d_params = params;
+  d_params.numWriterThreads = getNumThreadsToUse(params.numWriterThreads);
+  startThreads();
+}
+
+void MultithreadedSDWriter::setProps(const STR_VECT &propNames) {
+  if (d_molid > 0) {
+    BOOST_LOG(rdWarningLog) << "WARNING: Setting property list after a few "
+                               "molecules have been written\n";
+  }
+  // the property list is used by the formatting threads
+  flush();
+  d_props = propNames;
+}
+
+std::string MultithreadedSDWriter::formatRecord(const ROMol &mol, int confId,
+                                                unsigned int molid) {
+  return SDWriter::getText(mol, confId, df_kekulize, df_forceV3000,
+                           static_cast<int>(molid), &d_props);
+}
+}  // namespace RDKit
+#endif
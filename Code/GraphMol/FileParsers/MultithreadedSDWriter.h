@@ -0,0 +1,64 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#ifdef RDK_BUILD_THREADSAFE_SSS
+#ifndef MULTITHREADED_SD_WRITER
+#define MULTITHREADED_SD_WRITER
+#include "MultithreadedMolWriter.h"
+namespace RDKit {
+
+//! Writes SD files, the mol blocks and property blocks are generated on
+//! multiple threads. The output is the same as from SDWriter.
+//! This class is still a bit experimental and the public API may change
+//! in future releases.
+class RDKIT_FILEPARSERS_EXPORT MultithreadedSDWriter
+    : public MultithreadedMolWriter {
+ public:
+  /*!
+    \param fileName       : filename to write to ("-" to write to stdout)
+    \param params         : controls the threads and queues
+   */
+  explicit MultithreadedSDWriter(const std::string &fileName,
+                                 const Parameters &params = Parameters());
+  explicit MultithreadedSDWriter(std::ostream *outStream,
+                                 bool takeOwnership = false,
+                                 const Parameters &params = Parameters());
+  ~MultithreadedSDWriter() override;
+
+  //! \brief set a vector of property names that are need to be
+  //! written out for each molecule
+  void setProps(const STR_VECT &propNames) override;
+
+  //! changing the settings waits for the queued molecules to be written
+  void setForceV3000(bool val) {
+    flush();
+    df_forceV3000 = val;
+  }
+  bool getForceV3000() const { return df_forceV3000; }
+
+  void setKekulize(bool val) {
+    flush();
+    df_kekulize = val;
+  }
+  bool getKekulize() const { return df_kekulize; }
+
+ protected:
+  std::string formatRecord(const ROMol &mol, int confId,
+                           unsigned int molid) override;
+
+ private:
+  void initFromSettings(const Parameters &params);
+
+  STR_VECT d_props;  // list of property name that need to be written out
+  bool df_forceV3000 = false;  // force writing the mol blocks as V3000
+  bool df_kekulize = true;     // toggle kekulization of molecules on writing
+};
+}  // namespace RDKit
+#endif
+#endif
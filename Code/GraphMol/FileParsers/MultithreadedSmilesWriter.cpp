@@ -0,0 +1,89 @@
+#ifdef RDK_BUILD_THREADSAFE_SSS
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "MultithreadedSmilesWriter.h"
+
+#include <RDGeneral/RDLog.h>
+
+namespace RDKit {
+MultithreadedSmilesWriter::MultithreadedSmilesWriter(
+    const std::string &fileName, const std::string &delimiter,
+    const std::string &nameHeader, bool includeHeader, bool isomericSmiles,
+    bool kekuleSmiles, const Parameters &params) {
+  openStream(fileName);
+  initFromSettings(delimiter, nameHeader, includeHeader, isomericSmiles,
+                   kekuleSmiles, params);
+}
+
+MultithreadedSmilesWriter::MultithreadedSmilesWriter(
+    std::ostream *outStream, const std::string &delimiter,
+    const std::string &nameHeader, bool includeHeader, bool takeOwnership,
+    bool isomericSmiles, bool kekuleSmiles, const Parameters &params) {
+  setStream(outStream, takeOwnership);
+  initFromSettings(delimiter, nameHeader, includeHeader, isomericSmiles,
+                   kekuleSmiles, params);
+}
+
+MultithreadedSmilesWriter::~MultithreadedSmilesWriter() {
+  // the threads use formatRecord(), so they need to be finished before we
+  // are destroyed
+  close();
+}
+
+void MultithreadedSmilesWriter::initFromSettings(
+    const std::string &delimiter, const std::string &nameHeader,
+    bool includeHeader, bool isomericSmiles, bool kekuleSmiles,
+    const Parameters &params) {
+  d_delim = delimiter;
+  d_nameHeader = nameHeader;
+  df_includeHeader = includeHeader;
+  df_isomericSmiles = isomericSmiles;
+  df_kekuleSmiles = kekuleSmiles;
+  d_params = params;
+  d_params.numWriterThreads = getNumThreadsToUse(params.numWriterThreads);
+  startThreads();
+}
+
+void MultithreadedSmilesWriter::setProps(const STR_VECT &propNames) {
+  if (d_molid > 0) {
+    BOOST_LOG(rdErrorLog)
+        << "ERROR: Atleast one molecule has already been written\n";
+    BOOST_LOG(rdErrorLog)
+        << "ERROR: Cannot set properties now - ignoring setProps\n";
+    return;
+  }
+  d_props = propNames;
+}
+
+std::string MultithreadedSmilesWriter::getHeaderText() const {
+  if (!df_includeHeader) {
+    return "";
+  }
+  std::string res = "SMILES" + d_delim;
+  if (d_nameHeader != "") {
+    res += d_nameHeader + d_delim;
+  }
+  for (auto pi = d_props.begin(); pi != d_props.end(); ++pi) {
+    if (pi != d_props.begin()) {
+      res += d_delim;
+    }
+    res += *pi;
+  }
+  res += "\n";
+  return res;
+}
+
+std::string MultithreadedSmilesWriter::formatRecord(const ROMol &mol, int,
+                                                    unsigned int molid) {
+  return SmilesWriter::getText(mol, d_delim, d_nameHeader != "", molid,
+                               d_props, df_isomericSmiles, df_kekuleSmiles);
+}
+}  // namespace RDKit
+#endif
@@ -0,0 +1,76 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#ifdef RDK_BUILD_THREADSAFE_SSS
+#ifndef MULTITHREADED_SMILES_WRITER
+#define MULTITHREADED_SMILES_WRITER
+#include "MultithreadedMolWriter.h"
+namespace RDKit {
+
+//! Writes SMILES files, the SMILES are generated on multiple threads. The
+//! output is the same as from SmilesWriter.
+//! This class is still a bit experimental and the public API may change
+//! in future releases.
+class RDKIT_FILEPARSERS_EXPORT MultithreadedSmilesWriter
+    : public MultithreadedMolWriter {
+ public:
+  /*!
+    \param fileName       : filename to write to ("-" to write to stdout)
+    \param delimiter      : delimiter to use in the text file
+    \param nameHeader     : used to label the name column in the output. If this
+                            is provided as the empty string, no names will be
+                            written.
+    \param includeHeader  : toggles inclusion of a header line in the output
+    \param isomericSmiles : toggles generation of isomeric SMILES
+    \param kekuleSmiles   : toggles the generation of kekule SMILES
+    \param params         : controls the threads and queues
+   */
+  explicit MultithreadedSmilesWriter(const std::string &fileName,
+                                     const std::string &delimiter = " ",
+                                     const std::string &nameHeader = "Name",
+                                     bool includeHeader = true,
+                                     bool isomericSmiles = true,
+                                     bool kekuleSmiles = false,
+                                     const Parameters &params = Parameters());
+  //! \overload
+  explicit MultithreadedSmilesWriter(std::ostream *outStream,
+                                     const std::string &delimiter = " ",
+                                     const std::string &nameHeader = "Name",
+                                     bool includeHeader = true,
+                                     bool takeOwnership = false,
+                                     bool isomericSmiles = true,
+                                     bool kekuleSmiles = false,
+                                     const Parameters &params = Parameters());
+  ~MultithreadedSmilesWriter() override;
+
+  //! \brief set a vector of property names that are need to be
+  //! written out for each molecule
+  void setProps(const STR_VECT &propNames) override;
+
+ protected:
+  std::string formatRecord(const ROMol &mol, int confId,
+                           unsigned int molid) override;
+  std::string getHeaderText() const override;
+
+ private:
+  void initFromSettings(const std::string &delimiter,
+                        const std::string &nameHeader, bool includeHeader,
+                        bool isomericSmiles, bool kekuleSmiles,
+                        const Parameters &params);
+
+  bool df_includeHeader;     // whether or not to include a title line
+  std::string d_delim;       // delimiter string between various records
+  std::string d_nameHeader;  // header for the name column in the output file
+  STR_VECT d_props;        // list of property name that need to be written out
+  bool df_isomericSmiles;  // whether or not to do isomeric smiles
+  bool df_kekuleSmiles;    // whether or not to do kekule smiles
+};
+}  // namespace RDKit
+#endif
+#endif
@@ -0,0 +1,110 @@
+#ifdef RDK_BUILD_THREADSAFE_SSS
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "MultithreadedTDTMolSupplier.h"
+
+namespace RDKit {
+namespace v2 {
+namespace FileParsers {
+MultithreadedTDTMolSupplier::MultithreadedTDTMolSupplier(
+    const std::string &fileName, const Parameters &params,
+    const TDTMolSupplierParams &parseParams) {
+  dp_inStream = openAndCheckStream(fileName);
+  initFromSettings(true, params, parseParams);
+  POSTCONDITION(dp_inStream, "bad instream");
+  startThreads();
+}
+
+MultithreadedTDTMolSupplier::MultithreadedTDTMolSupplier(
+    std::istream *inStream, bool takeOwnership, const Parameters &params,
+    const TDTMolSupplierParams &parseParams) {
+  PRECONDITION(inStream, "bad stream");
+  dp_inStream = inStream;
+  initFromSettings(takeOwnership, params, parseParams);
+  POSTCONDITION(dp_inStream, "bad instream");
+  startThreads();
+}
+
+void MultithreadedTDTMolSupplier::initFromSettings(
+    bool takeOwnership, const Parameters &params,
+    const TDTMolSupplierParams &parseParams) {
+  df_owner = takeOwnership;
+  d_params = params;
+  d_parseParams = parseParams;
+  d_params.numWriterThreads = getNumThreadsToUse(params.numWriterThreads);
+  d_inputQueue =
+      new ConcurrentQueue<std::tuple<std::string, unsigned int, unsigned int>>(
+          d_params.sizeInputQueue);
+  d_outputQueue =
+      new ConcurrentQueue<std::tuple<RWMol *, std::string, unsigned int>>(
+          d_params.sizeOutputQueue);
+  df_end = false;
+  d_line = 0;
+}
+
+MultithreadedTDTMolSupplier::~MultithreadedTDTMolSupplier() {
+  if (df_owner && dp_inStream) {
+    delete dp_inStream;
+    df_owner = false;
+    dp_inStream = nullptr;
+  }
+}
+
+bool MultithreadedTDTMolSupplier::getEnd() const {
+  PRECONDITION(dp_inStream, "no stream");
+  return df_end;
+}
+
+bool MultithreadedTDTMolSupplier::extractNextRecord(std::string &record,
+                                                    unsigned int &lineNum,
+                                                    unsigned int &index) {
+  PRECONDITION(dp_inStream, "no stream");
+  // records start with the $SMI element, anything before that (like the
+  // header records) is skipped
+  std::string tempStr;
+  while (tempStr.find("$SMI<") != 0) {
+    if (dp_inStream->eof() || dp_inStream->fail()) {
+      df_end = true;
+      return false;
+    }
+    std::getline(*dp_inStream, tempStr);
+    ++d_line;
+  }
+  lineNum = d_line;
+  record = tempStr;
+  record += '\n';
+  while (!dp_inStream->eof() && !dp_inStream->fail() &&
+         tempStr.find("|") != 0) {
+    std::getline(*dp_inStream, tempStr);
+    ++d_line;
+    record += tempStr;
+    record += '\n';
+  }
+  index = d_currentRecordId;
+  ++d_currentRecordId;
+  return true;
+}
+
+RWMol *MultithreadedTDTMolSupplier::processMoleculeRecord(
+    const std::string &record, unsigned int lineNum) {
+  RDUNUSED_PARAM(lineNum);
+  // the record contains a single molecule, so we let TDTMolSupplier do
+  // the actual parsing
+  TDTMolSupplier suppl;
+  suppl.setData(record, d_parseParams);
+  if (suppl.atEnd()) {
+    return nullptr;
+  }
+  return suppl.next().release();
+}
+}  // namespace FileParsers
+}  // namespace v2
+}  // namespace RDKit
+#endif
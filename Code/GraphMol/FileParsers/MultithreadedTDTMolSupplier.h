@@ -0,0 +1,120 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#ifdef RDK_BUILD_THREADSAFE_SSS
+#ifndef MULTITHREADED_TDT_MOL_SUPPLIER
+#define MULTITHREADED_TDT_MOL_SUPPLIER
+#include "MultithreadedMolSupplier.h"
+namespace RDKit {
+namespace v2 {
+namespace FileParsers {
+
+//! concurrently parses the records of a TDT file
+/*!
+  The molecules and their properties are the same as those returned by
+  TDTMolSupplier.
+
+  This class is still a bit experimental and the public API may change
+  in future releases.
+*/
+class RDKIT_FILEPARSERS_EXPORT MultithreadedTDTMolSupplier
+    : public MultithreadedMolSupplier {
+ public:
+  explicit MultithreadedTDTMolSupplier(
+      const std::string &fileName, const Parameters &params = Parameters(),
+      const TDTMolSupplierParams &parseParams = TDTMolSupplierParams());
+
+  explicit MultithreadedTDTMolSupplier(
+      std::istream *inStream, bool takeOwnership = true,
+      const Parameters &params = Parameters(),
+      const TDTMolSupplierParams &parseParams = TDTMolSupplierParams());
+
+  ~MultithreadedTDTMolSupplier() override;
+  void init() override {}
+
+  bool getEnd() const override;
+
+  //! reads next record and returns whether or not EOF was hit
+  bool extractNextRecord(std::string &record, unsigned int &lineNum,
+                         unsigned int &index) override;
+  //! parses the record and returns the resulting molecule
+  RWMol *processMoleculeRecord(const std::string &record,
+                               unsigned int lineNum) override;
+
+ private:
+  void initFromSettings(bool takeOwnership, const Parameters &params,
+                        const TDTMolSupplierParams &parseParams);
+
+  bool df_end = false;  //!< have we reached the end of the file?
+  int d_line = 0;       //!< line number we are currently on
+  unsigned int d_currentRecordId = 1;  //!< current record id
+  TDTMolSupplierParams d_parseParams;
+};
+}  // namespace FileParsers
+}  // namespace v2
+
+inline namespace v1 {
+class RDKIT_FILEPARSERS_EXPORT MultithreadedTDTMolSupplier
+    : public MolSupplier {
+ public:
+  using ContainedType = v2::FileParsers::MultithreadedTDTMolSupplier;
+  MultithreadedTDTMolSupplier() {}
+  explicit MultithreadedTDTMolSupplier(
+      const std::string &fileName, const std::string &nameRecord = "",
+      int confId2D = -1, int confId3D = 0, bool sanitize = true,
+      unsigned int numWriterThreads = 1, size_t sizeInputQueue = 5,
+      size_t sizeOutputQueue = 5) {
+    v2::FileParsers::MultithreadedTDTMolSupplier::Parameters params;
+    params.numWriterThreads = numWriterThreads;
+    params.sizeInputQueue = sizeInputQueue;
+    params.sizeOutputQueue = sizeOutputQueue;
+    v2::FileParsers::TDTMolSupplierParams parseParams;
+    parseParams.nameRecord = nameRecord;
+    parseParams.confId2D = confId2D;
+    parseParams.confId3D = confId3D;
+    parseParams.parseParameters.sanitize = sanitize;
+
+    dp_supplier.reset(new v2::FileParsers::MultithreadedTDTMolSupplier(
+        fileName, params, parseParams));
+  }
+
+  explicit MultithreadedTDTMolSupplier(
+      std::istream *inStream, bool takeOwnership = true,
+      const std::string &nameRecord = "", int confId2D = -1, int confId3D = 0,
+      bool sanitize = true, unsigned int numWriterThreads = 1,
+      size_t sizeInputQueue = 5, size_t sizeOutputQueue = 5) {
+    v2::FileParsers::MultithreadedTDTMolSupplier::Parameters params;
+    params.numWriterThreads = numWriterThreads;
+    params.sizeInputQueue = sizeInputQueue;
+    params.sizeOutputQueue = sizeOutputQueue;
+    v2::FileParsers::TDTMolSupplierParams parseParams;
+    parseParams.nameRecord = nameRecord;
+    parseParams.confId2D = confId2D;
+    parseParams.confId3D = confId3D;
+    parseParams.parseParameters.sanitize = sanitize;
+
+    dp_supplier.reset(new v2::FileParsers::MultithreadedTDTMolSupplier(
+        inStream, takeOwnership, params, parseParams));
+  }
+
+  //! returns the record id of the last extracted item
+  unsigned int getLastRecordId() const {
+    PRECONDITION(dp_supplier, "no supplier");
+    return static_cast<ContainedType *>(dp_supplier.get())->getLastRecordId();
+  }
+  //! returns the text block for the last extracted item
+  std::string getLastItemText() const {
+    PRECONDITION(dp_supplier, "no supplier");
+    return static_cast<ContainedType *>(dp_supplier.get())->getLastItemText();
+  }
+};
+}  // namespace v1
+}  // namespace RDKit
+#endif
+#endif
@@ -9,9 +9,13 @@
 //
 #include <cstring>
 #include <cstdio>
+#include <exception>
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <utility>
+#include <vector>
 #include <RDGeneral/BoostStartInclude.h>
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
@@ -21,6 +25,7 @@
 #include <GraphMol/FileParsers/FileParsers.h>
 #include <GraphMol/FileParsers/FileParserUtils.h>
 #include <RDGeneral/LocaleSwitcher.h>
+#include <RDGeneral/RDThreads.h>
 #include "ProximityBonds.h"
 
 #include <GraphMol/MonomerInfo.h>
@@ -49,9 +54,19 @@ Atom *PDBAtomFromSymbol(const char *symb) {
   return elemno > 0 ? new Atom(elemno) : (Atom *)nullptr;
 }
 
-void PDBAtomLine(RWMol *mol, const char *ptr, unsigned int len,
-                 unsigned int flavor, std::map<int, Atom *> &amap) {
-  PRECONDITION(mol, "bad mol");
+// The result of parsing a single ATOM/HETATM record. The records don't
+// depend on each other, so they can be parsed in parallel and then added to
+// the molecule in file order.
+struct PDBAtomRecord {
+  std::unique_ptr<Atom> atom;  // empty if the record was skipped
+  int serialno = 0;
+  bool hasPos = false;
+  RDGeom::Point3D pos;
+  std::exception_ptr error;
+};
+
+void PDBAtomLine(const char *ptr, unsigned int len, unsigned int flavor,
+                 PDBAtomRecord &rec) {
   PRECONDITION(ptr, "bad char ptr");
   std::string tmp;
 
@@ -165,12 +180,12 @@ void PDBAtomLine(RWMol *mol, const char *ptr, unsigned int len,
     errout << "Cannot determine element for PDB atom #" << serialno;
     throw FileParseException(errout.str());
   }
-
-  mol->addAtom(atom, true, true);
-  amap[serialno] = atom;
+  rec.atom.reset(atom);
+  rec.serialno = serialno;
 
   if (len >= 38) {
-    RDGeom::Point3D pos;
+    RDGeom::Point3D &pos = rec.pos;
+    rec.hasPos = true;
     try {
       pos.x = FileParserUtils::toDouble(std::string(ptr + 30, 8));
       if (len >= 46) {
@@ -184,20 +199,6 @@ void PDBAtomLine(RWMol *mol, const char *ptr, unsigned int len,
       errout << "Problem with coordinates for PDB atom #" << serialno;
       throw FileParseException(errout.str());
     }
-
-    Conformer *conf;
-    if (!mol->getNumConformers()) {
-      conf = new RDKit::Conformer(mol->getNumAtoms());
-      conf->set3D(pos.z != 0.0);
-      conf->setId(0);
-      mol->addConformer(conf, false);
-    } else {
-      conf = &mol->getConformer();
-      if (pos.z != 0.0) {
-        conf->set3D(true);
-      }
-    }
-    conf->setAtomPos(atom->getIdx(), pos);
   }
 
   if (len >= 79) {
@@ -308,6 +309,96 @@ void PDBAtomLine(RWMol *mol, const char *ptr, unsigned int len,
   info->setTempFactor(bfactor);
 }
 
+void PDBAddAtom(RWMol *mol, PDBAtomRecord &rec, std::map<int, Atom *> &amap) {
+  PRECONDITION(mol, "bad mol");
+  if (rec.error) {
+    std::rethrow_exception(rec.error);
+  }
+  if (!rec.atom) {
+    return;
+  }
+  Atom *atom = rec.atom.release();
+  mol->addAtom(atom, true, true);
+  amap[rec.serialno] = atom;
+
+  if (rec.hasPos) {
+    const RDGeom::Point3D &pos = rec.pos;
+    Conformer *conf;
+    if (!mol->getNumConformers()) {
+      conf = new RDKit::Conformer(mol->getNumAtoms());
+      conf->set3D(pos.z != 0.0);
+      conf->setId(0);
+      mol->addConformer(conf, false);
+    } else {
+      conf = &mol->getConformer();
+      if (pos.z != 0.0) {
+        conf->set3D(true);
+      }
+    }
+    conf->setAtomPos(atom->getIdx(), pos);
+  }
+}
+
+bool IsPDBAtomRecord(const char *str) {
+  return (str[0] == 'A' && str[1] == 'T' && str[2] == 'O' && str[3] == 'M' &&
+          str[4] == ' ' && str[5] == ' ') ||
+         (str[0] == 'H' && str[1] == 'E' && str[2] == 'T' && str[3] == 'A' &&
+          str[4] == 'T' && str[5] == 'M');
+}
+
+bool IsPDBEndModelRecord(const char *str) {
+  return str[0] == 'E' && str[1] == 'N' && str[2] == 'D' && str[3] == 'M' &&
+         str[4] == 'D' && str[5] == 'L';
+}
+
+// Parses the ATOM/HETATM records of the first model. Any parse error is
+// stored with its record and rethrown when the record is added, so errors are
+// reported in file order.
+void PDBParseAtomRecords(
+    const std::vector<std::pair<const char *, unsigned int>> &lines,
+    unsigned int flavor, int numThreads, std::vector<PDBAtomRecord> &records) {
+  std::vector<unsigned int> atomLines;
+  for (unsigned int i = 0; i < lines.size(); ++i) {
+    if (IsPDBEndModelRecord(lines[i].first)) {
+      break;
+    }
+    if (IsPDBAtomRecord(lines[i].first)) {
+      atomLines.push_back(i);
+    }
+  }
+  records.resize(atomLines.size());
+  auto parseRecord = [&](unsigned int i) {
+    try {
+      const auto &line = lines[atomLines[i]];
+      PDBAtomLine(line.first, line.second, flavor, records[i]);
+    } catch (...) {
+      records[i].atom.reset();
+      records[i].error = std::current_exception();
+    }
+  };
+
+  unsigned int nThreads = getNumThreadsToUse(numThreads);
+  if (nThreads > atomLines.size() / 1000 + 1) {
+    nThreads = atomLines.size() / 1000 + 1;
+  }
+  if (nThreads == 1) {
+    for (unsigned int i = 0; i < atomLines.size(); ++i) {
+      parseRecord(i);
+    }
+  } else {
+    // one index per thread: the locale is per-thread, so each worker needs
+    // its own switcher
+    runOnIndices(
+        [&](size_t ti) {
+          Utils::LocaleSwitcher ls;
+          for (auto i = ti; i < atomLines.size(); i += nThreads) {
+            parseRecord(i);
+          }
+        },
+        nThreads, nThreads);
+  }
+}
+
 void PDBBondLine(RWMol *mol, const char *ptr, unsigned int len,
                  std::map<int, Atom *> &amap, std::map<Bond *, int> &bmap) {
   PRECONDITION(mol, "bad mol");
@@ -547,7 +638,8 @@ void BasicPDBCleanup(RWMol &mol) {
 }
 
 void parsePdbBlock(RWMol *&mol, const char *str, bool sanitize, bool removeHs,
-                   unsigned int flavor, bool proximityBonding) {
+                   unsigned int flavor, bool proximityBonding, int numThreads,
+                   bool buildResidueTable) {
   PRECONDITION(str, "bad char ptr");
   std::map<int, Atom *> amap;
   std::map<Bond *, int> bmap;
@@ -556,6 +648,7 @@ void parsePdbBlock(RWMol *&mol, const char *str, bool sanitize, bool removeHs,
   int conformer_atmidx = 0;
   Conformer *conf = nullptr;
 
+  std::vector<std::pair<const char *, unsigned int>> lines;
   while (*str) {
     unsigned int len;
     const char *next = str + 1;
@@ -578,30 +671,29 @@ void parsePdbBlock(RWMol *&mol, const char *str, bool sanitize, bool removeHs,
       }
       next++;
     }
+    lines.emplace_back(str, len);
+    str = next;
+  }
 
-    // ATOM records
-    if (str[0] == 'A' && str[1] == 'T' && str[2] == 'O' && str[3] == 'M' &&
-        str[4] == ' ' && str[5] == ' ') {
-      if (!multi_conformer) {
-        if (!mol) {
-          mol = new RWMol();
-        }
-        PDBAtomLine(mol, str, len, flavor, amap);
-      } else {
-        PDBConformerLine(mol, str, len, conf, conformer_atmidx);
-      }
-      // HETATM records
-    } else if (str[0] == 'H' && str[1] == 'E' && str[2] == 'T' &&
-               str[3] == 'A' && str[4] == 'T' && str[5] == 'M') {
+  std::vector<PDBAtomRecord> records;
+  PDBParseAtomRecords(lines, flavor, numThreads, records);
+  unsigned int recordIdx = 0;
+
+  for (const auto &line : lines) {
+    str = line.first;
+    unsigned int len = line.second;
+
+    // ATOM and HETATM records
+    if (IsPDBAtomRecord(str)) {
       if (!multi_conformer) {
         if (!mol) {
           mol = new RWMol();
         }
-        PDBAtomLine(mol, str, len, flavor, amap);
+        PDBAddAtom(mol, records[recordIdx++], amap);
       } else {
         PDBConformerLine(mol, str, len, conf, conformer_atmidx);
       }
-      // CONECT records
+    // CONECT records
     } else if (str[0] == 'C' && str[1] == 'O' && str[2] == 'N' &&
                str[3] == 'E' && str[4] == 'C' && str[5] == 'T') {
       if (mol && !multi_conformer) {
@@ -625,8 +717,7 @@ void parsePdbBlock(RWMol *&mol, const char *str, bool sanitize, bool removeHs,
       }
       PDBTitleLine(mol, str, len < 50 ? len : 50);
       // ENDMDL records
-    } else if (str[0] == 'E' && str[1] == 'N' && str[2] == 'D' &&
-               str[3] == 'M' && str[4] == 'D' && str[5] == 'L') {
+    } else if (IsPDBEndModelRecord(str)) {
       if (!mol) {
         break;
       }
@@ -634,7 +725,6 @@ void parsePdbBlock(RWMol *&mol, const char *str, bool sanitize, bool removeHs,
       conformer_atmidx = 0;
       conf = nullptr;
     }
-    str = next;
   }
 
   if (!mol) {
@@ -642,7 +732,7 @@ void parsePdbBlock(RWMol *&mol, const char *str, bool sanitize, bool removeHs,
   }
 
   if (proximityBonding) {
-    ConnectTheDots(mol, ctdIGNORE_H_H_CONTACTS);
+    ConnectTheDots(mol, ctdIGNORE_H_H_CONTACTS, numThreads);
   }
   // flavor & 8 doesn't encode double bonds
   if (proximityBonding || flavor & 8) {
@@ -665,6 +755,10 @@ void parsePdbBlock(RWMol *&mol, const char *str, bool sanitize, bool removeHs,
   /* Set tetrahedral chirality from 3D co-ordinates */
   MolOps::assignChiralTypesFrom3D(*mol);
   StandardPDBResidueChirality(mol);
+
+  if (buildResidueTable) {
+    mol->buildPDBResidueTable();
+  }
 }
 }  // namespace
 
@@ -675,7 +769,8 @@ std::unique_ptr<RWMol> MolFromPDBBlock(const std::string &str,
                                        const PDBParserParams &params) {
   RWMol *res = nullptr;
   parsePdbBlock(res, str.c_str(), params.sanitize, params.removeHs,
-                params.flavor, params.proximityBonding);
+                params.flavor, params.proximityBonding, params.numThreads,
+                params.buildResidueTable);
   return std::unique_ptr<RWMol>(res);
 }
 
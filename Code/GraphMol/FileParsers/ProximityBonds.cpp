@@ -12,6 +12,7 @@
 #include <GraphMol/RDKitBase.h>
 #include <GraphMol/RWMol.h>
 #include <GraphMol/MonomerInfo.h>
+#include <RDGeneral/RDThreads.h>
 
 namespace RDKit {
 
@@ -29,7 +30,8 @@ struct ProximityEntry {
   bool operator<(const ProximityEntry &p) const { return x < p.x; }
 };
 
-static bool IsBonded(ProximityEntry *p, ProximityEntry *q, unsigned int flags) {
+static bool IsBonded(const ProximityEntry *p, const ProximityEntry *q,
+                     unsigned int flags) {
   if (flags & ctdIGNORE_H_H_CONTACTS && p->elem == 1 && q->elem == 1) {
     return false;
   }
@@ -162,21 +164,58 @@ constexpr int HASHX = 571;
 constexpr int HASHY = 127;
 constexpr int HASHZ = 3;
 
-static void ConnectTheDots_Large(RWMol *mol, unsigned int flags) {
+// Finds the proximity bonds to atoms with lower indices for the atoms in
+// [begin, end). The pairs are produced in the order in which the serial
+// incremental search visits them, so adding them in sequence gives the
+// same bond ordering regardless of how the atoms are partitioned.
+static void FindProximityBonds(
+    RWMol *mol, unsigned int flags, const std::vector<ProximityEntry> &tmp,
+    const int *HashTable, unsigned int begin, unsigned int end,
+    std::vector<std::pair<unsigned int, unsigned int>> &res) {
+  for (unsigned int i = begin; i < end; i++) {
+    const ProximityEntry *tmpi = &tmp[i];
+    Atom *atom = mol->getAtomWithIdx(i);
+    for (int dx = -HASHX; dx <= HASHX; dx += HASHX) {
+      for (int dy = -HASHY; dy <= HASHY; dy += HASHY) {
+        for (int dz = -HASHZ; dz <= HASHZ; dz += HASHZ) {
+          int probe = tmpi->hash + dx + dy + dz;
+          int list = HashTable[probe & HASHMASK];
+          while (list != -1) {
+            const ProximityEntry *tmpj = &tmp[list];
+            if (static_cast<unsigned int>(list) < i && tmpj->hash == probe &&
+                IsBonded(tmpi, tmpj, flags) &&
+                !IsBlacklistedPair(atom, mol->getAtomWithIdx(tmpj->atm))) {
+              res.emplace_back(i, tmpj->atm);
+            }
+            list = tmpj->next;
+          }
+        }
+      }
+    }
+  }
+}
+
+static void ConnectTheDots_Large(RWMol *mol, unsigned int flags,
+                                 int numThreads) {
   int HashTable[HASHSIZE];
   memset(HashTable, -1, sizeof(HashTable));
 
   unsigned int count = mol->getNumAtoms();
-  auto *tmp = (ProximityEntry *)malloc(count * sizeof(ProximityEntry));
-  CHECK_INVARIANT(tmp, "bad allocation");
+  std::vector<ProximityEntry> tmp(count);
   PeriodicTable *table = PeriodicTable::getTable();
   Conformer *conf = &mol->getConformer();
 
+  // small molecules aren't worth splitting up
+  unsigned int nThreads = getNumThreadsToUse(numThreads);
+  if (nThreads > count / 1000 + 1) {
+    nThreads = count / 1000 + 1;
+  }
+
   for (unsigned int i = 0; i < count; i++) {
     Atom *atom = mol->getAtomWithIdx(i);
     unsigned int elem = atom->getAtomicNum();
     RDGeom::Point3D p = conf->getAtomPos(i);
-    ProximityEntry *tmpi = tmp + i;
+    ProximityEntry *tmpi = &tmp[i];
     tmpi->x = (float)p.x;
     tmpi->y = (float)p.y;
     tmpi->z = (float)p.z;
@@ -187,19 +226,21 @@ static void ConnectTheDots_Large(RWMol *mol, unsigned int flags) {
     int hash = HASHX * (int)(p.x / MAXDIST) + HASHY * (int)(p.y / MAXDIST) +
                HASHZ * (int)(p.z / MAXDIST);
 
-    for (int dx = -HASHX; dx <= HASHX; dx += HASHX) {
-      for (int dy = -HASHY; dy <= HASHY; dy += HASHY) {
-        for (int dz = -HASHZ; dz <= HASHZ; dz += HASHZ) {
-          int probe = hash + dx + dy + dz;
-          int list = HashTable[probe & HASHMASK];
-          while (list != -1) {
-            ProximityEntry *tmpj = &tmp[list];
-            if (tmpj->hash == probe && IsBonded(tmpi, tmpj, flags) &&
-                !mol->getBondBetweenAtoms(tmpi->atm, tmpj->atm) &&
-                !IsBlacklistedPair(atom, mol->getAtomWithIdx(tmpj->atm))) {
-              mol->addBond(tmpi->atm, tmpj->atm, Bond::SINGLE);
+    if (nThreads == 1) {
+      for (int dx = -HASHX; dx <= HASHX; dx += HASHX) {
+        for (int dy = -HASHY; dy <= HASHY; dy += HASHY) {
+          for (int dz = -HASHZ; dz <= HASHZ; dz += HASHZ) {
+            int probe = hash + dx + dy + dz;
+            int list = HashTable[probe & HASHMASK];
+            while (list != -1) {
+              ProximityEntry *tmpj = &tmp[list];
+              if (tmpj->hash == probe && IsBonded(tmpi, tmpj, flags) &&
+                  !mol->getBondBetweenAtoms(tmpi->atm, tmpj->atm) &&
+                  !IsBlacklistedPair(atom, mol->getAtomWithIdx(tmpj->atm))) {
+                mol->addBond(tmpi->atm, tmpj->atm, Bond::SINGLE);
+              }
+              list = tmpj->next;
             }
-            list = tmpj->next;
           }
         }
       }
@@ -209,6 +250,31 @@ static void ConnectTheDots_Large(RWMol *mol, unsigned int flags) {
     HashTable[list] = i;
     tmpi->hash = hash;
   }
+
+  if (nThreads > 1) {
+    // the neighbor search only reads the molecule, so it can be split across
+    // threads once the hash table is complete; the bonds themselves are added
+    // serially afterwards
+    std::vector<std::vector<std::pair<unsigned int, unsigned int>>> pairs(
+        nThreads);
+    unsigned int chunk = (count + nThreads - 1) / nThreads;
+    runOnIndices(
+        [&](size_t ti) {
+          unsigned int begin = std::min<unsigned int>(count, ti * chunk);
+          unsigned int end = std::min(count, begin + chunk);
+          FindProximityBonds(mol, flags, tmp, HashTable, begin, end,
+                             pairs[ti]);
+        },
+        nThreads, nThreads);
+    for (const auto &threadPairs : pairs) {
+      for (const auto &pr : threadPairs) {
+        if (!mol->getBondBetweenAtoms(pr.first, pr.second)) {
+          mol->addBond(pr.first, pr.second, Bond::SINGLE);
+        }
+      }
+    }
+  }
+
   // Cleanup pass
   for (unsigned int i = 0; i < count; i++) {
     Atom *atom = mol->getAtomWithIdx(i);
@@ -248,15 +314,14 @@ static void ConnectTheDots_Large(RWMol *mol, unsigned int flags) {
       }
     }
   }
-  free(tmp);
 }
 
-void ConnectTheDots(RWMol *mol, unsigned int flags) {
+void ConnectTheDots(RWMol *mol, unsigned int flags, int numThreads) {
   if (!mol || !mol->getNumConformers()) {
     return;
   }
   // Determine optimal algorithm to use by getNumAtoms()?
-  ConnectTheDots_Large(mol, flags);
+  ConnectTheDots_Large(mol, flags, numThreads);
 }
 
 // These are macros to allow their use in C++ constants
@@ -17,8 +17,16 @@ static const unsigned int ctdIGNORE_H_H_CONTACTS = 0x1;
 // static const unsigned int ctdALL_FLAGS = 0xFFFFFFFF;
 class AtomPDBResidueInfo;
 RDKIT_FILEPARSERS_EXPORT bool IsBlacklistedPair(Atom *beg_atom, Atom *end_atom);
+//! adds single bonds between atoms that are within covalent bonding distance
+/*!
+  \param numThreads  the number of threads used for the neighbor search. If
+                     this is <= 0, the number of threads used is the number
+                     of hardware threads plus this value. The bonds added
+                     do not depend on the number of threads.
+*/
 RDKIT_FILEPARSERS_EXPORT void ConnectTheDots(RWMol *mol,
-                                             unsigned int flags = 0);
+                                             unsigned int flags = 0,
+                                             int numThreads = 1);
 RDKIT_FILEPARSERS_EXPORT void StandardPDBResidueBondOrders(RWMol *mol);
 RDKIT_FILEPARSERS_EXPORT bool SamePDBResidue(AtomPDBResidueInfo *p,
                                              AtomPDBResidueInfo *q);
@@ -165,20 +165,44 @@ std::string SDMolSupplier::getItemText(unsigned int idx) {
   moveTo(idx);
   std::streampos begP = d_molpos[idx];
   std::streampos endP;
+  bool lastItem = false;
   try {
     moveTo(idx + 1);
     endP = d_molpos[idx + 1];
   } catch (FileParseException &) {
-    dp_inStream->clear();
-    dp_inStream->seekg(0, std::ios_base::end);
-    endP = dp_inStream->tellg();
+    lastItem = true;
   }
   d_last = holder;
-  auto *buff = new char[endP - begP];
+  // streams which can seek relative to their end use byte offsets, so the
+  // length of the item is just the difference of the positions
+  dp_inStream->clear();
+  dp_inStream->seekg(0, std::ios_base::end);
+  if (!dp_inStream->fail()) {
+    if (lastItem) {
+      endP = dp_inStream->tellg();
+    }
+    auto *buff = new char[endP - begP];
+    dp_inStream->seekg(begP);
+    dp_inStream->read(buff, endP - begP);
+    std::string res(buff, endP - begP);
+    delete[] buff;
+    return res;
+  }
+  // otherwise the positions are virtual offsets (e.g. on BGZF streams) and
+  // the text is read line by line until we reach the start of the next item
+  dp_inStream->clear();
   dp_inStream->seekg(begP);
-  dp_inStream->read(buff, endP - begP);
-  std::string res(buff, endP - begP);
-  delete[] buff;
+  std::string res;
+  std::string line;
+  while (std::getline(*dp_inStream, line)) {
+    res += line;
+    if (!dp_inStream->eof()) {
+      res += '\n';
+    }
+    if (!lastItem && dp_inStream->tellg() == endP) {
+      break;
+    }
+  }
   return res;
 }
 
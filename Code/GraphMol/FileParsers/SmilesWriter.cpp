@@ -114,39 +114,50 @@ SmilesWriter::~SmilesWriter() {
   }
 }
 
-void SmilesWriter::write(const ROMol &mol, int) {
-  CHECK_INVARIANT(dp_ostream, "no output stream");
-  if (d_molid <= 0 && df_includeHeader) {
-    dumpHeader();
-  }
-
+std::string SmilesWriter::getText(const ROMol &mol,
+                                  const std::string &delimiter,
+                                  bool includeName, unsigned int molid,
+                                  const STR_VECT &propNames,
+                                  bool isomericSmiles, bool kekuleSmiles) {
+  std::stringstream sstr;
   std::string name = "";
-  std::string smi = MolToSmiles(mol, df_isomericSmiles, df_kekuleSmiles);
-  (*dp_ostream) << smi;
-  if (d_nameHeader != "") {
+  std::string smi = MolToSmiles(mol, isomericSmiles, kekuleSmiles);
+  sstr << smi;
+  if (includeName) {
     if (!mol.getPropIfPresent(common_properties::_Name, name) ||
         name.size() == 0) {
       std::stringstream tstream;
-      tstream << d_molid;
+      tstream << molid;
       name = tstream.str();
     }
 
-    (*dp_ostream) << d_delim << name;
+    sstr << delimiter << name;
   }
 
   STR_VECT_CI pi;
-  for (pi = d_props.begin(); pi != d_props.end(); pi++) {
+  for (pi = propNames.begin(); pi != propNames.end(); pi++) {
     std::string pval;
     // FIX: we will assume that any property that the user requests is castable
     // to
     // a std::string
     if (mol.getPropIfPresent(*pi, pval)) {
-      (*dp_ostream) << d_delim << pval;
+      sstr << delimiter << pval;
     } else {
-      (*dp_ostream) << d_delim << "";
+      sstr << delimiter << "";
     }
   }
-  (*dp_ostream) << "\n";
+  sstr << "\n";
+  return sstr.str();
+}
+
+void SmilesWriter::write(const ROMol &mol, int) {
+  CHECK_INVARIANT(dp_ostream, "no output stream");
+  if (d_molid <= 0 && df_includeHeader) {
+    dumpHeader();
+  }
+
+  (*dp_ostream) << getText(mol, d_delim, d_nameHeader != "", d_molid, d_props,
+                           df_isomericSmiles, df_kekuleSmiles);
   d_molid++;
 }
 }  // namespace RDKit
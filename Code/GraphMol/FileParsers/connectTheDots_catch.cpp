@@ -63,4 +63,40 @@ TEST_CASE(
     ConnectTheDots(m.get());
     CHECK(m->getNumBonds() == 1);
   }
-}
\ No newline at end of file
+}
+
+namespace {
+std::string readPDBTestFile(const std::string &name) {
+  std::string rdbase = getenv("RDBASE");
+  std::ifstream ifs(rdbase + "/Code/GraphMol/FileParsers/test_data/" + name);
+  REQUIRE(ifs);
+  return std::string(std::istreambuf_iterator<char>(ifs),
+                     std::istreambuf_iterator<char>());
+}
+
+void compareBonds(const ROMol &m1, const ROMol &m2) {
+  REQUIRE(m1.getNumBonds() == m2.getNumBonds());
+  for (unsigned int i = 0; i < m1.getNumBonds(); ++i) {
+    const auto b1 = m1.getBondWithIdx(i);
+    const auto b2 = m2.getBondWithIdx(i);
+    CHECK(b1->getBeginAtomIdx() == b2->getBeginAtomIdx());
+    CHECK(b1->getEndAtomIdx() == b2->getEndAtomIdx());
+    CHECK(b1->getBondType() == b2->getBondType());
+  }
+}
+}  // namespace
+
+TEST_CASE("parallel ConnectTheDots") {
+  auto pdb = readPDBTestFile("github1029.1jld.pdb");
+  v2::FileParsers::PDBParserParams ps;
+  ps.proximityBonding = false;
+  ps.sanitize = false;
+  auto m1 = v2::FileParsers::MolFromPDBBlock(pdb, ps);
+  REQUIRE(m1);
+  REQUIRE(m1->getNumBonds() == 0);
+  RWMol m2(*m1);
+  ConnectTheDots(m1.get(), ctdIGNORE_H_H_CONTACTS);
+  ConnectTheDots(&m2, ctdIGNORE_H_H_CONTACTS, 4);
+  CHECK(m1->getNumBonds() > 0);
+  compareBonds(*m1, m2);
+}
@@ -22,6 +22,7 @@
 #include <GraphMol/MolPickler.h>
 #include <GraphMol/Chirality.h>
 #include <GraphMol/FileParsers/FileParsers.h>
+#include <GraphMol/FileParsers/FileParserUtils.h>
 #include <GraphMol/FileParsers/MolSupplier.h>
 #include <GraphMol/SmilesParse/SmilesWrite.h>
 #include <GraphMol/SmilesParse/SmilesParse.h>
@@ -7327,3 +7328,56 @@ TEST_CASE("Github #7306: bad crossed bonds in large aromatic rings") {
     CHECK(ctab.find("2  3\n") == std::string::npos);
   }
 }
+
+TEST_CASE("parsing from string views") {
+  SECTION("numeric fields") {
+    // coordinates which overflow their field are still read completely
+    std::string txt = "-15355.5894 F";
+    CHECK(FileParserUtils::toDouble(std::string_view(txt).substr(0, 10)) ==
+          -15355.5894);
+    CHECK(FileParserUtils::toDouble(std::string_view("  +2.25")) == 2.25);
+    CHECK(FileParserUtils::toDouble(std::string_view("   -1.0")) == -1.0);
+    CHECK(FileParserUtils::toDouble(std::string_view("    ")) == 0.0);
+    CHECK_THROWS_AS(FileParserUtils::toDouble(std::string_view("1.0x")),
+                    boost::bad_lexical_cast);
+    std::string itxt = "12345";
+    CHECK(FileParserUtils::toInt(std::string_view(itxt).substr(0, 2)) == 12);
+    CHECK(FileParserUtils::toUnsigned(std::string_view(itxt).substr(1, 3)) ==
+          234);
+  }
+  SECTION("StringViewInStream") {
+    std::string buf = "line1\r\nline2\nline3";
+    StringViewInStream strm(std::string_view(buf).substr(0, 11));
+    std::string line;
+    getLine(&strm, line);
+    CHECK(line == "line1");
+    auto pos = strm.tellg();
+    getLine(&strm, line);
+    CHECK(line == "line");
+    CHECK(strm.eof());
+    strm.clear();
+    strm.seekg(pos);
+    CHECK(getLine(&strm) == "line");
+  }
+  SECTION("mol blocks in a larger buffer") {
+    auto m = "C[C@H](F)C(=O)[O-].[Na+]"_smiles;
+    REQUIRE(m);
+    for (const auto &block : {MolToMolBlock(*m), MolToV3KMolBlock(*m)}) {
+      // the view is not followed by a null
+      auto buffer = block + block;
+      StringViewInStream strm(std::string_view(buffer).substr(0, block.size()));
+      unsigned int line = 0;
+      auto m2 = v2::FileParsers::MolFromMolDataStream(strm, line);
+      REQUIRE(m2);
+      CHECK(MolToSmiles(*m2) == MolToSmiles(*m));
+      auto m3 = v2::FileParsers::MolFromMolBlock(block);
+      REQUIRE(m3);
+      REQUIRE(m3->getNumAtoms() == m2->getNumAtoms());
+      for (unsigned int i = 0; i < m2->getNumAtoms(); ++i) {
+        auto p2 = m2->getConformer().getAtomPos(i);
+        auto p3 = m3->getConformer().getAtomPos(i);
+        CHECK((p2 - p3).length() < 1e-8);
+      }
+    }
+  }
+}
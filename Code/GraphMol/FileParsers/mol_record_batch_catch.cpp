@@ -0,0 +1,397 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "RDGeneral/test.h"
+#include <catch2/catch_all.hpp>
+#include <GraphMol/RDKitBase.h>
+#include <GraphMol/FileParsers/MolRecordBatch.h>
+#include <GraphMol/FileParsers/MolSupplier.h>
+#include <GraphMol/FileParsers/MolWriters.h>
+#include <GraphMol/Fingerprints/MorganGenerator.h>
+#include <GraphMol/SmilesParse/SmilesParse.h>
+#include <GraphMol/SmilesParse/SmilesWrite.h>
+#include <RDGeneral/FileParseException.h>
+#include <RDGeneral/StreamOps.h>
+
+using namespace RDKit;
+
+namespace {
+std::vector<std::unique_ptr<ROMol>> readNCIMols() {
+  std::string rdbase = getenv("RDBASE");
+  SDMolSupplier sup(rdbase + "/Data/NCI/first_200.props.sdf");
+  std::vector<std::unique_ptr<ROMol>> res;
+  while (!sup.atEnd()) {
+    std::unique_ptr<ROMol> mol(sup.next());
+    if (mol) {
+      res.push_back(std::move(mol));
+    }
+  }
+  return res;
+}
+
+std::vector<const ROMol *> getPointers(
+    const std::vector<std::unique_ptr<ROMol>> &mols) {
+  std::vector<const ROMol *> res;
+  for (const auto &mol : mols) {
+    res.push_back(mol.get());
+  }
+  return res;
+}
+}  // namespace
+
+TEST_CASE("MolRecordBatch property columns") {
+  auto m1 = "CCO"_smiles;
+  REQUIRE(m1);
+  m1->setProp(common_properties::_Name, "ethanol");
+  m1->setProp("count", 3);
+  m1->setProp("weight", 46.07);
+  m1->setProp("flag", true);
+  m1->setProp("mixed", 1);
+  auto m2 = "c1ccccc1"_smiles;
+  REQUIRE(m2);
+  m2->setProp("count", 6u);
+  m2->setProp("weight", 78);
+  m2->setProp("mixed", std::string("six"));
+  m2->setProp("extra", std::string("only here"));
+
+  std::vector<const ROMol *> mols{m1.get(), nullptr, m2.get()};
+  SECTION("column types") {
+    auto batch = makeMolRecordBatch(mols);
+    CHECK(batch.getNumRows() == 3);
+    CHECK(batch.getMolFormat() == MolRecordFormat::Pickle);
+    REQUIRE(!batch.getColumns().empty());
+    CHECK(batch.getColumns()[0].name == "pickle");
+    CHECK(batch.getColumns()[0].type == MolRecordBatch::ColumnType::Binary);
+
+    const auto &count = batch.getColumn("count");
+    CHECK(count.type == MolRecordBatch::ColumnType::Int64);
+    CHECK(count.isValid(0));
+    CHECK(!count.isValid(1));
+    CHECK(count.getInt64(0) == 3);
+    CHECK(count.getInt64(2) == 6);
+
+    // ints are converted to doubles once a double has been seen
+    const auto &weight = batch.getColumn("weight");
+    CHECK(weight.type == MolRecordBatch::ColumnType::Double);
+    CHECK(weight.getDouble(0) == Catch::Approx(46.07));
+    CHECK(weight.getDouble(2) == Catch::Approx(78.0));
+
+    const auto &flag = batch.getColumn("flag");
+    CHECK(flag.type == MolRecordBatch::ColumnType::Bool);
+    CHECK(flag.getBool(0));
+    CHECK(!flag.isValid(2));
+
+    const auto &mixed = batch.getColumn("mixed");
+    CHECK(mixed.type == MolRecordBatch::ColumnType::String);
+    CHECK(mixed.getString(0) == "1");
+    CHECK(mixed.getString(2) == "six");
+
+    // columns that first show up in later rows are back-filled with nulls
+    const auto &extra = batch.getColumn("extra");
+    CHECK(!extra.isValid(0));
+    CHECK(!extra.isValid(1));
+    CHECK(extra.getString(2) == "only here");
+
+    CHECK(batch.getColumn(common_properties::_Name).getString(0) ==
+          "ethanol");
+    CHECK_THROWS_AS(batch.getColumn("missing"), KeyErrorException);
+  }
+  SECTION("selected properties") {
+    MolRecordBatchParams params;
+    params.propNames = {"count"};
+    params.includeName = false;
+    auto batch = makeMolRecordBatch(mols, params);
+    CHECK(batch.getColumns().size() == 2);
+    CHECK(batch.hasColumn("count"));
+    CHECK(!batch.hasColumn("weight"));
+    CHECK(!batch.hasColumn(common_properties::_Name));
+  }
+  SECTION("molecules") {
+    for (auto molFormat : {MolRecordFormat::Pickle, MolRecordFormat::SMILES}) {
+      MolRecordBatchParams params;
+      params.molFormat = molFormat;
+      auto batch = makeMolRecordBatch(mols, params);
+      CHECK(!batch.getMol(1));
+      auto mol = batch.getMol(0);
+      REQUIRE(mol);
+      CHECK(MolToSmiles(*mol) == "CCO");
+      CHECK(mol->getProp<std::string>(common_properties::_Name) == "ethanol");
+      CHECK(mol->getProp<int>("count") == 3);
+      CHECK(mol->getProp<double>("weight") == Catch::Approx(46.07));
+      CHECK(mol->getProp<bool>("flag"));
+      CHECK(!mol->hasProp("extra"));
+      mol = batch.getMol(2);
+      REQUIRE(mol);
+      CHECK(MolToSmiles(*mol) == "c1ccccc1");
+      CHECK(mol->getProp<std::string>("extra") == "only here");
+    }
+  }
+}
+
+TEST_CASE("MolRecordBatch fingerprint columns") {
+  std::unique_ptr<FingerprintGenerator<std::uint64_t>> fpgen(
+      MorganFingerprint::getMorganGenerator<std::uint64_t>(2));
+  MolRecordBatchParams params;
+  params.fingerprints.emplace_back("morgan2", [&fpgen](const ROMol &mol) {
+    return std::unique_ptr<ExplicitBitVect>(fpgen->getFingerprint(mol));
+  });
+  auto m1 = "CCOC(=O)c1ccccc1"_smiles;
+  REQUIRE(m1);
+  auto m2 = "OCCN"_smiles;
+  REQUIRE(m2);
+  std::vector<const ROMol *> mols{m1.get(), nullptr, m2.get()};
+  auto batch = makeMolRecordBatch(mols, params);
+  const auto &col = batch.getColumn("morgan2");
+  CHECK(col.type == MolRecordBatch::ColumnType::Bits);
+  CHECK(col.width == 2048);
+  CHECK(col.data.size() == 3 * 2048 / 8);
+  CHECK(!batch.getFingerprint("morgan2", 1));
+  for (auto row : {0u, 2u}) {
+    auto fp = batch.getFingerprint("morgan2", row);
+    REQUIRE(fp);
+    std::unique_ptr<ExplicitBitVect> ref(fpgen->getFingerprint(*mols[row]));
+    CHECK(*fp == *ref);
+  }
+  CHECK_THROWS_AS(batch.getFingerprint(common_properties::_Name, 0),
+                  ValueErrorException);
+}
+
+TEST_CASE("MolRecordBatch writer and reader") {
+  auto mols = readNCIMols();
+  REQUIRE(mols.size() > 128);
+  std::stringstream ss;
+  {
+    MolRecordBatchWriter writer(&ss, false, MolRecordBatchParams(), 64);
+    for (const auto &mol : mols) {
+      writer.write(*mol);
+    }
+    CHECK(writer.numMols() == mols.size());
+  }
+  MolRecordBatchReader reader(&ss);
+  std::vector<size_t> batchSizes;
+  size_t idx = 0;
+  while (!reader.atEnd()) {
+    auto batch = reader.next();
+    batchSizes.push_back(batch->getNumRows());
+    for (size_t row = 0; row < batch->getNumRows(); ++row, ++idx) {
+      auto mol = batch->getMol(row);
+      REQUIRE(mol);
+      CHECK(MolToSmiles(*mol) == MolToSmiles(*mols[idx]));
+      CHECK(mol->getNumConformers() == 1);
+      CHECK(mol->getProp<std::string>(common_properties::_Name) ==
+            mols[idx]->getProp<std::string>(common_properties::_Name));
+      CHECK(mol->getProp<std::string>("AMW") ==
+            mols[idx]->getProp<std::string>("AMW"));
+      CHECK(mol->hasProp("P1") == mols[idx]->hasProp("P1"));
+    }
+  }
+  CHECK(idx == mols.size());
+  CHECK(batchSizes.size() == (mols.size() + 63) / 64);
+  CHECK(batchSizes[0] == 64);
+  CHECK_THROWS_AS(reader.next(), FileParseException);
+
+  SECTION("bad input") {
+    std::stringstream bad("this is not a batch file");
+    CHECK_THROWS_AS(MolRecordBatchReader(&bad), FileParseException);
+  }
+  SECTION("whole batches") {
+    std::stringstream ss2;
+    {
+      MolRecordBatchWriter writer(&ss2);
+      writer.write(makeMolRecordBatch(getPointers(mols)));
+    }
+    MolRecordBatchReader reader2(&ss2);
+    auto batch = reader2.next();
+    CHECK(batch->getNumRows() == mols.size());
+    CHECK(reader2.atEnd());
+  }
+}
+
+TEST_CASE("MolRecordBatch corrupt input") {
+  using ColumnType = MolRecordBatch::ColumnType;
+  // writes a column in the layout used by MolRecordBatch::toStream()
+  auto writeColumn = [](std::ostream &ss, const std::string &name,
+                        ColumnType type, std::uint32_t width,
+                        std::uint64_t validitySize,
+                        const std::vector<std::int32_t> &offsets,
+                        std::uint64_t dataSize) {
+    streamWrite(ss, name);
+    streamWrite(ss, static_cast<std::uint8_t>(type));
+    streamWrite(ss, width);
+    streamWrite(ss, validitySize);
+    for (std::uint64_t i = 0; i < validitySize; ++i) {
+      streamWrite(ss, static_cast<std::uint8_t>(0xff));
+    }
+    streamWrite(ss, static_cast<std::uint64_t>(offsets.size()));
+    for (auto offset : offsets) {
+      streamWrite(ss, offset);
+    }
+    streamWrite(ss, dataSize);
+    for (std::uint64_t i = 0; i < dataSize; ++i) {
+      streamWrite(ss, static_cast<std::uint8_t>('C'));
+    }
+  };
+  // a batch with two rows, its SMILES column and one more column
+  auto makeBatch = [&](const std::function<void(std::ostream &)> &extra,
+                       const std::vector<std::int32_t> &smilesOffsets = {0, 1,
+                                                                         2}) {
+    std::stringstream ss;
+    streamWrite(ss, static_cast<std::uint64_t>(2));
+    streamWrite(ss, static_cast<std::uint8_t>(MolRecordFormat::SMILES));
+    streamWrite(ss, static_cast<std::uint32_t>(2));
+    writeColumn(ss, "smiles", ColumnType::String, 0, 1, smilesOffsets, 2);
+    extra(ss);
+    return ss.str();
+  };
+  auto parse = [](const std::string &data) {
+    std::istringstream iss(data);
+    MolRecordBatch batch;
+    batch.initFromStream(iss);
+    return batch.getNumRows();
+  };
+
+  SECTION("valid input") {
+    auto data = makeBatch([&](std::ostream &ss) {
+      writeColumn(ss, "fp", ColumnType::Bits, 12, 1, {}, 4);
+    });
+    CHECK(parse(data) == 2);
+  }
+  SECTION("offsets") {
+    auto noExtra = [&](std::ostream &ss) {
+      writeColumn(ss, "val", ColumnType::Int64, 0, 1, {}, 16);
+    };
+    CHECK(parse(makeBatch(noExtra)) == 2);
+    CHECK_THROWS_AS(parse(makeBatch(noExtra, {0, 2, 1})), FileParseException);
+    CHECK_THROWS_AS(parse(makeBatch(noExtra, {0, 1, 3})), FileParseException);
+    CHECK_THROWS_AS(parse(makeBatch(noExtra, {-1, 1, 2})),
+                    FileParseException);
+    CHECK_THROWS_AS(parse(makeBatch(noExtra, {0, 1})), FileParseException);
+  }
+  SECTION("fixed size data") {
+    CHECK_THROWS_AS(parse(makeBatch([&](std::ostream &ss) {
+                      writeColumn(ss, "val", ColumnType::Int64, 0, 1, {}, 8);
+                    })),
+                    FileParseException);
+    CHECK_THROWS_AS(parse(makeBatch([&](std::ostream &ss) {
+                      writeColumn(ss, "val", ColumnType::Double, 0, 1, {}, 17);
+                    })),
+                    FileParseException);
+    CHECK_THROWS_AS(parse(makeBatch([&](std::ostream &ss) {
+                      writeColumn(ss, "fp", ColumnType::Bits, 12, 1, {}, 3);
+                    })),
+                    FileParseException);
+    CHECK_THROWS_AS(parse(makeBatch([&](std::ostream &ss) {
+                      writeColumn(ss, "fp", ColumnType::Bits, 0, 1, {}, 2);
+                    })),
+                    FileParseException);
+  }
+  SECTION("molecule column") {
+    std::stringstream ss;
+    streamWrite(ss, static_cast<std::uint64_t>(2));
+    streamWrite(ss, static_cast<std::uint8_t>(MolRecordFormat::SMILES));
+    streamWrite(ss, static_cast<std::uint32_t>(1));
+    writeColumn(ss, "val", ColumnType::Int64, 0, 1, {}, 16);
+    CHECK_THROWS_AS(parse(ss.str()), FileParseException);
+  }
+  SECTION("buffer sizes larger than the input") {
+    std::stringstream ss;
+    streamWrite(ss, static_cast<std::uint64_t>(2));
+    streamWrite(ss, static_cast<std::uint8_t>(MolRecordFormat::SMILES));
+    streamWrite(ss, std::numeric_limits<std::uint32_t>::max());
+    streamWrite(ss, std::string("smiles"));
+    streamWrite(ss, static_cast<std::uint8_t>(ColumnType::String));
+    streamWrite(ss, static_cast<std::uint32_t>(0));
+    streamWrite(ss, std::numeric_limits<std::uint64_t>::max() / 2);
+    CHECK_THROWS_AS(parse(ss.str()), FileParseException);
+  }
+}
+
+TEST_CASE("MolRecordBatch benchmark", "[.][benchmark]") {
+  auto mols = readNCIMols();
+  // make the data set large enough to be timed
+  std::vector<const ROMol *> molPtrs;
+  for (unsigned int i = 0; i < 50; ++i) {
+    for (const auto &mol : mols) {
+      molPtrs.push_back(mol.get());
+    }
+  }
+  auto report = [&molPtrs](const std::string &label, const auto &t1,
+                           size_t nBytes) {
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "TIMING : " << label << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << molPtrs.size() << " molecules, "
+              << nBytes << " bytes" << std::endl;
+  };
+
+  std::string sdf;
+  {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::ostringstream ss;
+    SDWriter writer(&ss);
+    for (const auto mol : molPtrs) {
+      writer.write(*mol);
+    }
+    writer.close();
+    sdf = ss.str();
+    report("SDWriter", t1, sdf.size());
+  }
+  {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    SDMolSupplier sup;
+    sup.setData(sdf);
+    unsigned int nRead = 0;
+    while (!sup.atEnd()) {
+      std::unique_ptr<ROMol> mol(sup.next());
+      nRead += mol != nullptr;
+    }
+    report("SDMolSupplier", t1, sdf.size());
+    CHECK(nRead == molPtrs.size());
+  }
+  for (auto molFormat : {MolRecordFormat::Pickle, MolRecordFormat::SMILES}) {
+    std::string label =
+        molFormat == MolRecordFormat::Pickle ? "pickle" : "smiles";
+    MolRecordBatchParams params;
+    params.molFormat = molFormat;
+    std::string data;
+    {
+      auto t1 = std::chrono::high_resolution_clock::now();
+      std::ostringstream ss;
+      MolRecordBatchWriter writer(&ss, false, params, 1000);
+      for (const auto mol : molPtrs) {
+        writer.write(*mol);
+      }
+      writer.close();
+      data = ss.str();
+      report("MolRecordBatchWriter (" + label + ")", t1, data.size());
+    }
+    {
+      auto t1 = std::chrono::high_resolution_clock::now();
+      std::istringstream ss(data);
+      MolRecordBatchReader reader(&ss);
+      unsigned int nRead = 0;
+      while (!reader.atEnd()) {
+        auto batch = reader.next();
+        for (size_t row = 0; row < batch->getNumRows(); ++row) {
+          nRead += batch->getMol(row) != nullptr;
+        }
+      }
+      report("MolRecordBatchReader (" + label + ")", t1, data.size());
+      CHECK(nRead == molPtrs.size());
+    }
+  }
+}
@@ -0,0 +1,221 @@
+//
+//  Copyright (C) 2026 Greg Landrum and other RDKit contributors
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+
+#include <chrono>
+#include <clocale>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <streambuf>
+
+#include "RDGeneral/test.h"
+#include <catch2/catch_all.hpp>
+#include <GraphMol/RDKitBase.h>
+#include <GraphMol/MonomerInfo.h>
+#include <GraphMol/FileParsers/FileParsers.h>
+#include <GraphMol/FileParsers/FileWriters.h>
+#include <GraphMol/FileParsers/ProximityBonds.h>
+#include <GraphMol/SmilesParse/SmilesWrite.h>
+
+using namespace RDKit;
+
+namespace {
+std::string readPDBTestFile(const std::string &name) {
+  std::string rdbase = getenv("RDBASE");
+  std::ifstream ifs(rdbase + "/Code/GraphMol/FileParsers/test_data/" + name);
+  REQUIRE(ifs);
+  return std::string(std::istreambuf_iterator<char>(ifs),
+                     std::istreambuf_iterator<char>());
+}
+
+// builds a large structure from copies of the ATOM/HETATM records in pdb,
+// translated on an n x n x n grid
+std::string tilePDBBlock(const std::string &pdb, unsigned int n) {
+  std::vector<std::string> atomLines;
+  std::istringstream iss(pdb);
+  std::string line;
+  while (std::getline(iss, line)) {
+    if (line.size() >= 54 &&
+        (line.rfind("ATOM  ", 0) == 0 || line.rfind("HETATM", 0) == 0)) {
+      atomLines.push_back(line);
+    }
+  }
+  std::string res;
+  unsigned int serial = 0;
+  char buf[32];
+  for (unsigned int i = 0; i < n; ++i) {
+    for (unsigned int j = 0; j < n; ++j) {
+      for (unsigned int k = 0; k < n; ++k) {
+        for (auto atomLine : atomLines) {
+          snprintf(buf, sizeof(buf), "%5u", serial++ % 100000);
+          atomLine.replace(6, 5, buf);
+          double offsets[3] = {80.0 * i, 80.0 * j, 80.0 * k};
+          for (unsigned int d = 0; d < 3; ++d) {
+            auto pos = std::stod(atomLine.substr(30 + 8 * d, 8)) + offsets[d];
+            snprintf(buf, sizeof(buf), "%8.3f", pos);
+            atomLine.replace(30 + 8 * d, 8, buf);
+          }
+          res += atomLine + "\n";
+        }
+      }
+    }
+  }
+  return res + "END\n";
+}
+
+void compareMols(const ROMol &m1, const ROMol &m2) {
+  REQUIRE(m1.getNumAtoms() == m2.getNumAtoms());
+  REQUIRE(m1.getNumBonds() == m2.getNumBonds());
+  for (unsigned int i = 0; i < m1.getNumBonds(); ++i) {
+    const auto b1 = m1.getBondWithIdx(i);
+    const auto b2 = m2.getBondWithIdx(i);
+    CHECK(b1->getBeginAtomIdx() == b2->getBeginAtomIdx());
+    CHECK(b1->getEndAtomIdx() == b2->getEndAtomIdx());
+    CHECK(b1->getBondType() == b2->getBondType());
+  }
+  for (unsigned int i = 0; i < m1.getNumAtoms(); ++i) {
+    const auto info1 = static_cast<const AtomPDBResidueInfo *>(
+        m1.getAtomWithIdx(i)->getMonomerInfo());
+    const auto info2 = static_cast<const AtomPDBResidueInfo *>(
+        m2.getAtomWithIdx(i)->getMonomerInfo());
+    REQUIRE(info1);
+    REQUIRE(info2);
+    CHECK(info1->getSerialNumber() == info2->getSerialNumber());
+    CHECK(info1->getName() == info2->getName());
+    CHECK(info1->getResidueName() == info2->getResidueName());
+    CHECK(info1->getResidueNumber() == info2->getResidueNumber());
+    CHECK(info1->getChainId() == info2->getChainId());
+    auto p1 = m1.getConformer().getAtomPos(i);
+    auto p2 = m2.getConformer().getAtomPos(i);
+    CHECK((p1 - p2).length() < 1e-8);
+  }
+  CHECK(MolToSmiles(m1) == MolToSmiles(m2));
+}
+}  // namespace
+
+TEST_CASE("parallel PDB parsing") {
+  SECTION("same results as serial parsing") {
+    for (const auto fname :
+         {"1CRN.pdb", "2FVD.pdb", "4TNA.pdb", "github1029.1jld.pdb"}) {
+      INFO(fname);
+      auto pdb = readPDBTestFile(fname);
+      v2::FileParsers::PDBParserParams ps;
+      auto m1 = v2::FileParsers::MolFromPDBBlock(pdb, ps);
+      REQUIRE(m1);
+      ps.numThreads = 4;
+      auto m2 = v2::FileParsers::MolFromPDBBlock(pdb, ps);
+      REQUIRE(m2);
+      compareMols(*m1, *m2);
+    }
+  }
+  SECTION("comma decimal separator locale") {
+    auto pdb = tilePDBBlock(readPDBTestFile("1CRN.pdb"), 2);
+    v2::FileParsers::PDBParserParams ps;
+    auto m1 = v2::FileParsers::MolFromPDBBlock(pdb, ps);
+    REQUIRE(m1);
+    std::string oldLocale = std::setlocale(LC_ALL, nullptr);
+    if (!std::setlocale(LC_ALL, "de_DE.UTF-8")) {
+      WARN("de_DE.UTF-8 locale not available, skipping");
+    } else {
+      ps.numThreads = 4;
+      std::unique_ptr<RWMol> m2;
+      try {
+        m2 = v2::FileParsers::MolFromPDBBlock(pdb, ps);
+      } catch (...) {
+        std::setlocale(LC_ALL, oldLocale.c_str());
+        throw;
+      }
+      std::setlocale(LC_ALL, oldLocale.c_str());
+      REQUIRE(m2);
+      compareMols(*m1, *m2);
+    }
+  }
+  SECTION("parse errors are reported in file order") {
+    auto pdb = tilePDBBlock(readPDBTestFile("1CRN.pdb"), 2);
+    pdb.insert(pdb.size() - 4,
+               "ATOM   XXXX  N   THR A   1      17.047  14.099   3.625  1.00 "
+               "13.79           N\n"
+               "ATOM  YYYYY  N   THR A   1      17.047  14.099   3.625  1.00 "
+               "13.79           N\n");
+    v2::FileParsers::PDBParserParams ps;
+    ps.numThreads = 4;
+    CHECK_THROWS_WITH(v2::FileParsers::MolFromPDBBlock(pdb, ps),
+                      "Non-integer PDB serial number  XXXX");
+  }
+  SECTION("residue strings are interned") {
+    auto m = v2::FileParsers::MolFromPDBBlock(readPDBTestFile("1CRN.pdb"));
+    REQUIRE(m);
+    const auto info0 = static_cast<const AtomPDBResidueInfo *>(
+        m->getAtomWithIdx(0)->getMonomerInfo());
+    const auto info1 = static_cast<const AtomPDBResidueInfo *>(
+        m->getAtomWithIdx(1)->getMonomerInfo());
+    REQUIRE(info0);
+    REQUIRE(info1);
+    CHECK(info0->getResidueName() == "THR");
+    CHECK(&info0->getResidueName() == &info1->getResidueName());
+    CHECK(&info0->getChainId() == &info1->getChainId());
+    AtomPDBResidueInfo cp(*info0);
+    CHECK(&cp.getResidueName() == &info0->getResidueName());
+    cp.setResidueName("ALA");
+    CHECK(cp.getResidueName() == "ALA");
+    CHECK(info0->getResidueName() == "THR");
+    CHECK(internPDBString("ALA") == &cp.getResidueName());
+  }
+}
+
+TEST_CASE("residue table from the PDB parser") {
+  auto pdb = readPDBTestFile("1CRN.pdb");
+  auto m = v2::FileParsers::MolFromPDBBlock(pdb);
+  REQUIRE(m);
+  v2::FileParsers::PDBParserParams ps;
+  ps.buildResidueTable = true;
+  auto cm = v2::FileParsers::MolFromPDBBlock(pdb, ps);
+  REQUIRE(cm);
+  CHECK(!m->getPDBResidueTable());
+  REQUIRE(cm->getPDBResidueTable());
+  CHECK(cm->getPDBResidueTable()->getNumAtoms() == cm->getNumAtoms());
+  compareMols(*m, *cm);
+  CHECK(MolToPDBBlock(*cm) == MolToPDBBlock(*m));
+}
+
+TEST_CASE("PDB parsing benchmark", "[.][benchmark]") {
+  auto pdb = tilePDBBlock(readPDBTestFile("github1029.1jld.pdb"), 4);
+  for (auto numThreads : {1, 0}) {
+    v2::FileParsers::PDBParserParams ps;
+    ps.numThreads = numThreads;
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto m = v2::FileParsers::MolFromPDBBlock(pdb, ps);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    REQUIRE(m);
+    std::cout << "TIMING : MolFromPDBBlock numThreads=" << numThreads
+              << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << m->getNumAtoms() << " atoms"
+              << std::endl;
+
+    RWMol cp(*m);
+    cp.beginBatchEdit();
+    for (auto bond : cp.bonds()) {
+      cp.removeBond(bond->getBeginAtomIdx(), bond->getEndAtomIdx());
+    }
+    cp.commitBatchEdit();
+    t1 = std::chrono::high_resolution_clock::now();
+    ConnectTheDots(&cp, ctdIGNORE_H_H_CONTACTS, numThreads);
+    t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "TIMING : ConnectTheDots numThreads=" << numThreads
+              << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << cp.getNumAtoms() << " atoms"
+              << std::endl;
+    CHECK(cp.getNumBonds() > 0);
+  }
+}
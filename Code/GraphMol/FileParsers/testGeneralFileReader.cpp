@@ -15,10 +15,13 @@
 
 #include <boost/iostreams/device/file.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <map>
 #include <memory>
+#include <sstream>
 #include <string>
 
 #include "GeneralFileReader.h"
@@ -65,6 +68,10 @@ void testDetermineFormat() {
   determineFormat(fname7, fileFormat, compressionFormat);
   TEST_ASSERT(fileFormat == "sdf");
   TEST_ASSERT(compressionFormat == "gz");
+
+  determineFormat("something.smi.bgz", fileFormat, compressionFormat);
+  TEST_ASSERT(fileFormat == "smi");
+  TEST_ASSERT(compressionFormat == "bgz");
 }
 
 void testSdf() {
@@ -123,6 +130,109 @@ void testSdf() {
 #endif
 }
 
+void testBGZF() {
+#ifdef RDK_USE_BOOST_IOSTREAMS
+  std::string rdbase = getenv("RDBASE");
+  std::string fname =
+      rdbase + "/Code/GraphMol/FileParsers/test_data/NCI_aids_few.sdf";
+  std::string bgzfname = fname + ".bgz";
+  TEST_ASSERT(isBGZFFile(bgzfname));
+  TEST_ASSERT(!isBGZFFile(fname));
+  TEST_ASSERT(!isBGZFFile(fname + ".gz"));
+
+  std::vector<std::string> names;
+  {
+    SDMolSupplier sdsup(fname);
+    while (!sdsup.atEnd()) {
+      std::unique_ptr<ROMol> nmol(sdsup.next());
+      TEST_ASSERT(nmol);
+      names.push_back(nmol->getProp<std::string>(common_properties::_Name));
+    }
+  }
+  TEST_ASSERT(names.size() == 16);
+
+  //! a BGZF file can be read with the single and multithreaded suppliers
+  for (auto numThreads : {0u, 2u}) {
+    struct SupplierOptions opt;
+    opt.numWriterThreads = numThreads;
+    auto sdsup = getSupplier(bgzfname, opt);
+    std::vector<std::string> bgzfnames;
+    while (!sdsup->atEnd()) {
+      std::unique_ptr<ROMol> nmol(sdsup->next());
+      if (nmol) {
+        bgzfnames.push_back(
+            nmol->getProp<std::string>(common_properties::_Name));
+      }
+    }
+    if (!numThreads) {
+      TEST_ASSERT(bgzfnames == names);
+    } else {
+      std::sort(bgzfnames.begin(), bgzfnames.end());
+      auto sortedNames = names;
+      std::sort(sortedNames.begin(), sortedNames.end());
+      TEST_ASSERT(bgzfnames == sortedNames);
+    }
+  }
+
+  //! round trip through the writer, using small blocks
+  {
+    std::ifstream inStream(fname, std::ios_base::binary);
+    std::string text((std::istreambuf_iterator<char>(inStream)),
+                     std::istreambuf_iterator<char>());
+    std::string repeated;
+    for (unsigned int i = 0; i < 20; ++i) {
+      repeated += text;
+    }
+    std::stringstream compressed;
+    {
+      bgzfostream outStream(&compressed, false, 4);
+      outStream << repeated;
+    }
+    TEST_ASSERT(compressed.str().size() < repeated.size() / 4);
+    TEST_ASSERT(isBGZFStream(compressed));
+    bgzfstream inStream2(&compressed, false, 4);
+    std::string roundTrip((std::istreambuf_iterator<char>(inStream2)),
+                          std::istreambuf_iterator<char>());
+    TEST_ASSERT(roundTrip == repeated);
+
+    //! random access through the virtual offsets
+    compressed.clear();
+    compressed.seekg(0);
+    bgzfstream inStream3(&compressed, false, 2);
+    SDMolSupplier sdsup(&inStream3, false);
+    TEST_ASSERT(sdsup.length() == 20 * names.size());
+    for (auto idx : {250u, 3u, 17u, 319u, 100u}) {
+      std::unique_ptr<ROMol> nmol(sdsup[idx]);
+      TEST_ASSERT(nmol);
+      TEST_ASSERT(nmol->getProp<std::string>(common_properties::_Name) ==
+                  names[idx % names.size()]);
+    }
+
+    //! the item text spans block boundaries and matches the plain text
+    std::istringstream plainStream(repeated);
+    SDMolSupplier plainsup(&plainStream, false);
+    for (auto idx : {0u, 57u, 250u, 17u, 319u}) {
+      auto itemText = sdsup.getItemText(idx);
+      TEST_ASSERT(itemText == plainsup.getItemText(idx));
+      std::unique_ptr<ROMol> nmol(MolBlockToMol(itemText));
+      TEST_ASSERT(nmol);
+      TEST_ASSERT(nmol->getProp<std::string>(common_properties::_Name) ==
+                  names[idx % names.size()]);
+    }
+  }
+
+  {
+    bool ok = false;
+    try {
+      bgzfstream inStream(fname + ".gz");
+    } catch (const BadFileException&) {
+      ok = true;
+    }
+    TEST_ASSERT(ok);
+  }
+#endif
+}
+
 void testSmi() {
   //! Open uncompressed SMI file format, try .csv formats
   std::string mname;
@@ -267,6 +377,58 @@ void testTdt() {
     }
   }
   TEST_ASSERT(i == 10);
+
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  //! Use Multithreaded Supplier
+  opt.numWriterThreads = 2;
+  auto supMulti = getSupplier(fname, opt);
+  i = 0;
+  while (!supMulti->atEnd()) {
+    std::unique_ptr<ROMol> nmol(supMulti->next());
+    if (nmol) {
+      TEST_ASSERT(nmol->hasProp(common_properties::_Name));
+      TEST_ASSERT(!nmol->getNumConformers());
+      i++;
+    }
+  }
+  TEST_ASSERT(i == 10);
+#endif
+}
+
+void testPdb() {
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  std::string rdbase = getenv("RDBASE");
+  std::string fname = rdbase + "/Code/GraphMol/FileParsers/test_data/1CRN.pdb";
+  std::string fileFormat, compressionFormat;
+  determineFormat(fname, fileFormat, compressionFormat);
+  TEST_ASSERT(fileFormat == "pdb");
+  TEST_ASSERT(compressionFormat == "");
+
+  struct SupplierOptions opt;
+  auto suppl = getSupplier(fname, opt);
+  std::unique_ptr<ROMol> ref(PDBFileToMol(fname));
+  TEST_ASSERT(ref);
+  unsigned int i = 0;
+  while (!suppl->atEnd()) {
+    std::unique_ptr<ROMol> nmol(suppl->next());
+    if (nmol) {
+      TEST_ASSERT(nmol->getNumAtoms() == ref->getNumAtoms());
+      TEST_ASSERT(nmol->getNumBonds() == ref->getNumBonds());
+      i++;
+    }
+  }
+  TEST_ASSERT(i == 1);
+#else
+  // PDB files are not supported without the multithreaded supplier
+  std::string fileFormat, compressionFormat;
+  bool ok = false;
+  try {
+    determineFormat("1CRN.pdb", fileFormat, compressionFormat);
+  } catch (const BadFileException&) {
+    ok = true;
+  }
+  TEST_ASSERT(ok);
+#endif
 }
 
 int main() {
@@ -282,6 +444,11 @@ int main() {
   BOOST_LOG(rdErrorLog) << "Finished: testSdf()\n";
   BOOST_LOG(rdErrorLog) << "-----------------------------------------\n\n";
 
+  BOOST_LOG(rdErrorLog) << "\n-----------------------------------------\n";
+  testBGZF();
+  BOOST_LOG(rdErrorLog) << "Finished: testBGZF()\n";
+  BOOST_LOG(rdErrorLog) << "-----------------------------------------\n\n";
+
   BOOST_LOG(rdErrorLog) << "\n-----------------------------------------\n";
   testSmi();
   BOOST_LOG(rdErrorLog) << "Finished: testSmi()\n";
@@ -297,5 +464,10 @@ int main() {
   BOOST_LOG(rdErrorLog) << "Finished: testTdt()\n";
   BOOST_LOG(rdErrorLog) << "-----------------------------------------\n\n";
 
+  BOOST_LOG(rdErrorLog) << "\n-----------------------------------------\n";
+  testPdb();
+  BOOST_LOG(rdErrorLog) << "Finished: testPdb()\n";
+  BOOST_LOG(rdErrorLog) << "-----------------------------------------\n\n";
+
   return 0;
 }
@@ -9,7 +9,9 @@
 //
 
 #include <chrono>
+#include <fstream>
 #include <memory>
+#include <sstream>
 
 #include <GraphMol/Fingerprints/MorganFingerprints.h>
 #include <GraphMol/SmilesParse/SmilesWrite.h>
@@ -20,8 +22,11 @@
 #include <boost/iostreams/device/file.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 
+#include "MultithreadedMaeMolSupplier.h"
+#include "MultithreadedPDBMolSupplier.h"
 #include "MultithreadedSDMolSupplier.h"
 #include "MultithreadedSmilesMolSupplier.h"
+#include "MultithreadedTDTMolSupplier.h"
 
 namespace io = boost::iostreams;
 using namespace RDKit;
@@ -304,6 +309,163 @@ void testSDCorrectness() {
   testSDProperties();
 }
 
+void testPDBCorrectness() {
+  std::string rdbase = getenv("RDBASE");
+  std::string dirName = rdbase + "/Code/GraphMol/FileParsers/test_data/";
+  // a stream with several entries, each of the files ends with END
+  std::string text;
+  for (const auto fname : {"1ps3_zn.pdb", "2dej_APW.pdb", "2vnf_bindedHOH.pdb",
+                           "2c92_hypervalentH.pdb", "github1023.pdb"}) {
+    std::ifstream inf(dirName + fname);
+    std::stringstream buf;
+    buf << inf.rdbuf();
+    text += buf.str();
+    if (text.back() != '\n') {
+      text += '\n';
+    }
+  }
+  std::vector<std::string> expected;
+  {
+    std::istringstream inStream(text);
+    while (!inStream.eof()) {
+      std::unique_ptr<RWMol> mol(PDBDataStreamToMol(inStream, false, false));
+      if (mol) {
+        expected.push_back(MolToSmiles(*mol));
+      }
+    }
+  }
+  TEST_ASSERT(expected.size() == 5);
+
+  for (unsigned int numThreads : {1, 3}) {
+    std::istream *strm = new std::istringstream(text);
+    MultithreadedPDBMolSupplier sup(strm, true, false, false, 0, true,
+                                    numThreads);
+    std::vector<std::string> smis(expected.size());
+    unsigned int nMols = 0;
+    while (!sup.atEnd()) {
+      std::unique_ptr<ROMol> mol(sup.next());
+      if (mol) {
+        auto id = sup.getLastRecordId();
+        TEST_ASSERT(id >= 1 && id <= expected.size());
+        smis[id - 1] = MolToSmiles(*mol);
+        ++nMols;
+      }
+    }
+    TEST_ASSERT(nMols == expected.size());
+    TEST_ASSERT(smis == expected);
+  }
+
+  // each MODEL as a separate molecule
+  std::string models;
+  std::vector<std::string> expectedModels;
+  for (const auto fname : {"2dej_APW.pdb", "1ps3_zn.pdb", "2dej_APW.pdb"}) {
+    std::ifstream inf(dirName + fname);
+    std::string model = "MODEL\n";
+    std::string line;
+    while (std::getline(inf, line)) {
+      if (line.find("ATOM") == 0 || line.find("HETATM") == 0) {
+        model += line + "\n";
+      }
+    }
+    model += "ENDMDL\n";
+    models += model;
+    std::unique_ptr<RWMol> mol(PDBBlockToMol(model, false, false));
+    TEST_ASSERT(mol);
+    expectedModels.push_back(MolToSmiles(*mol));
+  }
+  models += "END\n";
+  std::istream *strm = new std::istringstream(models);
+  MultithreadedPDBMolSupplier sup(strm, true, false, false, 2, true, 2);
+  std::vector<std::string> smis(expectedModels.size());
+  unsigned int nMols = 0;
+  while (!sup.atEnd()) {
+    std::unique_ptr<ROMol> mol(sup.next());
+    if (mol) {
+      auto id = sup.getLastRecordId();
+      TEST_ASSERT(id >= 1 && id <= expectedModels.size());
+      smis[id - 1] = MolToSmiles(*mol);
+      ++nMols;
+    }
+  }
+  TEST_ASSERT(nMols == expectedModels.size());
+  TEST_ASSERT(smis == expectedModels);
+}
+
+void testTDTCorrectness() {
+  std::string rdbase = getenv("RDBASE");
+  std::string path =
+      rdbase + "/Code/GraphMol/FileParsers/test_data/acd_few.tdt";
+  std::vector<std::string> expected;
+  {
+    TDTMolSupplier sup(path, "PN", 2, 3);
+    while (!sup.atEnd()) {
+      std::unique_ptr<ROMol> mol(sup.next());
+      TEST_ASSERT(mol);
+      TEST_ASSERT(mol->getNumConformers() == 1);
+      expected.push_back(MolToSmiles(*mol) + " " +
+                         mol->getProp<std::string>(common_properties::_Name));
+    }
+  }
+  TEST_ASSERT(expected.size() == 10);
+
+  for (unsigned int numThreads : {1, 3}) {
+    MultithreadedTDTMolSupplier sup(path, "PN", 2, 3, true, numThreads);
+    std::vector<std::string> res(expected.size());
+    unsigned int nMols = 0;
+    while (!sup.atEnd()) {
+      std::unique_ptr<ROMol> mol(sup.next());
+      if (mol) {
+        auto id = sup.getLastRecordId();
+        TEST_ASSERT(id >= 1 && id <= expected.size());
+        TEST_ASSERT(mol->getNumConformers() == 1);
+        TEST_ASSERT(mol->getConformer(2).getNumAtoms() == mol->getNumAtoms());
+        res[id - 1] = MolToSmiles(*mol) + " " +
+                      mol->getProp<std::string>(common_properties::_Name);
+        ++nMols;
+      }
+    }
+    TEST_ASSERT(nMols == expected.size());
+    TEST_ASSERT(res == expected);
+  }
+}
+
+void testMaeCorrectness() {
+#ifdef RDK_BUILD_MAEPARSER_SUPPORT
+  std::string rdbase = getenv("RDBASE");
+  std::string path =
+      rdbase + "/Code/GraphMol/FileParsers/test_data/NCI_aids_few.mae";
+  std::vector<std::string> expected;
+  {
+    MaeMolSupplier sup(path);
+    while (!sup.atEnd()) {
+      std::unique_ptr<ROMol> mol(sup.next());
+      TEST_ASSERT(mol);
+      expected.push_back(MolToSmiles(*mol) + " " +
+                         mol->getProp<std::string>(common_properties::_Name));
+    }
+  }
+  TEST_ASSERT(expected.size() == 16);
+
+  for (unsigned int numThreads : {1, 3}) {
+    MultithreadedMaeMolSupplier sup(path, true, true, numThreads);
+    std::vector<std::string> res(expected.size());
+    unsigned int nMols = 0;
+    while (!sup.atEnd()) {
+      std::unique_ptr<ROMol> mol(sup.next());
+      if (mol) {
+        auto id = sup.getLastRecordId();
+        TEST_ASSERT(id >= 1 && id <= expected.size());
+        res[id - 1] = MolToSmiles(*mol) + " " +
+                      mol->getProp<std::string>(common_properties::_Name);
+        ++nMols;
+      }
+    }
+    TEST_ASSERT(nMols == expected.size());
+    TEST_ASSERT(res == expected);
+  }
+#endif
+}
+
 void testPerformance() {
   /*
      TEST PERFORMANCE
@@ -410,6 +572,21 @@ int main() {
   BOOST_LOG(rdErrorLog) << "Finished: testSDCorrectness()\n";
   BOOST_LOG(rdErrorLog) << "-----------------------------------------\n\n";
 
+  BOOST_LOG(rdErrorLog) << "\n-----------------------------------------\n";
+  testPDBCorrectness();
+  BOOST_LOG(rdErrorLog) << "Finished: testPDBCorrectness()\n";
+  BOOST_LOG(rdErrorLog) << "-----------------------------------------\n\n";
+
+  BOOST_LOG(rdErrorLog) << "\n-----------------------------------------\n";
+  testTDTCorrectness();
+  BOOST_LOG(rdErrorLog) << "Finished: testTDTCorrectness()\n";
+  BOOST_LOG(rdErrorLog) << "-----------------------------------------\n\n";
+
+  BOOST_LOG(rdErrorLog) << "\n-----------------------------------------\n";
+  testMaeCorrectness();
+  BOOST_LOG(rdErrorLog) << "Finished: testMaeCorrectness()\n";
+  BOOST_LOG(rdErrorLog) << "-----------------------------------------\n\n";
+
   /*
     BOOST_LOG(rdErrorLog) << "\n-----------------------------------------\n";
     testPerformance();
@@ -0,0 +1,243 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+
+#include <RDGeneral/test.h>
+#include <RDGeneral/RDLog.h>
+
+#include "MolSupplier.h"
+#include "MolWriters.h"
+#include "MultithreadedSDWriter.h"
+#include "MultithreadedSmilesWriter.h"
+
+using namespace RDKit;
+using namespace std::chrono;
+
+namespace {
+std::vector<std::unique_ptr<ROMol>> readSDMols(const std::string &path) {
+  std::string rdbase = getenv("RDBASE");
+  SDMolSupplier sup(rdbase + path, false);
+  std::vector<std::unique_ptr<ROMol>> res;
+  while (!sup.atEnd()) {
+    std::unique_ptr<ROMol> mol(sup.next());
+    if (mol) {
+      res.push_back(std::move(mol));
+    }
+  }
+  return res;
+}
+
+std::vector<std::unique_ptr<ROMol>> readSmilesMols(const std::string &path) {
+  std::string rdbase = getenv("RDBASE");
+  SmilesMolSupplier sup(rdbase + path, ",", 0, -1, true);
+  std::vector<std::unique_ptr<ROMol>> res;
+  while (!sup.atEnd()) {
+    std::unique_ptr<ROMol> mol(sup.next());
+    if (mol) {
+      res.push_back(std::move(mol));
+    }
+  }
+  return res;
+}
+}  // namespace
+
+void testSDWriter() {
+  auto mols =
+      readSDMols("/Code/GraphMol/FileParsers/test_data/NCI_aids_few.sdf");
+  TEST_ASSERT(mols.size() == 16);
+
+  std::ostringstream expected;
+  {
+    SDWriter writer(&expected);
+    for (const auto &mol : mols) {
+      writer.write(*mol);
+    }
+  }
+
+  for (unsigned int numThreads : {1, 2, 4}) {
+    for (size_t queueSize : {1, 5, 100}) {
+      MultithreadedSDWriter::Parameters params;
+      params.numWriterThreads = numThreads;
+      params.sizeInputQueue = queueSize;
+      params.sizeOutputQueue = queueSize;
+      std::ostringstream out;
+      {
+        MultithreadedSDWriter writer(&out, false, params);
+        for (const auto &mol : mols) {
+          writer.write(*mol);
+        }
+        TEST_ASSERT(writer.numMols() == mols.size());
+      }
+      TEST_ASSERT(out.str() == expected.str());
+    }
+  }
+
+  // a subset of the properties, V3000, and writing after a flush
+  std::ostringstream expected2;
+  {
+    SDWriter writer(&expected2);
+    writer.setProps({"NSC", "CAS_RN"});
+    writer.setForceV3000(true);
+    for (const auto &mol : mols) {
+      writer.write(*mol);
+    }
+  }
+  MultithreadedSDWriter::Parameters params;
+  params.numWriterThreads = 3;
+  std::ostringstream out;
+  MultithreadedSDWriter writer(&out, false, params);
+  writer.setProps({"NSC", "CAS_RN"});
+  writer.setForceV3000(true);
+  for (unsigned int i = 0; i < mols.size(); ++i) {
+    writer.write(*mols[i]);
+    if (i == 7) {
+      writer.flush();
+      TEST_ASSERT(out.str() == expected2.str().substr(0, out.str().size()));
+      TEST_ASSERT(out.str().size() < expected2.str().size());
+    }
+  }
+  writer.close();
+  TEST_ASSERT(out.str() == expected2.str());
+}
+
+void testSmilesWriter() {
+  auto mols =
+      readSmilesMols("/Code/GraphMol/FileParsers/test_data/first_200.tpsa.csv");
+  TEST_ASSERT(mols.size() == 200);
+
+  for (bool includeHeader : {true, false}) {
+    for (std::string nameHeader : {"Name", ""}) {
+      std::ostringstream expected;
+      {
+        SmilesWriter writer(&expected, ",", nameHeader, includeHeader);
+        writer.setProps({"TPSA", "missing"});
+        for (const auto &mol : mols) {
+          writer.write(*mol);
+        }
+      }
+      for (unsigned int numThreads : {1, 4}) {
+        MultithreadedSmilesWriter::Parameters params;
+        params.numWriterThreads = numThreads;
+        params.sizeInputQueue = 10;
+        params.sizeOutputQueue = 2;
+        std::ostringstream out;
+        {
+          bool takeOwnership = false;
+          MultithreadedSmilesWriter writer(&out, ",", nameHeader,
+                                           includeHeader, takeOwnership, true,
+                                           false, params);
+          writer.setProps({"TPSA", "missing"});
+          for (const auto &mol : mols) {
+            writer.write(*mol);
+          }
+        }
+        TEST_ASSERT(out.str() == expected.str());
+      }
+    }
+  }
+
+  // the molecules are copied, so they can be modified after being written
+  std::ostringstream expected;
+  {
+    SmilesWriter writer(&expected);
+    for (const auto &mol : mols) {
+      writer.write(*mol);
+    }
+  }
+  MultithreadedSmilesWriter::Parameters params;
+  params.numWriterThreads = 2;
+  std::ostringstream out;
+  {
+    MultithreadedSmilesWriter writer(&out, " ", "Name", true, false, true,
+                                     false, params);
+    for (const auto &mol : mols) {
+      writer.write(*mol);
+      mol->setProp(common_properties::_Name, "changed");
+    }
+  }
+  TEST_ASSERT(out.str() == expected.str());
+
+  // nothing is written for an empty file
+  std::ostringstream empty;
+  {
+    MultithreadedSmilesWriter writer(&empty);
+  }
+  TEST_ASSERT(empty.str().empty());
+}
+
+void testPerformance() {
+  auto mols =
+      readSmilesMols("/Code/GraphMol/FileParsers/test_data/first_200.tpsa.csv");
+  std::vector<std::unique_ptr<ROMol>> manyMols;
+  for (unsigned int i = 0; i < 100; ++i) {
+    for (const auto &mol : mols) {
+      manyMols.emplace_back(new ROMol(*mol));
+    }
+  }
+  auto start = high_resolution_clock::now();
+  {
+    std::ostringstream out;
+    SDWriter writer(&out);
+    for (const auto &mol : manyMols) {
+      writer.write(*mol);
+    }
+  }
+  auto duration =
+      duration_cast<milliseconds>(high_resolution_clock::now() - start);
+  std::cout << "Duration for SDWriter: " << duration.count()
+            << " (milliseconds) \n";
+  for (unsigned int i = 1; i <= 4; ++i) {
+    MultithreadedSDWriter::Parameters params;
+    params.numWriterThreads = i;
+    params.sizeInputQueue = 1000;
+    params.sizeOutputQueue = 1000;
+    start = high_resolution_clock::now();
+    {
+      std::ostringstream out;
+      MultithreadedSDWriter writer(&out, false, params);
+      for (const auto &mol : manyMols) {
+        writer.write(*mol);
+      }
+    }
+    duration =
+        duration_cast<milliseconds>(high_resolution_clock::now() - start);
+    std::cout << "Duration for MultithreadedSDWriter with " << i
+              << " writer threads: " << duration.count()
+              << " (milliseconds) \n";
+  }
+}
+
+int main() {
+  RDLog::InitLogs();
+
+#ifdef RDK_TEST_MULTITHREADED
+  BOOST_LOG(rdErrorLog) << "\n-----------------------------------------\n";
+  testSDWriter();
+  BOOST_LOG(rdErrorLog) << "Finished: testSDWriter()\n";
+  BOOST_LOG(rdErrorLog) << "-----------------------------------------\n\n";
+
+  BOOST_LOG(rdErrorLog) << "\n-----------------------------------------\n";
+  testSmilesWriter();
+  BOOST_LOG(rdErrorLog) << "Finished: testSmilesWriter()\n";
+  BOOST_LOG(rdErrorLog) << "-----------------------------------------\n\n";
+
+  /*
+    BOOST_LOG(rdErrorLog) << "\n-----------------------------------------\n";
+    testPerformance();
+    BOOST_LOG(rdErrorLog) << "Finished: testPerformance()\n";
+    BOOST_LOG(rdErrorLog) << "-----------------------------------------\n\n";
+  */
+#endif
+
+  return 0;
+}
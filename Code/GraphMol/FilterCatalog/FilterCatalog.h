@@ -37,6 +37,12 @@
 #include <Catalogs/CatalogParams.h>
 #include "FilterCatalogEntry.h"
 
+#include <cstdint>
+#include <iostream>
+#include <memory>
+
+class ExplicitBitVect;
+
 namespace RDKit {
 class FilterCatalog;
 class RDKIT_FILTERCATALOG_EXPORT FilterCatalogParams
@@ -265,6 +271,102 @@ RDKIT_FILTERCATALOG_EXPORT
 std::vector<std::vector<boost::shared_ptr<const FilterCatalogEntry>>>
 RunFilterCatalog(const FilterCatalog &filterCatalog,
                  const std::vector<std::string> &smiles, int numThreads = 1);
+
+//! Statistics for one entry of the catalog used by a FilterCatalogRunner
+struct RDKIT_FILTERCATALOG_EXPORT FilterCatalogEntryStats {
+  //! molecules which were rejected by the fingerprint screen
+  std::uint64_t numScreenedOut = 0;
+  //! molecules which were matched against the entry's filters
+  std::uint64_t numTested = 0;
+  //! molecules which matched the entry
+  std::uint64_t numHits = 0;
+};
+
+//! Runs a FilterCatalog on large numbers of molecules
+/*!
+  <b>Notes:</b>
+    - Entries whose filter is a SmartsMatcher which requires at least one
+      match have a pattern fingerprint calculated for their pattern when the
+      runner is constructed. An entry is only matched against a molecule if
+      all of the bits in its fingerprint are set in the molecule's pattern
+      fingerprint. Entries using other filters are always matched.
+    - The matches are the same as those from FilterCatalog::getMatches()
+    - The runner shares the entries with the catalog it was constructed from;
+      changes to the catalog after that are not seen by the runner.
+*/
+class RDKIT_FILTERCATALOG_EXPORT FilterCatalogRunner {
+ public:
+  //! \param catalog the catalog to run
+  //! \param fpSize  the size of the pattern fingerprints used for screening
+  FilterCatalogRunner(const FilterCatalog &catalog, unsigned int fpSize = 2048);
+  FilterCatalogRunner(const FilterCatalogRunner &) = delete;
+  FilterCatalogRunner &operator=(const FilterCatalogRunner &) = delete;
+  ~FilterCatalogRunner();
+
+  //! returns all entry matches to the molecule, the statistics are not updated
+  std::vector<FilterCatalog::CONST_SENTRY> getMatches(const ROMol &mol) const;
+
+  //! returns the entry matches for each of a set of SMILES
+  /*!
+    \param smiles     the SMILES to analyze
+    \param numThreads the number of threads to use, values <= 0 are
+                      interpreted as described for getNumThreadsToUse()
+
+    \return the matches for each SMILES, as returned by RunFilterCatalog().
+            SMILES which can't be sanitized are treated the same way as
+            SMILES which can't be parsed.
+  */
+  std::vector<std::vector<FilterCatalog::CONST_SENTRY>> getMatches(
+      const std::vector<std::string> &smiles, int numThreads = 1);
+
+  //! runs the catalog on each molecule in a SMILES file
+  /*!
+    Each input line should contain a SMILES, optionally followed by
+    whitespace and a name. Each output line contains the SMILES, the name,
+    the number of matching entries and the descriptions of those entries
+    separated by '|'; the fields are separated by tabs. Molecules which can't
+    be parsed or sanitized have -1 as their number of matches. The input is
+    processed \c batchSize lines at a time, so arbitrarily large files can
+    be processed.
+
+    \param ins        the stream to read from
+    \param outs       the stream to write to
+    \param numThreads the number of threads to use, values <= 0 are
+                      interpreted as described for getNumThreadsToUse()
+    \param batchSize  the number of lines to process at a time
+
+    \return the number of molecules processed
+  */
+  std::uint64_t runOnStream(std::istream &ins, std::ostream &outs,
+                            int numThreads = 1, unsigned int batchSize = 1000);
+
+  //! returns the statistics for each entry in the catalog, accumulated over
+  //! all calls to the multi-molecule versions of getMatches() and
+  //! runOnStream()
+  const std::vector<FilterCatalogEntryStats> &getEntryStats() const {
+    return d_entryStats;
+  }
+  //! returns the number of molecules which have been processed
+  std::uint64_t getNumMolecules() const { return d_numMolecules; }
+  //! returns the number of molecules which couldn't be parsed or sanitized
+  std::uint64_t getNumInvalidMolecules() const {
+    return d_numInvalidMolecules;
+  }
+  //! resets the statistics
+  void resetStats();
+
+ private:
+  std::vector<FilterCatalog::CONST_SENTRY> getMatches(
+      const ROMol &mol, std::vector<FilterCatalogEntryStats> *stats) const;
+  unsigned int d_fpSize;
+  std::vector<FilterCatalog::CONST_SENTRY> d_entries;
+  // fingerprints of the entries' patterns, null if the entry isn't screened
+  std::vector<std::unique_ptr<ExplicitBitVect>> d_fps;
+  bool d_haveScreens = false;
+  std::vector<FilterCatalogEntryStats> d_entryStats;
+  std::uint64_t d_numMolecules = 0;
+  std::uint64_t d_numInvalidMolecules = 0;
+};
 }  // namespace RDKit
 
 #endif
@@ -85,6 +85,12 @@ class RDKIT_FILTERCATALOG_EXPORT FilterCatalogEntry
 
   bool isValid() const { return d_matcher.get() && d_matcher->isValid(); }
 
+  //------------------------------------
+  //! Returns the filter matcher used by this entry
+  boost::shared_ptr<const FilterMatcherBase> getFilterMatcher() const {
+    return d_matcher;
+  }
+
   //------------------------------------
   //! Returns the description of the catalog entry
   std::string getDescription() const override;
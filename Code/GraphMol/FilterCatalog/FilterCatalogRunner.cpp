@@ -11,9 +11,14 @@
 #include "Filters.h"
 #include "FilterMatchers.h"
 #include <GraphMol/SmilesParse/SmilesParse.h>
+#include <GraphMol/SanitException.h>
+#include <GraphMol/Fingerprints/Fingerprints.h>
+#include <DataStructs/BitOps.h>
+#include <DataStructs/ExplicitBitVect.h>
+#include <RDGeneral/RDThreads.h>
+#include <sstream>
 
 #ifdef RDK_BUILD_THREADSAFE_SSS
-#include <RDGeneral/RDThreads.h>
 #include <thread>
 #include <future>
 #endif
@@ -70,4 +75,162 @@ RunFilterCatalog(const FilterCatalog &fc,
   return results;
 }
 
+FilterCatalogRunner::FilterCatalogRunner(const FilterCatalog &catalog,
+                                         unsigned int fpSize)
+    : d_fpSize(fpSize) {
+  for (unsigned int i = 0; i < catalog.getNumEntries(); ++i) {
+    auto entry = catalog.getEntry(i);
+    std::unique_ptr<ExplicitBitVect> fp;
+    // the pattern fingerprint is only a valid screen if the pattern has to
+    // be present for the entry to match
+    auto smartsMatcher =
+        dynamic_cast<const SmartsMatcher *>(entry->getFilterMatcher().get());
+    if (smartsMatcher && smartsMatcher->isValid() &&
+        smartsMatcher->getMinCount() > 0) {
+      fp.reset(PatternFingerprintMol(*smartsMatcher->getPattern(), d_fpSize));
+      d_haveScreens = true;
+    }
+    d_entries.push_back(entry);
+    d_fps.push_back(std::move(fp));
+  }
+  d_entryStats.resize(d_entries.size());
+}
+
+FilterCatalogRunner::~FilterCatalogRunner() = default;
+
+void FilterCatalogRunner::resetStats() {
+  d_entryStats.assign(d_entries.size(), FilterCatalogEntryStats());
+  d_numMolecules = 0;
+  d_numInvalidMolecules = 0;
+}
+
+std::vector<FilterCatalog::CONST_SENTRY> FilterCatalogRunner::getMatches(
+    const ROMol &mol) const {
+  return getMatches(mol, nullptr);
+}
+
+std::vector<FilterCatalog::CONST_SENTRY> FilterCatalogRunner::getMatches(
+    const ROMol &mol, std::vector<FilterCatalogEntryStats> *stats) const {
+  std::vector<FilterCatalog::CONST_SENTRY> res;
+  std::unique_ptr<ExplicitBitVect> molFp;
+  if (d_haveScreens) {
+    molFp.reset(PatternFingerprintMol(mol, d_fpSize));
+  }
+  for (unsigned int i = 0; i < d_entries.size(); ++i) {
+    if (d_fps[i] && !AllProbeBitsMatch(*d_fps[i], *molFp)) {
+      if (stats) {
+        ++(*stats)[i].numScreenedOut;
+      }
+      continue;
+    }
+    bool hit = d_entries[i]->hasFilterMatch(mol);
+    if (stats) {
+      ++(*stats)[i].numTested;
+      if (hit) {
+        ++(*stats)[i].numHits;
+      }
+    }
+    if (hit) {
+      res.push_back(d_entries[i]);
+    }
+  }
+  return res;
+}
+
+std::vector<std::vector<FilterCatalog::CONST_SENTRY>>
+FilterCatalogRunner::getMatches(const std::vector<std::string> &smiles,
+                                int numThreads) {
+  std::vector<std::vector<FilterCatalog::CONST_SENTRY>> results(smiles.size());
+  unsigned int numThreadsToUse = std::min(
+      static_cast<unsigned int>(smiles.size()), getNumThreadsToUse(numThreads));
+  numThreadsToUse = std::max(numThreadsToUse, 1u);
+  // each thread collects its own statistics, these are combined at the end
+  std::vector<std::vector<FilterCatalogEntryStats>> threadStats(
+      numThreadsToUse,
+      std::vector<FilterCatalogEntryStats>(d_entries.size()));
+  std::vector<std::uint64_t> threadInvalid(numThreadsToUse, 0);
+  auto searcher = [&](size_t tidx) {
+    for (auto idx = tidx; idx < smiles.size(); idx += numThreadsToUse) {
+      std::unique_ptr<ROMol> mol;
+      try {
+        mol.reset(SmilesToMol(smiles[idx]));
+      } catch (const MolSanitizeException &) {
+        // treated the same as a parse failure
+      }
+      if (mol) {
+        results[idx] = getMatches(*mol, &threadStats[tidx]);
+      } else {
+        results[idx].push_back(makeBadSmilesEntry());
+        ++threadInvalid[tidx];
+      }
+    }
+  };
+  // one index per thread, so that each one can use its own statistics
+  runOnIndices(searcher, numThreadsToUse, numThreadsToUse);
+  for (unsigned int tidx = 0; tidx < numThreadsToUse; ++tidx) {
+    for (unsigned int i = 0; i < d_entries.size(); ++i) {
+      d_entryStats[i].numScreenedOut += threadStats[tidx][i].numScreenedOut;
+      d_entryStats[i].numTested += threadStats[tidx][i].numTested;
+      d_entryStats[i].numHits += threadStats[tidx][i].numHits;
+    }
+    d_numInvalidMolecules += threadInvalid[tidx];
+  }
+  d_numMolecules += smiles.size();
+  return results;
+}
+
+std::uint64_t FilterCatalogRunner::runOnStream(std::istream &ins,
+                                               std::ostream &outs,
+                                               int numThreads,
+                                               unsigned int batchSize) {
+  PRECONDITION(batchSize > 0, "batchSize must be positive");
+  std::uint64_t res = 0;
+  std::vector<std::string> smiles;
+  std::vector<std::string> names;
+  auto processBatch = [&]() {
+    auto matches = getMatches(smiles, numThreads);
+    for (unsigned int i = 0; i < smiles.size(); ++i) {
+      outs << smiles[i] << "\t" << names[i] << "\t";
+      if (matches[i].size() == 1 && matches[i][0] == makeBadSmilesEntry()) {
+        outs << "-1\t";
+      } else {
+        outs << matches[i].size() << "\t";
+        for (unsigned int j = 0; j < matches[i].size(); ++j) {
+          if (j) {
+            outs << "|";
+          }
+          outs << matches[i][j]->getDescription();
+        }
+      }
+      outs << "\n";
+    }
+    res += smiles.size();
+    smiles.clear();
+    names.clear();
+  };
+
+  std::string line;
+  while (std::getline(ins, line)) {
+    std::istringstream iss(line);
+    std::string smi;
+    if (!(iss >> smi)) {
+      continue;
+    }
+    std::string name;
+    std::getline(iss >> std::ws, name);
+    if (!name.empty() && name.back() == '\r') {
+      name.pop_back();
+    }
+    smiles.push_back(std::move(smi));
+    names.push_back(std::move(name));
+    if (smiles.size() == batchSize) {
+      processBatch();
+    }
+  }
+  if (!smiles.empty()) {
+    processBatch();
+  }
+  return res;
+}
+
 }  // namespace RDKit
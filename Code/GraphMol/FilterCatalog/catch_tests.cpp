@@ -0,0 +1,196 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include <catch2/catch_all.hpp>
+
+#include <GraphMol/RDKitBase.h>
+#include <GraphMol/SmilesParse/SmilesParse.h>
+#include <GraphMol/FilterCatalog/FilterCatalog.h>
+#include <GraphMol/FilterCatalog/FilterMatchers.h>
+#include <GraphMol/test_fixtures.h>
+
+#include <chrono>
+#include <sstream>
+
+using namespace RDKit;
+
+namespace {
+
+FilterCatalogParams painsBrenkNIHParams() {
+  FilterCatalogParams ps;
+  ps.addCatalog(FilterCatalogParams::PAINS);
+  ps.addCatalog(FilterCatalogParams::BRENK);
+  ps.addCatalog(FilterCatalogParams::NIH);
+  return ps;
+}
+}  // namespace
+
+TEST_CASE("FilterCatalogRunner") {
+  auto smis = readChemblTestSmiles(100);
+  REQUIRE(smis.size() == 100);
+  // some molecules which hit PAINS filters
+  smis.push_back("O=C(Cn1cnc2c1c(=O)n(C)c(=O)n2C)N/N=C/c1c(O)ccc2c1cccc2");
+  smis.push_back("c1ccccc1N=Nc1ccc(N(C)C)cc1");
+  smis.push_back("Oc1ccccc1/C=N/Nc1ccccc1");
+
+  SECTION("all catalogs") {
+    FilterCatalog fc(FilterCatalogParams::ALL);
+    FilterCatalogRunner runner(fc);
+    for (const auto &smi : smis) {
+      INFO(smi);
+      std::unique_ptr<ROMol> mol(SmilesToMol(smi));
+      REQUIRE(mol);
+      CHECK(runner.getMatches(*mol) == fc.getMatches(*mol));
+    }
+    // the single molecule version doesn't collect statistics
+    CHECK(runner.getNumMolecules() == 0);
+  }
+  SECTION("batches and statistics") {
+    FilterCatalog fc(painsBrenkNIHParams());
+    FilterCatalogRunner runner(fc);
+    auto batch = smis;
+    batch.push_back("CC)C");  // can't be parsed
+    for (auto numThreads : {1, 4}) {
+      runner.resetStats();
+      auto res = runner.getMatches(batch, numThreads);
+      CHECK(res == RunFilterCatalog(fc, batch));
+      CHECK(runner.getNumMolecules() == batch.size());
+      CHECK(runner.getNumInvalidMolecules() == 1);
+
+      std::uint64_t numMatches = 0;
+      for (unsigned int i = 0; i + 1 < res.size(); ++i) {
+        numMatches += res[i].size();
+      }
+      CHECK(numMatches > 3);
+      const auto &stats = runner.getEntryStats();
+      REQUIRE(stats.size() == fc.getNumEntries());
+      std::uint64_t numHits = 0;
+      std::uint64_t numScreenedOut = 0;
+      for (const auto &stat : stats) {
+        CHECK(stat.numScreenedOut + stat.numTested == batch.size() - 1);
+        numHits += stat.numHits;
+        numScreenedOut += stat.numScreenedOut;
+      }
+      CHECK(numHits == numMatches);
+      // the screen should reject most of the entries
+      CHECK(numScreenedOut > stats.size() * (batch.size() - 1) / 2);
+    }
+    // SMILES which can't be sanitized are also treated as invalid
+    auto res = runner.getMatches({"c1ccccc1cc", "CCO"});
+    REQUIRE(res.size() == 2);
+    REQUIRE(res[0].size() == 1);
+    CHECK(res[0][0]->getDescription() == "no valid RDKit molecule");
+    CHECK(res[1].empty());
+  }
+  SECTION("entries which can't be screened") {
+    FilterCatalog fc;
+    // matches molecules which have no carbonyl
+    fc.addEntry(new FilterCatalogEntry(
+        "no carbonyl", SmartsMatcher("carbonyl", "C=O", 0, 0)));
+    fc.addEntry(new FilterCatalogEntry(
+        "not an amine", FilterMatchOps::Not(SmartsMatcher("amine", "[NX3]"))));
+    fc.addEntry(new FilterCatalogEntry("nitrile",
+                                       SmartsMatcher("nitrile", "C#N")));
+    FilterCatalogRunner runner(fc);
+    std::vector<std::string> batch = {"CCO", "CC(=O)N", "CC#N"};
+    auto res = runner.getMatches(batch);
+    CHECK(res == RunFilterCatalog(fc, batch));
+    CHECK(res[0].size() == 2);
+    CHECK(res[1].size() == 0);
+    CHECK(res[2].size() == 3);
+    const auto &stats = runner.getEntryStats();
+    CHECK(stats[0].numTested == 3);
+    CHECK(stats[1].numTested == 3);
+    CHECK(stats[2].numScreenedOut == 2);
+    CHECK(stats[2].numHits == 1);
+  }
+  SECTION("streaming") {
+    FilterCatalog fc(painsBrenkNIHParams());
+    FilterCatalogRunner runner(fc);
+    std::stringstream ins;
+    for (unsigned int i = 0; i < smis.size(); ++i) {
+      ins << smis[i] << " mol-" << i << "\n";
+    }
+    ins << "\n";
+    ins << "c1ccccc1cc bad mol\n";
+    std::stringstream outs;
+    CHECK(runner.runOnStream(ins, outs, 2, 7) == smis.size() + 1);
+
+    auto expected = runner.getMatches(smis);
+    std::string line;
+    unsigned int i = 0;
+    while (std::getline(outs, line)) {
+      std::vector<std::string> fields;
+      std::stringstream fs(line);
+      std::string field;
+      while (std::getline(fs, field, '\t')) {
+        fields.push_back(field);
+      }
+      if (i < smis.size()) {
+        REQUIRE(fields.size() >= 3);
+        CHECK(fields[0] == smis[i]);
+        CHECK(fields[1] == "mol-" + std::to_string(i));
+        CHECK(fields[2] == std::to_string(expected[i].size()));
+        if (!expected[i].empty()) {
+          REQUIRE(fields.size() == 4);
+          CHECK(fields[3].substr(0, fields[3].find('|')) ==
+                expected[i][0]->getDescription());
+        }
+      } else {
+        REQUIRE(fields.size() == 3);
+        CHECK(fields[0] == "c1ccccc1cc");
+        CHECK(fields[1] == "bad mol");
+        CHECK(fields[2] == "-1");
+      }
+      ++i;
+    }
+    CHECK(i == smis.size() + 1);
+    CHECK(runner.getNumInvalidMolecules() == 1);
+  }
+}
+
+TEST_CASE("FilterCatalogRunner benchmark", "[.][benchmark]") {
+  auto smis = readChemblTestSmiles();
+  FilterCatalog fc(painsBrenkNIHParams());
+  auto report = [&smis](const std::string &label, const auto &t1) {
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "TIMING : " << label << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << smis.size() << " molecules"
+              << std::endl;
+  };
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+  auto res1 = RunFilterCatalog(fc, smis, 1);
+  report("RunFilterCatalog, 1 thread", t1);
+
+  FilterCatalogRunner runner(fc);
+  t1 = std::chrono::high_resolution_clock::now();
+  auto res2 = runner.getMatches(smis);
+  report("FilterCatalogRunner, 1 thread", t1);
+  CHECK(res1 == res2);
+
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  t1 = std::chrono::high_resolution_clock::now();
+  auto res3 = runner.getMatches(smis, -1);
+  report("FilterCatalogRunner, all threads", t1);
+  CHECK(res1 == res3);
+#endif
+
+  std::uint64_t numScreenedOut = 0;
+  std::uint64_t numTested = 0;
+  for (const auto &stat : runner.getEntryStats()) {
+    numScreenedOut += stat.numScreenedOut;
+    numTested += stat.numTested;
+  }
+  std::cout << "fraction of entry tests removed by the screen: "
+            << double(numScreenedOut) / (numScreenedOut + numTested)
+            << std::endl;
+}
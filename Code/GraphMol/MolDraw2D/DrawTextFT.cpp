@@ -13,6 +13,12 @@
 
 #include <cstdio>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#ifdef RDK_BUILD_THREADSAFE_SSS
+#include <mutex>
+#endif
 
 #include <GraphMol/MolDraw2D/MolDraw2D.h>
 #include <GraphMol/MolDraw2D/DrawTextFT.h>
@@ -24,31 +30,86 @@ extern const std::string telex_ttf;
 
 namespace MolDraw2D_detail {
 
+// ****************************************************************************
+// The glyphs extracted so far for a font.  Entries are never removed, so
+// pointers to them stay valid for the life of the program.
+struct FontGlyphs {
+  FT_UShort units_per_EM = 0;
+  std::unordered_map<char, std::unique_ptr<const GlyphOutline>> glyphs;
+};
+
+namespace {
+#ifdef RDK_BUILD_THREADSAFE_SSS
+std::mutex glyph_cache_mutex;
+#endif
+
+// keyed by font file name, with the built-in fonts under their
+// Builtin... names.
+std::map<std::string, FontGlyphs> &glyphCache() {
+  static std::map<std::string, FontGlyphs> cache;
+  return cache;
+}
+
+int recordMoveTo(const FT_Vector *to, void *user) {
+  auto glyph = static_cast<GlyphOutline *>(user);
+  glyph->segments.push_back(GlyphOutline::Segment::MoveTo);
+  glyph->points.push_back(*to);
+  return 0;
+}
+
+int recordLineTo(const FT_Vector *to, void *user) {
+  auto glyph = static_cast<GlyphOutline *>(user);
+  glyph->segments.push_back(GlyphOutline::Segment::LineTo);
+  glyph->points.push_back(*to);
+  return 0;
+}
+
+int recordConicTo(const FT_Vector *control, const FT_Vector *to, void *user) {
+  auto glyph = static_cast<GlyphOutline *>(user);
+  glyph->segments.push_back(GlyphOutline::Segment::ConicTo);
+  glyph->points.push_back(*control);
+  glyph->points.push_back(*to);
+  return 0;
+}
+
+int recordCubicTo(const FT_Vector *controlOne, const FT_Vector *controlTwo,
+                  const FT_Vector *to, void *user) {
+  auto glyph = static_cast<GlyphOutline *>(user);
+  glyph->segments.push_back(GlyphOutline::Segment::CubicTo);
+  glyph->points.push_back(*controlOne);
+  glyph->points.push_back(*controlTwo);
+  glyph->points.push_back(*to);
+  return 0;
+}
+}  // namespace
+
 // ****************************************************************************
 DrawTextFT::DrawTextFT(double max_fnt_sz, double min_fnt_sz,
                        const std::string &font_file)
     : DrawText(max_fnt_sz, min_fnt_sz),
       library_(nullptr),
       face_(nullptr),
+      font_glyphs_(nullptr),
+      glyph_(nullptr),
       x_trans_(0),
       y_trans_(0),
       string_y_max_(0) {
-  int err_code = FT_Init_FreeType(&library_);
-  if (err_code != FT_Err_Ok) {
-    throw std::runtime_error(std::string("Couldn't initialise Freetype."));
-  }
   setFontFile(font_file);
 }
 
 // ****************************************************************************
 DrawTextFT::~DrawTextFT() {
-  FT_Done_Face(face_);
-  FT_Done_FreeType(library_);
+  if (face_) {
+    FT_Done_Face(face_);
+  }
+  if (library_) {
+    FT_Done_FreeType(library_);
+  }
 }
 
 // ****************************************************************************
 void DrawTextFT::drawChar(char c, const Point2D &cds) {
-  FT_Load_Char(face_, c, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP);
+  glyph_ = &getGlyph(c);
   x_trans_ = cds.x;
   y_trans_ = cds.y;
   extractOutline();
@@ -72,24 +133,30 @@ void DrawTextFT::fontPosToDrawPos(FT_Pos fx, FT_Pos fy, double &dx,
 
 // ****************************************************************************
 double DrawTextFT::extractOutline() {
-  FT_Outline_Funcs callbacks;
-
-  callbacks.move_to = moveToFunction;
-  callbacks.line_to = lineToFunction;
-  callbacks.conic_to = conicToFunction;
-  callbacks.cubic_to = cubicToFunction;
-
-  callbacks.shift = 0;
-  callbacks.delta = 0;
-
-  FT_GlyphSlot slot = face_->glyph;
-  FT_Outline &outline = slot->outline;
-
-  FT_Error error = FT_Outline_Decompose(&outline, &callbacks, this);
-  if (error != FT_Err_Ok) {
-    /* not sure what to do in this case */;
+  PRECONDITION(glyph_, "no glyph to draw");
+  // replay the outline as FT_Outline_Decompose would have produced it
+  const FT_Vector *pt = glyph_->points.data();
+  for (auto segment : glyph_->segments) {
+    switch (segment) {
+      case GlyphOutline::Segment::MoveTo:
+        MoveToFunctionImpl(pt);
+        pt += 1;
+        break;
+      case GlyphOutline::Segment::LineTo:
+        LineToFunctionImpl(pt);
+        pt += 1;
+        break;
+      case GlyphOutline::Segment::ConicTo:
+        ConicToFunctionImpl(pt, pt + 1);
+        pt += 2;
+        break;
+      case GlyphOutline::Segment::CubicTo:
+        CubicToFunctionImpl(pt, pt + 1, pt + 2);
+        pt += 3;
+        break;
+    }
   }
-  return fontCoordToDrawCoord(slot->advance.x);
+  return fontCoordToDrawCoord(glyph_->advance);
 }
 
 // ****************************************************************************
@@ -109,23 +176,59 @@ std::string DrawTextFT::getFontFile() const {
 
 // ****************************************************************************
 void DrawTextFT::setFontFile(const std::string &font_file) {
-  if (face_ && font_file == font_file_) {
+  if (font_glyphs_ && font_file == font_file_) {
     return;
   }
 
   font_file_ = font_file;
-  FT_Done_Face(face_);
-  face_ = nullptr;
+  if (face_) {
+    FT_Done_Face(face_);
+    face_ = nullptr;
+  }
+  FT_UShort units_per_EM = 0;
+  {
+#ifdef RDK_BUILD_THREADSAFE_SSS
+    std::lock_guard<std::mutex> lock(glyph_cache_mutex);
+#endif
+    font_glyphs_ =
+        &glyphCache()[font_file_.empty() ? "BuiltinTelexRegular" : font_file_];
+    units_per_EM = font_glyphs_->units_per_EM;
+  }
+  if (!units_per_EM) {
+    // first use of this font, so make sure that it can be loaded
+    loadFace();
+    units_per_EM = face_->units_per_EM;
+#ifdef RDK_BUILD_THREADSAFE_SSS
+    std::lock_guard<std::mutex> lock(glyph_cache_mutex);
+#endif
+    font_glyphs_->units_per_EM = units_per_EM;
+  }
+  em_scale_ = 1.0 / units_per_EM;
+}
+
+// ****************************************************************************
+void DrawTextFT::loadFace() const {
+  if (face_) {
+    return;
+  }
+  if (!library_) {
+    int err_code = FT_Init_FreeType(&library_);
+    if (err_code != FT_Err_Ok) {
+      library_ = nullptr;
+      throw std::runtime_error(std::string("Couldn't initialise Freetype."));
+    }
+  }
   // take the first face
   const std::string *font_string = nullptr;
   if (!font_file_.empty()) {
-    if (font_file == "BuiltinTelexRegular") {
+    if (font_file_ == "BuiltinTelexRegular") {
       font_string = &telex_regular_ttf;
-    } else if (font_file == "BuiltinRobotoRegular") {
+    } else if (font_file_ == "BuiltinRobotoRegular") {
       font_string = &roboto_regular_ttf;
     } else {
       int err_code = FT_New_Face(library_, font_file_.c_str(), 0, &face_);
       if (err_code != FT_Err_Ok) {
+        face_ = nullptr;
         throw std::runtime_error(std::string("Font file ") + font_file_ +
                                  std::string(" not found."));
       }
@@ -137,10 +240,56 @@ void DrawTextFT::setFontFile(const std::string &font_file) {
     int err_code = FT_New_Memory_Face(library_, (FT_Byte *)font_string->c_str(),
                                       font_string->size(), 0, &face_);
     if (err_code != FT_Err_Ok) {
+      face_ = nullptr;
       throw std::runtime_error("could not load embedded font data");
     }
   }
-  em_scale_ = 1.0 / face_->units_per_EM;
+}
+
+// ****************************************************************************
+const GlyphOutline &DrawTextFT::getGlyph(char c) const {
+  PRECONDITION(font_glyphs_, "no font set");
+  {
+#ifdef RDK_BUILD_THREADSAFE_SSS
+    std::lock_guard<std::mutex> lock(glyph_cache_mutex);
+#endif
+    auto it = font_glyphs_->glyphs.find(c);
+    if (it != font_glyphs_->glyphs.end()) {
+      return *it->second;
+    }
+  }
+
+  // extract it with our own face, so other threads aren't held up
+  loadFace();
+  FT_Load_Char(face_, c, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP);
+  FT_GlyphSlot slot = face_->glyph;
+  FT_Outline &outline = slot->outline;
+  auto glyph = std::make_unique<GlyphOutline>();
+  FT_BBox bbox;
+  FT_Outline_Get_BBox(&outline, &bbox);
+  glyph->x_min = bbox.xMin;
+  glyph->y_min = bbox.yMin;
+  glyph->x_max = bbox.xMax;
+  glyph->y_max = bbox.yMax;
+  glyph->advance = slot->advance.x;
+
+  FT_Outline_Funcs callbacks;
+  callbacks.move_to = recordMoveTo;
+  callbacks.line_to = recordLineTo;
+  callbacks.conic_to = recordConicTo;
+  callbacks.cubic_to = recordCubicTo;
+  callbacks.shift = 0;
+  callbacks.delta = 0;
+  FT_Error error = FT_Outline_Decompose(&outline, &callbacks, glyph.get());
+  if (error != FT_Err_Ok) {
+    /* not sure what to do in this case */;
+  }
+
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  std::lock_guard<std::mutex> lock(glyph_cache_mutex);
+#endif
+  // if another thread got there first, this one is thrown away
+  return *font_glyphs_->glyphs.emplace(c, std::move(glyph)).first->second;
 }
 
 // ****************************************************************************
@@ -209,44 +358,14 @@ void DrawTextFT::getStringRects(const std::string &text,
 void DrawTextFT::calcGlyphBBox(char c, FT_Pos &x_min, FT_Pos &y_min,
                                FT_Pos &x_max, FT_Pos &y_max,
                                FT_Pos &advance) const {
-  FT_Load_Char(face_, c, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP);
-  FT_GlyphSlot slot = face_->glyph;
-  FT_Outline &outline = slot->outline;
-  FT_BBox bbox;
-
-  FT_Outline_Get_BBox(&outline, &bbox);
-
-  x_min = bbox.xMin;
-  y_min = bbox.yMin;
-  x_max = bbox.xMax;
-  y_max = bbox.yMax;
-  advance = slot->advance.x;
+  const auto &glyph = getGlyph(c);
+  x_min = glyph.x_min;
+  y_min = glyph.y_min;
+  x_max = glyph.x_max;
+  y_max = glyph.y_max;
+  advance = glyph.advance;
 }
 
-// ****************************************************************************
-int moveToFunction(const FT_Vector *to, void *user) {
-  auto *rdft = static_cast<DrawTextFT *>(user);
-  return rdft->MoveToFunctionImpl(to);
-}
-
-// ****************************************************************************
-int lineToFunction(const FT_Vector *to, void *user) {
-  auto *rdft = static_cast<DrawTextFT *>(user);
-  return rdft->LineToFunctionImpl(to);
-}
-
-// ****************************************************************************
-int conicToFunction(const FT_Vector *control, const FT_Vector *to, void *user) {
-  auto *rdft = static_cast<DrawTextFT *>(user);
-  return rdft->ConicToFunctionImpl(control, to);
-}
-
-// ****************************************************************************
-int cubicToFunction(const FT_Vector *controlOne, const FT_Vector *controlTwo,
-                    const FT_Vector *to, void *user) {
-  auto *rdft = static_cast<DrawTextFT *>(user);
-  return rdft->CubicToFunctionImpl(controlOne, controlTwo, to);
-}
 }  // namespace MolDraw2D_detail
 
 }  // namespace RDKit
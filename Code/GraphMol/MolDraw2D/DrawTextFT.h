@@ -17,6 +17,7 @@
 #define RDKIT_DRAWTEXTFT_H
 
 #include <string>
+#include <vector>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
@@ -32,6 +33,19 @@ struct StringRect;
 
 namespace MolDraw2D_detail {
 
+// The outline of a glyph in font units, as produced by FT_Outline_Decompose,
+// along with its bounding box and advance.  None of this depends on the
+// drawer, so the glyphs are extracted once per font and shared by all
+// DrawTextFT objects (and threads) that use that font.
+struct GlyphOutline {
+  enum class Segment { MoveTo, LineTo, ConicTo, CubicTo };
+  std::vector<Segment> segments;
+  // 1 point for MoveTo and LineTo, 2 for ConicTo and 3 for CubicTo
+  std::vector<FT_Vector> points;
+  FT_Pos x_min = 0, y_min = 0, x_max = 0, y_max = 0, advance = 0;
+};
+struct FontGlyphs;
+
 // ****************************************************************************
 class RDKIT_MOLDRAW2D_EXPORT DrawTextFT : public DrawText {
  public:
@@ -63,9 +77,13 @@ class RDKIT_MOLDRAW2D_EXPORT DrawTextFT : public DrawText {
   // adds x_trans_ and y_trans_ to coords returns x advance distance
   virtual double extractOutline();
 
-  FT_Library library_;
-  FT_Face face_;
+  // the FreeType library and face are only set up when a glyph is needed
+  // that isn't in the shared cache yet.
+  mutable FT_Library library_;
+  mutable FT_Face face_;
   std::string font_file_;  // over-rides default if not empty.
+  FontGlyphs *font_glyphs_;
+  const GlyphOutline *glyph_;  // the glyph being drawn
   double x_trans_, y_trans_;
   mutable FT_Pos
       string_y_max_;  // maximum y value of string drawn, for inverting y
@@ -83,15 +101,12 @@ class RDKIT_MOLDRAW2D_EXPORT DrawTextFT : public DrawText {
   // font units (0 -> face_->units_per_EM (2048 for roboto font).
   void calcGlyphBBox(char c, FT_Pos &x_min, FT_Pos &y_min, FT_Pos &x_max,
                      FT_Pos &y_max, FT_Pos &advance) const;
-};
 
-// Callbacks for FT_Outline_Decompose.  user should be a pointer to
-// an instance of DrawTextFT.
-int moveToFunction(const FT_Vector *to, void *user);
-int lineToFunction(const FT_Vector *to, void *user);
-int conicToFunction(const FT_Vector *control, const FT_Vector *to, void *user);
-int cubicToFunction(const FT_Vector *controlOne, const FT_Vector *controlTwo,
-                    const FT_Vector *to, void *user);
+  // returns the glyph for c from the shared cache, extracting it from the
+  // font if need be.
+  const GlyphOutline &getGlyph(char c) const;
+  void loadFace() const;
+};
 
 }  // namespace MolDraw2D_detail
 }  // namespace RDKit
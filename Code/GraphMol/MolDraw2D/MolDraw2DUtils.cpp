@@ -21,6 +21,7 @@
 #include <GraphMol/RWMol.h>
 #include <GraphMol/MolOps.h>
 #include <GraphMol/Depictor/RDDepictor.h>
+#include <RDGeneral/RDThreads.h>
 
 #include <RDGeneral/BoostStartInclude.h>
 #include <boost/lexical_cast.hpp>
@@ -555,5 +556,60 @@ double meanBondLength(const ROMol &mol, int confId) {
   return bondLen;
 }
 
+namespace {
+// draws each molecule with a fresh drawer from makeDrawer and returns the
+// drawing texts
+template <typename DrawerType, typename MakeDrawer>
+std::vector<std::string> drawEachMolecule(
+    const std::vector<ROMol *> &mols, const MolDrawOptions &opts,
+    const std::vector<std::string> *legends, int numThreads,
+    MakeDrawer makeDrawer) {
+  PRECONDITION(!legends || legends->size() == mols.size(),
+               "bad legends size");
+  std::vector<std::string> res(mols.size());
+  auto func = [&](size_t i) {
+    if (!mols[i]) {
+      return;
+    }
+    std::unique_ptr<DrawerType> drawer(makeDrawer());
+    drawer->drawOptions() = opts;
+    drawer->drawMolecule(*mols[i], legends ? (*legends)[i] : "");
+    drawer->finishDrawing();
+    res[i] = drawer->getDrawingText();
+  };
+
+  // molecules without coordinates are laid out by the drawer, which isn't
+  // thread safe when CoordGen is used
+  bool serialOnly = false;
+#ifdef RDK_BUILD_COORDGEN_SUPPORT
+  serialOnly = RDDepict::preferCoordGen;
+#endif
+  runOnIndices(func, mols.size(), serialOnly ? 1 : numThreads);
+  return res;
+}
+}  // namespace
+
+// ****************************************************************************
+std::vector<std::string> drawMoleculesToSVG(
+    const std::vector<ROMol *> &mols, int width, int height,
+    const MolDrawOptions &opts, const std::vector<std::string> *legends,
+    int numThreads) {
+  return drawEachMolecule<MolDraw2DSVG>(
+      mols, opts, legends, numThreads,
+      [width, height]() { return new MolDraw2DSVG(width, height); });
+}
+
+#ifdef RDK_BUILD_CAIRO_SUPPORT
+// ****************************************************************************
+std::vector<std::string> drawMoleculesToPNG(
+    const std::vector<ROMol *> &mols, int width, int height,
+    const MolDrawOptions &opts, const std::vector<std::string> *legends,
+    int numThreads) {
+  return drawEachMolecule<MolDraw2DCairo>(
+      mols, opts, legends, numThreads,
+      [width, height]() { return new MolDraw2DCairo(width, height); });
+}
+#endif
+
 }  // namespace MolDraw2DUtils
 }  // namespace RDKit
@@ -12,8 +12,11 @@
 #ifndef MOLDRAW2DUTILS_H
 #define MOLDRAW2DUTILS_H
 #include <GraphMol/RWMol.h>
+#include <GraphMol/MolDraw2D/MolDraw2DHelpers.h>
 
+#include <string>
 #include <tuple>
+#include <vector>
 
 // ****************************************************************************
 
@@ -232,6 +235,42 @@ RDKIT_MOLDRAW2D_EXPORT void drawMolACS1996(
 RDKIT_MOLDRAW2D_EXPORT void setACS1996Options(MolDrawOptions &opts,
                                               double meanBondLen = 1.0);
 RDKIT_MOLDRAW2D_EXPORT double meanBondLength(const ROMol &mol, int confId = -1);
+
+//! draws each of a set of molecules into its own SVG
+/*
+  \param mols: the molecules to draw. These are not modified, but they should
+     not be changed by other threads while this runs.
+  \param width: width of each drawing
+  \param height: height of each drawing
+  \param opts: the drawing options used for every molecule
+  \param legends: (optional) a legend for each molecule
+  \param numThreads: the number of threads to use, values <= 0 are
+     interpreted as in getNumThreadsToUse()
+
+  \return one SVG per molecule, empty for null entries in mols
+
+  The drawings are independent of each other, so they are done in parallel.
+  They are done serially if RDDepict::preferCoordGen is set, because the
+  drawers generate the coordinates of molecules which don't have any.
+  The glyph outlines used by the FreeType text drawers are cached across
+  drawers, so the fonts are only read once.
+*/
+RDKIT_MOLDRAW2D_EXPORT std::vector<std::string> drawMoleculesToSVG(
+    const std::vector<ROMol *> &mols, int width, int height,
+    const MolDrawOptions &opts = MolDrawOptions(),
+    const std::vector<std::string> *legends = nullptr, int numThreads = 1);
+#ifdef RDK_BUILD_CAIRO_SUPPORT
+//! draws each of a set of molecules into its own PNG
+/*
+  The arguments are as for drawMoleculesToSVG()
+
+  \return the PNG data for each molecule, empty for null entries in mols
+*/
+RDKIT_MOLDRAW2D_EXPORT std::vector<std::string> drawMoleculesToPNG(
+    const std::vector<ROMol *> &mols, int width, int height,
+    const MolDrawOptions &opts = MolDrawOptions(),
+    const std::vector<std::string> *legends = nullptr, int numThreads = 1);
+#endif
 }  // namespace MolDraw2DUtils
 
 }  // namespace RDKit
@@ -8,6 +8,8 @@
 //  of the RDKit source tree.
 //
 #include <catch2/catch_all.hpp>
+#include <chrono>
+#include <fstream>
 #include <numeric>
 #include <random>
 
@@ -16,6 +18,7 @@
 #include <RDGeneral/hash/hash.hpp>
 #include <GraphMol/Chirality.h>
 #include <GraphMol/SmilesParse/SmilesParse.h>
+#include <GraphMol/SmilesParse/SmilesWrite.h>
 #include <GraphMol/MolDraw2D/MolDraw2D.h>
 #include <GraphMol/MolDraw2D/MolDraw2DSVG.h>
 #include <GraphMol/MolDraw2D/MolDraw2DUtils.h>
@@ -9793,3 +9796,102 @@ TEST_CASE("avoid duplicate enhanced stereo labels") {
     }
   }
 }
+
+TEST_CASE("draw molecules in parallel") {
+  std::vector<std::unique_ptr<ROMol>> mols;
+  for (const auto smi :
+       {"c1ccccc1C(=O)O", "C[C@H](N)C(=O)O", "CN1C=NC2=C1C(=O)N(C(=O)N2C)C",
+        "[NH3+]CC(=O)[O-]", "FC(F)(F)c1ccc(Br)cc1"}) {
+    mols.emplace_back(SmilesToMol(smi));
+    REQUIRE(mols.back());
+  }
+  std::vector<ROMol *> molPtrs;
+  std::vector<std::string> legends;
+  for (const auto &mol : mols) {
+    molPtrs.push_back(mol.get());
+    legends.push_back(MolToSmiles(*mol));
+  }
+  molPtrs.push_back(nullptr);
+  legends.push_back("");
+  MolDrawOptions opts;
+  opts.addAtomIndices = true;
+  std::vector<std::string> expected;
+  for (size_t i = 0; i < mols.size(); ++i) {
+    MolDraw2DSVG drawer(250, 200);
+    drawer.drawOptions() = opts;
+    drawer.drawMolecule(*mols[i], legends[i]);
+    drawer.finishDrawing();
+    expected.push_back(drawer.getDrawingText());
+  }
+  for (auto numThreads : {1, 4}) {
+    auto svgs = MolDraw2DUtils::drawMoleculesToSVG(molPtrs, 250, 200, opts,
+                                                   &legends, numThreads);
+    REQUIRE(svgs.size() == molPtrs.size());
+    for (size_t i = 0; i < mols.size(); ++i) {
+      CHECK(svgs[i] == expected[i]);
+    }
+    CHECK(svgs.back().empty());
+  }
+#ifdef RDK_BUILD_CAIRO_SUPPORT
+  auto pngs = MolDraw2DUtils::drawMoleculesToPNG(molPtrs, 250, 200, opts,
+                                                 &legends, 4);
+  REQUIRE(pngs.size() == molPtrs.size());
+  for (size_t i = 0; i < mols.size(); ++i) {
+    CHECK(!pngs[i].empty());
+  }
+  CHECK(pngs.back().empty());
+#endif
+}
+
+TEST_CASE("drawing throughput", "[.][benchmark]") {
+  std::string rdbase = getenv("RDBASE");
+  std::ifstream inf(rdbase + "/Data/NCI/first_5K.smi");
+  std::vector<std::unique_ptr<ROMol>> mols;
+  std::string line;
+  while (std::getline(inf, line) && mols.size() < 2000) {
+    std::unique_ptr<ROMol> mol(SmilesToMol(line.substr(0, line.find('\t'))));
+    if (mol) {
+      RDDepict::compute2DCoords(*mol);
+      mols.push_back(std::move(mol));
+    }
+  }
+  REQUIRE(!mols.empty());
+  std::vector<ROMol *> molPtrs;
+  for (const auto &mol : mols) {
+    molPtrs.push_back(mol.get());
+  }
+  auto report = [&molPtrs](const std::string &label, const auto &t1) {
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "TIMING : " << label << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << molPtrs.size() << " molecules"
+              << std::endl;
+  };
+  {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (const auto mol : molPtrs) {
+      MolDraw2DSVG drawer(250, 200);
+      drawer.drawMolecule(*mol);
+      drawer.finishDrawing();
+      CHECK(!drawer.getDrawingText().empty());
+    }
+    report("MolDraw2DSVG", t1);
+  }
+  for (auto numThreads : {1, -1}) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto svgs = MolDraw2DUtils::drawMoleculesToSVG(
+        molPtrs, 250, 200, MolDrawOptions(), nullptr, numThreads);
+    report("drawMoleculesToSVG numThreads=" + std::to_string(numThreads), t1);
+    CHECK(svgs.size() == molPtrs.size());
+  }
+#ifdef RDK_BUILD_CAIRO_SUPPORT
+  for (auto numThreads : {1, -1}) {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    auto pngs = MolDraw2DUtils::drawMoleculesToPNG(
+        molPtrs, 250, 200, MolDrawOptions(), nullptr, numThreads);
+    report("drawMoleculesToPNG numThreads=" + std::to_string(numThreads), t1);
+    CHECK(pngs.size() == molPtrs.size());
+  }
+#endif
+}
@@ -14,7 +14,9 @@
 #include <GraphMol/FileParsers/FileParsers.h>
 #include <GraphMol/SmilesParse/SmilesWrite.h>
 #include "MolHash.h"
+#include <GraphMol/test_fixtures.h>
 
+#include <chrono>
 #include <iostream>
 #include <fstream>
 
@@ -79,6 +81,16 @@ TEST_CASE("Basic MolHash", "[molhash]") {
       auto hsh = MolHash::MolHash(m.get(), MolHash::HashFunction::Regioisomer);
       CHECK(hsh == "*O.*O*.C.C1CCCCC1.c1ccncc1");
     }
+    {
+      // without ring information: this used to fail with an invariant
+      // violation, because rings were only perceived if they were already
+      // there. Now they are perceived and the result is the same as above.
+      std::unique_ptr<RWMol> m(new RWMol(*om));
+      m->getRingInfo()->reset();
+      REQUIRE(!m->getRingInfo()->isInitialized());
+      auto hsh = MolHash::MolHash(m.get(), MolHash::HashFunction::Regioisomer);
+      CHECK(hsh == "*O.*O*.C.C1CCCCC1.c1ccncc1");
+    }
     {
       std::unique_ptr<RWMol> m(new RWMol(*om));
       auto hsh = MolHash::MolHash(m.get(), MolHash::HashFunction::NetCharge);
@@ -874,4 +886,144 @@ TEST_CASE("overreach with v2 tautomer hashes and imines") {
             "[CH3]-[C@H](-[F])-[N]:[C]1:[C]-[CH2]-[CH2]-[CH2]-[C]:1_4_0");
     }
   }
-}
\ No newline at end of file
+}
+namespace {
+std::vector<std::unique_ptr<RWMol>> readHashTestMols() {
+  std::vector<std::unique_ptr<RWMol>> res;
+  for (const auto &smi : readChemblTestSmiles()) {
+    res.emplace_back(SmilesToMol(smi));
+    REQUIRE(res.back());
+  }
+  return res;
+}
+
+const std::vector<MolHash::HashFunction> allHashFunctions = {
+    MolHash::HashFunction::AnonymousGraph,
+    MolHash::HashFunction::ElementGraph,
+    MolHash::HashFunction::CanonicalSmiles,
+    MolHash::HashFunction::MurckoScaffold,
+    MolHash::HashFunction::ExtendedMurcko,
+    MolHash::HashFunction::MolFormula,
+    MolHash::HashFunction::AtomBondCounts,
+    MolHash::HashFunction::DegreeVector,
+    MolHash::HashFunction::Mesomer,
+    MolHash::HashFunction::HetAtomTautomer,
+    MolHash::HashFunction::HetAtomProtomer,
+    MolHash::HashFunction::RedoxPair,
+    MolHash::HashFunction::Regioisomer,
+    MolHash::HashFunction::NetCharge,
+    MolHash::HashFunction::SmallWorldIndexBR,
+    MolHash::HashFunction::SmallWorldIndexBRL,
+    MolHash::HashFunction::ArthorSubstructureOrder,
+    MolHash::HashFunction::HetAtomTautomerv2,
+    MolHash::HashFunction::HetAtomProtomerv2};
+}  // namespace
+
+TEST_CASE("MolHashes", "[molhash]") {
+  auto mols = readHashTestMols();
+  REQUIRE(mols.size() == 529);
+  for (const auto smi :
+       {"C[C@H](F)NC1=CCCCC1", "[O-]C(=O)c1ccccc1CC=CO.[Na+]",
+        "C/C=C/C(O)=C(C)C1CC[C@H](C)CC1", "[13CH3]C1CC[N+](C)(C)CC1"}) {
+    mols.emplace_back(SmilesToMol(smi));
+    REQUIRE(mols.back());
+  }
+  SECTION("single molecules") {
+    for (auto useCXSmiles : {false, true}) {
+      for (const auto &mol : mols) {
+        RWMol orig(*mol);
+        auto hashes =
+            MolHash::MolHashes(*mol, allHashFunctions, useCXSmiles);
+        REQUIRE(hashes.size() == allHashFunctions.size());
+        for (unsigned int i = 0; i < allHashFunctions.size(); ++i) {
+          RWMol cp(*mol);
+          INFO(MolToSmiles(*mol) << " " << i);
+          CHECK(hashes[i] ==
+                MolHash::MolHash(&cp, allHashFunctions[i], useCXSmiles));
+        }
+        // the input molecule is not modified
+        CHECK(MolToCXSmiles(orig) == MolToCXSmiles(*mol));
+      }
+    }
+  }
+  SECTION("subsets, repeats and ordering") {
+    const auto &mol = *mols.back();
+    std::vector<MolHash::HashFunction> funcs = {
+        MolHash::HashFunction::HetAtomProtomer,
+        MolHash::HashFunction::MolFormula,
+        MolHash::HashFunction::HetAtomProtomer,
+        MolHash::HashFunction::CanonicalSmiles,
+        MolHash::HashFunction::RedoxPair};
+    auto hashes = MolHash::MolHashes(mol, funcs);
+    REQUIRE(hashes.size() == funcs.size());
+    for (unsigned int i = 0; i < funcs.size(); ++i) {
+      RWMol cp(mol);
+      CHECK(hashes[i] == MolHash::MolHash(&cp, funcs[i]));
+    }
+    CHECK(MolHash::MolHashes(mol, {}).empty());
+  }
+  SECTION("multiple molecules") {
+    std::vector<const ROMol *> ptrs;
+    for (const auto &mol : mols) {
+      ptrs.push_back(mol.get());
+    }
+    ptrs.push_back(nullptr);
+    for (auto numThreads : {1, 4}) {
+      auto hashes = MolHash::MolHashes(ptrs, allHashFunctions, numThreads);
+      REQUIRE(hashes.size() == ptrs.size());
+      for (unsigned int i = 0; i < mols.size(); ++i) {
+        CHECK(hashes[i] == MolHash::MolHashes(*mols[i], allHashFunctions));
+      }
+      CHECK(hashes.back() ==
+            std::vector<std::string>(allHashFunctions.size()));
+    }
+  }
+}
+
+TEST_CASE("MolHashes benchmark", "[.][benchmark]") {
+  auto mols = readHashTestMols();
+  // the hashes computed by our registration system
+  std::vector<MolHash::HashFunction> funcs = {
+      MolHash::HashFunction::AnonymousGraph,
+      MolHash::HashFunction::ElementGraph,
+      MolHash::HashFunction::CanonicalSmiles,
+      MolHash::HashFunction::MurckoScaffold,
+      MolHash::HashFunction::MolFormula,
+      MolHash::HashFunction::HetAtomTautomer,
+      MolHash::HashFunction::HetAtomProtomer,
+      MolHash::HashFunction::NetCharge};
+  auto report = [&mols](const std::string &label, const auto &t1) {
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "TIMING : " << label << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << mols.size() << " molecules"
+              << std::endl;
+  };
+
+  std::vector<std::vector<std::string>> res1(mols.size());
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < mols.size(); ++i) {
+    for (auto func : funcs) {
+      RWMol cp(*mols[i]);
+      res1[i].push_back(MolHash::MolHash(&cp, func));
+    }
+  }
+  report("MolHash one hash at a time", t1);
+
+  std::vector<const ROMol *> ptrs;
+  for (const auto &mol : mols) {
+    ptrs.push_back(mol.get());
+  }
+  t1 = std::chrono::high_resolution_clock::now();
+  auto res2 = MolHash::MolHashes(ptrs, funcs);
+  report("MolHashes, 1 thread", t1);
+  CHECK(res1 == res2);
+
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  t1 = std::chrono::high_resolution_clock::now();
+  auto res3 = MolHash::MolHashes(ptrs, funcs, -1);
+  report("MolHashes, all threads", t1);
+  CHECK(res1 == res3);
+#endif
+}
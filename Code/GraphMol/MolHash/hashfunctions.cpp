@@ -14,6 +14,7 @@
 #include <cstdlib>
 #include <cstdio>
 #include <deque>
+#include <algorithm>
 
 // #define VERBOSE_HASH 1
 
@@ -21,6 +22,7 @@
 #include <GraphMol/RDKitBase.h>
 #include <GraphMol/RDKitQueries.h>
 #include <GraphMol/SmilesParse/SmilesWrite.h>
+#include <RDGeneral/RDThreads.h>
 
 #include "nmmolhash.h"
 #include "mf.h"
@@ -301,6 +303,38 @@ std::string convertToSmilesWithCXFlags(
     SmilesWriteParams ps = SmilesWriteParams()) {
   return SmilesWrite::detail::MolToSmiles(mol, ps, doingCXSmiles);
 }
+
+// The hashes which come in pairs (Mesomer/RedoxPair, HetAtomTautomer/
+// HetAtomProtomer, and the v2 versions of those) only differ in the suffix
+// which is added to the SMILES, so the SMILES and the counts used to build
+// the suffix are kept separately. This allows both members of a pair to be
+// generated from a single canonicalization.
+struct HashParts {
+  std::string smiles;
+  std::string cxext;  // includes the leading space, if not empty
+  int hcount = 0;
+  int charge = 0;
+};
+
+std::string tautomerHashFromParts(const HashParts &parts, bool proto) {
+  char buffer[32];
+  if (!proto) {
+    sprintf(buffer, "_%d_%d", parts.hcount, parts.charge);
+  } else {
+    sprintf(buffer, "_%d", parts.hcount - parts.charge);
+  }
+  return parts.smiles + buffer + parts.cxext;
+}
+
+std::string mesomerHashFromParts(const HashParts &parts, bool netq) {
+  std::string result = parts.smiles;
+  if (netq) {
+    char buffer[32];
+    sprintf(buffer, "_%d", parts.charge);
+    result += buffer;
+  }
+  return result + parts.cxext;
+}
 }  // namespace
 
 std::string AnonymousGraph(RWMol *mol, bool elem, bool useCXSmiles,
@@ -342,11 +376,9 @@ std::string AnonymousGraph(RWMol *mol, bool elem, bool useCXSmiles,
   return result;
 }
 
-std::string MesomerHash(RWMol *mol, bool netq, bool useCXSmiles,
-                        unsigned cxFlagsToSkip = 0) {
+void MesomerHashParts(RWMol *mol, bool useCXSmiles, unsigned cxFlagsToSkip,
+                      HashParts &parts) {
   PRECONDITION(mol, "bad molecule");
-  std::string result;
-  char buffer[32];
   int charge = 0;
 
   for (auto aptr : mol->atoms()) {
@@ -367,15 +399,20 @@ std::string MesomerHash(RWMol *mol, bool netq, bool useCXSmiles,
   bool force = true;
   MolOps::assignStereochemistry(*mol, cleanIt, force);
 
-  result = convertToSmilesWithCXFlags(*mol, useCXSmiles);
-  if (netq) {
-    sprintf(buffer, "_%d", charge);
-    result += buffer;
-  }
+  parts.smiles = convertToSmilesWithCXFlags(*mol, useCXSmiles);
+  parts.charge = charge;
+  parts.cxext.clear();
   if (useCXSmiles) {
-    addCXExtensions(mol, result, cxFlagsToSkip | SmilesWrite::CX_RADICALS);
+    addCXExtensions(mol, parts.cxext,
+                    cxFlagsToSkip | SmilesWrite::CX_RADICALS);
   }
-  return result;
+}
+
+std::string MesomerHash(RWMol *mol, bool netq, bool useCXSmiles,
+                        unsigned cxFlagsToSkip = 0) {
+  HashParts parts;
+  MesomerHashParts(mol, useCXSmiles, cxFlagsToSkip, parts);
+  return mesomerHashFromParts(parts, netq);
 }
 
 namespace {
@@ -456,10 +493,9 @@ bool skipNeighborBond(const Atom *atom, const Atom *otherAtom,
 }
 }  // namespace
 
-std::string TautomerHashv2(RWMol *mol, bool proto, bool useCXSmiles,
-                           unsigned cxFlagsToSkip = 0) {
+void TautomerHashv2Parts(RWMol *mol, bool useCXSmiles,
+                         unsigned cxFlagsToSkip, HashParts &parts) {
   PRECONDITION(mol, "bad molecule");
-  std::string result;
   unsigned int hcount = 0;
   int charge = 0;
 
@@ -665,26 +701,26 @@ std::string TautomerHashv2(RWMol *mol, bool proto, bool useCXSmiles,
   SmilesWriteParams ps;
   ps.allBondsExplicit = true;
   ps.allHsExplicit = true;
-  result = convertToSmilesWithCXFlags(*mol, useCXSmiles, ps);
-  char buffer[32];
-  if (!proto) {
-    sprintf(buffer, "_%d_%d", hcount, charge);
-  } else {
-    sprintf(buffer, "_%d", hcount - charge);
-  }
-  result += buffer;
+  parts.smiles = convertToSmilesWithCXFlags(*mol, useCXSmiles, ps);
+  parts.hcount = static_cast<int>(hcount);
+  parts.charge = charge;
+  parts.cxext.clear();
   if (useCXSmiles) {
-    addCXExtensions(mol, result, cxFlagsToSkip | SmilesWrite::CX_RADICALS);
+    addCXExtensions(mol, parts.cxext,
+                    cxFlagsToSkip | SmilesWrite::CX_RADICALS);
   }
+}
 
-  return result;
+std::string TautomerHashv2(RWMol *mol, bool proto, bool useCXSmiles,
+                           unsigned cxFlagsToSkip = 0) {
+  HashParts parts;
+  TautomerHashv2Parts(mol, useCXSmiles, cxFlagsToSkip, parts);
+  return tautomerHashFromParts(parts, proto);
 }
 
-std::string TautomerHash(RWMol *mol, bool proto, bool useCXSmiles,
-                         unsigned cxFlagsToSkip = 0) {
+void TautomerHashParts(RWMol *mol, bool useCXSmiles, unsigned cxFlagsToSkip,
+                       HashParts &parts) {
   PRECONDITION(mol, "bad molecule");
-  std::string result;
-  char buffer[32];
   int hcount = 0;
   int charge = 0;
 
@@ -715,18 +751,21 @@ std::string TautomerHash(RWMol *mol, bool proto, bool useCXSmiles,
   bool cleanIt = true;
   bool force = true;
   MolOps::assignStereochemistry(*mol, cleanIt, force);
-  result = convertToSmilesWithCXFlags(*mol, useCXSmiles);
-  if (!proto) {
-    sprintf(buffer, "_%d_%d", hcount, charge);
-  } else {
-    sprintf(buffer, "_%d", hcount - charge);
-  }
-  result += buffer;
+  parts.smiles = convertToSmilesWithCXFlags(*mol, useCXSmiles);
+  parts.hcount = hcount;
+  parts.charge = charge;
+  parts.cxext.clear();
   if (useCXSmiles) {
-    addCXExtensions(mol, result, cxFlagsToSkip | SmilesWrite::CX_RADICALS);
+    addCXExtensions(mol, parts.cxext,
+                    cxFlagsToSkip | SmilesWrite::CX_RADICALS);
   }
+}
 
-  return result;
+std::string TautomerHash(RWMol *mol, bool proto, bool useCXSmiles,
+                         unsigned cxFlagsToSkip = 0) {
+  HashParts parts;
+  TautomerHashParts(mol, useCXSmiles, cxFlagsToSkip, parts);
+  return tautomerHashFromParts(parts, proto);
 }
 
 bool TraverseForRing(Atom *atom, unsigned char *visit) {
@@ -1015,7 +1054,7 @@ std::string RegioisomerHash(RWMol *mol, bool useCXSmiles,
   // we need a copy of the molecule so that we can loop over the bonds of
   // something while modifying something else
   RDKit::ROMol molcpy(*mol);
-  if (molcpy.getRingInfo()->isFindFastOrBetter()) {
+  if (!molcpy.getRingInfo()->isFindFastOrBetter()) {
     MolOps::fastFindRings(molcpy);
   }
   for (int i = molcpy.getNumBonds() - 1; i >= 0; --i) {
@@ -1183,14 +1222,12 @@ std::string ArthorSubOrderHash(RWMol *mol) {
           pcount, ccount, ocount, zcount, rcount, qcount, icount);
   return buffer;
 }
-}  // namespace
 
-std::string MolHash(RWMol *mol, HashFunction func, bool useCXSmiles,
-                    unsigned cxFlagsToSkip) {
+std::string computeHash(RWMol *mol, HashFunction func, bool useCXSmiles,
+                        unsigned cxFlagsToSkip) {
   PRECONDITION(mol, "bad molecule");
   std::string result;
   char buffer[32];
-  NMRDKitSanitizeHydrogens(mol);
 
   switch (func) {
     default:
@@ -1261,5 +1298,158 @@ std::string MolHash(RWMol *mol, HashFunction func, bool useCXSmiles,
   }
   return result;
 }
+
+// these only look at the molecule, they don't modify it
+bool isReadOnlyHash(HashFunction func) {
+  switch (func) {
+    case HashFunction::MolFormula:
+    case HashFunction::AtomBondCounts:
+    case HashFunction::NetCharge:
+    case HashFunction::SmallWorldIndexBR:
+    case HashFunction::SmallWorldIndexBRL:
+    case HashFunction::DegreeVector:
+    case HashFunction::ArthorSubstructureOrder:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// hashes which can be generated from the HashParts of another one
+HashFunction sharedHashFunction(HashFunction func) {
+  switch (func) {
+    case HashFunction::RedoxPair:
+      return HashFunction::Mesomer;
+    case HashFunction::HetAtomProtomer:
+      return HashFunction::HetAtomTautomer;
+    case HashFunction::HetAtomProtomerv2:
+      return HashFunction::HetAtomTautomerv2;
+    default:
+      return func;
+  }
+}
+
+void computeHashParts(RWMol *mol, HashFunction func, bool useCXSmiles,
+                      unsigned cxFlagsToSkip, HashParts &parts) {
+  switch (func) {
+    case HashFunction::Mesomer:
+      MesomerHashParts(mol, useCXSmiles, cxFlagsToSkip, parts);
+      break;
+    case HashFunction::HetAtomTautomer:
+      TautomerHashParts(mol, useCXSmiles, cxFlagsToSkip, parts);
+      break;
+    case HashFunction::HetAtomTautomerv2:
+      TautomerHashv2Parts(mol, useCXSmiles, cxFlagsToSkip, parts);
+      break;
+    default:
+      parts.smiles = computeHash(mol, func, useCXSmiles, cxFlagsToSkip);
+      break;
+  }
+}
+
+std::string hashFromParts(const HashParts &parts, HashFunction func) {
+  switch (func) {
+    case HashFunction::Mesomer:
+      return mesomerHashFromParts(parts, true);
+    case HashFunction::RedoxPair:
+      return mesomerHashFromParts(parts, false);
+    case HashFunction::HetAtomTautomer:
+    case HashFunction::HetAtomTautomerv2:
+      return tautomerHashFromParts(parts, false);
+    case HashFunction::HetAtomProtomer:
+    case HashFunction::HetAtomProtomerv2:
+      return tautomerHashFromParts(parts, true);
+    default:
+      return parts.smiles;
+  }
+}
+}  // namespace
+
+std::string MolHash(RWMol *mol, HashFunction func, bool useCXSmiles,
+                    unsigned cxFlagsToSkip) {
+  PRECONDITION(mol, "bad molecule");
+  NMRDKitSanitizeHydrogens(mol);
+  return computeHash(mol, func, useCXSmiles, cxFlagsToSkip);
+}
+
+std::vector<std::string> MolHashes(const ROMol &mol,
+                                   const std::vector<HashFunction> &funcs,
+                                   bool useCXSmiles, unsigned cxFlagsToSkip) {
+  std::vector<std::string> res(funcs.size());
+  if (funcs.empty()) {
+    return res;
+  }
+  RWMol base(mol);
+  NMRDKitSanitizeHydrogens(&base);
+  if (!base.getRingInfo()->isInitialized()) {
+    MolOps::fastFindRings(base);
+  }
+
+  // The read-only hashes are done on the shared molecule. Each of the others
+  // needs its own copy of it, apart from the last one, which can use the
+  // shared molecule itself. The canonical SMILES are generated last so that
+  // they don't leave any computed properties on the molecule which is copied.
+  std::vector<HashFunction> modifying;
+  bool needCanonicalSmiles = false;
+  for (unsigned int i = 0; i < funcs.size(); ++i) {
+    if (isReadOnlyHash(funcs[i])) {
+      res[i] = computeHash(&base, funcs[i], useCXSmiles, cxFlagsToSkip);
+    } else if (funcs[i] == HashFunction::CanonicalSmiles) {
+      needCanonicalSmiles = true;
+    } else {
+      auto shared = sharedHashFunction(funcs[i]);
+      if (std::find(modifying.begin(), modifying.end(), shared) ==
+          modifying.end()) {
+        modifying.push_back(shared);
+      }
+    }
+  }
+  std::vector<HashParts> parts(modifying.size());
+  for (unsigned int i = 0; i < modifying.size(); ++i) {
+    if (i + 1 == modifying.size() && !needCanonicalSmiles) {
+      computeHashParts(&base, modifying[i], useCXSmiles, cxFlagsToSkip,
+                       parts[i]);
+    } else {
+      RWMol cp(base);
+      computeHashParts(&cp, modifying[i], useCXSmiles, cxFlagsToSkip,
+                       parts[i]);
+    }
+  }
+  for (unsigned int i = 0; i < funcs.size(); ++i) {
+    if (isReadOnlyHash(funcs[i]) ||
+        funcs[i] == HashFunction::CanonicalSmiles) {
+      continue;
+    }
+    auto loc = std::find(modifying.begin(), modifying.end(),
+                         sharedHashFunction(funcs[i]));
+    res[i] = hashFromParts(parts[loc - modifying.begin()], funcs[i]);
+  }
+  if (needCanonicalSmiles) {
+    auto smi = computeHash(&base, HashFunction::CanonicalSmiles, useCXSmiles,
+                           cxFlagsToSkip);
+    for (unsigned int i = 0; i < funcs.size(); ++i) {
+      if (funcs[i] == HashFunction::CanonicalSmiles) {
+        res[i] = smi;
+      }
+    }
+  }
+  return res;
+}
+
+std::vector<std::vector<std::string>> MolHashes(
+    const std::vector<const ROMol *> &mols,
+    const std::vector<HashFunction> &funcs, int numThreads, bool useCXSmiles,
+    unsigned cxFlagsToSkip) {
+  std::vector<std::vector<std::string>> res(mols.size());
+  auto func = [&](size_t idx) {
+    if (!mols[idx]) {
+      res[idx].resize(funcs.size());
+      return;
+    }
+    res[idx] = MolHashes(*mols[idx], funcs, useCXSmiles, cxFlagsToSkip);
+  };
+  runOnIndices(func, mols.size(), numThreads);
+  return res;
+}
 }  // namespace MolHash
 }  // namespace RDKit
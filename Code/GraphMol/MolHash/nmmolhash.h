@@ -20,6 +20,7 @@
 #include <vector>
 
 namespace RDKit {
+class ROMol;
 class RWMol;
 namespace MolHash {
 enum class HashFunction {
@@ -52,6 +53,44 @@ RDKIT_MOLHASH_EXPORT std::string MolHash(RWMol *mol, HashFunction func,
                                          bool useCXSmiles = false,
                                          unsigned cxFlagsToSkip = 0);
 
+//! Calculates multiple hashes for a molecule
+/*!
+  The results are the same as calling MolHash() with each of the hash
+  functions on separate copies of \c mol, but work is shared between the
+  hashes: hydrogen counts and ring information are only set up once, and the
+  pairs of hashes which differ only by a suffix (Mesomer and RedoxPair,
+  HetAtomTautomer and HetAtomProtomer, HetAtomTautomerv2 and
+  HetAtomProtomerv2) are generated from a single canonical SMILES.
+
+  \param mol            the molecule to hash, this is not modified
+  \param funcs          the hash functions to calculate
+  \param useCXSmiles    as for MolHash()
+  \param cxFlagsToSkip  as for MolHash()
+
+  \return the hashes, in the same order as \c funcs
+*/
+RDKIT_MOLHASH_EXPORT std::vector<std::string> MolHashes(
+    const ROMol &mol, const std::vector<HashFunction> &funcs,
+    bool useCXSmiles = false, unsigned cxFlagsToSkip = 0);
+
+//! Calculates multiple hashes for each of a set of molecules
+/*!
+  \param mols           the molecules to hash, null entries result in
+                        empty hashes
+  \param funcs          the hash functions to calculate
+  \param numThreads     the number of threads to use, values <= 0 are
+                        interpreted as described for getNumThreadsToUse()
+  \param useCXSmiles    as for MolHash()
+  \param cxFlagsToSkip  as for MolHash()
+
+  \return the hashes for each molecule, as returned by the single molecule
+          version of MolHashes()
+*/
+RDKIT_MOLHASH_EXPORT std::vector<std::vector<std::string>> MolHashes(
+    const std::vector<const ROMol *> &mols,
+    const std::vector<HashFunction> &funcs, int numThreads = 1,
+    bool useCXSmiles = false, unsigned cxFlagsToSkip = 0);
+
 enum class StripType {
   AtomStereo = 1,
   BondStereo = 2,
@@ -48,6 +48,9 @@ struct RDKIT_MOLINTERCHANGE_EXPORT JSONParseParameters {
   bool useHCounts =
       true; /*!< toggles using the implicit H counts for atoms from the JSON
                block. You may want to set this to false when parsing queries. */
+  int numThreads = 1; /*!< the number of threads used to construct the
+                         molecules. Values <= 0 are interpreted as in
+                         getNumThreadsToUse() */
 };
 static JSONParseParameters defaultJSONParseParameters;
 
@@ -73,6 +76,9 @@ JSONDataToMols(const std::string &jsonBlock,
 struct RDKIT_MOLINTERCHANGE_EXPORT JSONWriteParameters {
   bool useRDKitExtensions =
       true; /*!< toggles using RDKit extensions to commmonchem */
+  int numThreads = 1; /*!< the number of threads used to generate the JSON
+                         for the molecules. Values <= 0 are interpreted as
+                         in getNumThreadsToUse() */
 };
 static JSONWriteParameters defaultJSONWriteParameters;
 
@@ -85,6 +91,17 @@ RDKIT_MOLINTERCHANGE_EXPORT std::string MolsToJSONData(
     const std::vector<T> &mols,
     const JSONWriteParameters &params = defaultJSONWriteParameters);
 
+// \brief appends MolJSON for a set of molecules to a string
+/*!
+ *   \param mols    - the molecules to work with
+ *   \param buffer  - the string the JSON is appended to. Reusing the same
+ *                    string for many calls avoids reallocating it.
+ */
+template <typename T>
+RDKIT_MOLINTERCHANGE_EXPORT void appendMolsToJSONData(
+    const std::vector<T> &mols, std::string &buffer,
+    const JSONWriteParameters &params = defaultJSONWriteParameters);
+
 // \brief returns MolJSON for a molecule
 /*!
  *   \param mol   - the molecule to work with
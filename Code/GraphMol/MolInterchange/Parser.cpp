@@ -12,6 +12,7 @@
 #endif
 
 #include <RDGeneral/Invariant.h>
+#include <RDGeneral/RDThreads.h>
 #include <RDGeneral/versions.h>
 #include <GraphMol/RDKitBase.h>
 #include <GraphMol/RDKitQueries.h>
@@ -28,9 +29,12 @@
 #include <RDGeneral/BoostEndInclude.h>
 using namespace Queries;
 
+#include <algorithm>
 #include <sstream>
 #include <exception>
+#include <iterator>
 #include <map>
+#include <memory>
 
 #if !defined(_MSC_VER)
 // g++ (at least as of v9.3.0) generates some spurious warnings from here.
@@ -41,7 +45,8 @@ using namespace Queries;
 #endif
 #endif
 #include <rapidjson/document.h>
-#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/memorystream.h>
+#include <rapidjson/reader.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 #include <rapidjson/pointer.h>
@@ -914,69 +919,265 @@ void processMol(RWMol *mol, const rj::Value &molval,
   mol->setProp(common_properties::_StereochemDone, 1);
 }
 
-std::vector<boost::shared_ptr<ROMol>> DocToMols(
-    rj::Document &doc, const JSONParseParameters &params) {
-  std::vector<boost::shared_ptr<ROMol>> res;
+//! finds the parts of a MolJSON document without building a DOM for it
+/*!
+  The molecules, the header and the defaults are recorded as spans of the
+  input so that they can be parsed separately later.
+*/
+class JSONScanner : public rj::BaseReaderHandler<rj::UTF8<>, JSONScanner> {
+ public:
+  struct Span {
+    size_t start = 0;
+    size_t end = 0;
+    bool found = false;
+    bool isObject = false;
+  };
 
-  // some error checking
-  if (!doc.IsObject()) {
-    throw FileParseException("Bad Format: JSON should be an object");
+  explicit JSONScanner(const rj::MemoryStream &stream) : d_stream(stream) {}
+
+  Span commonchemHeader;
+  Span rdkitjsonHeader;
+  Span defaults;
+  std::vector<Span> molecules;
+  bool notObject = false;
+  bool hasMolecules = false;
+  bool moleculesNotArray = false;
+  bool moleculeNotObject = false;
+
+  bool Default() {
+    if (!d_depth) {
+      notObject = true;
+      return false;
+    }
+    checkScalar();
+    return true;
+  }
+  bool Key(const char *str, rj::SizeType len, bool) {
+    if (d_depth == 1) {
+      d_key.assign(str, len);
+    }
+    return true;
+  }
+  bool StartObject() {
+    if (!d_capture) {
+      const size_t start = d_stream.Tell() - 1;
+      if (d_depth == 1) {
+        auto span = getTopLevelSpan();
+        if (span && !span->found) {
+          span->found = true;
+          span->isObject = true;
+          span->start = start;
+          d_capture = span;
+          d_captureDepth = d_depth;
+        }
+        if (d_key == "molecules" && !hasMolecules) {
+          hasMolecules = true;
+          moleculesNotArray = true;
+        }
+      } else if (d_depth == 2 && d_inMolecules) {
+        molecules.emplace_back();
+        molecules.back().found = true;
+        molecules.back().isObject = true;
+        molecules.back().start = start;
+        d_capture = &molecules.back();
+        d_captureDepth = d_depth;
+      }
+    }
+    ++d_depth;
+    return true;
+  }
+  bool EndObject(rj::SizeType) {
+    --d_depth;
+    if (d_capture && d_depth == d_captureDepth) {
+      d_capture->end = d_stream.Tell();
+      d_capture = nullptr;
+    }
+    return true;
+  }
+  bool StartArray() {
+    if (!d_depth) {
+      notObject = true;
+      return false;
+    }
+    if (!d_capture) {
+      if (d_depth == 1 && d_key == "molecules" && !hasMolecules) {
+        hasMolecules = true;
+        d_inMolecules = true;
+      } else {
+        checkScalar();
+      }
+    }
+    ++d_depth;
+    return true;
+  }
+  bool EndArray(rj::SizeType) {
+    --d_depth;
+    if (d_depth == 1) {
+      d_inMolecules = false;
+    }
+    return true;
+  }
+
+ private:
+  Span *getTopLevelSpan() {
+    if (d_key == "commonchem") {
+      return &commonchemHeader;
+    } else if (d_key == "rdkitjson") {
+      return &rdkitjsonHeader;
+    } else if (d_key == "defaults") {
+      return &defaults;
+    }
+    return nullptr;
+  }
+  // called for values that aren't objects
+  void checkScalar() {
+    if (d_capture) {
+      return;
+    }
+    if (d_depth == 1) {
+      if (d_key == "commonchem" || d_key == "rdkitjson") {
+        getTopLevelSpan()->found = true;
+      } else if (d_key == "molecules" && !hasMolecules) {
+        hasMolecules = true;
+        moleculesNotArray = true;
+      }
+    } else if (d_depth == 2 && d_inMolecules) {
+      moleculeNotObject = true;
+    }
   }
 
-  if (doc.HasMember("commonchem")) {
-    if (!doc["commonchem"].IsObject() ||
-        !doc["commonchem"].HasMember("version")) {
+  const rj::MemoryStream &d_stream;
+  unsigned int d_depth = 0;
+  std::string d_key;
+  bool d_inMolecules = false;
+  Span *d_capture = nullptr;
+  unsigned int d_captureDepth = 0;
+};
+
+void parseSpan(const char *data, const JSONScanner::Span &span,
+               rj::Document &doc) {
+  rj::MemoryStream ms(data + span.start, span.end - span.start);
+  doc.ParseStream(ms);
+  if (doc.HasParseError()) {
+    throw FileParseException("Bad Format: JSON parse error");
+  }
+}
+
+void checkHeader(const char *data, const JSONScanner &scanner) {
+  if (scanner.commonchemHeader.found) {
+    rj::Document header;
+    if (scanner.commonchemHeader.isObject) {
+      parseSpan(data, scanner.commonchemHeader, header);
+    }
+    if (!header.IsObject() || !header.HasMember("version")) {
       throw FileParseException("Bad Format: missing version in JSON");
     }
-    if (doc["commonchem"]["version"].GetInt() != currentMolJSONVersion) {
+    if (header["version"].GetInt() != currentMolJSONVersion) {
       throw FileParseException("Bad Format: bad version in JSON");
     }
-  } else if (doc.HasMember("rdkitjson")) {
-    if (!doc["rdkitjson"].IsObject() ||
-        !doc["rdkitjson"].HasMember("version")) {
+  } else if (scanner.rdkitjsonHeader.found) {
+    rj::Document header;
+    if (scanner.rdkitjsonHeader.isObject) {
+      parseSpan(data, scanner.rdkitjsonHeader, header);
+    }
+    if (!header.IsObject() || !header.HasMember("version")) {
       throw FileParseException("Bad Format: missing version in JSON");
     }
     // FIX: we want to be backwards compatible
     // Version 10 files can be read by 11, but not vice versa.
-    if (int jsonVersion = doc["rdkitjson"]["version"].GetInt();
+    if (int jsonVersion = header["version"].GetInt();
         jsonVersion > currentRDKitJSONVersion || jsonVersion < 10) {
       throw FileParseException("Bad Format: bad version in JSON");
     }
   } else {
     throw FileParseException("Bad Format: missing header in JSON");
   }
+}
 
-  rj::Value atomDefaults_;
-  if (rj::GetValueByPointer(doc, "/defaults/atom")) {
-    atomDefaults_ = *rj::GetValueByPointer(doc, "/defaults/atom");
-    if (!atomDefaults_.IsObject()) {
-      throw FileParseException("Bad Format: atomDefaults is not an object");
+// the molecules are parsed with a memory pool that starts with this
+// much space, so that small molecules don't need any allocations
+constexpr size_t molParseBufferSize = 64 * 1024;
+
+void parseMolecules(const char *data,
+                    const std::vector<JSONScanner::Span> &spans,
+                    size_t startIdx, size_t endIdx,
+                    const rj::Value &atomDefaultsVal,
+                    const rj::Value &bondDefaultsVal,
+                    const JSONParseParameters &params,
+                    std::vector<boost::shared_ptr<ROMol>> &res) {
+  // the caches aren't thread safe, so each thread has its own
+  const DefaultValueCache atomDefaults(atomDefaultsVal);
+  const DefaultValueCache bondDefaults(bondDefaultsVal);
+  std::vector<char> buffer(molParseBufferSize);
+  rj::MemoryPoolAllocator<> allocator(buffer.data(), buffer.size());
+  for (size_t i = startIdx; i < endIdx; ++i) {
+    {
+      rj::Document molval(&allocator);
+      parseSpan(data, spans[i], molval);
+      std::unique_ptr<RWMol> mol(new RWMol());
+      processMol(mol.get(), molval, atomDefaults, bondDefaults, params);
+      mol->updatePropertyCache(params.strictValenceCheck);
+      mol->setProp(common_properties::_StereochemDone, 1);
+      res[i].reset(static_cast<ROMol *>(mol.release()));
     }
+    allocator.Clear();
   }
-  const DefaultValueCache atomDefaults(atomDefaults_);
+}
 
-  rj::Value bondDefaults_;
-  if (rj::GetValueByPointer(doc, "/defaults/bond")) {
-    bondDefaults_ = *rj::GetValueByPointer(doc, "/defaults/bond");
-    if (!bondDefaults_.IsObject()) {
-      throw FileParseException("Bad Format: bondDefaults is not an object");
-    }
+std::vector<boost::shared_ptr<ROMol>> parseMolJSON(
+    const char *data, size_t length, const JSONParseParameters &params) {
+  rj::MemoryStream ms(data, length);
+  JSONScanner scanner(ms);
+  rj::Reader reader;
+  reader.Parse(ms, scanner);
+  // some error checking
+  if (reader.HasParseError() || scanner.notObject) {
+    throw FileParseException("Bad Format: JSON should be an object");
   }
-  const DefaultValueCache bondDefaults(bondDefaults_);
+  checkHeader(data, scanner);
 
-  if (doc.HasMember("molecules")) {
-    if (!doc["molecules"].IsArray()) {
-      throw FileParseException("Bad Format: molecules is not an array");
+  rj::Document defaults;
+  if (scanner.defaults.found) {
+    parseSpan(data, scanner.defaults, defaults);
+  }
+  const rj::Value emptyDefaults(rj::kObjectType);
+  const rj::Value *atomDefaults = &emptyDefaults;
+  const rj::Value *bondDefaults = &emptyDefaults;
+  if (defaults.IsObject()) {
+    if (const auto val = rj::GetValueByPointer(defaults, "/atom")) {
+      if (!val->IsObject()) {
+        throw FileParseException("Bad Format: atomDefaults is not an object");
+      }
+      atomDefaults = val;
     }
-    for (const auto &molval : doc["molecules"].GetArray()) {
-      auto *mol = new RWMol();
-      processMol(mol, molval, atomDefaults, bondDefaults, params);
-      mol->updatePropertyCache(params.strictValenceCheck);
-      mol->setProp(common_properties::_StereochemDone, 1);
-      res.emplace_back(static_cast<ROMol *>(mol));
+    if (const auto val = rj::GetValueByPointer(defaults, "/bond")) {
+      if (!val->IsObject()) {
+        throw FileParseException("Bad Format: bondDefaults is not an object");
+      }
+      bondDefaults = val;
     }
   }
 
+  if (scanner.moleculesNotArray) {
+    throw FileParseException("Bad Format: molecules is not an array");
+  }
+  if (scanner.moleculeNotObject) {
+    throw FileParseException("Bad Format: molecule is not an object");
+  }
+  const auto &spans = scanner.molecules;
+  std::vector<boost::shared_ptr<ROMol>> res(spans.size());
+  auto numThreads = std::min<size_t>(getNumThreadsToUse(params.numThreads),
+                                     spans.size());
+  numThreads = std::max<size_t>(numThreads, 1);
+  // each thread gets a contiguous block of molecules, so the first error
+  // reported is the same one a serial parse would report
+  runOnIndices(
+      [&](size_t t) {
+        parseMolecules(data, spans, t * spans.size() / numThreads,
+                       (t + 1) * spans.size() / numThreads, *atomDefaults,
+                       *bondDefaults, params, res);
+      },
+      numThreads, numThreads);
   return res;
 }
 
@@ -986,17 +1187,13 @@ std::vector<boost::shared_ptr<ROMol>> JSONDataStreamToMols(
     std::istream *inStream, const JSONParseParameters &params) {
   PRECONDITION(inStream, "no stream");
 
-  rj::IStreamWrapper isw(*inStream);
-  rj::Document doc;
-  doc.ParseStream(isw);
-
-  return DocToMols(doc, params);
+  std::string jsonBlock((std::istreambuf_iterator<char>(*inStream)),
+                        std::istreambuf_iterator<char>());
+  return parseMolJSON(jsonBlock.data(), jsonBlock.size(), params);
 }
 std::vector<boost::shared_ptr<ROMol>> JSONDataToMols(
     const std::string &jsonBlock, const JSONParseParameters &params) {
-  rj::Document doc;
-  doc.Parse(jsonBlock.c_str());
-  return DocToMols(doc, params);
+  return parseMolJSON(jsonBlock.data(), jsonBlock.size(), params);
 }
 
 }  // namespace MolInterchange
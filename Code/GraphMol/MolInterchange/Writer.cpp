@@ -12,6 +12,7 @@
 #endif
 
 #include <RDGeneral/Invariant.h>
+#include <RDGeneral/RDThreads.h>
 #include <RDGeneral/versions.h>
 #include <GraphMol/RDKitBase.h>
 #include <GraphMol/MolPickler.h>
@@ -22,12 +23,12 @@
 #include <GraphMol/MolInterchange/details.h>
 #include <RDGeneral/FileParseException.h>
 
+#include <algorithm>
 #include <sstream>
 #include <exception>
 #include <map>
 
 #include <rapidjson/document.h>
-#include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 #include "rapidjson/pointer.h"
 
@@ -648,21 +649,18 @@ void addMol(const T &imol, rj::Value &rjMol, rj::Document &doc,
 }
 }  // end of anonymous namespace
 
-template <typename T>
-std::string MolsToJSONData(const std::vector<T> &mols,
-                           const JSONWriteParameters &params) {
-  std::string res = "";
-  rj::Document doc;
-  doc.SetObject();
-
-  rj::Value header(rj::kObjectType);
-  initHeader(header, doc, params);
-  if (!params.useRDKitExtensions) {
-    doc.AddMember("commonchem", header, doc.GetAllocator());
-  } else {
-    doc.AddMember("rdkitjson", header, doc.GetAllocator());
-  }
+namespace {
+//! a rapidjson output stream which appends to a string
+struct StringOutStream {
+  using Ch = char;
+  explicit StringOutStream(std::string &str) : d_str(str) {}
+  void Put(char c) { d_str.push_back(c); }
+  void Flush() {}
+  std::string &d_str;
+};
 
+void initDefaults(rj::Document &doc) {
+  doc.SetObject();
   rj::Value defaults(rj::kObjectType);
 
   rj::Value atomDefaults(rj::kObjectType);
@@ -673,25 +671,94 @@ std::string MolsToJSONData(const std::vector<T> &mols,
   initBondDefaults(bondDefaults, doc);
   defaults.AddMember("bond", bondDefaults, doc.GetAllocator());
   doc.AddMember("defaults", defaults, doc.GetAllocator());
+}
 
-  rj::Value rjMols(rj::kArrayType);
+// the molecules are built with a memory pool that starts with this much
+// space, so that small molecules don't need any allocations
+constexpr size_t molWriteBufferSize = 64 * 1024;
+
+template <typename T>
+void writeMols(const std::vector<T> &mols, size_t startIdx, size_t endIdx,
+               const JSONWriteParameters &params, std::string &buffer) {
+  std::vector<char> poolBuffer(molWriteBufferSize);
+  rj::MemoryPoolAllocator<> allocator(poolBuffer.data(), poolBuffer.size());
+  StringOutStream os(buffer);
+  rj::Writer<StringOutStream> writer(os);
+  writer.SetMaxDecimalPlaces(4);
+  for (size_t i = startIdx; i < endIdx; ++i) {
+    {
+      // each molecule gets its own document, the defaults need to be in
+      // it for the recursive queries
+      rj::Document doc(&allocator);
+      initDefaults(doc);
+      rj::Value rjMol(rj::kObjectType);
+      addMol(*mols[i], rjMol, doc,
+             *rj::GetValueByPointer(doc, "/defaults/atom"),
+             *rj::GetValueByPointer(doc, "/defaults/bond"), params);
+      if (i) {
+        buffer.push_back(',');
+      }
+      writer.Reset(os);
+      rjMol.Accept(writer);
+    }
+    allocator.Clear();
+  }
+}
+}  // namespace
+
+template <typename T>
+void appendMolsToJSONData(const std::vector<T> &mols, std::string &buffer,
+                          const JSONWriteParameters &params) {
   for (const auto &mol : mols) {
     if (!mol) {
       throw ValueErrorException("null molecule passed to MolsToJSONData");
     }
-    rj::Value rjMol(rj::kObjectType);
-    // write mol;
-    addMol(*mol, rjMol, doc, *rj::GetValueByPointer(doc, "/defaults/atom"),
-           *rj::GetValueByPointer(doc, "/defaults/bond"), params);
-    rjMols.PushBack(rjMol, doc.GetAllocator());
   }
-  doc.AddMember("molecules", rjMols, doc.GetAllocator());
+  rj::Document doc;
+  initDefaults(doc);
+  rj::Value header(rj::kObjectType);
+  initHeader(header, doc, params);
 
-  rj::StringBuffer buffer;
-  rj::Writer<rj::StringBuffer> writer(buffer);
+  StringOutStream os(buffer);
+  rj::Writer<StringOutStream> writer(os);
   writer.SetMaxDecimalPlaces(4);
-  doc.Accept(writer);
-  return buffer.GetString();
+  if (!params.useRDKitExtensions) {
+    buffer += "{\"commonchem\":";
+  } else {
+    buffer += "{\"rdkitjson\":";
+  }
+  header.Accept(writer);
+  buffer += ",\"defaults\":";
+  writer.Reset(os);
+  doc["defaults"].Accept(writer);
+  buffer += ",\"molecules\":[";
+
+  auto numThreads =
+      std::min<size_t>(getNumThreadsToUse(params.numThreads), mols.size());
+  if (numThreads > 1) {
+    // each thread writes a contiguous block of molecules to its own buffer
+    std::vector<std::string> chunks(numThreads);
+    runOnIndices(
+        [&](size_t t) {
+          writeMols(mols, t * mols.size() / numThreads,
+                    (t + 1) * mols.size() / numThreads, params, chunks[t]);
+        },
+        numThreads, numThreads);
+    for (const auto &chunk : chunks) {
+      buffer += chunk;
+    }
+  } else {
+    writeMols(mols, 0, mols.size(), params, buffer);
+  }
+  buffer += "]}";
+}
+
+template <typename T>
+std::string MolsToJSONData(const std::vector<T> &mols,
+                           const JSONWriteParameters &params) {
+  std::string res;
+  appendMolsToJSONData(mols, res, params);
+  return res;
 };
 
 template RDKIT_MOLINTERCHANGE_EXPORT std::string MolsToJSONData<ROMol *>(
@@ -702,6 +769,16 @@ template RDKIT_MOLINTERCHANGE_EXPORT std::string MolsToJSONData<const ROMol *>(
     const std::vector<const ROMol *> &, const JSONWriteParameters &);
 template RDKIT_MOLINTERCHANGE_EXPORT std::string MolsToJSONData<const RWMol *>(
     const std::vector<const RWMol *> &, const JSONWriteParameters &);
+template RDKIT_MOLINTERCHANGE_EXPORT void appendMolsToJSONData<ROMol *>(
+    const std::vector<ROMol *> &, std::string &, const JSONWriteParameters &);
+template RDKIT_MOLINTERCHANGE_EXPORT void appendMolsToJSONData<RWMol *>(
+    const std::vector<RWMol *> &, std::string &, const JSONWriteParameters &);
+template RDKIT_MOLINTERCHANGE_EXPORT void appendMolsToJSONData<const ROMol *>(
+    const std::vector<const ROMol *> &, std::string &,
+    const JSONWriteParameters &);
+template RDKIT_MOLINTERCHANGE_EXPORT void appendMolsToJSONData<const RWMol *>(
+    const std::vector<const RWMol *> &, std::string &,
+    const JSONWriteParameters &);
 
 }  // end of namespace MolInterchange
 }  // end of namespace RDKit
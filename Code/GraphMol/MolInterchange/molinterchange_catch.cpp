@@ -10,9 +10,12 @@
 #include <RDGeneral/test.h>
 #include <catch2/catch_all.hpp>
 
+#include <chrono>
+
 #include <GraphMol/RDKitBase.h>
 #include <GraphMol/MolPickler.h>
 #include <GraphMol/FileParsers/FileParsers.h>
+#include <GraphMol/FileParsers/MolSupplier.h>
 #include <GraphMol/SmilesParse/SmilesWrite.h>
 #include <GraphMol/SmilesParse/SmilesParse.h>
 #include <GraphMol/SmilesParse/SmartsWrite.h>
@@ -422,4 +425,173 @@ TEST_CASE("github #5923: add more error checking to substance groups") {
                       ValueErrorException);
     }
   }
-}
\ No newline at end of file
+}
+namespace {
+std::vector<std::unique_ptr<ROMol>> readNCIMols() {
+  std::string rdbase = getenv("RDBASE");
+  SDMolSupplier sup(rdbase + "/Data/NCI/first_200.props.sdf");
+  std::vector<std::unique_ptr<ROMol>> res;
+  while (!sup.atEnd()) {
+    std::unique_ptr<ROMol> mol(sup.next());
+    if (mol) {
+      res.push_back(std::move(mol));
+    }
+  }
+  return res;
+}
+}  // namespace
+
+TEST_CASE("multithreaded reading and writing") {
+  auto nciMols = readNCIMols();
+  REQUIRE(nciMols.size() > 100);
+  std::vector<const ROMol *> mols;
+  for (const auto &mol : nciMols) {
+    mols.push_back(mol.get());
+  }
+  auto json = MolInterchange::MolsToJSONData(mols);
+  SECTION("writing") {
+    for (auto numThreads : {2, 4, 0}) {
+      MolInterchange::JSONWriteParameters ps;
+      ps.numThreads = numThreads;
+      CHECK(MolInterchange::MolsToJSONData(mols, ps) == json);
+    }
+    // more threads than molecules
+    std::vector<const ROMol *> few{mols[0], mols[1]};
+    MolInterchange::JSONWriteParameters ps;
+    ps.numThreads = 4;
+    CHECK(MolInterchange::MolsToJSONData(few, ps) ==
+          MolInterchange::MolsToJSONData(few));
+    std::vector<const ROMol *> none;
+    CHECK(MolInterchange::MolsToJSONData(none, ps) ==
+          MolInterchange::MolsToJSONData(none));
+  }
+  SECTION("appending") {
+    std::string buffer = "some text";
+    MolInterchange::appendMolsToJSONData(mols, buffer);
+    CHECK(buffer == "some text" + json);
+    buffer.clear();
+    MolInterchange::appendMolsToJSONData(mols, buffer);
+    CHECK(buffer == json);
+  }
+  SECTION("reading") {
+    for (auto numThreads : {1, 2, 4, 0}) {
+      MolInterchange::JSONParseParameters ps;
+      ps.numThreads = numThreads;
+      auto newMols = MolInterchange::JSONDataToMols(json, ps);
+      REQUIRE(newMols.size() == mols.size());
+      for (size_t i = 0; i < mols.size(); ++i) {
+        REQUIRE(newMols[i]);
+        CHECK(MolToSmiles(*newMols[i]) == MolToSmiles(*mols[i]));
+        CHECK(newMols[i]->getNumConformers() == 1);
+        CHECK(newMols[i]->getProp<std::string>(common_properties::_Name) ==
+              mols[i]->getProp<std::string>(common_properties::_Name));
+      }
+    }
+  }
+  SECTION("errors are reported for the first bad molecule") {
+    auto badjson = json;
+    auto pos = badjson.find("\"atoms\":[", badjson.find("\"molecules\""));
+    REQUIRE(pos != std::string::npos);
+    badjson.replace(pos, 9, "\"atoms\":[{\"z\":\"C\"},");
+    MolInterchange::JSONParseParameters ps;
+    ps.numThreads = 4;
+    CHECK_THROWS(MolInterchange::JSONDataToMols(badjson, ps));
+  }
+}
+
+TEST_CASE("MolJSON format errors") {
+  MolInterchange::JSONParseParameters ps;
+  ps.numThreads = 2;
+  for (auto json : {"", "[]", "12", "{\"rdkitjson\":{\"version\":11}",
+                    "{\"rdkitjson\":{\"version\":11}} extra"}) {
+    CHECK_THROWS_WITH(MolInterchange::JSONDataToMols(json, ps),
+                      "Bad Format: JSON should be an object");
+  }
+  CHECK_THROWS_WITH(MolInterchange::JSONDataToMols("{}", ps),
+                    "Bad Format: missing header in JSON");
+  CHECK_THROWS_WITH(
+      MolInterchange::JSONDataToMols("{\"rdkitjson\":{\"version\":2}}", ps),
+      "Bad Format: bad version in JSON");
+  CHECK_THROWS_WITH(
+      MolInterchange::JSONDataToMols(
+          R"JSON({"rdkitjson":{"version":11},"defaults":{"atom":3}})JSON", ps),
+      "Bad Format: atomDefaults is not an object");
+  CHECK_THROWS_WITH(MolInterchange::JSONDataToMols(
+                        R"JSON({"rdkitjson":{"version":11},"molecules":{}})JSON",
+                        ps),
+                    "Bad Format: molecules is not an array");
+  CHECK_THROWS_WITH(
+      MolInterchange::JSONDataToMols(
+          R"JSON({"rdkitjson":{"version":11},"molecules":[{"atoms":[]},3]})JSON",
+          ps),
+      "Bad Format: molecule is not an object");
+  // keys at other levels don't confuse the parser
+  auto mols = MolInterchange::JSONDataToMols(
+      R"JSON({"rdkitjson":{"version":11,"molecules":5},
+      "defaults":{"atom":{"z":6,"impHs":0,"chg":0,"nRad":0,"isotope":0,"stereo":"unspecified"},
+                  "bond":{"bo":1,"stereo":"unspecified"}},
+      "molecules":[{"name":"a","molecules":[],"atoms":[{"impHs":3},{"z":8,"impHs":1}],"bonds":[{"atoms":[0,1]}]},
+                   {"name":"b","atoms":[{"impHs":4}],"bonds":[]}]})JSON",
+      ps);
+  REQUIRE(mols.size() == 2);
+  CHECK(MolToSmiles(*mols[0]) == "CO");
+  CHECK(MolToSmiles(*mols[1]) == "C");
+}
+
+TEST_CASE("MolJSON benchmark", "[.][benchmark]") {
+  auto nciMols = readNCIMols();
+  // make the data set large enough to be timed
+  std::vector<const ROMol *> mols;
+  for (unsigned int i = 0; i < 50; ++i) {
+    for (const auto &mol : nciMols) {
+      mols.push_back(mol.get());
+    }
+  }
+  auto report = [&mols](const std::string &label, const auto &t1) {
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "TIMING : " << label << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << mols.size() << " molecules"
+              << std::endl;
+  };
+
+  std::vector<std::string> jsons;
+  {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    for (const auto mol : mols) {
+      jsons.push_back(MolInterchange::MolToJSONData(*mol));
+    }
+    report("MolToJSONData", t1);
+  }
+  {
+    auto t1 = std::chrono::high_resolution_clock::now();
+    size_t nRead = 0;
+    for (const auto &json : jsons) {
+      nRead += MolInterchange::JSONDataToMols(json).size();
+    }
+    report("JSONDataToMols, one molecule at a time", t1);
+    CHECK(nRead == mols.size());
+  }
+  for (auto numThreads : {1, 4}) {
+    MolInterchange::JSONWriteParameters wps;
+    wps.numThreads = numThreads;
+    std::string json;
+    {
+      auto t1 = std::chrono::high_resolution_clock::now();
+      MolInterchange::appendMolsToJSONData(mols, json, wps);
+      report("appendMolsToJSONData, " + std::to_string(numThreads) +
+                 " threads",
+             t1);
+    }
+    {
+      MolInterchange::JSONParseParameters ps;
+      ps.numThreads = numThreads;
+      auto t1 = std::chrono::high_resolution_clock::now();
+      auto newMols = MolInterchange::JSONDataToMols(json, ps);
+      report("JSONDataToMols, " + std::to_string(numThreads) + " threads",
+             t1);
+      CHECK(newMols.size() == mols.size());
+    }
+  }
+}
@@ -23,6 +23,7 @@
 #include <map>
 #include <iostream>
 #include <cstdint>
+#include <tuple>
 #include <boost/algorithm/string.hpp>
 
 #ifdef RDK_BUILD_THREADSAFE_SSS
@@ -35,7 +36,7 @@ using std::uint32_t;
 namespace RDKit {
 
 const int32_t MolPickler::versionMajor = 16;
-const int32_t MolPickler::versionMinor = 1;
+const int32_t MolPickler::versionMinor = 2;
 const int32_t MolPickler::versionPatch = 0;
 const int32_t MolPickler::endianId = 0xDEADBEEF;
 
@@ -868,6 +869,124 @@ AtomMonomerInfo *unpickleAtomMonomerInfo(std::istream &ss, int version) {
   return res;
 }
 
+// monomer info stored in the molecule's PDBResidueTable is pickled in a single
+// block after the atoms
+bool hasPerAtomMonomerInfo(const Atom *atom) {
+  const auto info = atom->getMonomerInfo();
+  return info && !info->isOwnedByResidueTable();
+}
+
+// The residues are written once and each atom refers to its residue by index.
+void picklePDBResidueTable(std::ostream &ss, const ROMol &mol) {
+  // the string members are interned, so residues can be compared by pointer
+  using ResidueKey = std::tuple<const std::string *, int, const std::string *,
+                                const std::string *>;
+  std::map<ResidueKey, int32_t> residueIdx;
+  std::vector<const AtomPDBResidueInfo *> residues;
+  std::stringstream rows(std::ios_base::binary | std::ios_base::out |
+                         std::ios_base::in);
+  int32_t numRows = 0;
+  for (const auto atom : mol.atoms()) {
+    const auto info = atom->getMonomerInfo();
+    if (!info || !info->isOwnedByResidueTable()) {
+      continue;
+    }
+    const auto pdbInfo = static_cast<const AtomPDBResidueInfo *>(info);
+    ResidueKey key{&pdbInfo->getResidueName(), pdbInfo->getResidueNumber(),
+                   &pdbInfo->getChainId(), &pdbInfo->getInsertionCode()};
+    auto res =
+        residueIdx.emplace(key, static_cast<int32_t>(residues.size()));
+    if (res.second) {
+      residues.push_back(pdbInfo);
+    }
+    streamWrite(rows, static_cast<int32_t>(atom->getIdx()));
+    streamWrite(rows, res.first->second);
+    streamWrite(rows, pdbInfo->getName());
+    streamWrite(rows, static_cast<int32_t>(pdbInfo->getSerialNumber()));
+    streamWrite(rows, pdbInfo->getAltLoc());
+    streamWrite(rows, pdbInfo->getOccupancy());
+    streamWrite(rows, pdbInfo->getTempFactor());
+    streamWrite(rows, static_cast<char>(pdbInfo->getIsHeteroAtom()));
+    streamWrite(rows,
+                static_cast<uint32_t>(pdbInfo->getSecondaryStructure()));
+    streamWrite(rows, static_cast<uint32_t>(pdbInfo->getSegmentNumber()));
+    ++numRows;
+  }
+
+  streamWrite(ss, static_cast<int32_t>(residues.size()));
+  for (const auto residue : residues) {
+    streamWrite(ss, residue->getResidueName());
+    streamWrite(ss, static_cast<int32_t>(residue->getResidueNumber()));
+    streamWrite(ss, residue->getChainId());
+    streamWrite(ss, residue->getInsertionCode());
+  }
+  streamWrite(ss, numRows);
+  auto tmp = rows.str();
+  ss.write(tmp.c_str(), tmp.size());
+}
+
+std::unique_ptr<PDBResidueTable> unpicklePDBResidueTable(
+    std::istream &ss, int version, unsigned int atomOffset) {
+  int32_t tmpInt;
+  std::string tmpStr;
+  streamRead(ss, tmpInt, version);
+  if (tmpInt < 0) {
+    throw MolPicklerException("Bad pickle format: bad PDB residue count.");
+  }
+  std::vector<AtomPDBResidueInfo> residues(tmpInt);
+  for (auto &residue : residues) {
+    streamRead(ss, tmpStr, version);
+    residue.setResidueName(tmpStr);
+    streamRead(ss, tmpInt, version);
+    residue.setResidueNumber(tmpInt);
+    streamRead(ss, tmpStr, version);
+    residue.setChainId(tmpStr);
+    streamRead(ss, tmpStr, version);
+    residue.setInsertionCode(tmpStr);
+  }
+
+  int32_t numRows;
+  streamRead(ss, numRows, version);
+  std::vector<unsigned int> atomIndices;
+  atomIndices.reserve(numRows);
+  std::vector<AtomPDBResidueInfo> atomInfo;
+  atomInfo.reserve(numRows);
+  for (int32_t i = 0; i < numRows; ++i) {
+    int32_t atomIdx, residueIdx;
+    streamRead(ss, atomIdx, version);
+    streamRead(ss, residueIdx, version);
+    if (atomIdx < 0 || residueIdx < 0 ||
+        residueIdx >= static_cast<int32_t>(residues.size())) {
+      throw MolPicklerException(
+          "Bad pickle format: bad index in PDB residue table.");
+    }
+    atomIndices.push_back(atomOffset + atomIdx);
+    atomInfo.push_back(residues[residueIdx]);
+    auto &info = atomInfo.back();
+    streamRead(ss, tmpStr, version);
+    info.setName(tmpStr);
+    streamRead(ss, tmpInt, version);
+    info.setSerialNumber(tmpInt);
+    streamRead(ss, tmpStr, version);
+    info.setAltLoc(tmpStr);
+    double tmpDouble;
+    streamRead(ss, tmpDouble, version);
+    info.setOccupancy(tmpDouble);
+    streamRead(ss, tmpDouble, version);
+    info.setTempFactor(tmpDouble);
+    char tmpChar;
+    streamRead(ss, tmpChar, version);
+    info.setIsHeteroAtom(tmpChar);
+    uint32_t tmpUint;
+    streamRead(ss, tmpUint, version);
+    info.setSecondaryStructure(tmpUint);
+    streamRead(ss, tmpUint, version);
+    info.setSegmentNumber(tmpUint);
+  }
+  return std::unique_ptr<PDBResidueTable>(
+      new PDBResidueTable(std::move(atomIndices), std::move(atomInfo)));
+}
+
 }  // namespace
 
 // Resets the `exceptionState` of the passed stream `ss` in the destructor to
@@ -1212,6 +1331,14 @@ void MolPickler::_pickle(const ROMol *mol, std::ostream &ss,
       streamWrite(ss, ENDPROPS);
     }
   }
+
+  if (mol->getPDBResidueTable()) {
+    std::stringstream tss;
+    picklePDBResidueTable(tss, *mol);
+    streamWrite(ss, BEGINPDBRESIDUETABLE);
+    write_sstream_to_stream(ss, tss);
+    streamWrite(ss, ENDPROPS);
+  }
   streamWrite(ss, ENDMOL);
 }
 
@@ -1220,6 +1347,7 @@ void MolPickler::_depickle(std::istream &ss, ROMol *mol, int version,
                            int numAtoms, unsigned int propertyFlags) {
   PRECONDITION(mol, "empty molecule");
   bool directMap = mol->getNumAtoms() == 0;
+  unsigned int atomOffset = mol->getNumAtoms();
   Tags tag;
   int32_t tmpInt;
   // int numAtoms,numBonds;
@@ -1419,6 +1547,18 @@ void MolPickler::_depickle(std::istream &ss, ROMol *mol, int version,
         _unpickleAtomData(ss, atom, version);
       }
       streamRead(ss, tag, version);
+    } else if (tag == BEGINPDBRESIDUETABLE) {
+      int32_t blkSize = 0;
+      streamRead(ss, blkSize, version);
+      auto table = unpicklePDBResidueTable(ss, version, atomOffset);
+      for (unsigned int i = 0; i < table->getNumAtoms(); ++i) {
+        if (table->getAtomIndex(i) >= mol->getNumAtoms()) {
+          throw MolPicklerException(
+              "Bad pickle format: bad atom index in PDB residue table.");
+        }
+      }
+      mol->setPDBResidueTable(std::move(table));
+      streamRead(ss, tag, version);
     } else {
       break;  // break to tag != ENDMOL
     }
@@ -1626,7 +1766,7 @@ void MolPickler::_pickleAtom(std::ostream &ss, const Atom *atom) {
   if (atom->hasProp(common_properties::dummyLabel)) {
     flags |= 0x1 << 2;
   }
-  if (atom->getMonomerInfo()) {
+  if (hasPerAtomMonomerInfo(atom)) {
     flags |= 0x1 << 1;
   }
 
@@ -1656,7 +1796,7 @@ void MolPickler::_pickleAtom(std::ostream &ss, const Atom *atom) {
     streamWrite(ss, ATOM_DUMMYLABEL,
                 atom->getProp<std::string>(common_properties::dummyLabel));
   }
-  if (atom->getMonomerInfo()) {
+  if (hasPerAtomMonomerInfo(atom)) {
     streamWrite(ss, BEGIN_ATOM_MONOMER);
     pickleAtomMonomerInfo(ss, atom->getMonomerInfo());
     streamWrite(ss, END_ATOM_MONOMER);
@@ -146,6 +146,7 @@ class RDKIT_GRAPHMOL_EXPORT MolPickler {
     BEGINSYMMSSSR,
     BEGINFASTFIND,
     BEGINFINDOTHERORUNKNOWN,
+    BEGINPDBRESIDUETABLE,
     // add new entries above here
     INVALID_TAG = 255
   } Tags;
@@ -48,6 +48,7 @@ Reionizer::Reionizer() {
       &(param_filename_flyweight(defaultCleanupParameters.acidbaseFile).get());
   this->d_abcat = new AcidBaseCatalog(abparams);
   this->d_ccs = CHARGE_CORRECTIONS;
+  initChargeCorrectionMatchers();
 }
 
 Reionizer::Reionizer(const std::string acidbaseFile) {
@@ -55,6 +56,7 @@ Reionizer::Reionizer(const std::string acidbaseFile) {
       &(param_filename_flyweight(acidbaseFile).get());
   this->d_abcat = new AcidBaseCatalog(abparams);
   this->d_ccs = CHARGE_CORRECTIONS;
+  initChargeCorrectionMatchers();
 }
 
 Reionizer::Reionizer(
@@ -63,6 +65,7 @@ Reionizer::Reionizer(
   const AcidBaseCatalogParams *abparams = &(param_data_flyweight(data).get());
   this->d_abcat = new AcidBaseCatalog(abparams);
   this->d_ccs = CHARGE_CORRECTIONS;
+  initChargeCorrectionMatchers();
 }
 
 Reionizer::Reionizer(
@@ -71,6 +74,7 @@ Reionizer::Reionizer(
   const AcidBaseCatalogParams *abparams = &(param_data_flyweight(data).get());
   this->d_abcat = new AcidBaseCatalog(abparams);
   this->d_ccs = ccs;
+  initChargeCorrectionMatchers();
 }
 
 Reionizer::Reionizer(const std::string acidbaseFile,
@@ -79,6 +83,7 @@ Reionizer::Reionizer(const std::string acidbaseFile,
       &(param_filename_flyweight(acidbaseFile).get());
   this->d_abcat = new AcidBaseCatalog(abparams);
   this->d_ccs = ccs;
+  initChargeCorrectionMatchers();
 }
 
 Reionizer::Reionizer(std::istream &acidbaseStream,
@@ -86,10 +91,19 @@ Reionizer::Reionizer(std::istream &acidbaseStream,
   AcidBaseCatalogParams abparams(acidbaseStream);
   this->d_abcat = new AcidBaseCatalog(&abparams);
   this->d_ccs = ccs;
+  initChargeCorrectionMatchers();
 }
 
 Reionizer::~Reionizer() { delete d_abcat; }
 
+void Reionizer::initChargeCorrectionMatchers() {
+  d_ccMatchers.clear();
+  d_ccMatchers.reserve(d_ccs.size());
+  for (const auto &cc : d_ccs) {
+    d_ccMatchers.emplace_back(SmartsToMol(cc.Smarts));
+  }
+}
+
 // Reionizer::Reionizer(const AcidBaseCatalog *abcat, const
 // std::vector<ChargeCorrection> ccs = CHARGE_CORRECTIONS) 	:
 // d_abcat(abcat),
@@ -114,10 +128,10 @@ void Reionizer::reionizeInPlace(RWMol &mol) {
   }
   int start_charge = MolOps::getFormalCharge(mol);
 
-  for (const auto &cc : this->d_ccs) {
+  for (size_t i = 0; i < this->d_ccs.size(); ++i) {
+    const auto &cc = this->d_ccs[i];
     std::vector<MatchVectType> res;
-    ROMOL_SPTR ccmol(SmartsToMol(cc.Smarts));
-    unsigned int matches = SubstructMatch(mol, *ccmol, res);
+    unsigned int matches = SubstructMatch(mol, *d_ccMatchers[i], res);
     if (matches) {
       for (const auto &match : res) {
         for (const auto &pair : match) {
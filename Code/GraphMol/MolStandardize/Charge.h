@@ -92,6 +92,10 @@ class RDKIT_MOLSTANDARDIZE_EXPORT Reionizer {
  private:
   AcidBaseCatalog *d_abcat;
   std::vector<ChargeCorrection> d_ccs;
+  // the parsed SMARTS of the charge corrections, in the same order as d_ccs
+  std::vector<ROMOL_SPTR> d_ccMatchers;
+
+  void initChargeCorrectionMatchers();
 
   std::pair<unsigned int, std::vector<unsigned int>> *strongestProtonated(
       const ROMol &mol,
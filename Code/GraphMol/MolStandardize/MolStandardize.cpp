@@ -18,14 +18,11 @@
 #include <GraphMol/MolOps.h>
 #include <GraphMol/MolStandardize/TransformCatalog/TransformCatalogParams.h>
 #include "Charge.h"
+#include "StandardizationPipeline.h"
 #include <GraphMol/SmilesParse/SmilesWrite.h>
 #include <GraphMol/SmilesParse/SmilesParse.h>
 #include <RDGeneral/RDThreads.h>
 
-#ifdef RDK_BUILD_THREADSAFE_SSS
-#include <thread>
-#endif
-
 #include <RDGeneral/BoostStartInclude.h>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/json_parser.hpp>
@@ -131,31 +128,8 @@ template <typename FuncType>
 void standardizeMultipleMolsInPlace(FuncType sfunc, std::vector<RWMol *> &mols,
                                     int numThreads,
                                     const CleanupParameters &params) {
-  unsigned int numThreadsToUse = std::min(
-      static_cast<unsigned int>(mols.size()), getNumThreadsToUse(numThreads));
-  if (numThreadsToUse == 1) {
-    for (auto molp : mols) {
-      sfunc(*molp, params);
-    }
-  }
-#ifdef RDK_BUILD_THREADSAFE_SSS
-  else {
-    auto func = [&](unsigned int tidx) {
-      for (auto mi = tidx; mi < mols.size(); mi += numThreads) {
-        sfunc(*mols[mi], params);
-      }
-    };
-    std::vector<std::thread> threads;
-    for (auto tidx = 0u; tidx < numThreadsToUse; ++tidx) {
-      threads.emplace_back(func, tidx);
-    }
-    for (auto &t : threads) {
-      if (t.joinable()) {
-        t.join();
-      }
-    }
-  }
-#endif
+  runOnIndices([&](size_t mi) { sfunc(*mols[mi], params); }, mols.size(),
+               numThreads);
 }
 }  // namespace
 
@@ -177,9 +151,8 @@ void cleanupInPlace(RWMol &mol, const CleanupParameters &params) {
 
 void cleanupInPlace(std::vector<RWMol *> &mols, int numThreads,
                     const CleanupParameters &params) {
-  standardizeMultipleMolsInPlace(
-      static_cast<void (*)(RWMol &, const CleanupParameters &)>(cleanupInPlace),
-      mols, numThreads, params);
+  StandardizationPipeline pipeline(params);
+  pipeline.run(mols, StandardizationStep::Cleanup, numThreads);
 }
 
 void tautomerParentInPlace(RWMol &mol, const CleanupParameters &params,
@@ -195,10 +168,9 @@ void tautomerParentInPlace(RWMol &mol, const CleanupParameters &params,
 void tautomerParentInPlace(std::vector<RWMol *> &mols, int numThreads,
                            const CleanupParameters &params,
                            bool skip_standardize) {
-  auto sfunc = [skip_standardize](RWMol &m, const CleanupParameters &ps) {
-    tautomerParentInPlace(m, ps, skip_standardize);
-  };
-  standardizeMultipleMolsInPlace(sfunc, mols, numThreads, params);
+  StandardizationPipeline pipeline(params);
+  pipeline.run(mols, StandardizationStep::TautomerParent, numThreads,
+               skip_standardize);
 }
 
 RWMol *tautomerParent(const RWMol &mol, const CleanupParameters &params,
@@ -211,10 +183,9 @@ RWMol *tautomerParent(const RWMol &mol, const CleanupParameters &params,
 void fragmentParentInPlace(std::vector<RWMol *> &mols, int numThreads,
                            const CleanupParameters &params,
                            bool skip_standardize) {
-  auto sfunc = [skip_standardize](RWMol &m, const CleanupParameters &ps) {
-    fragmentParentInPlace(m, ps, skip_standardize);
-  };
-  standardizeMultipleMolsInPlace(sfunc, mols, numThreads, params);
+  StandardizationPipeline pipeline(params);
+  pipeline.run(mols, StandardizationStep::FragmentParent, numThreads,
+               skip_standardize);
 }
 void fragmentParentInPlace(RWMol &mol, const CleanupParameters &params,
                            bool skip_standardize) {
@@ -238,10 +209,9 @@ RWMol *fragmentParent(const RWMol &mol, const CleanupParameters &params,
 void stereoParentInPlace(std::vector<RWMol *> &mols, int numThreads,
                          const CleanupParameters &params,
                          bool skip_standardize) {
-  auto sfunc = [skip_standardize](RWMol &m, const CleanupParameters &ps) {
-    stereoParentInPlace(m, ps, skip_standardize);
-  };
-  standardizeMultipleMolsInPlace(sfunc, mols, numThreads, params);
+  StandardizationPipeline pipeline(params);
+  pipeline.run(mols, StandardizationStep::StereoParent, numThreads,
+               skip_standardize);
 }
 void stereoParentInPlace(RWMol &mol, const CleanupParameters &params,
                          bool skip_standardize) {
@@ -260,10 +230,9 @@ RWMol *stereoParent(const RWMol &mol, const CleanupParameters &params,
 void isotopeParentInPlace(std::vector<RWMol *> &mols, int numThreads,
                           const CleanupParameters &params,
                           bool skip_standardize) {
-  auto sfunc = [skip_standardize](RWMol &m, const CleanupParameters &ps) {
-    isotopeParentInPlace(m, ps, skip_standardize);
-  };
-  standardizeMultipleMolsInPlace(sfunc, mols, numThreads, params);
+  StandardizationPipeline pipeline(params);
+  pipeline.run(mols, StandardizationStep::IsotopeParent, numThreads,
+               skip_standardize);
 }
 
 void isotopeParentInPlace(RWMol &mol, const CleanupParameters &params,
@@ -286,10 +255,9 @@ RWMol *isotopeParent(const RWMol &mol, const CleanupParameters &params,
 void chargeParentInPlace(std::vector<RWMol *> &mols, int numThreads,
                          const CleanupParameters &params,
                          bool skip_standardize) {
-  auto sfunc = [skip_standardize](RWMol &m, const CleanupParameters &ps) {
-    chargeParentInPlace(m, ps, skip_standardize);
-  };
-  standardizeMultipleMolsInPlace(sfunc, mols, numThreads, params);
+  StandardizationPipeline pipeline(params);
+  pipeline.run(mols, StandardizationStep::ChargeParent, numThreads,
+               skip_standardize);
 }
 void chargeParentInPlace(RWMol &mol, const CleanupParameters &params,
                          bool skip_standardize) {
@@ -323,10 +291,9 @@ void superParentInPlace(RWMol &mol, const CleanupParameters &params,
 void superParentInPlace(std::vector<RWMol *> &mols, int numThreads,
                         const CleanupParameters &params,
                         bool skip_standardize) {
-  auto sfunc = [skip_standardize](RWMol &m, const CleanupParameters &ps) {
-    superParentInPlace(m, ps, skip_standardize);
-  };
-  standardizeMultipleMolsInPlace(sfunc, mols, numThreads, params);
+  StandardizationPipeline pipeline(params);
+  pipeline.run(mols, StandardizationStep::SuperParent, numThreads,
+               skip_standardize);
 }
 
 RWMol *superParent(const RWMol &mol, const CleanupParameters &params,
@@ -15,6 +15,7 @@
 #include <GraphMol/SmilesParse/SmilesWrite.h>
 #include <GraphMol/SanitException.h>
 #include <GraphMol/ChemTransforms/ChemTransforms.h>
+#include <GraphMol/QueryOps.h>
 #include <RDGeneral/BoostStartInclude.h>
 #include <boost/flyweight.hpp>
 #include <boost/flyweight/key_value.hpp>
@@ -43,6 +44,52 @@ typedef boost::flyweight<boost::flyweights::key_value<
 
 // unsigned int MAX_RESTARTS = 200;
 
+namespace {
+// returns the atomic number a query atom is restricted to, or -1 if it can
+// match more than one element
+int getRequiredAtomicNum(const Atom::QUERYATOM_QUERY *query) {
+  if (!query || query->getNegation()) {
+    return -1;
+  }
+  const auto &descr = query->getDescription();
+  if (descr == "AtomAtomicNum" || descr == "AtomType") {
+    const auto eqQuery = dynamic_cast<const ATOM_EQUALS_QUERY *>(query);
+    if (!eqQuery) {
+      return -1;
+    }
+    if (descr == "AtomAtomicNum") {
+      return eqQuery->getVal();
+    }
+    int atomicNum;
+    bool aromatic;
+    parseAtomType(eqQuery->getVal(), atomicNum, aromatic);
+    return atomicNum;
+  }
+  if (descr == "AtomAnd") {
+    for (const auto &child : boost::make_iterator_range(
+             query->beginChildren(), query->endChildren())) {
+      auto res = getRequiredAtomicNum(child.get());
+      if (res >= 0) {
+        return res;
+      }
+    }
+  }
+  return -1;
+}
+
+std::vector<unsigned int> getElementCounts(const ROMol &mol) {
+  std::vector<unsigned int> res;
+  for (const auto atom : mol.atoms()) {
+    auto atomicNum = atom->getAtomicNum();
+    if (atomicNum >= static_cast<int>(res.size())) {
+      res.resize(atomicNum + 1, 0);
+    }
+    ++res[atomicNum];
+  }
+  return res;
+}
+}  // namespace
+
 // constructor
 Normalizer::Normalizer() {
   BOOST_LOG(rdInfoLog) << "Initializing Normalizer\n";
@@ -52,6 +99,7 @@ Normalizer::Normalizer() {
   this->MAX_RESTARTS = 200;
 
   this->d_tcat->getCatalogParams()->initializeTransforms();
+  initRequiredElements();
 }
 
 // overloaded constructor
@@ -64,6 +112,7 @@ Normalizer::Normalizer(const std::string normalizeFile,
   this->MAX_RESTARTS = maxRestarts;
 
   this->d_tcat->getCatalogParams()->initializeTransforms();
+  initRequiredElements();
 }
 
 // overloaded constructor
@@ -75,6 +124,7 @@ Normalizer::Normalizer(std::istream &normalizeStream,
   this->MAX_RESTARTS = maxRestarts;
 
   this->d_tcat->getCatalogParams()->initializeTransforms();
+  initRequiredElements();
 }
 
 // overloaded constructor
@@ -88,11 +138,48 @@ Normalizer::Normalizer(
   this->MAX_RESTARTS = maxRestarts;
 
   this->d_tcat->getCatalogParams()->initializeTransforms();
+  initRequiredElements();
 }
 
 // destructor
 Normalizer::~Normalizer() { delete d_tcat; }
 
+void Normalizer::initRequiredElements() {
+  const auto &transforms = d_tcat->getCatalogParams()->getTransformations();
+  d_requiredElements.clear();
+  d_requiredElements.resize(transforms.size());
+  for (size_t i = 0; i < transforms.size(); ++i) {
+    if (!transforms[i] || transforms[i]->getNumReactantTemplates() != 1) {
+      continue;
+    }
+    std::map<int, unsigned int> counts;
+    for (const auto atom : transforms[i]->getReactants()[0]->atoms()) {
+      if (!atom->hasQuery()) {
+        continue;
+      }
+      auto atomicNum = getRequiredAtomicNum(atom->getQuery());
+      if (atomicNum >= 0) {
+        ++counts[atomicNum];
+      }
+    }
+    d_requiredElements[i].assign(counts.begin(), counts.end());
+  }
+}
+
+bool Normalizer::passesElementScreen(
+    size_t transformIdx, const std::vector<unsigned int> &elementCounts) const {
+  if (transformIdx >= d_requiredElements.size()) {
+    return true;
+  }
+  for (const auto &[atomicNum, count] : d_requiredElements[transformIdx]) {
+    if (atomicNum >= static_cast<int>(elementCounts.size()) ||
+        elementCounts[atomicNum] < count) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void Normalizer::normalizeInPlace(RWMol &mol) {
   BOOST_LOG(rdInfoLog) << "Running Normalizer\n";
   PRECONDITION(this->d_tcat, "");
@@ -123,8 +210,13 @@ void Normalizer::normalizeInPlace(RWMol &mol) {
   }
   for (unsigned int i = 0; i < MAX_RESTARTS; ++i) {
     bool loop_break = false;
+    const auto elementCounts = getElementCounts(mol);
     // Iterate through Normalization transforms and apply each in order
-    for (auto &transform : transforms) {
+    for (size_t ti = 0; ti < transforms.size(); ++ti) {
+      if (!passesElementScreen(ti, elementCounts)) {
+        continue;
+      }
+      const auto &transform = transforms[ti];
       constexpr bool removeUnmatchedAtoms = false;
       if (transform->runReactant(mol, removeUnmatchedAtoms)) {
         BOOST_LOG(rdInfoLog)
@@ -193,8 +285,13 @@ ROMOL_SPTR Normalizer::normalizeFragment(
   std::set<std::string> seenProductSmiles;
   for (unsigned int i = 0; i < MAX_RESTARTS; ++i) {
     bool loop_break = false;
+    const auto elementCounts = getElementCounts(*nfrag);
     // Iterate through Normalization transforms and apply each in order
-    for (auto &transform : transforms) {
+    for (size_t ti = 0; ti < transforms.size(); ++ti) {
+      if (!passesElementScreen(ti, elementCounts)) {
+        continue;
+      }
+      const auto &transform = transforms[ti];
       SmilesMolPair product = applyTransform(nfrag, *transform);
       if (!product.first.empty() && !seenProductSmiles.count(product.first)) {
         seenProductSmiles.insert(product.first);
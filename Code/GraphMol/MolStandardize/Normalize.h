@@ -82,7 +82,13 @@ class RDKIT_MOLSTANDARDIZE_EXPORT Normalizer {
  private:
   const TransformCatalog *d_tcat;
   unsigned int MAX_RESTARTS;
+  // for each transform, the (atomic number, count) pairs its reactant
+  // template requires. Used to skip transforms which cannot match.
+  std::vector<std::vector<std::pair<int, unsigned int>>> d_requiredElements;
 
+  void initRequiredElements();
+  bool passesElementScreen(size_t transformIdx,
+                           const std::vector<unsigned int> &elementCounts) const;
   ROMOL_SPTR normalizeFragment(
       const ROMol &mol,
       const std::vector<std::shared_ptr<ChemicalReaction>> &transforms) const;
@@ -0,0 +1,168 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "StandardizationPipeline.h"
+#include "Metal.h"
+#include "Normalize.h"
+#include "Charge.h"
+#include "Fragment.h"
+#include "Tautomer.h"
+#include <GraphMol/RDKitBase.h>
+#include <GraphMol/SmilesParse/SmilesParse.h>
+#include <GraphMol/SmilesParse/SmilesWrite.h>
+#include <RDGeneral/RDThreads.h>
+#include <RDGeneral/RDLog.h>
+
+namespace RDKit {
+namespace MolStandardize {
+
+StandardizationPipeline::StandardizationPipeline(
+    const CleanupParameters &params)
+    : d_params(params),
+      dp_metalDisconnector(new MetalDisconnector()),
+      dp_normalizer(normalizerFromParams(params)),
+      dp_reionizer(reionizerFromParams(params)),
+      dp_uncharger(new Uncharger(params.doCanonical)),
+      dp_fragmentChooser(new LargestFragmentChooser(params.preferOrganic)),
+      dp_tautomerEnumerator(tautomerEnumeratorFromParams(params)) {}
+
+StandardizationPipeline::~StandardizationPipeline() = default;
+
+void StandardizationPipeline::run(RWMol &mol, StandardizationStep step,
+                                  bool skipStandardize) const {
+  switch (step) {
+    case StandardizationStep::Cleanup:
+      cleanupInPlace(mol);
+      break;
+    case StandardizationStep::FragmentParent:
+      fragmentParentInPlace(mol, skipStandardize);
+      break;
+    case StandardizationStep::ChargeParent:
+      chargeParentInPlace(mol, skipStandardize);
+      break;
+    case StandardizationStep::IsotopeParent:
+      isotopeParentInPlace(mol, skipStandardize);
+      break;
+    case StandardizationStep::StereoParent:
+      stereoParentInPlace(mol, skipStandardize);
+      break;
+    case StandardizationStep::TautomerParent:
+      tautomerParentInPlace(mol, skipStandardize);
+      break;
+    case StandardizationStep::SuperParent:
+      superParentInPlace(mol, skipStandardize);
+      break;
+    default:
+      throw ValueErrorException("unrecognized standardization step");
+  }
+}
+
+void StandardizationPipeline::run(std::vector<RWMol *> &mols,
+                                  StandardizationStep step, int numThreads,
+                                  bool skipStandardize) const {
+  auto func = [&](size_t i) {
+    if (mols[i]) {
+      run(*mols[i], step, skipStandardize);
+    }
+  };
+  runOnIndices(func, mols.size(), numThreads);
+}
+
+std::vector<std::string> StandardizationPipeline::standardizeSmiles(
+    const std::vector<std::string> &smiles, int numThreads) const {
+  std::vector<std::string> res(smiles.size());
+  auto func = [&](size_t i) {
+    // failures leave an empty string in the results; we can't let the
+    // exception escape from a worker thread
+    try {
+      std::unique_ptr<RWMol> mol(SmilesToMol(smiles[i], 0, false));
+      if (!mol) {
+        return;
+      }
+      cleanupInPlace(*mol);
+      res[i] = MolToSmiles(*mol);
+    } catch (const std::exception &e) {
+      BOOST_LOG(rdWarningLog) << "standardizeSmiles failed for " << smiles[i]
+                              << ": " << e.what() << std::endl;
+    }
+  };
+  runOnIndices(func, smiles.size(), numThreads);
+  return res;
+}
+
+// The operations below do exactly what the free functions of the same name
+// in MolStandardize.cpp do, using the pipeline's standardizers
+
+void StandardizationPipeline::cleanupInPlace(RWMol &mol) const {
+  MolOps::removeHs(mol);
+  dp_metalDisconnector->disconnectInPlace(mol);
+  dp_normalizer->normalizeInPlace(mol);
+  dp_reionizer->reionizeInPlace(mol);
+  bool cleanIt = true;
+  bool force = true;
+  MolOps::assignStereochemistry(mol, cleanIt, force);
+}
+
+void StandardizationPipeline::fragmentParentInPlace(
+    RWMol &mol, bool skipStandardize) const {
+  if (!skipStandardize) {
+    cleanupInPlace(mol);
+  }
+  dp_fragmentChooser->chooseInPlace(mol);
+}
+
+void StandardizationPipeline::chargeParentInPlace(RWMol &mol,
+                                                  bool skipStandardize) const {
+  fragmentParentInPlace(mol, skipStandardize);
+  dp_uncharger->unchargeInPlace(mol);
+  cleanupInPlace(mol);
+}
+
+void StandardizationPipeline::isotopeParentInPlace(
+    RWMol &mol, bool skipStandardize) const {
+  if (!skipStandardize) {
+    cleanupInPlace(mol);
+  }
+  for (auto atom : mol.atoms()) {
+    atom->setIsotope(0);
+  }
+}
+
+void StandardizationPipeline::stereoParentInPlace(RWMol &mol,
+                                                  bool skipStandardize) const {
+  if (!skipStandardize) {
+    cleanupInPlace(mol);
+  }
+  MolOps::removeStereochemistry(mol);
+}
+
+void StandardizationPipeline::tautomerParentInPlace(
+    RWMol &mol, bool skipStandardize) const {
+  if (!skipStandardize) {
+    cleanupInPlace(mol);
+  }
+  dp_tautomerEnumerator->canonicalizeInPlace(mol);
+  cleanupInPlace(mol);
+}
+
+void StandardizationPipeline::superParentInPlace(RWMol &mol,
+                                                 bool skipStandardize) const {
+  if (!skipStandardize) {
+    cleanupInPlace(mol);
+  }
+  // we can skip fragmentParent since the chargeParent takes care of that
+  chargeParentInPlace(mol, true);
+  isotopeParentInPlace(mol, true);
+  stereoParentInPlace(mol, true);
+  tautomerParentInPlace(mol, true);
+  cleanupInPlace(mol);
+}
+
+}  // namespace MolStandardize
+}  // namespace RDKit
@@ -0,0 +1,122 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+/*! \file StandardizationPipeline.h
+
+        \brief Defines the StandardizationPipeline class.
+
+*/
+#include <RDGeneral/export.h>
+#ifndef RD_STANDARDIZATIONPIPELINE_H
+#define RD_STANDARDIZATIONPIPELINE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <GraphMol/MolStandardize/MolStandardize.h>
+
+namespace RDKit {
+class RWMol;
+
+namespace MolStandardize {
+class MetalDisconnector;
+class Normalizer;
+class Reionizer;
+class Uncharger;
+class LargestFragmentChooser;
+class TautomerEnumerator;
+
+//! The operations a StandardizationPipeline can apply; each one corresponds
+//! to the function with the same name in MolStandardize.h
+enum class StandardizationStep {
+  Cleanup,
+  FragmentParent,
+  ChargeParent,
+  IsotopeParent,
+  StereoParent,
+  TautomerParent,
+  SuperParent
+};
+
+//! Applies the standardization operations to many molecules
+/*!
+
+  <b>Notes:</b>
+    - The free functions in MolStandardize.h construct a new
+  MetalDisconnector, Normalizer, Reionizer, Uncharger and TautomerEnumerator
+  each time they are called, and cleanup() is called several times while
+  generating the parent molecules. The pipeline sets all of these up once,
+  when it is constructed, and shares them between all molecules and threads.
+    - The results are the same as those of the corresponding functions in
+  MolStandardize.h called with the same CleanupParameters.
+*/
+class RDKIT_MOLSTANDARDIZE_EXPORT StandardizationPipeline {
+ public:
+  StandardizationPipeline(
+      const CleanupParameters &params = defaultCleanupParameters);
+  //! making StandardizationPipeline objects non-copyable
+  StandardizationPipeline(const StandardizationPipeline &other) = delete;
+  StandardizationPipeline &operator=(StandardizationPipeline const &) =
+      delete;
+  ~StandardizationPipeline();
+
+  //! applies \c step to a molecule, modifying it in place
+  /*!
+    \param mol             the molecule to standardize
+    \param step            the operation to apply
+    \param skipStandardize if true, the initial cleanup() done by the parent
+                           operations is skipped
+  */
+  void run(RWMol &mol, StandardizationStep step = StandardizationStep::Cleanup,
+           bool skipStandardize = false) const;
+  //! applies \c step to multiple molecules, modifying them in place
+  /*!
+    \param mols            the molecules to standardize
+    \param step            the operation to apply
+    \param numThreads      the number of threads to use, values <= 0 are
+                           interpreted as described for getNumThreadsToUse()
+    \param skipStandardize if true, the initial cleanup() done by the parent
+                           operations is skipped
+  */
+  void run(std::vector<RWMol *> &mols,
+           StandardizationStep step = StandardizationStep::Cleanup,
+           int numThreads = 1, bool skipStandardize = false) const;
+
+  //! returns standardized canonical SMILES for each of the input SMILES
+  /*!
+    This is equivalent to calling standardizeSmiles() on each of them.
+    SMILES which cannot be parsed or standardized result in an empty
+    string.
+  */
+  std::vector<std::string> standardizeSmiles(
+      const std::vector<std::string> &smiles, int numThreads = 1) const;
+
+  const CleanupParameters &getParams() const { return d_params; }
+
+ private:
+  void cleanupInPlace(RWMol &mol) const;
+  void fragmentParentInPlace(RWMol &mol, bool skipStandardize) const;
+  void chargeParentInPlace(RWMol &mol, bool skipStandardize) const;
+  void isotopeParentInPlace(RWMol &mol, bool skipStandardize) const;
+  void stereoParentInPlace(RWMol &mol, bool skipStandardize) const;
+  void tautomerParentInPlace(RWMol &mol, bool skipStandardize) const;
+  void superParentInPlace(RWMol &mol, bool skipStandardize) const;
+
+  CleanupParameters d_params;
+  std::unique_ptr<MetalDisconnector> dp_metalDisconnector;
+  std::unique_ptr<Normalizer> dp_normalizer;
+  std::unique_ptr<Reionizer> dp_reionizer;
+  std::unique_ptr<Uncharger> dp_uncharger;
+  std::unique_ptr<LargestFragmentChooser> dp_fragmentChooser;
+  std::unique_ptr<TautomerEnumerator> dp_tautomerEnumerator;
+};
+
+}  // namespace MolStandardize
+}  // namespace RDKit
+#endif
@@ -20,6 +20,8 @@
 #include <boost/flyweight.hpp>
 #include <boost/flyweight/key_value.hpp>
 #include <boost/flyweight/no_tracking.hpp>
+#include <boost/functional/hash.hpp>
+#include <unordered_map>
 #include <utility>
 
 // #define VERBOSE_ENUMERATION 1
@@ -147,6 +149,102 @@ int scoreHeteroHs(const ROMol &mol) {
 }
 }  // namespace TautomerScoringFunctions
 
+namespace {
+// The parts of a kekulized tautomer which feed into sanitization and SMILES
+// generation, packed into a vector of ints: for each atom the explicit H
+// count, noImplicit flag, formal charge, aromatic flag and chiral tag; for
+// each bond the bond type, aromatic flag, stereo and direction.
+// Two transform products with the same state are identical once sanitized,
+// which lets us recognize duplicates without building a new molecule.
+constexpr size_t atomStateSize = 5;
+constexpr size_t bondStateSize = 4;
+typedef std::vector<int> TautomerState;
+
+TautomerState getTautomerState(const ROMol &kmol) {
+  TautomerState state;
+  state.reserve(kmol.getNumAtoms() * atomStateSize +
+                kmol.getNumBonds() * bondStateSize);
+  for (const auto atom : kmol.atoms()) {
+    state.push_back(atom->getNumExplicitHs());
+    state.push_back(atom->getNoImplicit());
+    state.push_back(atom->getFormalCharge());
+    state.push_back(atom->getIsAromatic());
+    state.push_back(atom->getChiralTag());
+  }
+  for (const auto bond : kmol.bonds()) {
+    state.push_back(bond->getBondType());
+    state.push_back(bond->getIsAromatic());
+    state.push_back(bond->getStereo());
+    state.push_back(bond->getBondDir());
+  }
+  return state;
+}
+
+// Applies a transform match to the state of the kekulized parent tautomer,
+// doing to the state exactly what TautomerEnumerator::enumerate() does to
+// the product molecule. The bonds touched by the transform are flagged in
+// modifiedBonds. Returns false if the product state cannot be predicted.
+bool applyTransformToState(const ROMol &kmol,
+                           const TautomerTransform &transform,
+                           const MatchVectType &match, TautomerState &state,
+                           boost::dynamic_bitset<> &modifiedBonds) {
+  int firstIdx = match.front().second;
+  int lastIdx = match.back().second;
+  if (firstIdx == lastIdx) {
+    return false;
+  }
+  auto first = kmol.getAtomWithIdx(firstIdx);
+  auto last = kmol.getAtomWithIdx(lastIdx);
+  state[firstIdx * atomStateSize] =
+      std::max(0, static_cast<int>(first->getTotalNumHs()) - 1);
+  state[firstIdx * atomStateSize + 1] = true;
+  state[lastIdx * atomStateSize] = last->getTotalNumHs() + 1;
+  state[lastIdx * atomStateSize + 1] = true;
+
+  const auto bondOffset = kmol.getNumAtoms() * atomStateSize;
+  unsigned int bi = 0;
+  for (const auto tbond : transform.Mol->bonds()) {
+    const auto bond =
+        kmol.getBondBetweenAtoms(match[tbond->getBeginAtomIdx()].second,
+                                 match[tbond->getEndAtomIdx()].second);
+    if (!bond) {
+      return false;
+    }
+    auto &bondType = state[bondOffset + bond->getIdx() * bondStateSize];
+    if (!transform.BondTypes.empty()) {
+      bondType = transform.BondTypes[bi++];
+    } else if (bondType == Bond::SINGLE) {
+      bondType = Bond::DOUBLE;
+    } else if (bondType == Bond::DOUBLE) {
+      bondType = Bond::SINGLE;
+    }
+    modifiedBonds.set(bond->getIdx());
+  }
+  if (!transform.Charges.empty()) {
+    unsigned int ci = 0;
+    for (const auto &pair : match) {
+      state[pair.second * atomStateSize + 2] += transform.Charges[ci++];
+    }
+  }
+  return true;
+}
+
+// What we know about a product that has already been generated: whether it
+// could be sanitized, its SMILES and the number of modified atoms and bonds
+// at the time the SMILES was generated (these control the stereo cleanup in
+// setTautomerStereoAndIsoHs(), so the SMILES is only valid while they do not
+// change)
+struct SeenProduct {
+  bool sanitized;
+  std::string smiles;
+  size_t numModifiedAtoms;
+  size_t numModifiedBonds;
+};
+typedef std::unordered_map<TautomerState, SeenProduct,
+                           boost::hash<TautomerState>>
+    SeenProductMap;
+}  // namespace
+
 TautomerEnumerator::TautomerEnumerator(const CleanupParameters &params)
     : d_maxTautomers(params.maxTautomers),
       d_maxTransforms(params.maxTransforms),
@@ -296,6 +394,10 @@ TautomerEnumeratorResult TautomerEnumerator::enumerate(const ROMol &mol) const {
   bool completed = false;
   bool bailOut = false;
   unsigned int nTransforms = 0;
+  // transforms frequently regenerate products we have already seen (the
+  // reverse transform always leads back to the parent), keep track of them
+  // so that we don't sanitize them and generate their SMILES again
+  SeenProductMap seenProducts;
   static const std::array<const char *, 4> statusMsg{
       "completed", "max tautomers reached", "max transforms reached",
       "canceled"};
@@ -324,6 +426,8 @@ TautomerEnumeratorResult TautomerEnumerator::enumerate(const ROMol &mol) const {
                 << std::endl;
 #endif
       // tautomer not yet done
+      const auto kmolState =
+          getTautomerState(*smilesTautomerPair.second.kekulized);
       for (const auto &transform : transforms) {
         if (bailOut) {
           break;
@@ -364,6 +468,25 @@ TautomerEnumeratorResult TautomerEnumerator::enumerate(const ROMol &mol) const {
           if (bailOut) {
             break;
           }
+          // check whether we already know the outcome of this transform
+          auto productState = kmolState;
+          bool haveState = applyTransformToState(
+              *kmol, transform, match, productState, res.d_modifiedBonds);
+          if (haveState) {
+            res.d_modifiedAtoms.set(match.front().second);
+            res.d_modifiedAtoms.set(match.back().second);
+            const auto seenIt = seenProducts.find(productState);
+            if (seenIt != seenProducts.end()) {
+              const auto &seen = seenIt->second;
+              if (!seen.sanitized ||
+                  (seen.numModifiedAtoms == res.d_modifiedAtoms.count() &&
+                   seen.numModifiedBonds == res.d_modifiedBonds.count() &&
+                   res.d_tautomers.find(seen.smiles) !=
+                       res.d_tautomers.end())) {
+                continue;
+              }
+            }
+          }
           // Create a copy of in the input molecule so we can modify it
           // Use kekule form so bonds are explicitly single/double instead of
           // aromatic
@@ -444,6 +567,9 @@ TautomerEnumeratorResult TautomerEnumerator::enumerate(const ROMol &mol) const {
                                     MolOps::SANITIZE_SETHYBRIDIZATION |
                                     MolOps::SANITIZE_ADJUSTHS);
           } catch (const KekulizeException &) {
+            if (haveState) {
+              seenProducts[productState] = {false, "", 0, 0};
+            }
             continue;
           }
 #ifdef VERBOSE_ENUMERATION
@@ -454,6 +580,11 @@ TautomerEnumeratorResult TautomerEnumerator::enumerate(const ROMol &mol) const {
 #endif
           setTautomerStereoAndIsoHs(mol, *product, res);
           tsmiles = MolToSmiles(*product, true);
+          if (haveState) {
+            seenProducts[productState] = {true, tsmiles,
+                                          res.d_modifiedAtoms.count(),
+                                          res.d_modifiedBonds.count()};
+          }
 #ifdef VERBOSE_ENUMERATION
           (transform.Mol)->getProp(common_properties::_Name, name);
           std::cout << "Applied rule: " << name << " to "
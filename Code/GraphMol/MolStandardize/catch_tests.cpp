@@ -19,9 +19,13 @@
 #include <GraphMol/MolStandardize/Fragment.h>
 #include <GraphMol/MolStandardize/Charge.h>
 #include <GraphMol/MolStandardize/Tautomer.h>
+#include <GraphMol/MolStandardize/StandardizationPipeline.h>
+#include <GraphMol/test_fixtures.h>
 
 #include <iostream>
 #include <fstream>
+#include <chrono>
+#include <functional>
 
 using namespace RDKit;
 
@@ -1151,6 +1155,44 @@ TEST_CASE("Github 5784: kekulization error when enumerating tautomers") {
   }
 }
 
+TEST_CASE("tautomer enumeration with repeated products", "[tautomers]") {
+  // every tautomer can be reached from several others here, so most of the
+  // transform products are duplicates. The results must not depend on which
+  // tautomer we start from.
+  std::vector<std::pair<std::vector<std::string>, std::vector<std::string>>>
+      data{{{"Oc1nc(O)nc(O)n1", "O=c1[nH]c(=O)[nH]c(=O)[nH]1",
+             "O=c1nc(O)[nH]c(O)n1"},
+            {"O=c1[nH]c(=O)[nH]c(=O)[nH]1", "O=c1nc(O)[nH]c(=O)[nH]1",
+             "O=c1nc(O)[nH]c(O)n1", "O=c1nc(O)nc(O)[nH]1",
+             "Oc1nc(O)nc(O)n1"}},
+           {{"CC(=O)CC(C)=O", "CC(O)=CC(C)=O"},
+            {"C=C(O)C=C(C)O", "C=C(O)CC(=C)O", "C=C(O)CC(C)=O",
+             "CC(=O)C=C(C)O", "CC(=O)CC(C)=O"}},
+           {{"Oc1cc(O)cc(O)c1", "O=C1CC(=O)CC(=O)C1"},
+            {"O=C1C=C(O)C=C(O)C1", "O=C1C=C(O)CC(=O)C1",
+             "O=C1C=C(O)CC(O)=C1", "O=C1CC(=O)CC(=O)C1",
+             "Oc1cc(O)cc(O)c1"}}};
+  MolStandardize::TautomerEnumerator te;
+  for (const auto &[smis, expected] : data) {
+    std::string canonSmi;
+    for (const auto &smi : smis) {
+      INFO(smi);
+      std::unique_ptr<ROMol> m{SmilesToMol(smi)};
+      REQUIRE(m);
+      auto res = te.enumerate(*m);
+      CHECK(res.status() ==
+            MolStandardize::TautomerEnumeratorStatus::Completed);
+      CHECK(res.smiles() == expected);
+      std::unique_ptr<ROMol> canon{te.canonicalize(*m)};
+      REQUIRE(canon);
+      if (canonSmi.empty()) {
+        canonSmi = MolToSmiles(*canon);
+      }
+      CHECK(MolToSmiles(*canon) == canonSmi);
+    }
+  }
+}
+
 TEST_CASE("in place operations") {
   SECTION("reionizer") {
     MolStandardize::Reionizer reion;
@@ -1678,4 +1720,159 @@ TEST_CASE("superParent with multiple mols") {
     }
   }
 #endif
-}
\ No newline at end of file
+}
+
+TEST_CASE("StandardizationPipeline") {
+  auto smis = readChemblTestSmiles(40);
+  REQUIRE(smis.size() == 40);
+  // add some things which exercise the metal disconnector, reionizer,
+  // uncharger and isotope handling
+  smis.push_back("[O-]c1ccc(C(=O)O)cc1CC=CO.[Na+]");
+  smis.push_back("[O-]c1ccc(C(=O)O)cc1C[13CH]=CO");
+  smis.push_back("CCC(=O)O[Na]");
+  smis.push_back("C[N+](C)(C)CC(=O)[O-].Cl");
+  smis.push_back("C/C=C/C(O)=C(C)C");
+  REQUIRE(smis.size() == 45);
+  auto params = MolStandardize::defaultCleanupParameters;
+  MolStandardize::StandardizationPipeline pipeline(params);
+
+  using Step = MolStandardize::StandardizationStep;
+  std::vector<std::pair<Step, std::function<void(RWMol &, bool)>>> steps = {
+      {Step::Cleanup,
+       [&params](RWMol &m, bool) {
+         MolStandardize::cleanupInPlace(m, params);
+       }},
+      {Step::FragmentParent,
+       [&params](RWMol &m, bool skip) {
+         MolStandardize::fragmentParentInPlace(m, params, skip);
+       }},
+      {Step::ChargeParent,
+       [&params](RWMol &m, bool skip) {
+         MolStandardize::chargeParentInPlace(m, params, skip);
+       }},
+      {Step::IsotopeParent,
+       [&params](RWMol &m, bool skip) {
+         MolStandardize::isotopeParentInPlace(m, params, skip);
+       }},
+      {Step::StereoParent,
+       [&params](RWMol &m, bool skip) {
+         MolStandardize::stereoParentInPlace(m, params, skip);
+       }},
+      {Step::TautomerParent,
+       [&params](RWMol &m, bool skip) {
+         MolStandardize::tautomerParentInPlace(m, params, skip);
+       }},
+      {Step::SuperParent,
+       [&params](RWMol &m, bool skip) {
+         MolStandardize::superParentInPlace(m, params, skip);
+       }},
+  };
+  SECTION("matches the free functions") {
+    for (const auto &[step, func] : steps) {
+      for (auto skip : {false, true}) {
+        for (auto numThreads : {1, 4}) {
+          std::vector<std::unique_ptr<RWMol>> mols;
+          std::vector<RWMol *> molPtrs;
+          std::vector<std::string> expected;
+          for (const auto &smi : smis) {
+            std::unique_ptr<RWMol> ref(SmilesToMol(smi));
+            REQUIRE(ref);
+            func(*ref, skip);
+            expected.push_back(MolToSmiles(*ref));
+            mols.emplace_back(SmilesToMol(smi));
+            molPtrs.push_back(mols.back().get());
+          }
+#ifndef RDK_BUILD_THREADSAFE_SSS
+          numThreads = 1;
+#endif
+          pipeline.run(molPtrs, step, numThreads, skip);
+          for (auto i = 0u; i < mols.size(); ++i) {
+            INFO(smis[i] << " step " << static_cast<int>(step));
+            CHECK(MolToSmiles(*mols[i]) == expected[i]);
+          }
+        }
+      }
+    }
+  }
+  SECTION("single molecules") {
+    std::unique_ptr<RWMol> mol(SmilesToMol("[O-]c1ccc(C(=O)O)cc1CC=CO.[Na+]"));
+    REQUIRE(mol);
+    pipeline.run(*mol, Step::SuperParent);
+    CHECK(MolToSmiles(*mol) == "O=CCCc1cc(C(=O)O)ccc1O");
+  }
+  SECTION("standardizeSmiles") {
+    auto tsmis = smis;
+    tsmis.push_back("c1cccc1");  // can't be kekulized
+    tsmis.push_back("C1CC");     // unclosed ring
+    for (auto numThreads : {1, 4}) {
+      auto res = pipeline.standardizeSmiles(tsmis, numThreads);
+      REQUIRE(res.size() == tsmis.size());
+      for (auto i = 0u; i < smis.size(); ++i) {
+        CHECK(res[i] == MolStandardize::standardizeSmiles(smis[i]));
+      }
+      CHECK(res[smis.size()].empty());
+      CHECK(res[smis.size() + 1].empty());
+    }
+  }
+}
+
+TEST_CASE("StandardizationPipeline benchmark", "[.][benchmark]") {
+  auto smis = readChemblTestSmiles();
+  REQUIRE(!smis.empty());
+  std::vector<std::unique_ptr<RWMol>> mols;
+  for (const auto &smi : smis) {
+    mols.emplace_back(SmilesToMol(smi));
+    REQUIRE(mols.back());
+  }
+  auto params = MolStandardize::defaultCleanupParameters;
+  auto makeCopies = [&mols]() {
+    std::vector<std::unique_ptr<RWMol>> res;
+    for (const auto &mol : mols) {
+      res.emplace_back(new RWMol(*mol));
+    }
+    return res;
+  };
+  auto getPtrs = [](std::vector<std::unique_ptr<RWMol>> &ms) {
+    std::vector<RWMol *> res;
+    for (auto &m : ms) {
+      res.push_back(m.get());
+    }
+    return res;
+  };
+  auto report = [&mols](const std::string &label, const auto &t1) {
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "TIMING : " << label << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << mols.size() << " molecules"
+              << std::endl;
+  };
+
+  auto copies1 = makeCopies();
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (auto &mol : copies1) {
+    MolStandardize::superParentInPlace(*mol, params);
+  }
+  report("superParentInPlace one molecule at a time", t1);
+
+  auto copies2 = makeCopies();
+  auto ptrs2 = getPtrs(copies2);
+  MolStandardize::StandardizationPipeline pipeline(params);
+  t1 = std::chrono::high_resolution_clock::now();
+  pipeline.run(ptrs2, MolStandardize::StandardizationStep::SuperParent);
+  report("StandardizationPipeline, 1 thread", t1);
+  for (auto i = 0u; i < mols.size(); ++i) {
+    CHECK(MolToSmiles(*copies1[i]) == MolToSmiles(*copies2[i]));
+  }
+
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  auto copies3 = makeCopies();
+  auto ptrs3 = getPtrs(copies3);
+  t1 = std::chrono::high_resolution_clock::now();
+  pipeline.run(ptrs3, MolStandardize::StandardizationStep::SuperParent, -1);
+  report("StandardizationPipeline, all threads", t1);
+  for (auto i = 0u; i < mols.size(); ++i) {
+    CHECK(MolToSmiles(*copies1[i]) == MolToSmiles(*copies3[i]));
+  }
+#endif
+}
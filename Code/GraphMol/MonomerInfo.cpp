@@ -7,11 +7,178 @@
 //  which is included in the file license.txt, found at the root
 //  of the RDKit source tree.
 //
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <map>
+#include <sstream>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#ifdef RDK_BUILD_THREADSAFE_SSS
+#include <mutex>
+#endif
 #include "MonomerInfo.h"
+#include <RDGeneral/Invariant.h>
 
 using namespace RDKit;
 
+namespace {
+// chain IDs, alternate locations and insertion codes are a single character
+// (or empty), so those are served from a fixed table without locking
+const std::array<std::string, 257> &shortPDBStrings() {
+  static const std::array<std::string, 257> res = [] {
+    std::array<std::string, 257> tmp;
+    for (unsigned int i = 0; i < 256; ++i) {
+      tmp[i + 1] = std::string(1, static_cast<char>(i));
+    }
+    return tmp;
+  }();
+  return res;
+}
+}  // namespace
+
+const std::string *RDKit::internPDBString(const std::string &val) {
+  if (val.size() <= 1) {
+    const auto &shortStrings = shortPDBStrings();
+    return val.empty()
+               ? &shortStrings[0]
+               : &shortStrings[static_cast<unsigned char>(val[0]) + 1];
+  }
+  // the pool is intentionally never destroyed so that the returned pointers
+  // stay valid during static destruction
+  static auto *pool = new std::unordered_set<std::string>();
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  // each thread keeps views of the pooled strings it has already seen, so
+  // the lock is only taken the first time a thread interns a given value
+  thread_local std::unordered_map<std::string_view, const std::string *>
+      seen;
+  if (auto it = seen.find(val); it != seen.end()) {
+    return it->second;
+  }
+  static std::mutex poolMutex;
+  const std::string *res;
+  {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    res = &*pool->insert(val).first;
+  }
+  seen.emplace(*res, res);
+  return res;
+#else
+  return &*pool->insert(val).first;
+#endif
+}
+
+PDBResidueTable::PDBResidueTable(std::vector<unsigned int> atomIndices,
+                                 std::vector<AtomPDBResidueInfo> atomInfo)
+    : d_atomInfo(std::move(atomInfo)), d_atomIndices(std::move(atomIndices)) {
+  PRECONDITION(d_atomIndices.size() == d_atomInfo.size(), "size mismatch");
+  // the string members are interned, so residues can be compared by pointer
+  using ResidueKey =
+      std::tuple<const std::string *, int, const std::string *,
+                 const std::string *>;
+  std::map<ResidueKey, int> residues;
+  d_atomResidue.reserve(d_atomInfo.size());
+  ResidueKey lastKey;
+  int lastResidue = -1;
+  for (unsigned int i = 0; i < d_atomInfo.size(); ++i) {
+    auto &info = d_atomInfo[i];
+    info.df_ownedByResidueTable = true;
+    ResidueKey key{&info.getResidueName(), info.getResidueNumber(),
+                   &info.getChainId(), &info.getInsertionCode()};
+    // atoms are almost always grouped by residue
+    if (lastResidue < 0 || key != lastKey) {
+      auto res = residues.emplace(key, static_cast<int>(d_residueStarts.size()));
+      if (res.second) {
+        d_residueStarts.push_back(i);
+      }
+      lastKey = key;
+      lastResidue = res.first->second;
+    }
+    d_atomResidue.push_back(lastResidue);
+  }
+}
+
+PDBResidueTable::PDBResidueTable(const PDBResidueTable &other)
+    : d_atomInfo(other.d_atomInfo),
+      d_atomIndices(other.d_atomIndices),
+      d_atomResidue(other.d_atomResidue),
+      d_residueStarts(other.d_residueStarts) {
+  // copying AtomMonomerInfo does not copy the ownership flag
+  for (auto &info : d_atomInfo) {
+    info.df_ownedByResidueTable = true;
+  }
+}
+
+unsigned int PDBResidueTable::getAtomIndex(unsigned int entry) const {
+  URANGE_CHECK(entry, d_atomIndices.size());
+  return d_atomIndices[entry];
+}
+
+const AtomPDBResidueInfo &PDBResidueTable::getAtomInfo(
+    unsigned int entry) const {
+  URANGE_CHECK(entry, d_atomInfo.size());
+  return d_atomInfo[entry];
+}
+
+AtomPDBResidueInfo &PDBResidueTable::getAtomInfo(unsigned int entry) {
+  URANGE_CHECK(entry, d_atomInfo.size());
+  return d_atomInfo[entry];
+}
+
+const AtomPDBResidueInfo &PDBResidueTable::getResidueInfo(
+    unsigned int idx) const {
+  URANGE_CHECK(idx, d_residueStarts.size());
+  return d_atomInfo[d_residueStarts[idx]];
+}
+
+int PDBResidueTable::getResidueIndex(const AtomMonomerInfo *info) const {
+  if (!owns(info)) {
+    return -1;
+  }
+  return d_atomResidue[static_cast<const AtomPDBResidueInfo *>(info) -
+                       d_atomInfo.data()];
+}
+
+void PDBResidueTable::removeAtom(unsigned int atomIdx) {
+  auto pos = std::find(d_atomIndices.begin(), d_atomIndices.end(), atomIdx);
+  if (pos != d_atomIndices.end()) {
+    auto entry = static_cast<unsigned int>(pos - d_atomIndices.begin());
+    auto residue = d_atomResidue[entry];
+    bool wasStart = d_residueStarts[residue] == entry;
+    d_atomInfo.erase(d_atomInfo.begin() + entry);
+    d_atomIndices.erase(pos);
+    d_atomResidue.erase(d_atomResidue.begin() + entry);
+    for (auto &start : d_residueStarts) {
+      if (start > entry) {
+        --start;
+      }
+    }
+    if (wasStart) {
+      // the residue now starts at its next atom, if it has any left
+      auto next = std::find(d_atomResidue.begin() + entry, d_atomResidue.end(),
+                            residue);
+      if (next != d_atomResidue.end()) {
+        d_residueStarts[residue] =
+            static_cast<unsigned int>(next - d_atomResidue.begin());
+      } else {
+        d_residueStarts.erase(d_residueStarts.begin() + residue);
+        for (auto &res : d_atomResidue) {
+          if (res > residue) {
+            --res;
+          }
+        }
+      }
+    }
+  }
+  for (auto &idx : d_atomIndices) {
+    if (idx > atomIdx) {
+      --idx;
+    }
+  }
+}
+
 //! allows AtomPDBResidueInfo objects to be dumped to streams
 std::ostream &operator<<(std::ostream &target, const AtomPDBResidueInfo &apri) {
   target << apri.getSerialNumber() << " " << apri.getName() << " "
@@ -18,10 +18,26 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 
 namespace RDKit {
 
+//! returns a pointer to a shared, immutable copy of \c val
+/*!
+  The residue-level strings of AtomPDBResidueInfo (residue name, chain ID,
+  alternate location and insertion code) take a small number of distinct
+  values, so they are stored once in a process-wide pool and referenced by
+  pointer. Pointers returned by this function remain valid for the lifetime
+  of the program.
+
+  The pool is never freed and grows by one entry for every distinct value
+  passed in, so it should not be used for arbitrary, unbounded sets of
+  strings.
+*/
+RDKIT_GRAPHMOL_EXPORT const std::string *internPDBString(
+    const std::string &val);
+
 //! The abstract base class for atom-level monomer info
 class RDKIT_GRAPHMOL_EXPORT AtomMonomerInfo {
  public:
@@ -32,7 +48,14 @@ class RDKIT_GRAPHMOL_EXPORT AtomMonomerInfo {
   AtomMonomerInfo() = default;
   AtomMonomerInfo(AtomMonomerType typ, std::string nm = "")
       : d_monomerType(typ), d_name(std::move(nm)) {}
-  AtomMonomerInfo(const AtomMonomerInfo &other) = default;
+  //! copies are never owned by a PDBResidueTable
+  AtomMonomerInfo(const AtomMonomerInfo &other)
+      : d_monomerType(other.d_monomerType), d_name(other.d_name) {}
+  AtomMonomerInfo &operator=(const AtomMonomerInfo &other) {
+    d_monomerType = other.d_monomerType;
+    d_name = other.d_name;
+    return *this;
+  }
 
   const std::string &getName() const { return d_name; }
   void setName(const std::string &nm) { d_name = nm; }
@@ -41,9 +64,15 @@ class RDKIT_GRAPHMOL_EXPORT AtomMonomerInfo {
 
   virtual AtomMonomerInfo *copy() const { return new AtomMonomerInfo(*this); }
 
+  //! returns whether or not this object is stored in a PDBResidueTable
+  //! (and is therefore not deleted by the atom it is attached to)
+  bool isOwnedByResidueTable() const { return df_ownedByResidueTable; }
+
  private:
+  friend class PDBResidueTable;
   AtomMonomerType d_monomerType{UNKNOWN};
   std::string d_name{""};
+  bool df_ownedByResidueTable = false;
 };
 
 //! Captures atom-level information about peptide residues
@@ -61,11 +90,11 @@ class RDKIT_GRAPHMOL_EXPORT AtomPDBResidueInfo : public AtomMonomerInfo {
                      unsigned int segmentNumber = 0)
       : AtomMonomerInfo(PDBRESIDUE, atomName),
         d_serialNumber(serialNumber),
-        d_altLoc(std::move(altLoc)),
-        d_residueName(std::move(residueName)),
+        d_altLoc(internPDBString(altLoc)),
+        d_residueName(internPDBString(residueName)),
         d_residueNumber(residueNumber),
-        d_chainId(std::move(chainId)),
-        d_insertionCode(std::move(insertionCode)),
+        d_chainId(internPDBString(chainId)),
+        d_insertionCode(internPDBString(insertionCode)),
         d_occupancy(occupancy),
         d_tempFactor(tempFactor),
         df_heteroAtom(isHeteroAtom),
@@ -74,16 +103,20 @@ class RDKIT_GRAPHMOL_EXPORT AtomPDBResidueInfo : public AtomMonomerInfo {
 
   int getSerialNumber() const { return d_serialNumber; }
   void setSerialNumber(int val) { d_serialNumber = val; }
-  const std::string &getAltLoc() const { return d_altLoc; }
-  void setAltLoc(const std::string &val) { d_altLoc = val; }
-  const std::string &getResidueName() const { return d_residueName; }
-  void setResidueName(const std::string &val) { d_residueName = val; }
+  const std::string &getAltLoc() const { return *d_altLoc; }
+  void setAltLoc(const std::string &val) { d_altLoc = internPDBString(val); }
+  const std::string &getResidueName() const { return *d_residueName; }
+  void setResidueName(const std::string &val) {
+    d_residueName = internPDBString(val);
+  }
   int getResidueNumber() const { return d_residueNumber; }
   void setResidueNumber(int val) { d_residueNumber = val; }
-  const std::string &getChainId() const { return d_chainId; }
-  void setChainId(const std::string &val) { d_chainId = val; }
-  const std::string &getInsertionCode() const { return d_insertionCode; }
-  void setInsertionCode(const std::string &val) { d_insertionCode = val; }
+  const std::string &getChainId() const { return *d_chainId; }
+  void setChainId(const std::string &val) { d_chainId = internPDBString(val); }
+  const std::string &getInsertionCode() const { return *d_insertionCode; }
+  void setInsertionCode(const std::string &val) {
+    d_insertionCode = internPDBString(val);
+  }
   double getOccupancy() const { return d_occupancy; }
   void setOccupancy(double val) { d_occupancy = val; }
   double getTempFactor() const { return d_tempFactor; }
@@ -104,12 +137,13 @@ class RDKIT_GRAPHMOL_EXPORT AtomPDBResidueInfo : public AtomMonomerInfo {
   // (http://www.wwpdb.org/documentation/format33/sect9.html#ATOM) [9 Aug, 2013]
   // element and charge are not present since the atom itself stores that
   // information
+  // the string fields are interned, see internPDBString()
   unsigned int d_serialNumber = 0;
-  std::string d_altLoc = "";
-  std::string d_residueName = "";
+  const std::string *d_altLoc = internPDBString("");
+  const std::string *d_residueName = internPDBString("");
   int d_residueNumber = 0;
-  std::string d_chainId = "";
-  std::string d_insertionCode = "";
+  const std::string *d_chainId = internPDBString("");
+  const std::string *d_insertionCode = internPDBString("");
   double d_occupancy = 1.0;
   double d_tempFactor = 0.0;
   // additional, non-PDB fields:
@@ -117,6 +151,75 @@ class RDKIT_GRAPHMOL_EXPORT AtomPDBResidueInfo : public AtomMonomerInfo {
   unsigned int d_secondaryStructure = 0;
   unsigned int d_segmentNumber = 0;
 };
+
+//! Molecule-level storage for the AtomPDBResidueInfo of the atoms of a
+//! molecule
+/*!
+  Instead of one heap allocation per atom, the residue info objects are kept
+  in a single contiguous block owned by the molecule (see
+  ROMol::buildPDBResidueTable()). The atoms point into that block, so
+  Atom::getMonomerInfo() and the AtomPDBResidueInfo accessors work as usual.
+
+  Because callers get a mutable AtomPDBResidueInfo for each atom, every entry
+  is a full AtomPDBResidueInfo: the residue-level fields are not shared
+  between the atoms of a residue, so this does not reduce the size of the
+  entries, only the number of allocations.
+
+  The table also groups the atoms into residues, using the same criteria as
+  SamePDBResidue(): residue name, residue number, chain ID and insertion code.
+  The grouping reflects the residue info at the time the table was built.
+*/
+class RDKIT_GRAPHMOL_EXPORT PDBResidueTable {
+ public:
+  //! constructs the table from the residue info \c atomInfo of the atoms with
+  //! indices \c atomIndices
+  PDBResidueTable(std::vector<unsigned int> atomIndices,
+                  std::vector<AtomPDBResidueInfo> atomInfo);
+  //! the copy is not referenced by any atoms
+  PDBResidueTable(const PDBResidueTable &other);
+  PDBResidueTable &operator=(const PDBResidueTable &) = delete;
+
+  //! returns the number of atoms stored in the table
+  unsigned int getNumAtoms() const {
+    return static_cast<unsigned int>(d_atomInfo.size());
+  }
+  //! returns the index of the atom that \c entry was created for
+  unsigned int getAtomIndex(unsigned int entry) const;
+  //! returns the residue info stored at \c entry
+  const AtomPDBResidueInfo &getAtomInfo(unsigned int entry) const;
+  AtomPDBResidueInfo &getAtomInfo(unsigned int entry);
+
+  //! returns the number of residues
+  unsigned int getNumResidues() const {
+    return static_cast<unsigned int>(d_residueStarts.size());
+  }
+  //! returns the residue info of the first atom of residue \c idx
+  const AtomPDBResidueInfo &getResidueInfo(unsigned int idx) const;
+  //! returns the index of the residue \c info belongs to, or -1 if \c info
+  //! is not stored in this table
+  int getResidueIndex(const AtomMonomerInfo *info) const;
+
+  //! removes the entry of the atom with index \c atomIdx, if there is one,
+  //! and decrements the indices of the atoms after it
+  /*!
+    The entries after the removed one move, so the atoms which point to them
+    have to be updated.
+  */
+  void removeAtom(unsigned int atomIdx);
+
+  //! returns whether or not \c info is stored in this table
+  bool owns(const AtomMonomerInfo *info) const {
+    return !d_atomInfo.empty() && info >= &d_atomInfo.front() &&
+           info <= &d_atomInfo.back();
+  }
+
+ private:
+  std::vector<AtomPDBResidueInfo> d_atomInfo;
+  std::vector<unsigned int> d_atomIndices;
+  std::vector<int> d_atomResidue;
+  std::vector<unsigned int> d_residueStarts;
+};
+
 };  // namespace RDKit
 //! allows AtomPDBResidueInfo objects to be dumped to streams
 RDKIT_GRAPHMOL_EXPORT std::ostream &operator<<(
@@ -52,6 +52,8 @@ void ROMol::destroy() {
   }
 
   d_graph.clear();
+  // the atoms are gone, so nothing refers to the table anymore
+  dp_pdbResidueTable.reset();
 
   delete dp_ringInfo;
 
@@ -81,10 +83,20 @@ void ROMol::initFromOther(const ROMol &other, bool quickCopy, int confId) {
   numBonds = 0;
   // std::cerr<<"    init from other: "<<this<<" "<<&other<<std::endl;
   // copy over the atoms
+  const auto otherTable = other.dp_pdbResidueTable.get();
   for (const auto oatom : other.atoms()) {
     constexpr bool updateLabel = false;
     constexpr bool takeOwnership = true;
-    addAtom(oatom->copy(), updateLabel, takeOwnership);
+    Atom *atom;
+    if (otherTable && !oatom->hasQuery() &&
+        otherTable->owns(oatom->getMonomerInfo())) {
+      // the residue info is picked up from the copy of the table below
+      atom = new Atom();
+      atom->initFromOther(*oatom, false);
+    } else {
+      atom = oatom->copy();
+    }
+    addAtom(atom, updateLabel, takeOwnership);
   }
 
   // and the bonds:
@@ -127,6 +139,24 @@ void ROMol::initFromOther(const ROMol &other, bool quickCopy, int confId) {
     dp_delBonds.reset(nullptr);
   }
 
+  if (otherTable) {
+    dp_pdbResidueTable.reset(new PDBResidueTable(*otherTable));
+    for (unsigned int i = 0; i < otherTable->getNumAtoms(); ++i) {
+      auto atomIdx = otherTable->getAtomIndex(i);
+      if (other.getAtomWithIdx(atomIdx)->getMonomerInfo() !=
+          &otherTable->getAtomInfo(i)) {
+        continue;
+      }
+      auto atom = getAtomWithIdx(atomIdx);
+      // query atoms were copied along with their residue info
+      auto info = atom->getMonomerInfo();
+      if (info && !info->isOwnedByResidueTable()) {
+        delete info;
+      }
+      atom->setMonomerInfo(&dp_pdbResidueTable->getAtomInfo(i));
+    }
+  }
+
   if (!quickCopy) {
     // copy conformations
     for (const auto &conf : other.d_confs) {
@@ -442,6 +472,78 @@ void ROMol::setStereoGroups(std::vector<StereoGroup> stereo_groups) {
   d_stereo_groups = std::move(stereo_groups);
 }
 
+void ROMol::buildPDBResidueTable() {
+  std::vector<unsigned int> atomIndices;
+  std::vector<AtomPDBResidueInfo> atomInfo;
+  for (const auto atom : atoms()) {
+    const auto info = atom->getMonomerInfo();
+    if (info && info->getMonomerType() == AtomMonomerInfo::PDBRESIDUE) {
+      atomIndices.push_back(atom->getIdx());
+      atomInfo.push_back(*static_cast<const AtomPDBResidueInfo *>(info));
+    }
+  }
+  setPDBResidueTable(std::unique_ptr<PDBResidueTable>(
+      new PDBResidueTable(std::move(atomIndices), std::move(atomInfo))));
+}
+
+void ROMol::setPDBResidueTable(std::unique_ptr<PDBResidueTable> table) {
+  PRECONDITION(table, "bad table");
+  for (unsigned int i = 0; i < table->getNumAtoms(); ++i) {
+    auto atom = getAtomWithIdx(table->getAtomIndex(i));
+    auto info = atom->getMonomerInfo();
+    if (info && !info->isOwnedByResidueTable()) {
+      delete info;
+    }
+    atom->setMonomerInfo(&table->getAtomInfo(i));
+  }
+  // atoms which still refer to the old table get their own copy
+  dropPDBResidueTable();
+  dp_pdbResidueTable = std::move(table);
+}
+
+void ROMol::dropPDBResidueTable() {
+  if (!dp_pdbResidueTable) {
+    return;
+  }
+  for (auto atom : atoms()) {
+    auto info = atom->getMonomerInfo();
+    if (dp_pdbResidueTable->owns(info)) {
+      atom->setMonomerInfo(info->copy());
+    }
+  }
+  dp_pdbResidueTable.reset();
+}
+
+void ROMol::removeFromPDBResidueTable(Atom *atom) {
+  if (!dp_pdbResidueTable) {
+    return;
+  }
+  auto &table = *dp_pdbResidueTable;
+  const auto idx = atom->getIdx();
+  if (table.owns(atom->getMonomerInfo())) {
+    // the atom is about to be deleted and its entry goes away
+    atom->setMonomerInfo(nullptr);
+  }
+  // the atoms which point at entries after the removed one have to be
+  // repointed, find them before the entries move
+  std::vector<std::pair<Atom *, unsigned int>> moved;
+  for (unsigned int i = 0; i < table.getNumAtoms(); ++i) {
+    if (table.getAtomIndex(i) == idx) {
+      for (unsigned int j = i + 1; j < table.getNumAtoms(); ++j) {
+        auto other = getAtomWithIdx(table.getAtomIndex(j));
+        if (other->getMonomerInfo() == &table.getAtomInfo(j)) {
+          moved.emplace_back(other, j - 1);
+        }
+      }
+      break;
+    }
+  }
+  table.removeAtom(idx);
+  for (const auto &[other, entry] : moved) {
+    other->setMonomerInfo(&table.getAtomInfo(entry));
+  }
+}
+
 void ROMol::debugMol(std::ostream &str) const {
   str << "Atoms:" << std::endl;
   for (const auto atom : atoms()) {
@@ -360,6 +360,9 @@ void RWMol::removeAtom(Atom *atom, bool clearProps) {
     return;
   }
 
+  // the residue table refers to atoms by index
+  removeFromPDBResidueTable(atom);
+
   // remove any bookmarks which point to this atom:
   ATOM_BOOKMARK_MAP *marks = getAtomBookmarks();
   auto markI = marks->begin();
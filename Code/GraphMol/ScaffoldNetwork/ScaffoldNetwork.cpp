@@ -22,6 +22,12 @@
 #include <GraphMol/MolStandardize/Fragment.h>
 #include <GraphMol/ChemTransforms/ChemTransforms.h>
 #include <RDGeneral/Exceptions.h>
+#include <RDGeneral/RDThreads.h>
+
+#include <boost/functional/hash.hpp>
+#include <exception>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace RDKit {
 namespace ScaffoldNetwork {
@@ -197,9 +203,11 @@ size_t addEntryIfMissing(T &vect, const V &e,
   return res;
 }
 
-}  // namespace
-void addMolToNetwork(const ROMol &mol, ScaffoldNetwork &network,
-                     const ScaffoldNetworkParams &params) {
+// adds the scaffolds from a molecule to a network using linear searches of
+// the nodes and edges. This is only used to build the (small) network for a
+// single molecule, which is then merged into the full network.
+void addMolToSmallNetwork(const ROMol &mol, ScaffoldNetwork &network,
+                          const ScaffoldNetworkParams &params) {
   auto ismi = MolToSmiles(mol);
   boost::shared_ptr<ROMol> fmol(flattenMol(mol, params));
   if (params.pruneBeforeFragmenting) {
@@ -358,6 +366,99 @@ void addMolToNetwork(const ROMol &mol, ScaffoldNetwork &network,
     }
   }
 }
+
+}  // namespace
+
+size_t NetworkEdgeHash::operator()(const NetworkEdge &edge) const {
+  size_t res = 0;
+  boost::hash_combine(res, edge.beginIdx);
+  boost::hash_combine(res, edge.endIdx);
+  boost::hash_combine(res, static_cast<int>(edge.type));
+  return res;
+}
+
+NetworkIndex::NetworkIndex(const ScaffoldNetwork &network) {
+  d_nodes.reserve(network.nodes.size());
+  for (size_t i = 0; i < network.nodes.size(); ++i) {
+    d_nodes.emplace(network.nodes[i], i);
+  }
+  d_edges.reserve(network.edges.size());
+  d_edges.insert(network.edges.begin(), network.edges.end());
+}
+
+void NetworkIndex::merge(const ScaffoldNetwork &molNetwork,
+                         ScaffoldNetwork &network) {
+  std::vector<size_t> nodeMap(molNetwork.nodes.size());
+  for (size_t i = 0; i < molNetwork.nodes.size(); ++i) {
+    auto res = d_nodes.emplace(molNetwork.nodes[i], network.nodes.size());
+    if (res.second) {
+      network.nodes.push_back(molNetwork.nodes[i]);
+      network.counts.push_back(0);
+    }
+    nodeMap[i] = res.first->second;
+    if (i < molNetwork.counts.size()) {
+      network.counts[nodeMap[i]] += molNetwork.counts[i];
+    }
+  }
+  for (const auto &edge : molNetwork.edges) {
+    NetworkEdge nedge(nodeMap[edge.beginIdx], nodeMap[edge.endIdx], edge.type);
+    if (d_edges.insert(nedge).second) {
+      network.edges.push_back(nedge);
+    }
+  }
+  for (size_t i = 0; i < molNetwork.molCounts.size(); ++i) {
+    if (!molNetwork.molCounts[i]) {
+      continue;
+    }
+    auto idx = nodeMap[i];
+    if (network.molCounts.size() <= idx) {
+      network.molCounts.resize(idx + 1, 0u);
+    }
+    network.molCounts[idx]++;
+  }
+}
+
+namespace {
+// the number of molecules which are fragmented in parallel before the
+// results are merged into the network
+const unsigned int molChunkSize = 1000;
+
+void addMolsToNetwork(const std::vector<const ROMol *> &mols,
+                      ScaffoldNetwork &network, NetworkIndex &index,
+                      const ScaffoldNetworkParams &params) {
+  std::vector<ScaffoldNetwork> molNetworks(mols.size());
+  std::vector<std::exception_ptr> errors(mols.size());
+  auto func = [&](size_t i) {
+    try {
+      addMolToSmallNetwork(*mols[i], molNetworks[i], params);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+  runOnIndices(func, mols.size(), params.numThreads);
+  // merge in order, stopping at the first failure as we would if the
+  // molecules were processed one at a time
+  for (unsigned int i = 0; i < mols.size(); ++i) {
+    if (errors[i]) {
+      std::rethrow_exception(errors[i]);
+    }
+    index.merge(molNetworks[i], network);
+  }
+}
+}  // namespace
+
+void addMolToNetwork(const ROMol &mol, ScaffoldNetwork &network,
+                     NetworkIndex &index, const ScaffoldNetworkParams &params) {
+  ScaffoldNetwork molNetwork;
+  addMolToSmallNetwork(mol, molNetwork, params);
+  index.merge(molNetwork, network);
+}
+
+void addMolToNetwork(const ROMol &mol, ScaffoldNetwork &network,
+                     const ScaffoldNetworkParams &params) {
+  NetworkIndex index(network);
+  addMolToNetwork(mol, network, index, params);
+}
 }  // namespace detail
 
 template <typename T>
@@ -369,13 +470,21 @@ void updateScaffoldNetwork(const T &mols, ScaffoldNetwork &network,
         "must include at least one of scaffolds with attachments or scaffolds "
         "without attachments");
   }
+  detail::NetworkIndex index(network);
+  std::vector<const ROMol *> chunk;
   for (const auto &mol : mols) {
     if (!mol) {
+      detail::addMolsToNetwork(chunk, network, index, params);
       throw ValueErrorException(
           "updateScaffoldNetwork called with null molecule");
     }
-    detail::addMolToNetwork(*mol, network, params);
+    chunk.push_back(&*mol);
+    if (chunk.size() == detail::molChunkSize) {
+      detail::addMolsToNetwork(chunk, network, index, params);
+      chunk.clear();
+    }
   }
+  detail::addMolsToNetwork(chunk, network, index, params);
 }
 
 template RDKIT_SCAFFOLDNETWORK_EXPORT void updateScaffoldNetwork(
@@ -489,6 +598,110 @@ ScaffoldNetworkParams getBRICSNetworkParams() {
   return res;
 };
 
+namespace {
+void writeNodeCounts(const ScaffoldNetwork &network, size_t idx,
+                     std::ostream &outs) {
+  outs << "\t" << (idx < network.counts.size() ? network.counts[idx] : 0u);
+  if (idx < network.molCounts.size()) {
+    outs << "\t" << network.molCounts[idx];
+  }
+  outs << "\n";
+}
+}  // namespace
+
+void appendScaffoldNetworkChanges(const ScaffoldNetwork &network,
+                                  const ScaffoldNetworkCheckpoint &checkpoint,
+                                  std::ostream &outs) {
+  PRECONDITION(checkpoint.numNodes <= network.nodes.size() &&
+                   checkpoint.numEdges <= network.edges.size(),
+               "checkpoint does not match network");
+  for (size_t i = 0; i < checkpoint.numNodes; ++i) {
+    auto count = i < network.counts.size() ? network.counts[i] : 0u;
+    auto oldCount = i < checkpoint.counts.size() ? checkpoint.counts[i] : 0u;
+    bool molCountChanged = i < network.molCounts.size() &&
+                           (i >= checkpoint.molCounts.size() ||
+                            network.molCounts[i] != checkpoint.molCounts[i]);
+    if (count != oldCount || molCountChanged) {
+      outs << "C\t" << i;
+      writeNodeCounts(network, i, outs);
+    }
+  }
+  for (size_t i = checkpoint.numNodes; i < network.nodes.size(); ++i) {
+    outs << "N\t" << network.nodes[i];
+    writeNodeCounts(network, i, outs);
+  }
+  for (size_t i = checkpoint.numEdges; i < network.edges.size(); ++i) {
+    const auto &edge = network.edges[i];
+    outs << "E\t" << edge.beginIdx << "\t" << edge.endIdx << "\t"
+         << static_cast<int>(edge.type) << "\n";
+  }
+}
+
+void writeScaffoldNetwork(const ScaffoldNetwork &network, std::ostream &outs) {
+  appendScaffoldNetworkChanges(network, ScaffoldNetworkCheckpoint(), outs);
+}
+
+void readScaffoldNetwork(std::istream &ins, ScaffoldNetwork &network) {
+  std::string line;
+  unsigned int lineNum = 0;
+  while (std::getline(ins, line)) {
+    ++lineNum;
+    if (line.empty()) {
+      continue;
+    }
+    std::vector<std::string> tokens;
+    std::stringstream tokenizer(line);
+    std::string token;
+    while (std::getline(tokenizer, token, '\t')) {
+      tokens.push_back(token);
+    }
+    auto badLine = [&]() {
+      return ValueErrorException("bad scaffold network record on line " +
+                                 std::to_string(lineNum) + ": " + line);
+    };
+    try {
+      if ((tokens[0] == "N" || tokens[0] == "C") &&
+          (tokens.size() == 3 || tokens.size() == 4)) {
+        size_t idx;
+        if (tokens[0] == "N") {
+          idx = network.nodes.size();
+          network.nodes.push_back(tokens[1]);
+        } else {
+          idx = std::stoul(tokens[1]);
+          if (idx >= network.nodes.size()) {
+            throw badLine();
+          }
+        }
+        if (network.counts.size() <= idx) {
+          network.counts.resize(idx + 1, 0u);
+        }
+        network.counts[idx] = std::stoul(tokens[2]);
+        if (tokens.size() == 4) {
+          if (network.molCounts.size() <= idx) {
+            network.molCounts.resize(idx + 1, 0u);
+          }
+          network.molCounts[idx] = std::stoul(tokens[3]);
+        }
+      } else if (tokens[0] == "E" && tokens.size() == 4) {
+        NetworkEdge edge(std::stoul(tokens[1]), std::stoul(tokens[2]),
+                         static_cast<EdgeType>(std::stoi(tokens[3])));
+        if (edge.beginIdx >= network.nodes.size() ||
+            edge.endIdx >= network.nodes.size() ||
+            edge.type < EdgeType::Fragment ||
+            edge.type > EdgeType::Initialize) {
+          throw badLine();
+        }
+        network.edges.push_back(edge);
+      } else {
+        throw badLine();
+      }
+    } catch (const std::logic_error &) {
+      // from the numeric conversions
+      throw badLine();
+    }
+  }
+}
+
 // const ScaffoldNetworkParams BRICSNetworkParams;
 
 }  // namespace ScaffoldNetwork
@@ -55,6 +55,9 @@ struct RDKIT_SCAFFOLDNETWORK_EXPORT ScaffoldNetworkParams {
       true;  ///< keep only the largest fragment when doing flattening
   bool collectMolCounts = true;  ///< keep track of the number of molecules each
                                  ///< scaffold was reached from
+  int numThreads = 1;  ///< number of threads to use when fragmenting the
+                       ///< molecules. Values <= 0 are interpreted as described
+                       ///< for getNumThreadsToUse()
 
   std::vector<std::shared_ptr<ChemicalReaction>>
       bondBreakersRxns;  ///< the reaction(s) used to fragment. Should expect a
@@ -129,6 +132,11 @@ struct RDKIT_SCAFFOLDNETWORK_EXPORT ScaffoldNetwork {
 };
 
 //! update an existing ScaffoldNetwork using a set of molecules
+/*!
+  The molecules are fragmented in parallel if \c params.numThreads is not 1.
+  The results are added to the network in the order of the molecules, so the
+  network is the same regardless of the number of threads used.
+*/
 template <typename T>
 void updateScaffoldNetwork(const T &mols, ScaffoldNetwork &network,
                            const ScaffoldNetworkParams &params);
@@ -178,6 +186,44 @@ inline std::ostream &operator<<(std::ostream &ostr,
 //! fragmentation
 RDKIT_SCAFFOLDNETWORK_EXPORT ScaffoldNetworkParams getBRICSNetworkParams();
 
+//! records the size and counts of a ScaffoldNetwork so that the changes made
+//! to it by later updates can be written with appendScaffoldNetworkChanges()
+struct RDKIT_SCAFFOLDNETWORK_EXPORT ScaffoldNetworkCheckpoint {
+  size_t numNodes = 0;
+  size_t numEdges = 0;
+  std::vector<unsigned> counts;
+  std::vector<unsigned> molCounts;
+  ScaffoldNetworkCheckpoint() {}
+  explicit ScaffoldNetworkCheckpoint(const ScaffoldNetwork &network)
+      : numNodes(network.nodes.size()),
+        numEdges(network.edges.size()),
+        counts(network.counts),
+        molCounts(network.molCounts) {}
+};
+
+//! writes a ScaffoldNetwork to a stream using a line-based text format
+/*!
+  Each line is a tab-separated record:
+    - \c N \c smiles \c count [\c molCount] : adds a node
+    - \c C \c index \c count [\c molCount] : updates the counts for a node
+    - \c E \c beginIdx \c endIdx \c type : adds an edge
+
+  Since the records are applied in order, the changes made to a network by
+  updateScaffoldNetwork() can be appended to an existing file using
+  appendScaffoldNetworkChanges().
+*/
+RDKIT_SCAFFOLDNETWORK_EXPORT void writeScaffoldNetwork(
+    const ScaffoldNetwork &network, std::ostream &outs);
+//! writes the changes made to a ScaffoldNetwork since \c checkpoint was
+//! created, using the format described for writeScaffoldNetwork()
+RDKIT_SCAFFOLDNETWORK_EXPORT void appendScaffoldNetworkChanges(
+    const ScaffoldNetwork &network, const ScaffoldNetworkCheckpoint &checkpoint,
+    std::ostream &outs);
+//! reads a ScaffoldNetwork written by writeScaffoldNetwork() (and, possibly,
+//! appendScaffoldNetworkChanges()). The records are added to \c network
+RDKIT_SCAFFOLDNETWORK_EXPORT void readScaffoldNetwork(std::istream &ins,
+                                                      ScaffoldNetwork &network);
+
 }  // namespace ScaffoldNetwork
 }  // namespace RDKit
 
@@ -122,7 +122,12 @@ BOOST_PYTHON_MODULE(rdScaffoldNetwork) {
       .def_readwrite("collectMolCounts",
                      &ScaffoldNetwork::ScaffoldNetworkParams::collectMolCounts,
                      "keep track of the number of molecules each scaffold was "
-                     "found in");
+                     "found in")
+      .def_readwrite("numThreads",
+                     &ScaffoldNetwork::ScaffoldNetworkParams::numThreads,
+                     "number of threads to use when fragmenting the molecules. "
+                     "If this is <= 0, the number of threads used is the "
+                     "number of available CPUs plus this value");
 
   python::enum_<ScaffoldNetwork::EdgeType>("EdgeType")
       .value("Fragment", ScaffoldNetwork::EdgeType::Fragment)
@@ -11,11 +11,13 @@
 #include <catch2/catch_all.hpp>
 #include "GraphMol/ScaffoldNetwork/detail.h"
 #include "RDGeneral/test.h"
+#include <chrono>
 #include <sstream>
 #include <GraphMol/RDKitBase.h>
 #include <GraphMol/ScaffoldNetwork/ScaffoldNetwork.h>
 #include <GraphMol/SmilesParse/SmilesWrite.h>
 #include <GraphMol/SmilesParse/SmilesParse.h>
+#include <GraphMol/test_fixtures.h>
 #include <GraphMol/ChemReactions/Reaction.h>
 #include <GraphMol/ChemReactions/ReactionParser.h>
 
@@ -912,3 +914,154 @@ TEST_CASE("Github #6855 MakeScaffoldGeneric isotope removal", "[bug]") {
     CHECK(smiles == "*1**1");
   }
 }
+
+namespace {
+std::vector<ROMOL_SPTR> readNetworkTestMols(unsigned int maxToRead) {
+  std::vector<ROMOL_SPTR> res;
+  for (const auto &smi : readChemblTestSmiles(maxToRead)) {
+    res.emplace_back(SmilesToMol(smi));
+    REQUIRE(res.back());
+  }
+  REQUIRE(res.size() == maxToRead);
+  return res;
+}
+
+void compareNetworks(const ScaffoldNetwork::ScaffoldNetwork &net1,
+                     const ScaffoldNetwork::ScaffoldNetwork &net2) {
+  CHECK(net1.nodes == net2.nodes);
+  CHECK(net1.counts == net2.counts);
+  CHECK(net1.molCounts == net2.molCounts);
+  CHECK(net1.edges == net2.edges);
+}
+}  // namespace
+
+TEST_CASE("multithreaded network construction", "[scaffolds]") {
+  auto ms = readNetworkTestMols(60);
+  for (auto ps : {ScaffoldNetwork::ScaffoldNetworkParams(),
+                  ScaffoldNetwork::getBRICSNetworkParams()}) {
+    ps.includeGenericBondScaffolds = true;
+    // the reference: molecules added one at a time
+    ScaffoldNetwork::ScaffoldNetwork ref;
+    for (const auto &m : ms) {
+      ScaffoldNetwork::detail::addMolToNetwork(*m, ref, ps);
+    }
+    CHECK(ref.counts.size() == ref.nodes.size());
+    CHECK(ref.molCounts.size() == ref.nodes.size());
+    {
+      // keeping the index alive between molecules
+      ScaffoldNetwork::ScaffoldNetwork net;
+      ScaffoldNetwork::detail::NetworkIndex index(net);
+      for (const auto &m : ms) {
+        ScaffoldNetwork::detail::addMolToNetwork(*m, net, index, ps);
+      }
+      compareNetworks(net, ref);
+    }
+    for (auto numThreads : {1, 4}) {
+      ps.numThreads = numThreads;
+      auto net = ScaffoldNetwork::createScaffoldNetwork(ms, ps);
+      compareNetworks(net, ref);
+
+      // updating an existing network
+      std::vector<ROMOL_SPTR> first(ms.begin(), ms.begin() + 25);
+      std::vector<ROMOL_SPTR> second(ms.begin() + 25, ms.end());
+      auto net2 = ScaffoldNetwork::createScaffoldNetwork(first, ps);
+      ScaffoldNetwork::updateScaffoldNetwork(second, net2, ps);
+      compareNetworks(net2, ref);
+    }
+  }
+  SECTION("null molecules") {
+    // molecules before the null one are added to the network
+    std::vector<ROMOL_SPTR> mols(ms.begin(), ms.begin() + 5);
+    mols.emplace_back(nullptr);
+    mols.push_back(ms[6]);
+    ScaffoldNetwork::ScaffoldNetworkParams ps;
+    ps.numThreads = 4;
+    ScaffoldNetwork::ScaffoldNetwork net;
+    REQUIRE_THROWS_AS(ScaffoldNetwork::updateScaffoldNetwork(mols, net, ps),
+                      ValueErrorException);
+    std::vector<ROMOL_SPTR> valid(ms.begin(), ms.begin() + 5);
+    ps.numThreads = 1;
+    compareNetworks(net, ScaffoldNetwork::createScaffoldNetwork(valid, ps));
+  }
+}
+
+TEST_CASE("scaffold network text format", "[scaffolds]") {
+  auto ms = readNetworkTestMols(30);
+  ScaffoldNetwork::ScaffoldNetworkParams ps;
+  auto net = ScaffoldNetwork::createScaffoldNetwork(ms, ps);
+  SECTION("round trip") {
+    std::stringstream ss;
+    ScaffoldNetwork::writeScaffoldNetwork(net, ss);
+    ScaffoldNetwork::ScaffoldNetwork net2;
+    ScaffoldNetwork::readScaffoldNetwork(ss, net2);
+    compareNetworks(net2, net);
+  }
+  SECTION("appending") {
+    std::vector<ROMOL_SPTR> first(ms.begin(), ms.begin() + 10);
+    std::vector<ROMOL_SPTR> second(ms.begin() + 10, ms.end());
+    auto net2 = ScaffoldNetwork::createScaffoldNetwork(first, ps);
+    std::stringstream ss;
+    ScaffoldNetwork::writeScaffoldNetwork(net2, ss);
+    ScaffoldNetwork::ScaffoldNetworkCheckpoint checkpoint(net2);
+    ScaffoldNetwork::updateScaffoldNetwork(second, net2, ps);
+    ScaffoldNetwork::appendScaffoldNetworkChanges(net2, checkpoint, ss);
+    ScaffoldNetwork::ScaffoldNetwork net3;
+    ScaffoldNetwork::readScaffoldNetwork(ss, net3);
+    compareNetworks(net3, net);
+  }
+  SECTION("no molCounts") {
+    ps.collectMolCounts = false;
+    auto net2 = ScaffoldNetwork::createScaffoldNetwork(ms, ps);
+    CHECK(net2.molCounts.empty());
+    std::stringstream ss;
+    ScaffoldNetwork::writeScaffoldNetwork(net2, ss);
+    ScaffoldNetwork::ScaffoldNetwork net3;
+    ScaffoldNetwork::readScaffoldNetwork(ss, net3);
+    compareNetworks(net3, net2);
+  }
+  SECTION("bad input") {
+    for (const auto txt :
+         {"N\tc1ccccc1", "C\t0\t1\t1", "N\tc1ccccc1\t1\nE\t0\t1\t1",
+          "N\tc1ccccc1\t1\nE\t0\t0\t6", "N\tc1ccccc1\tfoo",
+          "X\t0"}) {
+      INFO(txt);
+      std::stringstream ss(txt);
+      ScaffoldNetwork::ScaffoldNetwork net2;
+      CHECK_THROWS_AS(ScaffoldNetwork::readScaffoldNetwork(ss, net2),
+                      ValueErrorException);
+    }
+  }
+}
+
+TEST_CASE("scaffold network benchmark", "[.][benchmark]") {
+  auto ms = readNetworkTestMols(500);
+  auto report = [&ms](const std::string &label, const auto &t1) {
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "TIMING : " << label << " took "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                     .count()
+              << " milliseconds for " << ms.size() << " molecules"
+              << std::endl;
+  };
+  ScaffoldNetwork::ScaffoldNetworkParams ps;
+  ScaffoldNetwork::ScaffoldNetwork ref;
+  ScaffoldNetwork::detail::NetworkIndex index(ref);
+  auto t1 = std::chrono::high_resolution_clock::now();
+  for (const auto &m : ms) {
+    ScaffoldNetwork::detail::addMolToNetwork(*m, ref, index, ps);
+  }
+  report("addMolToNetwork one molecule at a time", t1);
+
+  t1 = std::chrono::high_resolution_clock::now();
+  auto net1 = ScaffoldNetwork::createScaffoldNetwork(ms, ps);
+  report("createScaffoldNetwork, 1 thread", t1);
+  compareNetworks(net1, ref);
+
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  ps.numThreads = -1;
+  t1 = std::chrono::high_resolution_clock::now();
+  auto net2 = ScaffoldNetwork::createScaffoldNetwork(ms, ps);
+  report("createScaffoldNetwork, all threads", t1);
+  compareNetworks(net2, ref);
+#endif
+}
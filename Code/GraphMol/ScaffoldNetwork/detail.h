@@ -8,8 +8,12 @@
 //  of the RDKit source tree.
 //
 
+#pragma once
 #include <GraphMol/RDKitBase.h>
 #include <GraphMol/ScaffoldNetwork/ScaffoldNetwork.h>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 // declarations of stuff we want to test that isn't in the public API
 namespace RDKit {
@@ -26,6 +30,36 @@ RDKIT_SCAFFOLDNETWORK_EXPORT ROMol *pruneMol(
     const ROMol &mol, const ScaffoldNetworkParams &params);
 RDKIT_SCAFFOLDNETWORK_EXPORT ROMol *flattenMol(
     const ROMol &mol, const ScaffoldNetworkParams &params);
+
+struct RDKIT_SCAFFOLDNETWORK_EXPORT NetworkEdgeHash {
+  size_t operator()(const NetworkEdge &edge) const;
+};
+
+//! hash lookups for the nodes and edges of a network
+/*!
+  The index has to be built from the network it is used with, and is kept
+  up to date by the functions which add molecules to that network.
+*/
+class RDKIT_SCAFFOLDNETWORK_EXPORT NetworkIndex {
+ public:
+  explicit NetworkIndex(const ScaffoldNetwork &network);
+
+  //! merges the network for a single molecule into \c network. The result
+  //! is the same as adding the molecule to \c network directly.
+  void merge(const ScaffoldNetwork &molNetwork, ScaffoldNetwork &network);
+
+ private:
+  std::unordered_map<std::string, size_t> d_nodes;
+  std::unordered_set<NetworkEdge, NetworkEdgeHash> d_edges;
+};
+
+//! adds a molecule to a network, using an index of that network which is
+//! kept alive across calls
+RDKIT_SCAFFOLDNETWORK_EXPORT void addMolToNetwork(
+    const ROMol &mol, ScaffoldNetwork &network, NetworkIndex &index,
+    const ScaffoldNetworkParams &params);
+//! adds a molecule to a network. This indexes the whole network, use the
+//! overload which takes a NetworkIndex to add many molecules.
 RDKIT_SCAFFOLDNETWORK_EXPORT void addMolToNetwork(
     const ROMol &mol, ScaffoldNetwork &network,
     const ScaffoldNetworkParams &params);
@@ -4650,3 +4650,96 @@ TEST_CASE("Valences on Al, Si, P, As, Sb, Bi") {
     }
   }
 }
+
+TEST_CASE("PDB residue tables", "[PDB]") {
+  std::string pathName = getenv("RDBASE");
+  pathName += "/Code/GraphMol/FileParsers/test_data/1CRN.pdb";
+  std::unique_ptr<RWMol> m(PDBFileToMol(pathName));
+  REQUIRE(m);
+  REQUIRE(!m->getPDBResidueTable());
+  RWMol cm(*m);
+  cm.buildPDBResidueTable();
+  const auto table = cm.getPDBResidueTable();
+  REQUIRE(table);
+  CHECK(table->getNumAtoms() == cm.getNumAtoms());
+  CHECK(table->getNumResidues() == 46);
+
+  SECTION("accessors") {
+    for (const auto atom : cm.atoms()) {
+      const auto info = atom->getMonomerInfo();
+      REQUIRE(info);
+      CHECK(info->isOwnedByResidueTable());
+      CHECK(table->owns(info));
+      const auto orig = static_cast<const AtomPDBResidueInfo *>(
+          m->getAtomWithIdx(atom->getIdx())->getMonomerInfo());
+      const auto pdbInfo = static_cast<const AtomPDBResidueInfo *>(info);
+      CHECK(pdbInfo->getName() == orig->getName());
+      CHECK(pdbInfo->getSerialNumber() == orig->getSerialNumber());
+      CHECK(pdbInfo->getResidueName() == orig->getResidueName());
+      CHECK(pdbInfo->getResidueNumber() == orig->getResidueNumber());
+      auto residx = table->getResidueIndex(info);
+      REQUIRE(residx >= 0);
+      const auto &resInfo = table->getResidueInfo(residx);
+      CHECK(resInfo.getResidueName() == pdbInfo->getResidueName());
+      CHECK(resInfo.getResidueNumber() == pdbInfo->getResidueNumber());
+      CHECK(resInfo.getChainId() == pdbInfo->getChainId());
+      CHECK(resInfo.getInsertionCode() == pdbInfo->getInsertionCode());
+    }
+    CHECK(table->getResidueInfo(0).getResidueName() == "THR");
+    CHECK(table->getResidueInfo(45).getResidueName() == "ASN");
+  }
+  SECTION("copies") {
+    ROMol cp(cm);
+    REQUIRE(cp.getPDBResidueTable());
+    CHECK(cp.getPDBResidueTable() != table);
+    CHECK(cp.getPDBResidueTable()->getNumResidues() == 46);
+    for (const auto atom : cp.atoms()) {
+      CHECK(cp.getPDBResidueTable()->owns(atom->getMonomerInfo()));
+      CHECK(atom->getMonomerInfo()->getName() ==
+            cm.getAtomWithIdx(atom->getIdx())->getMonomerInfo()->getName());
+    }
+    std::unique_ptr<Atom> atomCopy(cm.getAtomWithIdx(0)->copy());
+    REQUIRE(atomCopy->getMonomerInfo());
+    CHECK(!atomCopy->getMonomerInfo()->isOwnedByResidueTable());
+  }
+  SECTION("editing") {
+    cm.removeAtom(0u);
+    REQUIRE(cm.getPDBResidueTable() == table);
+    CHECK(table->getNumAtoms() == cm.getNumAtoms());
+    CHECK(table->getNumResidues() == 46);
+    CHECK(table->getResidueInfo(0).getName() == " CA ");
+    for (unsigned int i = 0; i < table->getNumAtoms(); ++i) {
+      CHECK(table->getAtomIndex(i) == i);
+      const auto info = cm.getAtomWithIdx(i)->getMonomerInfo();
+      CHECK(info == &table->getAtomInfo(i));
+      CHECK(info->isOwnedByResidueTable());
+      CHECK(info->getName() ==
+            m->getAtomWithIdx(i + 1)->getMonomerInfo()->getName());
+    }
+    // removing the last atom of a residue removes the residue
+    for (unsigned int i = cm.getNumAtoms(); i > 0; --i) {
+      if (table->getResidueIndex(cm.getAtomWithIdx(i - 1)->getMonomerInfo()) ==
+          45) {
+        cm.removeAtom(i - 1);
+      }
+    }
+    CHECK(table->getNumResidues() == 45);
+    CHECK(table->getNumAtoms() == cm.getNumAtoms());
+    CHECK(table->getResidueInfo(44).getResidueName() == "ALA");
+    auto atom = new Atom(6);
+    atom->setMonomerInfo(new AtomPDBResidueInfo(" CX ", 1000, "", "UNL"));
+    cm.addAtom(atom, true, true);
+    auto info = static_cast<AtomPDBResidueInfo *>(
+        cm.getAtomWithIdx(0)->getMonomerInfo());
+    info->setResidueName("XXX");
+    cm.buildPDBResidueTable();
+    REQUIRE(cm.getPDBResidueTable());
+    CHECK(cm.getPDBResidueTable()->getNumAtoms() == cm.getNumAtoms());
+    CHECK(cm.getPDBResidueTable()->getNumResidues() == 47);
+    CHECK(atom->getMonomerInfo()->isOwnedByResidueTable());
+    CHECK(atom->getMonomerInfo()->getName() == " CX ");
+    CHECK(static_cast<AtomPDBResidueInfo *>(
+              cm.getAtomWithIdx(0)->getMonomerInfo())
+              ->getResidueName() == "XXX");
+  }
+}
@@ -16,6 +16,7 @@
 
 #include <GraphMol/RDKitBase.h>
 #include <GraphMol/MolPickler.h>
+#include <GraphMol/MonomerInfo.h>
 #include <GraphMol/FileParsers/FileParsers.h>
 #include <GraphMol/SmilesParse/SmilesParse.h>
 #include <GraphMol/SmilesParse/SmilesWrite.h>
@@ -229,3 +230,42 @@ TEST_CASE("parsing old pickles with many features") {
   CHECK(m2.getNumAtoms() == m->getNumAtoms());
   CHECK(MolToCXSmiles(*m) == MolToCXSmiles(m2));
 }
+
+TEST_CASE("pickling PDB residue tables") {
+  std::string pathName = getenv("RDBASE");
+  pathName += "/Code/GraphMol/FileParsers/test_data/1CRN.pdb";
+  std::unique_ptr<RWMol> m(PDBFileToMol(pathName));
+  REQUIRE(m);
+  RWMol cm(*m);
+  cm.buildPDBResidueTable();
+
+  std::string pkl;
+  MolPickler::pickleMol(cm, pkl);
+  ROMol m2(pkl);
+  REQUIRE(m2.getPDBResidueTable());
+  CHECK(m2.getPDBResidueTable()->getNumResidues() == 46);
+  REQUIRE(m2.getNumAtoms() == cm.getNumAtoms());
+  for (unsigned int i = 0; i < m2.getNumAtoms(); ++i) {
+    const auto info1 = static_cast<const AtomPDBResidueInfo *>(
+        cm.getAtomWithIdx(i)->getMonomerInfo());
+    const auto info2 = static_cast<const AtomPDBResidueInfo *>(
+        m2.getAtomWithIdx(i)->getMonomerInfo());
+    REQUIRE(info2);
+    CHECK(m2.getPDBResidueTable()->owns(info2));
+    CHECK(info1->getName() == info2->getName());
+    CHECK(info1->getSerialNumber() == info2->getSerialNumber());
+    CHECK(info1->getResidueName() == info2->getResidueName());
+    CHECK(info1->getResidueNumber() == info2->getResidueNumber());
+    CHECK(info1->getChainId() == info2->getChainId());
+    CHECK(info1->getAltLoc() == info2->getAltLoc());
+    CHECK(info1->getInsertionCode() == info2->getInsertionCode());
+    CHECK(info1->getOccupancy() == info2->getOccupancy());
+    CHECK(info1->getTempFactor() == info2->getTempFactor());
+    CHECK(info1->getIsHeteroAtom() == info2->getIsHeteroAtom());
+  }
+  CHECK(MolToSmiles(m2) == MolToSmiles(cm));
+  // the residue strings are only written once
+  std::string plainPkl;
+  MolPickler::pickleMol(*m, plainPkl);
+  CHECK(pkl.size() < plainPkl.size());
+}
@@ -11,7 +11,10 @@
 #pragma once
 
 #include <cstdlib>
+#include <fstream>
+#include <limits>
 #include <string>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 
@@ -76,4 +79,23 @@ class AllowNontetrahedralChiralityFixture : private TestFixtureTemplate {
             RDKit::Chirality::nonTetrahedralStereoEnvVar,
             &RDKit::Chirality::getAllowNontetrahedralChirality,
             &RDKit::Chirality::setAllowNontetrahedralChirality) {}
-};
\ No newline at end of file
+};
+
+//! returns the SMILES of the ChEMBL molecules in
+//! $RDBASE/Code/GraphMol/RascalMCES/data/chembl_1907596.smi, which are used as
+//! a set of realistic inputs by several tests
+inline std::vector<std::string> readChemblTestSmiles(
+    unsigned int maxToRead = std::numeric_limits<unsigned int>::max()) {
+  std::string rdbase = std::getenv("RDBASE");
+  std::ifstream inf(rdbase +
+                    "/Code/GraphMol/RascalMCES/data/chembl_1907596.smi");
+  std::vector<std::string> res;
+  std::string line;
+  while (res.size() < maxToRead && std::getline(inf, line)) {
+    auto pos = line.find('\t');
+    if (pos != std::string::npos) {
+      res.push_back(line.substr(pos + 1));
+    }
+  }
+  return res;
+}
@@ -751,6 +751,72 @@ void test_fingerprints() {
   printf("--------------------------\n");
 }
 
+void test_batch() {
+  printf("--------------------------\n");
+  printf("  test_batch\n");
+
+  const char *inputs[] = {"c1nccc(O)c1", "not a smiles", "CCO"};
+  size_t *pkl_szs = NULL;
+  assert(!get_mols(NULL, 3, &pkl_szs, NULL));
+  char **pkls = get_mols(inputs, 3, &pkl_szs, "");
+  assert(pkls);
+  assert(pkls[0] && pkl_szs[0]);
+  assert(!pkls[1] && !pkl_szs[1]);
+  assert(pkls[2] && pkl_szs[2]);
+  char *smi = get_smiles(pkls[2], pkl_szs[2], NULL);
+  assert(!strcmp(smi, "CCO"));
+  free(smi);
+
+  size_t nbytes;
+  size_t nbytes_per_fp;
+  char *fps = get_fps_as_bytes((const char **)pkls, pkl_szs, 3, "morgan",
+                               &nbytes_per_fp, "{\"radius\":2,\"nBits\":64}");
+  assert(fps);
+  assert(nbytes_per_fp == 8);
+  for (size_t i = 0; i < 3; ++i) {
+    if (!pkls[i]) {
+      for (size_t j = 0; j < nbytes_per_fp; ++j) {
+        assert(!fps[i * nbytes_per_fp + j]);
+      }
+      continue;
+    }
+    char *fp = get_morgan_fp_as_bytes(pkls[i], pkl_szs[i], &nbytes,
+                                      "{\"radius\":2,\"nBits\":64}");
+    assert(nbytes == nbytes_per_fp);
+    assert(!memcmp(fp, fps + i * nbytes_per_fp, nbytes));
+    free(fp);
+  }
+  free(fps);
+  fps = get_fps_as_bytes((const char **)pkls, pkl_szs, 3, "maccs",
+                         &nbytes_per_fp, NULL);
+  assert(fps);
+  assert(nbytes_per_fp == 21);
+  free(fps);
+  assert(!get_fps_as_bytes((const char **)pkls, pkl_szs, 3, "unknown",
+                           &nbytes_per_fp, NULL));
+
+  char *names = get_descriptor_names();
+  assert(strstr(names, "\"amw\""));
+  free(names);
+  size_t num_descriptors;
+  double *descrs = get_descriptors_as_array((const char **)pkls, pkl_szs, 3,
+                                            &num_descriptors);
+  assert(descrs);
+  assert(num_descriptors > 10);
+  assert(descrs[0] > 0);
+  assert(isnan(descrs[num_descriptors]));
+  assert(descrs[2 * num_descriptors] > 0);
+  free(descrs);
+
+  for (size_t i = 0; i < 3; ++i) {
+    free(pkls[i]);
+  }
+  free(pkls);
+  free(pkl_szs);
+  printf("  done\n");
+  printf("--------------------------\n");
+}
+
 void test_modifications() {
   printf("--------------------------\n");
   printf("  test_modifications\n");
@@ -2604,6 +2670,7 @@ int main() {
   test_substruct();
   test_descriptors();
   test_fingerprints();
+  test_batch();
   test_modifications();
   test_coords();
   test_standardize();
@@ -645,6 +645,110 @@ extern "C" char *get_avalon_fp_as_bytes(const char *mol_pkl, size_t mol_pkl_sz,
 }
 #endif
 
+namespace {
+ROMOL_SPTR mol_sptr_from_pkl(const char *pkl, size_t pkl_sz) {
+  if (!pkl || !pkl_sz) {
+    return ROMOL_SPTR();
+  }
+  return ROMOL_SPTR(new RWMol(mol_from_pkl(pkl, pkl_sz)));
+}
+}  // namespace
+
+extern "C" char **get_mols(const char **inputs, size_t num_inputs,
+                           size_t **pkl_sz_array, const char *details_json) {
+  if (!inputs || !num_inputs || !pkl_sz_array) {
+    return nullptr;
+  }
+  *pkl_sz_array = nullptr;
+  boost::property_tree::ptree pt;
+  try {
+    if (details_json && strlen(details_json)) {
+      std::istringstream ss;
+      ss.str(details_json);
+      boost::property_tree::read_json(ss, pt);
+    }
+  } catch (...) {
+    return nullptr;
+  }
+  char **molPklArray = (char **)malloc(sizeof(char *) * num_inputs);
+  if (!molPklArray) {
+    return nullptr;
+  }
+  *pkl_sz_array = (size_t *)malloc(sizeof(size_t) * num_inputs);
+  if (!*pkl_sz_array) {
+    free(molPklArray);
+    return nullptr;
+  }
+  memset(molPklArray, 0, sizeof(char *) * num_inputs);
+  memset(*pkl_sz_array, 0, sizeof(size_t) * num_inputs);
+  for (size_t i = 0; i < num_inputs; ++i) {
+    if (!inputs[i]) {
+      continue;
+    }
+    std::unique_ptr<RWMol> mol{MinimalLib::mol_from_input(inputs[i], pt)};
+    if (mol) {
+      mol_to_pkl(*mol, &molPklArray[i], &(*pkl_sz_array)[i]);
+    }
+  }
+  return molPklArray;
+}
+
+extern "C" char *get_fps_as_bytes(const char **pkls, const size_t *pkl_szs,
+                                  size_t num_mols, const char *fp_type,
+                                  size_t *nbytes_per_fp,
+                                  const char *details_json) {
+  if (!pkls || !pkl_szs || !num_mols || !fp_type || !nbytes_per_fp) {
+    return nullptr;
+  }
+  try {
+    auto generator = MinimalLib::fp_generator(fp_type, details_json);
+    auto res = MinimalLib::fps_as_packed_bytes(
+        num_mols,
+        [pkls, pkl_szs](size_t i) {
+          return mol_sptr_from_pkl(pkls[i], pkl_szs[i]);
+        },
+        generator, *nbytes_per_fp);
+    if (!*nbytes_per_fp) {
+      return nullptr;
+    }
+    return str_to_c(res);
+  } catch (...) {
+    return nullptr;
+  }
+}
+
+extern "C" char *get_descriptor_names() {
+  rj::Document doc;
+  doc.SetArray();
+  auto &alloc = doc.GetAllocator();
+  for (const auto &name : MinimalLib::get_descriptor_names()) {
+    doc.PushBack(rj::Value(name.c_str(), alloc), alloc);
+  }
+  rj::StringBuffer buffer;
+  rj::Writer<rj::StringBuffer> writer(buffer);
+  doc.Accept(writer);
+  return str_to_c(buffer.GetString());
+}
+
+extern "C" double *get_descriptors_as_array(const char **pkls,
+                                            const size_t *pkl_szs,
+                                            size_t num_mols,
+                                            size_t *num_descriptors) {
+  if (!pkls || !pkl_szs || !num_mols || !num_descriptors) {
+    return nullptr;
+  }
+  auto res = MinimalLib::descriptors_as_array(
+      num_mols, [pkls, pkl_szs](size_t i) {
+        return mol_sptr_from_pkl(pkls[i], pkl_szs[i]);
+      });
+  *num_descriptors = res.size() / num_mols;
+  auto arr = (double *)malloc(sizeof(double) * res.size());
+  if (arr) {
+    memcpy(arr, res.data(), sizeof(double) * res.size());
+  }
+  return arr;
+}
+
 extern "C" void prefer_coordgen(short val) {
 #ifdef RDK_BUILD_COORDGEN_SUPPORT
   RDDepict::preferCoordGen = val;
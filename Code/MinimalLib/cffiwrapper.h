@@ -112,6 +112,24 @@ RDKIT_RDKITCFFI_EXPORT char *get_avalon_fp_as_bytes(const char *pkl,
                                                     const char *details_json);
 #endif
 
+// batch calculations
+// the details are only parsed once and the results for all molecules are
+// returned in a single buffer. Empty or invalid inputs are left as rows of
+// zeros (fingerprints) or NaNs (descriptors).
+RDKIT_RDKITCFFI_EXPORT char **get_mols(const char **inputs, size_t num_inputs,
+                                       size_t **pkl_sz_array,
+                                       const char *details_json);
+RDKIT_RDKITCFFI_EXPORT char *get_fps_as_bytes(const char **pkls,
+                                              const size_t *pkl_szs,
+                                              size_t num_mols,
+                                              const char *fp_type,
+                                              size_t *nbytes_per_fp,
+                                              const char *details_json);
+RDKIT_RDKITCFFI_EXPORT char *get_descriptor_names();
+RDKIT_RDKITCFFI_EXPORT double *get_descriptors_as_array(
+    const char **pkls, const size_t *pkl_szs, size_t num_mols,
+    size_t *num_descriptors);
+
 // modification
 RDKIT_RDKITCFFI_EXPORT short add_hs(char **pkl, size_t *pkl_sz);
 RDKIT_RDKITCFFI_EXPORT short remove_all_hs(char **pkl, size_t *pkl_sz);
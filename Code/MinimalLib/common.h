@@ -50,6 +50,8 @@
 #include <RDGeneral/RDLog.h>
 #include "common_defs.h"
 
+#include <functional>
+#include <limits>
 #include <sstream>
 #include <RDGeneral/BoostStartInclude.h>
 #include <boost/property_tree/ptree.hpp>
@@ -93,8 +95,10 @@ static constexpr int d_defaultHeight = 200;
 #define LPT_OPT_GET(opt) opt = pt.get(#opt, opt);
 #define LPT_OPT_GET2(holder, opt) holder.opt = pt.get(#opt, holder.opt);
 
+// pt holds the already parsed details; this is used by the batch functions
+// so that the JSON is only parsed once
 RWMol *mol_from_input(const std::string &input,
-                      const std::string &details_json = "") {
+                      const boost::property_tree::ptree &pt) {
   bool sanitize = true;
   bool kekulize = true;
   bool removeHs = true;
@@ -105,21 +109,15 @@ RWMol *mol_from_input(const std::string &input,
   bool assignCIPLabels = false;
   bool mappedDummiesAreRGroups = false;
   RWMol *res = nullptr;
-  boost::property_tree::ptree pt;
-  if (!details_json.empty()) {
-    std::istringstream ss;
-    ss.str(details_json);
-    boost::property_tree::read_json(ss, pt);
-    LPT_OPT_GET(sanitize);
-    LPT_OPT_GET(kekulize);
-    LPT_OPT_GET(removeHs);
-    LPT_OPT_GET(mergeQueryHs);
-    LPT_OPT_GET(setAromaticity);
-    LPT_OPT_GET(fastFindRings);
-    LPT_OPT_GET(assignStereo);
-    LPT_OPT_GET(assignCIPLabels);
-    LPT_OPT_GET(mappedDummiesAreRGroups);
-  }
+  LPT_OPT_GET(sanitize);
+  LPT_OPT_GET(kekulize);
+  LPT_OPT_GET(removeHs);
+  LPT_OPT_GET(mergeQueryHs);
+  LPT_OPT_GET(setAromaticity);
+  LPT_OPT_GET(fastFindRings);
+  LPT_OPT_GET(assignStereo);
+  LPT_OPT_GET(assignCIPLabels);
+  LPT_OPT_GET(mappedDummiesAreRGroups);
   try {
     if (input.find("M  END") != std::string::npos) {
       bool strictParsing = false;
@@ -186,6 +184,17 @@ RWMol *mol_from_input(const std::string &input,
   return res;
 }
 
+RWMol *mol_from_input(const std::string &input,
+                      const std::string &details_json = "") {
+  boost::property_tree::ptree pt;
+  if (!details_json.empty()) {
+    std::istringstream ss;
+    ss.str(details_json);
+    boost::property_tree::read_json(ss, pt);
+  }
+  return mol_from_input(input, pt);
+}
+
 RWMol *mol_from_input(const std::string &input, const char *details_json) {
   std::string json;
   if (details_json) {
@@ -766,8 +775,12 @@ std::unique_ptr<RWMol> do_fragment_parent(RWMol &mol,
   return res;
 }
 
-std::unique_ptr<ExplicitBitVect> morgan_fp_as_bitvect(
-    const RWMol &mol, const char *details_json) {
+// the fingerprint functions parse their details when the generator is
+// created, so that the batch functions only need to do this once
+typedef std::function<std::unique_ptr<ExplicitBitVect>(const ROMol &)>
+    BitVectGenerator;
+
+BitVectGenerator morgan_fp_generator(const char *details_json) {
   size_t radius = 2;
   size_t nBits = 2048;
   bool useChirality = false;
@@ -787,14 +800,20 @@ std::unique_ptr<ExplicitBitVect> morgan_fp_as_bitvect(
     LPT_OPT_GET(includeRedundantEnvironments);
     LPT_OPT_GET(onlyNonzeroInvariants);
   }
-  auto fp = MorganFingerprints::getFingerprintAsBitVect(
-      mol, radius, nBits, nullptr, nullptr, useChirality, useBondTypes,
-      onlyNonzeroInvariants, nullptr, includeRedundantEnvironments);
-  return std::unique_ptr<ExplicitBitVect>{fp};
+  return [=](const ROMol &mol) {
+    auto fp = MorganFingerprints::getFingerprintAsBitVect(
+        mol, radius, nBits, nullptr, nullptr, useChirality, useBondTypes,
+        onlyNonzeroInvariants, nullptr, includeRedundantEnvironments);
+    return std::unique_ptr<ExplicitBitVect>{fp};
+  };
 }
 
-std::unique_ptr<ExplicitBitVect> rdkit_fp_as_bitvect(const RWMol &mol,
-                                                     const char *details_json) {
+std::unique_ptr<ExplicitBitVect> morgan_fp_as_bitvect(
+    const RWMol &mol, const char *details_json) {
+  return morgan_fp_generator(details_json)(mol);
+}
+
+BitVectGenerator rdkit_fp_generator(const char *details_json) {
   unsigned int minPath = 1;
   unsigned int maxPath = 7;
   unsigned int nBits = 2048;
@@ -816,13 +835,19 @@ std::unique_ptr<ExplicitBitVect> rdkit_fp_as_bitvect(const RWMol &mol,
     LPT_OPT_GET(branchedPaths);
     LPT_OPT_GET(useBondOrder);
   }
-  auto fp = RDKFingerprintMol(mol, minPath, maxPath, nBits, nBitsPerHash, useHs,
-                              0, 128, branchedPaths, useBondOrder);
-  return std::unique_ptr<ExplicitBitVect>{fp};
+  return [=](const ROMol &mol) {
+    auto fp = RDKFingerprintMol(mol, minPath, maxPath, nBits, nBitsPerHash,
+                                useHs, 0, 128, branchedPaths, useBondOrder);
+    return std::unique_ptr<ExplicitBitVect>{fp};
+  };
 }
 
-std::unique_ptr<ExplicitBitVect> pattern_fp_as_bitvect(
-    const RWMol &mol, const char *details_json) {
+std::unique_ptr<ExplicitBitVect> rdkit_fp_as_bitvect(const RWMol &mol,
+                                                     const char *details_json) {
+  return rdkit_fp_generator(details_json)(mol);
+}
+
+BitVectGenerator pattern_fp_generator(const char *details_json) {
   unsigned int nBits = 2048;
   bool tautomericFingerprint = false;
   if (details_json && strlen(details_json)) {
@@ -834,13 +859,19 @@ std::unique_ptr<ExplicitBitVect> pattern_fp_as_bitvect(
     LPT_OPT_GET(nBits);
     LPT_OPT_GET(tautomericFingerprint);
   }
-  auto fp = PatternFingerprintMol(mol, nBits, nullptr, nullptr,
-                                  tautomericFingerprint);
-  return std::unique_ptr<ExplicitBitVect>{fp};
+  return [=](const ROMol &mol) {
+    auto fp = PatternFingerprintMol(mol, nBits, nullptr, nullptr,
+                                    tautomericFingerprint);
+    return std::unique_ptr<ExplicitBitVect>{fp};
+  };
 }
 
-std::unique_ptr<ExplicitBitVect> topological_torsion_fp_as_bitvect(
+std::unique_ptr<ExplicitBitVect> pattern_fp_as_bitvect(
     const RWMol &mol, const char *details_json) {
+  return pattern_fp_generator(details_json)(mol);
+}
+
+BitVectGenerator topological_torsion_fp_generator(const char *details_json) {
   unsigned int nBits = 2048;
   if (details_json && strlen(details_json)) {
     // FIX: this should eventually be moved somewhere else
@@ -850,13 +881,19 @@ std::unique_ptr<ExplicitBitVect> topological_torsion_fp_as_bitvect(
     boost::property_tree::read_json(ss, pt);
     LPT_OPT_GET(nBits);
   }
-  auto fp =
-      AtomPairs::getHashedTopologicalTorsionFingerprintAsBitVect(mol, nBits);
-  return std::unique_ptr<ExplicitBitVect>{fp};
+  return [=](const ROMol &mol) {
+    auto fp =
+        AtomPairs::getHashedTopologicalTorsionFingerprintAsBitVect(mol, nBits);
+    return std::unique_ptr<ExplicitBitVect>{fp};
+  };
 }
 
-std::unique_ptr<ExplicitBitVect> atom_pair_fp_as_bitvect(
+std::unique_ptr<ExplicitBitVect> topological_torsion_fp_as_bitvect(
     const RWMol &mol, const char *details_json) {
+  return topological_torsion_fp_generator(details_json)(mol);
+}
+
+BitVectGenerator atom_pair_fp_generator(const char *details_json) {
   unsigned int nBits = 2048;
   unsigned int minLength = 1;
   unsigned int maxLength = 30;
@@ -870,9 +907,16 @@ std::unique_ptr<ExplicitBitVect> atom_pair_fp_as_bitvect(
     LPT_OPT_GET(minLength);
     LPT_OPT_GET(maxLength);
   }
-  auto fp = AtomPairs::getHashedAtomPairFingerprintAsBitVect(
-      mol, nBits, minLength, maxLength);
-  return std::unique_ptr<ExplicitBitVect>{fp};
+  return [=](const ROMol &mol) {
+    auto fp = AtomPairs::getHashedAtomPairFingerprintAsBitVect(
+        mol, nBits, minLength, maxLength);
+    return std::unique_ptr<ExplicitBitVect>{fp};
+  };
+}
+
+std::unique_ptr<ExplicitBitVect> atom_pair_fp_as_bitvect(
+    const RWMol &mol, const char *details_json) {
+  return atom_pair_fp_generator(details_json)(mol);
 }
 
 std::unique_ptr<ExplicitBitVect> maccs_fp_as_bitvect(const RWMol &mol) {
@@ -881,8 +925,7 @@ std::unique_ptr<ExplicitBitVect> maccs_fp_as_bitvect(const RWMol &mol) {
 }
 
 #ifdef RDK_BUILD_AVALON_SUPPORT
-std::unique_ptr<ExplicitBitVect> avalon_fp_as_bitvect(
-    const RWMol &mol, const char *details_json) {
+BitVectGenerator avalon_fp_generator(const char *details_json) {
   unsigned int nBits = 512;
   if (details_json && strlen(details_json)) {
     // FIX: this should eventually be moved somewhere else
@@ -892,12 +935,117 @@ std::unique_ptr<ExplicitBitVect> avalon_fp_as_bitvect(
     boost::property_tree::read_json(ss, pt);
     LPT_OPT_GET(nBits);
   }
-  std::unique_ptr<ExplicitBitVect> fp(new ExplicitBitVect(nBits));
-  AvalonTools::getAvalonFP(mol, *fp, nBits);
-  return fp;
+  return [=](const ROMol &mol) {
+    std::unique_ptr<ExplicitBitVect> fp(new ExplicitBitVect(nBits));
+    AvalonTools::getAvalonFP(mol, *fp, nBits);
+    return fp;
+  };
+}
+
+std::unique_ptr<ExplicitBitVect> avalon_fp_as_bitvect(
+    const RWMol &mol, const char *details_json) {
+  return avalon_fp_generator(details_json)(mol);
 }
 #endif
 
+// fpType is one of "morgan", "rdkit", "pattern", "topological_torsion",
+// "atom_pair", "maccs" or "avalon"
+BitVectGenerator fp_generator(const std::string &fpType,
+                              const char *details_json) {
+  if (fpType == "morgan") {
+    return morgan_fp_generator(details_json);
+  } else if (fpType == "rdkit") {
+    return rdkit_fp_generator(details_json);
+  } else if (fpType == "pattern") {
+    return pattern_fp_generator(details_json);
+  } else if (fpType == "topological_torsion") {
+    return topological_torsion_fp_generator(details_json);
+  } else if (fpType == "atom_pair") {
+    return atom_pair_fp_generator(details_json);
+  } else if (fpType == "maccs") {
+    return [](const ROMol &mol) {
+      return std::unique_ptr<ExplicitBitVect>{
+          MACCSFingerprints::getFingerprintAsBitVect(mol)};
+    };
+#ifdef RDK_BUILD_AVALON_SUPPORT
+  } else if (fpType == "avalon") {
+    return avalon_fp_generator(details_json);
+#endif
+  }
+  throw ValueErrorException("unknown fingerprint type: " + fpType);
+}
+
+// the fingerprints of numMols molecules, packed one after the other with the
+// same layout as BitVectToBinaryText(). getMol(i) returns a ROMOL_SPTR to the
+// i-th molecule, which may be null; molecules are requested one at a time so
+// that callers do not need to keep all of them in memory. Null molecules, and
+// molecules for which the fingerprint cannot be calculated, are left as rows
+// of zero bytes. nBytesPerFp is set to the size of each row, 0 if no
+// fingerprint could be calculated at all.
+template <typename MolGetter>
+std::string fps_as_packed_bytes(size_t numMols, MolGetter getMol,
+                                const BitVectGenerator &generator,
+                                size_t &nBytesPerFp) {
+  std::string res;
+  nBytesPerFp = 0;
+  size_t nPending = 0;
+  for (size_t i = 0; i < numMols; ++i) {
+    std::string fpText;
+    try {
+      ROMOL_SPTR mol = getMol(i);
+      if (mol) {
+        auto fp = generator(*mol);
+        fpText = BitVectToBinaryText(*fp);
+      }
+    } catch (...) {
+    }
+    if (!nBytesPerFp && !fpText.empty()) {
+      // the first fingerprint sets the row size; back-fill the rows we
+      // have already skipped
+      nBytesPerFp = fpText.size();
+      res.assign(nPending * nBytesPerFp, '\0');
+      res.reserve(numMols * nBytesPerFp);
+    }
+    if (!nBytesPerFp) {
+      ++nPending;
+    } else if (fpText.size() == nBytesPerFp) {
+      res += fpText;
+    } else {
+      res.append(nBytesPerFp, '\0');
+    }
+  }
+  return res;
+}
+
+// the names of the descriptors calculated by descriptors_as_array()
+std::vector<std::string> get_descriptor_names() {
+  Descriptors::Properties props;
+  return props.getPropertyNames();
+}
+
+// the descriptors of numMols molecules as a row-major array with one row per
+// molecule, getMol() is used as in fps_as_packed_bytes(). Rows for null
+// molecules, and for molecules where the calculation fails, are filled with
+// NaN.
+template <typename MolGetter>
+std::vector<double> descriptors_as_array(size_t numMols, MolGetter getMol) {
+  Descriptors::Properties props;
+  const auto nDescriptors = props.getPropertyNames().size();
+  std::vector<double> res(numMols * nDescriptors,
+                          std::numeric_limits<double>::quiet_NaN());
+  for (size_t i = 0; i < numMols; ++i) {
+    try {
+      ROMOL_SPTR mol = getMol(i);
+      if (mol) {
+        auto dvs = props.computeProperties(*mol);
+        std::copy(dvs.begin(), dvs.end(), res.begin() + i * nDescriptors);
+      }
+    } catch (...) {
+    }
+  }
+  return res;
+}
+
 // If alignOnly is set to true in details_json, original molblock wedging
 // information is preserved, and inverted if needed (in case the rigid-body
 // alignment required a flip around the Z axis).
@@ -258,6 +258,41 @@ emscripten::val get_maccs_fp_as_uint8array(const JSMol &self) {
   return binary_string_to_uint8array(fp);
 }
 
+emscripten::val get_fps_as_uint8array_helper(const JSMolList &self,
+                                            const std::string &fpType,
+                                            const std::string &details) {
+  auto res = self.get_fps_as_binary_text(fpType, details);
+  auto obj = emscripten::val::object();
+  obj.set("fps", binary_string_to_uint8array(res.first));
+  obj.set("nbytes", res.second);
+  return obj;
+}
+
+emscripten::val get_fps_as_uint8array_helper(const JSMolList &self,
+                                            const std::string &fpType) {
+  return get_fps_as_uint8array_helper(self, fpType, "{}");
+}
+
+emscripten::val get_descriptors_as_float64array(const JSMolList &self) {
+  auto vec = self.get_descriptors_as_array();
+  auto res = emscripten::val::global("Float64Array").new_(vec.size());
+  if (!vec.empty()) {
+    emscripten::val view(
+        emscripten::typed_memory_view(vec.size(), vec.data()));
+    res.call<void>("set", view);
+  }
+  return res;
+}
+
+JSMolList *get_mols_helper(const emscripten::val &inputs,
+                           const std::string &details) {
+  return get_mols(emscripten::vecFromJSArray<std::string>(inputs), details);
+}
+
+JSMolList *get_mols_no_details(const emscripten::val &inputs) {
+  return get_mols_helper(inputs, std::string());
+}
+
 emscripten::val get_frags_helper(JSMol &self, const std::string &details) {
   auto res = self.get_frags(details);
   auto obj = emscripten::val::object();
@@ -561,7 +596,22 @@ EMSCRIPTEN_BINDINGS(RDKit_minimal) {
       .function("next", &JSMolList::next, allow_raw_pointers())
       .function("reset", &JSMolList::reset)
       .function("at_end", &JSMolList::at_end)
-      .function("size", &JSMolList::size);
+      .function("size", &JSMolList::size)
+#ifdef __EMSCRIPTEN__
+      .function("get_fps_as_uint8array",
+                select_overload<emscripten::val(const JSMolList &,
+                                                const std::string &,
+                                                const std::string &)>(
+                    get_fps_as_uint8array_helper))
+      .function(
+          "get_fps_as_uint8array",
+          select_overload<emscripten::val(const JSMolList &,
+                                          const std::string &)>(
+              get_fps_as_uint8array_helper))
+      .function("get_descriptors_as_float64array",
+                &get_descriptors_as_float64array)
+#endif
+      ;
 
 #ifdef RDK_BUILD_MINIMAL_LIB_RXN
   class_<JSReaction>("Reaction")
@@ -651,6 +701,9 @@ EMSCRIPTEN_BINDINGS(RDKit_minimal) {
   function("get_mol_from_uint8array", &get_mol_from_uint8array,
            allow_raw_pointers());
   function("get_mol_copy", &get_mol_copy, allow_raw_pointers());
+  function("get_mols", &get_mols_helper, allow_raw_pointers());
+  function("get_mols", &get_mols_no_details, allow_raw_pointers());
+  function("get_descriptor_names", &get_descriptor_names);
   function("get_qmol", &get_qmol, allow_raw_pointers());
   function("enable_logging", &enable_logging);
   function("disable_logging", &disable_logging);
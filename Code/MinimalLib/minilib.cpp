@@ -738,6 +738,21 @@ size_t JSMolList::insert(size_t idx, const JSMol &mol) {
   return res;
 }
 
+std::pair<std::string, size_t> JSMolList::get_fps_as_binary_text(
+    const std::string &fpType, const std::string &details) const {
+  auto generator = MinimalLib::fp_generator(fpType, details.c_str());
+  size_t nBytesPerFp;
+  auto res = MinimalLib::fps_as_packed_bytes(
+      d_mols.size(), [this](size_t i) { return d_mols[i]; }, generator,
+      nBytesPerFp);
+  return std::make_pair(std::move(res), nBytesPerFp);
+}
+
+std::vector<double> JSMolList::get_descriptors_as_array() const {
+  return MinimalLib::descriptors_as_array(
+      d_mols.size(), [this](size_t i) { return d_mols[i]; });
+}
+
 #ifdef RDK_BUILD_MINIMAL_LIB_SUBSTRUCTLIBRARY
 JSSubstructLibrary::JSSubstructLibrary(unsigned int num_bits)
     : d_fpHolder(nullptr) {
@@ -883,6 +898,28 @@ JSMol *get_mol_from_pickle(const std::string &pkl) {
   return mol ? new JSMol(mol) : nullptr;
 }
 
+JSMolList *get_mols(const std::vector<std::string> &inputs,
+                    const std::string &details_json) {
+  boost::property_tree::ptree pt;
+  if (!details_json.empty()) {
+    std::istringstream ss;
+    ss.str(details_json);
+    boost::property_tree::read_json(ss, pt);
+  }
+  std::vector<ROMOL_SPTR> mols;
+  mols.reserve(inputs.size());
+  for (const auto &input : inputs) {
+    // inputs which cannot be parsed are kept as null entries so that the
+    // indices in the list match the indices of the inputs
+    mols.emplace_back(MinimalLib::mol_from_input(input, pt));
+  }
+  return new JSMolList(mols);
+}
+
+std::vector<std::string> get_descriptor_names() {
+  return MinimalLib::get_descriptor_names();
+}
+
 JSMol *get_qmol(const std::string &input) {
   auto mol = MinimalLib::qmol_from_input(input);
   return mol ? new JSMol(mol) : nullptr;
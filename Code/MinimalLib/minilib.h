@@ -177,6 +177,11 @@ class JSMolList {
   bool at_end() const { return d_idx == d_mols.size(); }
   size_t size() const { return d_mols.size(); }
   const std::vector<RDKit::ROMOL_SPTR> &mols() const { return d_mols; }
+  // batch calculations: the details are only parsed once and the results
+  // for all molecules are returned in a single buffer
+  std::pair<std::string, size_t> get_fps_as_binary_text(
+      const std::string &fpType, const std::string &details) const;
+  std::vector<double> get_descriptors_as_array() const;
 
  private:
   std::vector<RDKit::ROMOL_SPTR> d_mols;
@@ -275,6 +280,9 @@ class JSSubstructLibrary {
 std::string get_inchikey_for_inchi(const std::string &input);
 JSMol *get_mol(const std::string &input, const std::string &details_json);
 JSMol *get_mol_from_pickle(const std::string &pkl);
+JSMolList *get_mols(const std::vector<std::string> &inputs,
+                    const std::string &details_json);
+std::vector<std::string> get_descriptor_names();
 JSMol *get_mol_copy(const JSMol &other);
 JSMol *get_qmol(const std::string &input);
 #ifdef RDK_BUILD_MINIMAL_LIB_RXN
@@ -1,6 +1,6 @@
 //
 //
-//  Copyright (C) 2019 Greg Landrum
+//  Copyright (C) 2019-2024 Greg Landrum and other RDKit contributors
 //
 //   @@ All Rights Reserved @@
 //  This file is part of the RDKit.
@@ -9,9 +9,18 @@
 //  of the RDKit source tree.
 //
 
+// checks the canonical SMILES from the MinimalLib and compares the timings
+// of the per-molecule and the batch APIs.
+// Usage: testMinilib [smiles_file], the default is the NCI molecules in
+// $RDBASE/Data/NCI/first_5K.smi repeated to 20000 molecules
 #include <emscripten.h>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <vector>
 #include <MinimalLib/minilib.h>
 
 EMSCRIPTEN_KEEPALIVE
@@ -20,9 +29,109 @@ int lping() {
   return 2;
 }
 
-int main() {
+namespace {
+std::vector<std::string> read_smiles(const std::string &fname) {
+  std::vector<std::string> res;
+  std::ifstream inf(fname);
+  std::string line;
+  while (std::getline(inf, line)) {
+    auto pos = line.find_first_of(" \t");
+    line = line.substr(0, pos);
+    if (!line.empty()) {
+      res.push_back(line);
+    }
+  }
+  return res;
+}
+
+template <typename F>
+void time_it(const std::string &label, size_t nMols, F func) {
+  auto t1 = std::chrono::high_resolution_clock::now();
+  func();
+  auto t2 = std::chrono::high_resolution_clock::now();
+  std::cout << "TIMING : " << label << " took "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1)
+                   .count()
+            << " milliseconds for " << nMols << " molecules" << std::endl;
+}
+
+// unlike assert() this is also checked in release builds
+bool check(bool ok, const std::string &what) {
+  if (!ok) {
+    std::cerr << "FAILED: " << what << std::endl;
+  }
+  return ok;
+}
+}  // namespace
+
+int main(int argc, char *argv[]) {
   std::string smi = "c1ccccc1O";
-  std::string csmi = canon_smiles(smi);
-  std::cerr << csmi << std::endl;
-  assert(smi == "Oc1ccccc1");
-}
\ No newline at end of file
+  std::unique_ptr<JSMol> phenol(get_mol(smi, "{}"));
+  if (!check(phenol && phenol->get_smiles() == "Oc1ccccc1",
+             "canonical SMILES of " + smi)) {
+    return 1;
+  }
+
+  std::vector<std::string> smiles;
+  if (argc > 1) {
+    smiles = read_smiles(argv[1]);
+  } else {
+    const char *rdbase = std::getenv("RDBASE");
+    if (!check(rdbase != nullptr, "RDBASE is set")) {
+      return 1;
+    }
+    auto nci = read_smiles(std::string(rdbase) + "/Data/NCI/first_5K.smi");
+    for (unsigned int i = 0; i < 4; ++i) {
+      smiles.insert(smiles.end(), nci.begin(), nci.end());
+    }
+  }
+  if (!check(!smiles.empty(), "read the SMILES")) {
+    return 1;
+  }
+  const std::string details = R"JSON({"radius":2,"nBits":2048})JSON";
+
+  std::vector<std::unique_ptr<JSMol>> mols;
+  time_it("get_mol", smiles.size(), [&]() {
+    for (const auto &smi : smiles) {
+      mols.emplace_back(get_mol(smi, "{}"));
+    }
+  });
+  std::unique_ptr<JSMolList> molList;
+  time_it("get_mols", smiles.size(),
+          [&]() { molList.reset(get_mols(smiles, "{}")); });
+
+  std::string fps;
+  time_it("get_morgan_fp_as_binary_text", smiles.size(), [&]() {
+    for (const auto &mol : mols) {
+      if (mol) {
+        fps += mol->get_morgan_fp_as_binary_text(details);
+      }
+    }
+  });
+  std::pair<std::string, size_t> batchFps;
+  time_it("JSMolList::get_fps_as_binary_text", smiles.size(), [&]() {
+    batchFps = molList->get_fps_as_binary_text("morgan", details);
+  });
+
+  size_t nDescriptors = 0;
+  time_it("get_descriptors", smiles.size(), [&]() {
+    for (const auto &mol : mols) {
+      if (mol) {
+        nDescriptors += mol->get_descriptors().size();
+      }
+    }
+  });
+  std::vector<double> descriptors;
+  time_it("JSMolList::get_descriptors_as_array", smiles.size(), [&]() {
+    descriptors = molList->get_descriptors_as_array();
+  });
+
+  bool ok = check(molList->size() == smiles.size(), "get_mols size");
+  ok &= check(batchFps.second == 2048 / 8, "fingerprint size");
+  ok &= check(batchFps.first.size() == smiles.size() * batchFps.second,
+              "number of fingerprints");
+  ok &= check(
+      descriptors.size() == smiles.size() * get_descriptor_names().size(),
+      "number of descriptors");
+  return ok ? 0 : 1;
+}
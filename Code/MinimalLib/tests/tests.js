@@ -2249,6 +2249,41 @@ function molListFromSmiArray(smiArray) {
     return molList;
 }
 
+function test_batch() {
+    const smiArray = [ 'c1nccc(O)c1', 'not a smiles', 'CCO' ];
+    const details = JSON.stringify({ radius: 2, nBits: 64 });
+    let molList;
+    try {
+        molList = RDKitModule.get_mols(smiArray, '{}');
+        assert.equal(molList.size(), 3);
+        assert(!molList.at(1));
+        const { fps, nbytes } = molList.get_fps_as_uint8array('morgan', details);
+        assert.equal(nbytes, 8);
+        assert.equal(fps.length, 3 * nbytes);
+        assert(fps.slice(nbytes, 2 * nbytes).every(b => b === 0));
+        [0, 2].forEach((i) => {
+            const mol = molList.at(i);
+            try {
+                assert.deepEqual(fps.slice(i * nbytes, (i + 1) * nbytes),
+                    mol.get_morgan_fp_as_uint8array(details));
+            } finally {
+                mol.delete();
+            }
+        });
+        const names = RDKitModule.get_descriptor_names();
+        const descrs = molList.get_descriptors_as_float64array();
+        assert.equal(descrs.length, 3 * names.size());
+        const amwIdx = [...Array(names.size()).keys()].find(i => names.get(i) === 'amw');
+        assert(Math.abs(descrs[2 * names.size() + amwIdx] - 46.069) < 0.01);
+        assert(isNaN(descrs[names.size() + amwIdx]));
+        names.delete();
+    } finally {
+        if (molList) {
+            molList.delete();
+        }
+    }
+}
+
 function test_mol_list() {
     const smiArray = [ 'C1CC1', 'C1CCCC1' ];
     let molList;
@@ -3102,6 +3137,7 @@ initRDKitModule().then(function(instance) {
     test_alignment_r_groups_aromatic_ring();
     test_is_valid_deprecated();
     test_mol_list();
+    test_batch();
     test_get_num_atoms_bonds();
     if (RDKitModule.get_mcs_as_mol)  {
         test_mcs();
@@ -510,12 +510,16 @@ extern "C" char *makeMolBlob(CROMol data, int *len) {
 }
 
 extern "C" bytea *makeMolSignature(CROMol data) {
+  return makeMolSignatureWithSize(data, getSubstructFpSize());
+}
+
+extern "C" bytea *makeMolSignatureWithSize(CROMol data, int size) {
   auto *mol = (ROMol *)data;
   ExplicitBitVect *res = nullptr;
   bytea *ret = nullptr;
 
   try {
-    res = RDKit::PatternFingerprintMol(*mol, getSubstructFpSize());
+    res = RDKit::PatternFingerprintMol(*mol, size);
     // res =
     // RDKit::LayeredFingerprintMol(*mol,RDKit::substructLayers,1,5,SSS_FP_SIZE);
 
@@ -44,6 +44,15 @@ typedef unsigned long long POPCNT_TYPE;
 
 #endif
 
+/*
+** runtime dispatched AVX2 and AVX-512 kernels are only available with
+** gcc-compatible compilers on x86-64
+*/
+#if defined(RDK_OPTIMIZE_POPCNT) && defined(__GNUC__) && defined(__x86_64__)
+#define RDK_BITSTRING_SIMD
+#include <immintrin.h>
+#endif
+
 #include "bitstring.h"
 
 /* Number of one-bits in an unsigned byte */
@@ -124,7 +133,7 @@ void bitstringIntersection(int length, uint8 *bstr1, uint8 *bstr2) {
   }
 }
 
-int bitstringWeight(int length, uint8 *bstr) {
+static int bitstringWeightScalar(int length, uint8 *bstr) {
   int total_popcount = 0;
   uint8 *bstr_end = bstr + length;
 
@@ -156,7 +165,8 @@ int bitstringWeight(int length, uint8 *bstr) {
   return total_popcount;
 }
 
-int bitstringIntersectionWeight(int length, uint8 *bstr1, uint8 *bstr2) {
+static int bitstringIntersectionWeightScalar(int length, uint8 *bstr1,
+                                               uint8 *bstr2) {
   int intersect_popcount = 0;
   uint8 *bstr1_end = bstr1 + length;
 
@@ -190,7 +200,8 @@ int bitstringIntersectionWeight(int length, uint8 *bstr1, uint8 *bstr2) {
   return intersect_popcount;
 }
 
-int bitstringDifferenceWeight(int length, uint8 *bstr1, uint8 *bstr2) {
+static int bitstringDifferenceWeightScalar(int length, uint8 *bstr1,
+                                             uint8 *bstr2) {
   int difference = 0;
   uint8 *bstr1_end = bstr1 + length;
 
@@ -232,7 +243,8 @@ int bitstringDifferenceWeight(int length, uint8 *bstr1, uint8 *bstr2) {
   return difference;
 }
 
-int bitstringHemDistance(int length, uint8 *bstr1, uint8 *bstr2) {
+static int bitstringHemDistanceScalar(int length, uint8 *bstr1,
+                                       uint8 *bstr2) {
   int difference = 0;
   uint8 *bstr1_end = bstr1 + length;
 
@@ -266,9 +278,9 @@ int bitstringHemDistance(int length, uint8 *bstr1, uint8 *bstr2) {
   return difference;
 }
 
-double bitstringTanimotoSimilarity(int length, uint8 *bstr1, uint8 *bstr2) {
-  double sim;
-
+static void bitstringTanimotoCountsScalar(int length, uint8 *bstr1,
+                                          uint8 *bstr2, int *union_count,
+                                          int *intersect_count) {
   int union_popcount = 0;
   int intersect_popcount = 0;
 
@@ -320,6 +332,226 @@ double bitstringTanimotoSimilarity(int length, uint8 *bstr1, uint8 *bstr2) {
     intersect_popcount += number_of_ones[b1 & b2];
   }
 
+  *union_count += union_popcount;
+  *intersect_count += intersect_popcount;
+}
+
+/*
+** SIMD versions of the counting functions.
+**
+** The extension may be installed on machines other than the one it was
+** built on, so the wider instruction sets are not enabled at compile time.
+** The kernels are compiled for their target with function attributes and
+** the best version supported by the CPU is selected at run time. The
+** kernels process whole vector blocks and leave the remaining bytes to
+** the scalar functions.
+*/
+#ifdef RDK_BITSTRING_SIMD
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+#define AVX512_TARGET __attribute__((target("avx512f,avx512vpopcntdq")))
+
+/* the number of ones in each byte of v, using a nibble lookup table */
+AVX2_TARGET static inline __m256i avx2PopcountBytes(__m256i v) {
+  const __m256i lookup =
+      _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1,
+                       2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0f);
+  __m256i lo = _mm256_and_si256(v, low_mask);
+  __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+  return _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                         _mm256_shuffle_epi8(lookup, hi));
+}
+
+/* add the number of ones in v to the four 64 bit counters in acc */
+AVX2_TARGET static inline __m256i avx2Accumulate(__m256i acc, __m256i v) {
+  return _mm256_add_epi64(
+      acc, _mm256_sad_epu8(avx2PopcountBytes(v), _mm256_setzero_si256()));
+}
+
+AVX2_TARGET static inline int avx2Sum(__m256i acc) {
+  return (int)(_mm256_extract_epi64(acc, 0) + _mm256_extract_epi64(acc, 1) +
+               _mm256_extract_epi64(acc, 2) + _mm256_extract_epi64(acc, 3));
+}
+
+#define AVX2_LOAD(bstr, i) _mm256_loadu_si256(((const __m256i *)(bstr)) + (i))
+#define AVX512_LOAD(bstr, i) \
+  _mm512_loadu_si512((const void *)(((const __m512i *)(bstr)) + (i)))
+
+AVX2_TARGET static int avx2Weight(int length, uint8 *bstr) {
+  int i, nblocks = length / 32;
+  __m256i acc = _mm256_setzero_si256();
+  for (i = 0; i < nblocks; ++i) {
+    acc = avx2Accumulate(acc, AVX2_LOAD(bstr, i));
+  }
+  return avx2Sum(acc) +
+         bitstringWeightScalar(length - 32 * nblocks, bstr + 32 * nblocks);
+}
+
+AVX512_TARGET static int avx512Weight(int length, uint8 *bstr) {
+  int i, nblocks = length / 64;
+  __m512i acc = _mm512_setzero_si512();
+  for (i = 0; i < nblocks; ++i) {
+    acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(AVX512_LOAD(bstr, i)));
+  }
+  return (int)_mm512_reduce_add_epi64(acc) +
+         bitstringWeightScalar(length - 64 * nblocks, bstr + 64 * nblocks);
+}
+
+/*
+** kernels counting the ones in a binary operation on two bitstrings, OP is
+** applied to the vectors a and b
+*/
+#define AVX2_BINARY_COUNT(name, OP, scalar)                                  \
+  AVX2_TARGET static int name(int length, uint8 *bstr1, uint8 *bstr2) {      \
+    int i, nblocks = length / 32;                                            \
+    __m256i acc = _mm256_setzero_si256();                                    \
+    for (i = 0; i < nblocks; ++i) {                                          \
+      __m256i a = AVX2_LOAD(bstr1, i);                                       \
+      __m256i b = AVX2_LOAD(bstr2, i);                                       \
+      acc = avx2Accumulate(acc, OP);                                         \
+    }                                                                        \
+    return avx2Sum(acc) + scalar(length - 32 * nblocks, bstr1 + 32 * nblocks, \
+                                 bstr2 + 32 * nblocks);                      \
+  }
+
+#define AVX512_BINARY_COUNT(name, OP, scalar)                                 \
+  AVX512_TARGET static int name(int length, uint8 *bstr1, uint8 *bstr2) {     \
+    int i, nblocks = length / 64;                                             \
+    __m512i acc = _mm512_setzero_si512();                                     \
+    for (i = 0; i < nblocks; ++i) {                                           \
+      __m512i a = AVX512_LOAD(bstr1, i);                                      \
+      __m512i b = AVX512_LOAD(bstr2, i);                                      \
+      acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(OP));                   \
+    }                                                                         \
+    return (int)_mm512_reduce_add_epi64(acc) +                                \
+           scalar(length - 64 * nblocks, bstr1 + 64 * nblocks,                \
+                  bstr2 + 64 * nblocks);                                      \
+  }
+
+AVX2_BINARY_COUNT(avx2IntersectionWeight, _mm256_and_si256(a, b),
+                  bitstringIntersectionWeightScalar)
+AVX2_BINARY_COUNT(avx2DifferenceWeight, _mm256_andnot_si256(a, b),
+                  bitstringDifferenceWeightScalar)
+AVX2_BINARY_COUNT(avx2HemDistance, _mm256_xor_si256(a, b),
+                  bitstringHemDistanceScalar)
+AVX512_BINARY_COUNT(avx512IntersectionWeight, _mm512_and_si512(a, b),
+                    bitstringIntersectionWeightScalar)
+AVX512_BINARY_COUNT(avx512DifferenceWeight, _mm512_andnot_si512(a, b),
+                    bitstringDifferenceWeightScalar)
+AVX512_BINARY_COUNT(avx512HemDistance, _mm512_xor_si512(a, b),
+                    bitstringHemDistanceScalar)
+
+AVX2_TARGET static void avx2TanimotoCounts(int length, uint8 *bstr1,
+                                           uint8 *bstr2, int *union_count,
+                                           int *intersect_count) {
+  int i, nblocks = length / 32;
+  __m256i union_acc = _mm256_setzero_si256();
+  __m256i intersect_acc = _mm256_setzero_si256();
+  for (i = 0; i < nblocks; ++i) {
+    __m256i a = AVX2_LOAD(bstr1, i);
+    __m256i b = AVX2_LOAD(bstr2, i);
+    union_acc = avx2Accumulate(union_acc, _mm256_or_si256(a, b));
+    intersect_acc = avx2Accumulate(intersect_acc, _mm256_and_si256(a, b));
+  }
+  *union_count += avx2Sum(union_acc);
+  *intersect_count += avx2Sum(intersect_acc);
+  bitstringTanimotoCountsScalar(length - 32 * nblocks, bstr1 + 32 * nblocks,
+                                bstr2 + 32 * nblocks, union_count,
+                                intersect_count);
+}
+
+AVX512_TARGET static void avx512TanimotoCounts(int length, uint8 *bstr1,
+                                               uint8 *bstr2, int *union_count,
+                                               int *intersect_count) {
+  int i, nblocks = length / 64;
+  __m512i union_acc = _mm512_setzero_si512();
+  __m512i intersect_acc = _mm512_setzero_si512();
+  for (i = 0; i < nblocks; ++i) {
+    __m512i a = AVX512_LOAD(bstr1, i);
+    __m512i b = AVX512_LOAD(bstr2, i);
+    union_acc =
+        _mm512_add_epi64(union_acc, _mm512_popcnt_epi64(_mm512_or_si512(a, b)));
+    intersect_acc = _mm512_add_epi64(
+        intersect_acc, _mm512_popcnt_epi64(_mm512_and_si512(a, b)));
+  }
+  *union_count += (int)_mm512_reduce_add_epi64(union_acc);
+  *intersect_count += (int)_mm512_reduce_add_epi64(intersect_acc);
+  bitstringTanimotoCountsScalar(length - 64 * nblocks, bstr1 + 64 * nblocks,
+                                bstr2 + 64 * nblocks, union_count,
+                                intersect_count);
+}
+#endif
+
+typedef int (*BitstringCountFunc)(int length, uint8 *bstr1, uint8 *bstr2);
+
+/* the implementations of the counting functions selected for this CPU */
+static struct {
+  bool initialized;
+  int (*weight)(int length, uint8 *bstr);
+  BitstringCountFunc intersectionWeight;
+  BitstringCountFunc differenceWeight;
+  BitstringCountFunc hemDistance;
+  void (*tanimotoCounts)(int length, uint8 *bstr1, uint8 *bstr2,
+                         int *union_count, int *intersect_count);
+} bitstringKernels;
+
+static void initBitstringKernels(void) {
+  bitstringKernels.weight = bitstringWeightScalar;
+  bitstringKernels.intersectionWeight = bitstringIntersectionWeightScalar;
+  bitstringKernels.differenceWeight = bitstringDifferenceWeightScalar;
+  bitstringKernels.hemDistance = bitstringHemDistanceScalar;
+  bitstringKernels.tanimotoCounts = bitstringTanimotoCountsScalar;
+#ifdef RDK_BITSTRING_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512vpopcntdq")) {
+    bitstringKernels.weight = avx512Weight;
+    bitstringKernels.intersectionWeight = avx512IntersectionWeight;
+    bitstringKernels.differenceWeight = avx512DifferenceWeight;
+    bitstringKernels.hemDistance = avx512HemDistance;
+    bitstringKernels.tanimotoCounts = avx512TanimotoCounts;
+  } else if (__builtin_cpu_supports("avx2")) {
+    bitstringKernels.weight = avx2Weight;
+    bitstringKernels.intersectionWeight = avx2IntersectionWeight;
+    bitstringKernels.differenceWeight = avx2DifferenceWeight;
+    bitstringKernels.hemDistance = avx2HemDistance;
+    bitstringKernels.tanimotoCounts = avx2TanimotoCounts;
+  }
+#endif
+  bitstringKernels.initialized = true;
+}
+
+#define BITSTRING_KERNEL(name)     \
+  (bitstringKernels.initialized    \
+       ? bitstringKernels.name     \
+       : (initBitstringKernels(), bitstringKernels.name))
+
+int bitstringWeight(int length, uint8 *bstr) {
+  return BITSTRING_KERNEL(weight)(length, bstr);
+}
+
+int bitstringIntersectionWeight(int length, uint8 *bstr1, uint8 *bstr2) {
+  return BITSTRING_KERNEL(intersectionWeight)(length, bstr1, bstr2);
+}
+
+/* the number of bits set in bstr2 and not in bstr1 */
+int bitstringDifferenceWeight(int length, uint8 *bstr1, uint8 *bstr2) {
+  return BITSTRING_KERNEL(differenceWeight)(length, bstr1, bstr2);
+}
+
+int bitstringHemDistance(int length, uint8 *bstr1, uint8 *bstr2) {
+  return BITSTRING_KERNEL(hemDistance)(length, bstr1, bstr2);
+}
+
+double bitstringTanimotoSimilarity(int length, uint8 *bstr1, uint8 *bstr2) {
+  double sim;
+
+  int union_popcount = 0;
+  int intersect_popcount = 0;
+
+  BITSTRING_KERNEL(tanimotoCounts)
+  (length, bstr1, bstr2, &union_popcount, &intersect_popcount);
+
   if (union_popcount != 0) {
     sim = ((double)intersect_popcount) / union_popcount;
   } else {
@@ -0,0 +1,150 @@
+//
+//  Copyright (C) 2026 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+
+/*
+** Compares the SIMD bitstring kernels with the scalar versions.
+**
+** The kernels are static and only one of them is selected at run time, so
+** the regression tests only exercise the one that the machine running them
+** supports. This program includes bitstring.c directly and calls each
+** kernel the CPU supports on random inputs of many lengths, including odd
+** lengths and unaligned buffers.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <postgres.h>
+
+/* bitstring.c only needs these for bitstringRandomSubset() */
+void *palloc(Size size) { return malloc(size); }
+void pfree(void *pointer) { free(pointer); }
+#undef Assert
+#define Assert(condition) ((void)0)
+
+#include "bitstring.c"
+
+#ifdef RDK_BITSTRING_SIMD
+
+#define MAX_LENGTH 1100
+
+static unsigned long long rngState = 0x9E3779B97F4A7C15ULL;
+
+static uint8 nextByte(void) {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 7;
+  rngState ^= rngState << 17;
+  return (uint8)(rngState >> 24);
+}
+
+typedef struct {
+  const char *name;
+  int (*weight)(int length, uint8 *bstr);
+  BitstringCountFunc intersectionWeight;
+  BitstringCountFunc differenceWeight;
+  BitstringCountFunc hemDistance;
+  void (*tanimotoCounts)(int length, uint8 *bstr1, uint8 *bstr2,
+                         int *union_count, int *intersect_count);
+} KernelSet;
+
+static int numFailures = 0;
+
+static void check(const KernelSet *kernels, const char *func, int length,
+                  int offset, int expected, int result) {
+  if (expected != result) {
+    fprintf(stderr, "%s %s: length %d offset %d: expected %d, got %d\n",
+            kernels->name, func, length, offset, expected, result);
+    ++numFailures;
+  }
+}
+
+static void compareKernels(const KernelSet *kernels, int length, int offset,
+                           uint8 *bstr1, uint8 *bstr2) {
+  int expUnion = 0, expIntersect = 0, resUnion = 0, resIntersect = 0;
+
+  check(kernels, "weight", length, offset, bitstringWeightScalar(length, bstr1),
+        kernels->weight(length, bstr1));
+  check(kernels, "intersectionWeight", length, offset,
+        bitstringIntersectionWeightScalar(length, bstr1, bstr2),
+        kernels->intersectionWeight(length, bstr1, bstr2));
+  check(kernels, "differenceWeight", length, offset,
+        bitstringDifferenceWeightScalar(length, bstr1, bstr2),
+        kernels->differenceWeight(length, bstr1, bstr2));
+  check(kernels, "hemDistance", length, offset,
+        bitstringHemDistanceScalar(length, bstr1, bstr2),
+        kernels->hemDistance(length, bstr1, bstr2));
+  bitstringTanimotoCountsScalar(length, bstr1, bstr2, &expUnion,
+                                &expIntersect);
+  kernels->tanimotoCounts(length, bstr1, bstr2, &resUnion, &resIntersect);
+  check(kernels, "tanimotoCounts (union)", length, offset, expUnion, resUnion);
+  check(kernels, "tanimotoCounts (intersection)", length, offset,
+        expIntersect, resIntersect);
+}
+
+static void testKernels(const KernelSet *kernels) {
+  /* one extra byte so that the buffers can be used at an odd offset */
+  static uint8 buf1[MAX_LENGTH + 1], buf2[MAX_LENGTH + 1];
+  int length, offset, i;
+
+  for (length = 0; length <= MAX_LENGTH;
+       length += (length < 300 ? 1 : 61)) {
+    for (offset = 0; offset <= 1; ++offset) {
+      for (i = 0; i < length; ++i) {
+        buf1[offset + i] = nextByte();
+        buf2[offset + i] = nextByte();
+      }
+      compareKernels(kernels, length, offset, buf1 + offset, buf2 + offset);
+
+      /* all bits set in one of the inputs */
+      for (i = 0; i < length; ++i) {
+        buf1[offset + i] = 0xFF;
+      }
+      compareKernels(kernels, length, offset, buf1 + offset, buf2 + offset);
+      compareKernels(kernels, length, offset, buf2 + offset, buf1 + offset);
+    }
+  }
+  printf("%s kernels tested\n", kernels->name);
+}
+
+int main(void) {
+  const KernelSet avx2Kernels = {"AVX2",
+                                 avx2Weight,
+                                 avx2IntersectionWeight,
+                                 avx2DifferenceWeight,
+                                 avx2HemDistance,
+                                 avx2TanimotoCounts};
+  const KernelSet avx512Kernels = {"AVX-512",
+                                   avx512Weight,
+                                   avx512IntersectionWeight,
+                                   avx512DifferenceWeight,
+                                   avx512HemDistance,
+                                   avx512TanimotoCounts};
+
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    testKernels(&avx2Kernels);
+  } else {
+    printf("AVX2 is not supported, skipping its kernels\n");
+  }
+  if (__builtin_cpu_supports("avx512vpopcntdq")) {
+    testKernels(&avx512Kernels);
+  } else {
+    printf("AVX-512 VPOPCNTDQ is not supported, skipping its kernels\n");
+  }
+  return numFailures ? 1 : 0;
+}
+
+#else
+
+int main(void) {
+  printf("the SIMD bitstring kernels are not available in this build\n");
+  return 0;
+}
+
+#endif
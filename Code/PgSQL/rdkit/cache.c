@@ -32,10 +32,14 @@
 //
 #include <postgres.h>
 #include <fmgr.h>
+#include <funcapi.h>
+#include <access/hash.h>
+#include <access/htup_details.h>
 #include <utils/memutils.h>
 
 #include "rdkit.h"
 #include "cache.h"
+#include "guc.h"
 
 #define MAGICKNUMBER 0xBEEC0DED
 /*
@@ -76,6 +80,9 @@ typedef struct ValueCacheEntry {
     } reaction;
   } detoasted;
 
+  /* the backend cache entry owning detoasted.*.mol/fp, if any */
+  struct BackendCacheEntry *shared;
+
   struct ValueCacheEntry *prev;
   struct ValueCacheEntry *next;
 } ValueCacheEntry;
@@ -143,6 +150,286 @@ static int cmpDatum(Datum a, Datum b) {
   return (la > lb) ? 1 : -1;
 }
 
+/*********** Backend cache **********/
+
+/*
+ * The value caches above are allocated in the memory context of a function
+ * call and go away at the end of each query. The deserialized molecules and
+ * fingerprints are additionally kept in a cache which lives as long as the
+ * backend, so that the same values don't need to be unpickled again by every
+ * query.
+ *
+ * The entries are looked up by the hash of the detoasted value and kept in
+ * LRU order. The value caches reference the objects in this cache instead of
+ * owning them; referenced entries are never evicted. The maximum number of
+ * entries is set with the rdkit.backend_cache_size GUC.
+ */
+
+typedef struct BackendCacheEntry {
+  uint32 hash;
+  EntryKind kind;
+  bytea *value;   /* a copy of the detoasted value */
+  void *internal; /* CROMol, CBfp or CSfp */
+  int32 refcount; /* the number of value cache entries using this one */
+
+  struct BackendCacheEntry *chain; /* next entry in the same bucket */
+  struct BackendCacheEntry *prev;
+  struct BackendCacheEntry *next;
+} BackendCacheEntry;
+
+#define BACKEND_CACHE_MIN_BUCKETS (256)
+
+typedef struct BackendCache {
+  MemoryContext ctx;
+  int32 nbuckets;
+  BackendCacheEntry **buckets;
+  BackendCacheEntry *head;
+  BackendCacheEntry *tail;
+  int64 nentries;
+  int64 hits;
+  int64 misses;
+  int64 evictions;
+} BackendCache;
+
+static BackendCache *backendCache = NULL;
+
+static bool isBackendCacheKind(EntryKind kind) {
+  return kind == MolKind || kind == BfpKind || kind == SfpKind;
+}
+
+static void *constructInternal(EntryKind kind, void *value) {
+  switch (kind) {
+    case MolKind:
+      return constructROMol((Mol *)value);
+    case BfpKind:
+      return constructCBfp((Bfp *)value);
+    case SfpKind:
+      return constructCSfp((Sfp *)value);
+    default:
+      elog(ERROR, "Unknown kind: %d", kind);
+  }
+  return NULL;
+}
+
+static void freeInternal(EntryKind kind, void *internal) {
+  switch (kind) {
+    case MolKind:
+      freeCROMol((CROMol)internal);
+      break;
+    case BfpKind:
+      freeCBfp((CBfp)internal);
+      break;
+    case SfpKind:
+      freeCSfp((CSfp)internal);
+      break;
+    default:
+      elog(ERROR, "Unknown kind: %d", kind);
+  }
+}
+
+static void unlinkBackendEntry(BackendCacheEntry *entry) {
+  BackendCacheEntry **link =
+      &backendCache->buckets[entry->hash % backendCache->nbuckets];
+
+  while (*link != entry) {
+    link = &(*link)->chain;
+  }
+  *link = entry->chain;
+
+  if (entry->prev) {
+    entry->prev->next = entry->next;
+  } else {
+    backendCache->head = entry->next;
+  }
+  if (entry->next) {
+    entry->next->prev = entry->prev;
+  } else {
+    backendCache->tail = entry->prev;
+  }
+  entry->prev = entry->next = NULL;
+}
+
+static void linkBackendEntry(BackendCacheEntry *entry) {
+  BackendCacheEntry **bucket =
+      &backendCache->buckets[entry->hash % backendCache->nbuckets];
+
+  entry->chain = *bucket;
+  *bucket = entry;
+
+  entry->prev = NULL;
+  entry->next = backendCache->head;
+  if (backendCache->head) {
+    backendCache->head->prev = entry;
+  } else {
+    backendCache->tail = entry;
+  }
+  backendCache->head = entry;
+}
+
+/* double the number of buckets once the chains get long */
+static void growBackendCache(void) {
+  BackendCacheEntry *entry;
+  int32 nbuckets = 2 * backendCache->nbuckets;
+
+  pfree(backendCache->buckets);
+  backendCache->buckets = MemoryContextAllocZero(
+      backendCache->ctx, nbuckets * sizeof(BackendCacheEntry *));
+  backendCache->nbuckets = nbuckets;
+
+  for (entry = backendCache->head; entry; entry = entry->next) {
+    BackendCacheEntry **bucket = &backendCache->buckets[entry->hash % nbuckets];
+    entry->chain = *bucket;
+    *bucket = entry;
+  }
+}
+
+/*
+ * remove unreferenced entries, starting from the least recently used one,
+ * until at most maxEntries are left
+ */
+static void evictBackendEntries(int64 maxEntries) {
+  BackendCacheEntry *entry = backendCache->tail;
+
+  while (entry && backendCache->nentries > maxEntries) {
+    BackendCacheEntry *prev = entry->prev;
+    if (entry->refcount == 0) {
+      unlinkBackendEntry(entry);
+      freeInternal(entry->kind, entry->internal);
+      pfree(entry->value);
+      pfree(entry);
+      backendCache->nentries--;
+      backendCache->evictions++;
+    }
+    entry = prev;
+  }
+}
+
+/*
+ * return the backend cache entry for the detoasted value, creating it
+ * if needed. The entry is referenced and must be released with
+ * releaseBackendEntry().
+ *
+ * NULL is returned if the cache is disabled or full of referenced
+ * entries; the caller then builds its own copy of the value.
+ */
+static BackendCacheEntry *acquireBackendEntry(EntryKind kind, void *value) {
+  int maxEntries = getBackendCacheSize();
+  uint32 hash;
+  BackendCacheEntry *entry;
+  void *internal;
+
+  if (maxEntries <= 0) {
+    if (backendCache) {
+      evictBackendEntries(0);
+    }
+    return NULL;
+  }
+
+  if (!backendCache) {
+    MemoryContext ctx = AllocSetContextCreate(
+        TopMemoryContext, "RDKit backend cache", ALLOCSET_DEFAULT_SIZES);
+    backendCache = MemoryContextAllocZero(ctx, sizeof(BackendCache));
+    backendCache->ctx = ctx;
+    backendCache->nbuckets = BACKEND_CACHE_MIN_BUCKETS;
+    backendCache->buckets = MemoryContextAllocZero(
+        ctx, BACKEND_CACHE_MIN_BUCKETS * sizeof(BackendCacheEntry *));
+  }
+
+  /* the size may have been reduced since the last call */
+  if (backendCache->nentries > maxEntries) {
+    evictBackendEntries(maxEntries);
+  }
+
+  hash = DatumGetUInt32(
+      hash_any((unsigned char *)value, VARSIZE((struct varlena *)value)));
+  for (entry = backendCache->buckets[hash % backendCache->nbuckets]; entry;
+       entry = entry->chain) {
+    if (entry->hash == hash && entry->kind == kind &&
+        VARSIZE(entry->value) == VARSIZE((struct varlena *)value) &&
+        memcmp(entry->value, value, VARSIZE(entry->value)) == 0) {
+      /* move it to the head of the LRU list */
+      unlinkBackendEntry(entry);
+      linkBackendEntry(entry);
+      entry->refcount++;
+      backendCache->hits++;
+      return entry;
+    }
+  }
+  backendCache->misses++;
+
+  /* make room for the new entry */
+  evictBackendEntries(maxEntries - 1);
+  if (backendCache->nentries >= maxEntries) {
+    return NULL;
+  }
+
+  /*
+   * build the value before allocating the entry, this may throw an error
+   * and we don't want to leave a half-initialized entry around
+   */
+  internal = constructInternal(kind, value);
+
+  entry = MemoryContextAllocZero(backendCache->ctx, sizeof(BackendCacheEntry));
+  entry->hash = hash;
+  entry->kind = kind;
+  entry->value = MemoryContextAlloc(backendCache->ctx,
+                                    VARSIZE((struct varlena *)value));
+  memcpy(entry->value, value, VARSIZE((struct varlena *)value));
+  entry->internal = internal;
+  entry->refcount = 1;
+
+  if (backendCache->nentries >= 2 * backendCache->nbuckets) {
+    growBackendCache();
+  }
+  linkBackendEntry(entry);
+  backendCache->nentries++;
+
+  return entry;
+}
+
+static void releaseBackendEntry(BackendCacheEntry *entry) {
+  Assert(entry->refcount > 0);
+  entry->refcount--;
+}
+
+/*
+ * build the internal representation for a value cache entry, sharing it
+ * with the backend cache when possible
+ */
+static void *fetchInternal(ValueCacheEntry *entry, void *value) {
+  if (isBackendCacheKind(entry->kind)) {
+    entry->shared = acquireBackendEntry(entry->kind, value);
+    if (entry->shared) {
+      return entry->shared->internal;
+    }
+  }
+  return constructInternal(entry->kind, value);
+}
+
+/*
+ * SQL function returning the backend cache statistics
+ */
+PGDLLEXPORT Datum rdkit_backend_cache_stats(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(rdkit_backend_cache_stats);
+Datum rdkit_backend_cache_stats(PG_FUNCTION_ARGS) {
+  TupleDesc tupdesc;
+  Datum values[5];
+  bool nulls[5] = {false, false, false, false, false};
+
+  if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE) {
+    elog(ERROR, "return type must be a row type");
+  }
+  tupdesc = BlessTupleDesc(tupdesc);
+
+  values[0] = Int64GetDatum(backendCache ? backendCache->nentries : 0);
+  values[1] = Int32GetDatum(getBackendCacheSize());
+  values[2] = Int64GetDatum(backendCache ? backendCache->hits : 0);
+  values[3] = Int64GetDatum(backendCache ? backendCache->misses : 0);
+  values[4] = Int64GetDatum(backendCache ? backendCache->evictions : 0);
+
+  PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
+}
+
 /*
  * free the memory allocated by a cache entry to hold the
  * toasted, detoasted and signature values (called when the
@@ -157,7 +444,9 @@ static void cleanupData(ValueCacheEntry *entry) {
       if (entry->detoasted.mol.value) {
         pfree(entry->detoasted.mol.value);
       }
-      if (entry->detoasted.mol.mol) {
+      if (entry->shared) {
+        releaseBackendEntry(entry->shared);
+      } else if (entry->detoasted.mol.mol) {
         freeCROMol(entry->detoasted.mol.mol);
       }
       if (entry->detoasted.mol.sign) {
@@ -179,7 +468,9 @@ static void cleanupData(ValueCacheEntry *entry) {
       if (entry->detoasted.bfp.value) {
         pfree(entry->detoasted.bfp.value);
       }
-      if (entry->detoasted.bfp.fp) {
+      if (entry->shared) {
+        releaseBackendEntry(entry->shared);
+      } else if (entry->detoasted.bfp.fp) {
         freeCBfp(entry->detoasted.bfp.fp);
       }
       if (entry->detoasted.bfp.sign) {
@@ -190,7 +481,9 @@ static void cleanupData(ValueCacheEntry *entry) {
       if (entry->detoasted.sfp.value) {
         pfree(entry->detoasted.sfp.value);
       }
-      if (entry->detoasted.sfp.fp) {
+      if (entry->shared) {
+        releaseBackendEntry(entry->shared);
+      } else if (entry->detoasted.sfp.fp) {
         freeCSfp(entry->detoasted.sfp.fp);
       }
       if (entry->detoasted.sfp.sign) {
@@ -388,7 +681,8 @@ static void fetchData(ValueCache *ac, ValueCacheEntry *entry, void **detoasted,
       if (internal) {
         if (entry->detoasted.mol.mol == NULL) {
           fetchData(ac, entry, &_tmp, NULL, NULL);
-          entry->detoasted.mol.mol = constructROMol(entry->detoasted.mol.value);
+          entry->detoasted.mol.mol =
+              fetchInternal(entry, entry->detoasted.mol.value);
         }
         *internal = entry->detoasted.mol.mol;
       }
@@ -455,7 +749,8 @@ static void fetchData(ValueCache *ac, ValueCacheEntry *entry, void **detoasted,
       if (internal) {
         if (entry->detoasted.bfp.fp == NULL) {
           fetchData(ac, entry, &_tmp, NULL, NULL);
-          entry->detoasted.bfp.fp = constructCBfp(entry->detoasted.bfp.value);
+          entry->detoasted.bfp.fp =
+              fetchInternal(entry, entry->detoasted.bfp.value);
         }
         *internal = entry->detoasted.bfp.fp;
       }
@@ -486,7 +781,8 @@ static void fetchData(ValueCache *ac, ValueCacheEntry *entry, void **detoasted,
       if (internal) {
         if (entry->detoasted.sfp.fp == NULL) {
           fetchData(ac, entry, &_tmp, NULL, NULL);
-          entry->detoasted.sfp.fp = constructCSfp(entry->detoasted.sfp.value);
+          entry->detoasted.sfp.fp =
+              fetchInternal(entry, entry->detoasted.sfp.value);
         }
         *internal = entry->detoasted.sfp.fp;
       }
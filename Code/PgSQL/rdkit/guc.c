@@ -46,6 +46,7 @@ static bool rdkit_ignore_reaction_agents = false;
 static bool rdkit_move_unmmapped_reactants_to_agents = true;
 static bool rdkit_init_reaction = true;
 static bool rdkit_guc_inited = false;
+static int rdkit_backend_cache_size = 1024;
 
 #define SSS_FP_SIZE 2048
 #define LAYERED_FP_SIZE 1024
@@ -202,6 +203,12 @@ static void initRDKitGUC() {
       "rdkit.avalon_fp_size", "Size (in bits) of avalon fingerprints",
       "Size (in bits) of avalon fingerprints", &rdkit_avalon_fp_size,
       AVALON_FP_SIZE, 64, 9192, PGC_USERSET, 0, NULL, NULL, NULL);
+  DefineCustomIntVariable(
+      "rdkit.backend_cache_size",
+      "Maximum number of molecules and fingerprints kept in the backend cache",
+      "Deserialized molecules and fingerprints are kept for the lifetime of the backend, so that they are not rebuilt by every query. 0 disables the cache.",
+      &rdkit_backend_cache_size, 1024, 0, 1000000, PGC_USERSET, 0, NULL, NULL,
+      NULL);
   rdkit_guc_inited = true;
 }
 
@@ -324,5 +331,10 @@ int getReactionDifferenceFPWeightNonagents(void) {
   return rdkit_difference_FP_weight_nonagents;
 }
 
+int getBackendCacheSize(void) {
+  if (!rdkit_guc_inited) initRDKitGUC();
+  return rdkit_backend_cache_size;
+}
+
 PGDLLEXPORT void _PG_init(void);
 void _PG_init(void) { initRDKitGUC(); }
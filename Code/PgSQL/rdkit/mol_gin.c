@@ -0,0 +1,175 @@
+//
+//  Copyright (c) 2024, Greg Landrum and other RDKit contributors
+//  All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//     * Neither the name of the authors nor the names of their contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+
+#include <postgres.h>
+
+#include <access/gin.h>
+#include <access/stratnum.h>
+#include <fmgr.h>
+
+#include "rdkit.h"
+#include "bitstring.h"
+#include "cache.h"
+
+/*
+ * GIN support for substructure searches on mol columns
+ *
+ * The keys are the bits set in the pattern fingerprint of the molecules, a
+ * molecule can only contain the query if it has all the bits of the query.
+ * The matches are always rechecked with a substructure search.
+ *
+ * The size of the fingerprint is fixed instead of using rdkit.sss_fp_size:
+ * keys computed with a different size would silently give wrong results.
+ */
+#define MOL_GIN_FP_SIZE (2048)
+
+static Datum *gin_mol_extract(FunctionCallInfo fcinfo, Datum value,
+                              int32 *nkeys) {
+  Datum *keys = NULL;
+  CROMol mol;
+  bytea *sign;
+  int32 weight, siglen;
+  uint8 *fp;
+
+  fcinfo->flinfo->fn_extra =
+      searchMolCache(fcinfo->flinfo->fn_extra, fcinfo->flinfo->fn_mcxt, value,
+                     NULL, &mol, NULL);
+
+  sign = makeMolSignatureWithSize(mol, MOL_GIN_FP_SIZE);
+  siglen = VARSIZE(sign) - VARHDRSZ;
+  fp = (uint8 *)VARDATA(sign);
+
+  *nkeys = weight = bitstringWeight(siglen, fp);
+
+  if (weight != 0) {
+    int32 i, j, keycount;
+
+    keys = palloc(sizeof(Datum) * weight);
+
+    for (keycount = 0, i = 0; i < siglen; ++i) {
+      uint8 byte = fp[i];
+      for (j = 0; j < 8; ++j) {
+        if (byte & 0x01) {
+          int32 key = 8 * i + j;
+          keys[keycount++] = Int32GetDatum(key);
+        }
+        byte >>= 1;
+      }
+    }
+  }
+  pfree(sign);
+
+  return keys;
+}
+
+PGDLLEXPORT Datum gin_mol_extract_value(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(gin_mol_extract_value);
+Datum gin_mol_extract_value(PG_FUNCTION_ARGS) {
+  int32 *nkeys = (int32 *)PG_GETARG_POINTER(1);
+
+  PG_RETURN_POINTER(gin_mol_extract(fcinfo, PG_GETARG_DATUM(0), nkeys));
+}
+
+PGDLLEXPORT Datum gin_mol_extract_query(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(gin_mol_extract_query);
+Datum gin_mol_extract_query(PG_FUNCTION_ARGS) {
+  int32 *nkeys = (int32 *)PG_GETARG_POINTER(1);
+  StrategyNumber strategy = PG_GETARG_UINT16(2);
+  /* bool **pmatch = (bool **) PG_GETARG_POINTER(3); */
+  /* Pointer **extra_data = (Pointer **) PG_GETARG_POINTER(4); */
+  /* bool **nullFlags = (bool **) PG_GETARG_POINTER(5); */
+  int32 *searchMode = (int32 *)PG_GETARG_POINTER(6);
+
+  Datum *keys;
+
+  if (strategy != RDKitContains && strategy != RDKitEquals) {
+    elog(ERROR, "Unknown strategy: %d", strategy);
+  }
+
+  keys = gin_mol_extract(fcinfo, PG_GETARG_DATUM(0), nkeys);
+
+  /* queries without any bits set can match anything */
+  if (*nkeys == 0) {
+    *searchMode = GIN_SEARCH_MODE_ALL;
+  }
+
+  PG_RETURN_POINTER(keys);
+}
+
+PGDLLEXPORT Datum gin_mol_consistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(gin_mol_consistent);
+Datum gin_mol_consistent(PG_FUNCTION_ARGS) {
+  bool *check = (bool *)PG_GETARG_POINTER(0);
+  /* StrategyNumber strategy = PG_GETARG_UINT16(1); */
+  /* CROMol query = PG_GETARG_DATUM(2); */
+  int32 nkeys = PG_GETARG_INT32(3);
+  /* Pointer *extra_data = (Pointer *) PG_GETARG_POINTER(4); */
+  bool *recheck = (bool *)PG_GETARG_POINTER(5);
+  /* Datum * queryKeys = PG_GETARG_POINTER(6); */
+  /* bool *nullFlags = (bool *) PG_GETARG_POINTER(7); */
+
+  bool result = true;
+  int32 i;
+
+  /* both for @> and @= the molecule needs all the bits of the query */
+  for (i = 0; result && i < nkeys; ++i) {
+    result = check[i];
+  }
+
+  *recheck = true;
+
+  PG_RETURN_BOOL(result);
+}
+
+PGDLLEXPORT Datum gin_mol_triconsistent(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(gin_mol_triconsistent);
+Datum gin_mol_triconsistent(PG_FUNCTION_ARGS) {
+  GinTernaryValue *check = (GinTernaryValue *)PG_GETARG_POINTER(0);
+  /* StrategyNumber strategy = PG_GETARG_UINT16(1); */
+  /* CROMol query = PG_GETARG_DATUM(2); */
+  int32 nkeys = PG_GETARG_INT32(3);
+  /* Pointer *extra_data = (Pointer *) PG_GETARG_POINTER(4); */
+  /* Datum * queryKeys = PG_GETARG_POINTER(5); */
+  /* bool *nullFlags = (bool *) PG_GETARG_POINTER(6); */
+
+  /* matches always need to be rechecked */
+  GinTernaryValue result = GIN_MAYBE;
+  int32 i;
+
+  for (i = 0; i < nkeys; ++i) {
+    if (check[i] == GIN_FALSE) {
+      result = GIN_FALSE;
+      break;
+    }
+  }
+
+  PG_RETURN_GIN_TERNARY_VALUE(result);
+}
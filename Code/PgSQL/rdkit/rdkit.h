@@ -144,6 +144,7 @@ int MolSubstruct(CROMol i, CROMol a, bool useChirality, bool useMatchers);
 int MolSubstructCount(CROMol i, CROMol a, bool uniquify, bool useChirality);
 
 bytea *makeMolSignature(CROMol data);
+bytea *makeMolSignatureWithSize(CROMol data, int size);
 
 double MolAMW(CROMol i);
 double MolExactMW(CROMol i);
@@ -0,0 +1,23 @@
+CREATE TABLE cachemols (id integer, m mol);
+INSERT INTO cachemols VALUES (1, 'c1ccccc1O'), (2, 'c1ccccc1N'), (3, 'CCO'), (4, 'CCN');
+
+SET rdkit.backend_cache_size=16;
+SELECT * FROM rdkit_backend_cache_stats();
+
+-- the first query fills the cache, the second one reuses the molecules
+SELECT id FROM cachemols WHERE m @> 'c1ccccc1'::mol ORDER BY id;
+SELECT * FROM rdkit_backend_cache_stats();
+SELECT id FROM cachemols WHERE m @> 'c1ccccc1'::mol ORDER BY id;
+SELECT * FROM rdkit_backend_cache_stats();
+
+-- shrinking the cache evicts the least recently used molecules
+SET rdkit.backend_cache_size=2;
+SELECT id FROM cachemols WHERE m @> 'c1ccccc1'::mol ORDER BY id;
+SELECT entries <= 2 AS bounded, evictions > 0 AS evicted FROM rdkit_backend_cache_stats();
+
+-- and disabling it empties it
+SET rdkit.backend_cache_size=0;
+SELECT id FROM cachemols WHERE m @> 'c1ccccc1'::mol ORDER BY id;
+SELECT entries FROM rdkit_backend_cache_stats();
+
+DROP TABLE cachemols;
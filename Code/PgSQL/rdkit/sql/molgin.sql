@@ -0,0 +1,54 @@
+CREATE INDEX molginidx ON pgmol USING gin (m gin_mol_ops);
+
+SET enable_indexscan=on;
+SET enable_bitmapscan=on;
+SET enable_seqscan=off;
+
+SELECT count(*) FROM pgmol WHERE m @> 'c1ccccc1';
+SELECT count(*) FROM pgmol WHERE m @> 'c1cccnc1';
+SELECT count(*) FROM pgmol WHERE m @> 'c1ccccc1C(=O)N';
+
+-- qmol patterns and exact matches: the index scan must find the same
+-- molecules as a sequential scan
+SET enable_indexscan=off;
+SET enable_bitmapscan=off;
+SET enable_seqscan=on;
+
+CREATE TEMP TABLE molgin_seqscan AS
+  SELECT 1 AS query, id FROM pgmol WHERE m @> qmol_from_smarts('c1ccccc1')
+  UNION ALL
+  SELECT 2, id FROM pgmol WHERE m @> qmol_from_smarts('c1ccc[n,c]c1')
+  UNION ALL
+  SELECT 3, id FROM pgmol WHERE m @= (SELECT m FROM pgmol WHERE id = 6061070)
+  UNION ALL
+  SELECT 4, id FROM pgmol WHERE m @= 'c1ccccc1'::mol;
+SELECT count(*) FROM molgin_seqscan WHERE query = 1;
+SELECT count(*) FROM molgin_seqscan WHERE query = 2;
+SELECT count(*) > 0 AS found FROM molgin_seqscan WHERE query = 3;
+
+SET enable_indexscan=on;
+SET enable_bitmapscan=on;
+SET enable_seqscan=off;
+
+CREATE TEMP TABLE molgin_indexscan AS
+  SELECT 1 AS query, id FROM pgmol WHERE m @> qmol_from_smarts('c1ccccc1')
+  UNION ALL
+  SELECT 2, id FROM pgmol WHERE m @> qmol_from_smarts('c1ccc[n,c]c1')
+  UNION ALL
+  SELECT 3, id FROM pgmol WHERE m @= (SELECT m FROM pgmol WHERE id = 6061070)
+  UNION ALL
+  SELECT 4, id FROM pgmol WHERE m @= 'c1ccccc1'::mol;
+SELECT count(*) FROM (
+  (SELECT * FROM molgin_seqscan EXCEPT ALL SELECT * FROM molgin_indexscan)
+  UNION ALL
+  (SELECT * FROM molgin_indexscan EXCEPT ALL SELECT * FROM molgin_seqscan)
+) AS diff;
+
+DROP TABLE molgin_seqscan;
+DROP TABLE molgin_indexscan;
+
+SET enable_indexscan=on;
+SET enable_bitmapscan=on;
+SET enable_seqscan=on;
+
+DROP INDEX molginidx;
@@ -41,4 +41,58 @@ inline unsigned int getNumThreadsToUse(int target) {
 }  // namespace RDKit
 #endif
 
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <vector>
+
+namespace RDKit {
+//! calls \c func(i) for each \c i in [0, \c numItems), using up to
+//! \c numThreads threads (see getNumThreadsToUse())
+/*!
+  The indices are interleaved across the threads. If \c func throws, the
+  thread which caught the exception skips its remaining indices and the
+  exception of the lowest numbered failing thread is rethrown once all of
+  the threads have finished.
+*/
+template <typename FuncType>
+void runOnIndices(FuncType func, size_t numItems, int numThreads) {
+  unsigned int numThreadsToUse = std::min(static_cast<unsigned int>(numItems),
+                                          getNumThreadsToUse(numThreads));
+  if (numThreadsToUse <= 1) {
+    for (size_t i = 0; i < numItems; ++i) {
+      func(i);
+    }
+  }
+#ifdef RDK_BUILD_THREADSAFE_SSS
+  else {
+    std::vector<std::exception_ptr> errors(numThreadsToUse);
+    auto threadFunc = [&](unsigned int tidx) {
+      try {
+        for (size_t i = tidx; i < numItems; i += numThreadsToUse) {
+          func(i);
+        }
+      } catch (...) {
+        errors[tidx] = std::current_exception();
+      }
+    };
+    std::vector<std::thread> threads;
+    for (auto tidx = 0u; tidx < numThreadsToUse; ++tidx) {
+      threads.emplace_back(threadFunc, tidx);
+    }
+    for (auto &t : threads) {
+      if (t.joinable()) {
+        t.join();
+      }
+    }
+    for (const auto &error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+#endif
+}
+}  // namespace RDKit
+
 #endif
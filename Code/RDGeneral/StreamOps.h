@@ -16,6 +16,7 @@
 #include "Invariant.h"
 #include "RDProps.h"
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <iostream>
 #include <unordered_set>
@@ -334,13 +335,21 @@ inline void streamReadStringVec(std::istream &ss, std::vector<std::string> &val,
   }
 }
 
-//! grabs the next line from an instream and returns it.
-inline std::string getLine(std::istream *inStream) {
-  std::string res;
+//! grabs the next line from an instream into res
+/*!
+  This reuses the storage of res, so calling it in a loop with the same
+  string avoids allocating a new string for each line.
+*/
+inline void getLine(std::istream *inStream, std::string &res) {
   std::getline(*inStream, res);
   if (!res.empty() && (res.back() == '\r')) {
     res.resize(res.length() - 1);
   }
+}
+//! grabs the next line from an instream and returns it.
+inline std::string getLine(std::istream *inStream) {
+  std::string res;
+  getLine(inStream, res);
   return res;
 }
 //! grabs the next line from an instream and returns it.
@@ -348,6 +357,58 @@ inline std::string getLine(std::istream &inStream) {
   return getLine(&inStream);
 }
 
+namespace detail {
+class StringViewStreamBuf : public std::streambuf {
+ public:
+  explicit StringViewStreamBuf(std::string_view data) {
+    // the get area is never written to, so the const_cast is safe
+    auto *begin = const_cast<char *>(data.data());
+    setg(begin, begin, begin + data.size());
+  }
+
+ protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override {
+    if (!(which & std::ios_base::in)) {
+      return pos_type(off_type(-1));
+    }
+    char *target = nullptr;
+    if (dir == std::ios_base::beg) {
+      target = eback() + off;
+    } else if (dir == std::ios_base::cur) {
+      target = gptr() + off;
+    } else {
+      target = egptr() + off;
+    }
+    if (target < eback() || target > egptr()) {
+      return pos_type(off_type(-1));
+    }
+    setg(eback(), target, egptr());
+    return pos_type(target - eback());
+  }
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+  }
+};
+}  // namespace detail
+
+//! an input stream which reads from an existing buffer without copying it
+/*!
+  This allows text which is already in memory (a mol block, a record from
+  a memory-mapped file, etc.) to be passed to code which reads from streams.
+  The buffer must outlive the stream.
+*/
+class StringViewInStream : public std::istream {
+ public:
+  explicit StringViewInStream(std::string_view data)
+      : std::istream(nullptr), d_buf(data) {
+    rdbuf(&d_buf);
+  }
+
+ private:
+  detail::StringViewStreamBuf d_buf;
+};
+
 // n.b. We can't use RDTypeTag directly, they are implementation
 //  specific
 namespace DTags {
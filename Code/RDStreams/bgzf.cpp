@@ -0,0 +1,413 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+#include "bgzf.h"
+#ifdef RDK_USE_BOOST_IOSTREAMS
+
+#include <RDGeneral/BadFileException.h>
+#include <RDGeneral/RDThreads.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace RDKit {
+namespace {
+const size_t headerSize = 18;
+const size_t footerSize = 8;
+const size_t maxBlockSize = 65536;
+// the amount of input in each block written, this leaves room for
+// incompressible data
+const size_t maxBlockInput = 0xff00;
+// the number of blocks each thread decompresses at a time
+const unsigned int blocksPerThread = 8;
+const char eofBlock[] =
+    "\x1f\x8b\x08\x04\x00\x00\x00\x00\x00\xff\x06\x00\x42\x43\x02\x00\x1b\x00"
+    "\x03\x00\x00\x00\x00\x00\x00\x00\x00\x00";
+
+std::uint32_t readLE16(const char *p) {
+  auto u = reinterpret_cast<const unsigned char *>(p);
+  return u[0] | (u[1] << 8);
+}
+std::uint32_t readLE32(const char *p) {
+  auto u = reinterpret_cast<const unsigned char *>(p);
+  return u[0] | (u[1] << 8) | (u[2] << 16) |
+         (static_cast<std::uint32_t>(u[3]) << 24);
+}
+void writeLE16(char *p, std::uint32_t v) {
+  p[0] = static_cast<char>(v & 0xff);
+  p[1] = static_cast<char>((v >> 8) & 0xff);
+}
+void writeLE32(char *p, std::uint32_t v) {
+  writeLE16(p, v & 0xffff);
+  writeLE16(p + 2, v >> 16);
+}
+
+bool isBGZFHeader(const char *h) {
+  return static_cast<unsigned char>(h[0]) == 31 &&
+         static_cast<unsigned char>(h[1]) == 139 && h[2] == 8 &&
+         (h[3] & 4) && readLE16(h + 10) == 6 && h[12] == 'B' &&
+         h[13] == 'C' && readLE16(h + 14) == 2;
+}
+
+void decompressBlock(const std::string &raw, std::vector<char> &data) {
+  const auto *footer = raw.data() + raw.size() - footerSize;
+  auto crc = readLE32(footer);
+  auto isize = readLE32(footer + 4);
+  if (isize > maxBlockSize) {
+    throw std::runtime_error("bad BGZF block size");
+  }
+  data.resize(isize);
+  z_stream zs;
+  std::memset(&zs, 0, sizeof(zs));
+  if (inflateInit2(&zs, -15) != Z_OK) {
+    throw std::runtime_error("could not initialize zlib");
+  }
+  zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(raw.data())) +
+               headerSize;
+  zs.avail_in = static_cast<uInt>(raw.size() - headerSize - footerSize);
+  // zlib doesn't like null output buffers, even for empty blocks
+  char dummy;
+  zs.next_out = reinterpret_cast<Bytef *>(isize ? data.data() : &dummy);
+  zs.avail_out = isize ? isize : 1;
+  auto ret = inflate(&zs, Z_FINISH);
+  inflateEnd(&zs);
+  if (ret != Z_STREAM_END || zs.total_out != isize) {
+    throw std::runtime_error("corrupt BGZF block");
+  }
+  if (crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef *>(data.data()),
+            isize) != crc) {
+    throw std::runtime_error("BGZF block checksum mismatch");
+  }
+}
+
+void compressBlock(const char *src, size_t len, int level, std::string &res) {
+  z_stream zs;
+  std::memset(&zs, 0, sizeof(zs));
+  if (deflateInit2(&zs, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) !=
+      Z_OK) {
+    throw std::runtime_error("could not initialize zlib");
+  }
+  res.resize(maxBlockSize);
+  zs.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(src));
+  zs.avail_in = static_cast<uInt>(len);
+  zs.next_out = reinterpret_cast<Bytef *>(&res[headerSize]);
+  zs.avail_out = static_cast<uInt>(maxBlockSize - headerSize - footerSize);
+  auto ret = deflate(&zs, Z_FINISH);
+  deflateEnd(&zs);
+  if (ret != Z_STREAM_END) {
+    throw std::runtime_error("BGZF block overflow");
+  }
+  auto blockSize = headerSize + zs.total_out + footerSize;
+  res.resize(blockSize);
+  std::memcpy(&res[0], eofBlock, headerSize);
+  writeLE16(&res[16], static_cast<std::uint32_t>(blockSize - 1));
+  auto crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef *>(src),
+                   static_cast<uInt>(len));
+  writeLE32(&res[blockSize - footerSize], static_cast<std::uint32_t>(crc));
+  writeLE32(&res[blockSize - 4], static_cast<std::uint32_t>(len));
+}
+}  // namespace
+
+bool isBGZFStream(std::istream &inStream) {
+  char header[headerSize];
+  auto pos = inStream.tellg();
+  inStream.read(header, headerSize);
+  bool res = inStream.gcount() == headerSize && isBGZFHeader(header);
+  inStream.clear();
+  inStream.seekg(pos);
+  return res;
+}
+
+bool isBGZFFile(const std::string &fname) {
+  std::ifstream inStream(fname.c_str(), std::ios_base::binary);
+  return inStream && isBGZFStream(inStream);
+}
+
+BGZFInStreamBuf::BGZFInStreamBuf(std::istream *inStream, bool takeOwnership,
+                                 int numThreads)
+    : dp_inStream(inStream),
+      df_owner(takeOwnership),
+      d_numThreads(getNumThreadsToUse(numThreads)) {
+  auto pos = dp_inStream->tellg();
+  d_nextOffset = pos >= 0 ? static_cast<std::uint64_t>(pos) : 0;
+  setg(nullptr, nullptr, nullptr);
+}
+
+BGZFInStreamBuf::~BGZFInStreamBuf() {
+  if (df_owner) {
+    delete dp_inStream;
+  }
+}
+
+bool BGZFInStreamBuf::readBlocks() {
+  d_blocks.clear();
+  d_current = 0;
+  const size_t maxBlocks = d_numThreads * blocksPerThread;
+  char header[headerSize];
+  while (d_blocks.size() < maxBlocks) {
+    dp_inStream->read(header, headerSize);
+    if (dp_inStream->gcount() == 0) {
+      break;
+    }
+    if (dp_inStream->gcount() != headerSize || !isBGZFHeader(header)) {
+      throw std::runtime_error("bad BGZF block header");
+    }
+    auto blockSize = readLE16(header + 16) + 1;
+    if (blockSize < headerSize + footerSize) {
+      throw std::runtime_error("bad BGZF block size");
+    }
+    d_blocks.emplace_back();
+    auto &block = d_blocks.back();
+    block.offset = d_nextOffset;
+    block.raw.resize(blockSize);
+    std::memcpy(&block.raw[0], header, headerSize);
+    dp_inStream->read(&block.raw[headerSize], blockSize - headerSize);
+    if (static_cast<size_t>(dp_inStream->gcount()) != blockSize - headerSize) {
+      throw std::runtime_error("truncated BGZF block");
+    }
+    d_nextOffset += blockSize;
+  }
+  runOnIndices(
+      [this](size_t i) {
+        decompressBlock(d_blocks[i].raw, d_blocks[i].data);
+        d_blocks[i].raw = std::string();
+      },
+      d_blocks.size(), d_numThreads);
+  return !d_blocks.empty();
+}
+
+void BGZFInStreamBuf::setBlock(size_t idx, size_t pos) {
+  d_current = idx;
+  auto &data = d_blocks[idx].data;
+  setg(data.data(), data.data() + pos, data.data() + data.size());
+}
+
+bool BGZFInStreamBuf::nextBlock() {
+  // skip over empty blocks, like the EOF marker
+  size_t idx = eback() ? d_current + 1 : 0;
+  while (true) {
+    if (idx >= d_blocks.size()) {
+      if (!readBlocks()) {
+        setg(nullptr, nullptr, nullptr);
+        return false;
+      }
+      idx = 0;
+    }
+    if (!d_blocks[idx].data.empty()) {
+      setBlock(idx, 0);
+      return true;
+    }
+    ++idx;
+  }
+}
+
+BGZFInStreamBuf::int_type BGZFInStreamBuf::underflow() {
+  if (gptr() < egptr()) {
+    return traits_type::to_int_type(*gptr());
+  }
+  if (!nextBlock()) {
+    return traits_type::eof();
+  }
+  return traits_type::to_int_type(*gptr());
+}
+
+std::uint64_t BGZFInStreamBuf::tell() const {
+  if (!eback()) {
+    return d_nextOffset << 16;
+  }
+  if (gptr() == egptr()) {
+    // the start of the next block, the offset in this one may not fit
+    if (d_current + 1 < d_blocks.size()) {
+      return d_blocks[d_current + 1].offset << 16;
+    }
+    return d_nextOffset << 16;
+  }
+  return (d_blocks[d_current].offset << 16) |
+         static_cast<std::uint64_t>(gptr() - eback());
+}
+
+BGZFInStreamBuf::pos_type BGZFInStreamBuf::seekoff(
+    off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) {
+  if (dir == std::ios_base::cur && off == 0) {
+    return pos_type(static_cast<off_type>(tell()));
+  }
+  if (dir == std::ios_base::beg) {
+    return seekpos(pos_type(off), which);
+  }
+  // relative seeks don't work with virtual offsets
+  return pos_type(off_type(-1));
+}
+
+BGZFInStreamBuf::pos_type BGZFInStreamBuf::seekpos(
+    pos_type pos, std::ios_base::openmode which) {
+  if (!(which & std::ios_base::in) || off_type(pos) < 0) {
+    return pos_type(off_type(-1));
+  }
+  const auto voffset = static_cast<std::uint64_t>(off_type(pos));
+  const auto blockOffset = voffset >> 16;
+  const size_t posInBlock = voffset & 0xffff;
+  // we don't need to read anything if the block is already loaded
+  for (size_t i = 0; i < d_blocks.size(); ++i) {
+    if (d_blocks[i].offset == blockOffset) {
+      if (posInBlock > d_blocks[i].data.size()) {
+        return pos_type(off_type(-1));
+      }
+      setBlock(i, posInBlock);
+      return pos;
+    }
+  }
+  dp_inStream->clear();
+  dp_inStream->seekg(static_cast<std::streamoff>(blockOffset));
+  if (dp_inStream->fail()) {
+    return pos_type(off_type(-1));
+  }
+  d_nextOffset = blockOffset;
+  setg(nullptr, nullptr, nullptr);
+  if (!readBlocks()) {
+    // at the end of the data
+    return posInBlock ? pos_type(off_type(-1)) : pos;
+  }
+  if (posInBlock > d_blocks[0].data.size()) {
+    return pos_type(off_type(-1));
+  }
+  setBlock(0, posInBlock);
+  return pos;
+}
+
+BGZFOutStreamBuf::BGZFOutStreamBuf(std::ostream *outStream, bool takeOwnership,
+                                   int numThreads, int compressionLevel)
+    : dp_outStream(outStream),
+      df_owner(takeOwnership),
+      d_numThreads(getNumThreadsToUse(numThreads)),
+      d_compressionLevel(compressionLevel),
+      d_buffer(d_numThreads * maxBlockInput) {
+  setp(d_buffer.data(), d_buffer.data() + d_buffer.size());
+}
+
+BGZFOutStreamBuf::~BGZFOutStreamBuf() {
+  try {
+    close();
+  } catch (const std::runtime_error &) {
+  }
+}
+
+void BGZFOutStreamBuf::writeBlocks() {
+  const size_t nBytes = pptr() - pbase();
+  if (!nBytes) {
+    return;
+  }
+  std::vector<std::string> blocks((nBytes + maxBlockInput - 1) /
+                                  maxBlockInput);
+  runOnIndices(
+      [&](size_t i) {
+        auto start = i * maxBlockInput;
+        compressBlock(pbase() + start, std::min(maxBlockInput, nBytes - start),
+                      d_compressionLevel, blocks[i]);
+      },
+      blocks.size(), d_numThreads);
+  for (const auto &block : blocks) {
+    dp_outStream->write(block.data(), block.size());
+  }
+  setp(d_buffer.data(), d_buffer.data() + d_buffer.size());
+}
+
+BGZFOutStreamBuf::int_type BGZFOutStreamBuf::overflow(int_type c) {
+  if (!dp_outStream) {
+    return traits_type::eof();
+  }
+  writeBlocks();
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+int BGZFOutStreamBuf::sync() {
+  if (!dp_outStream) {
+    return -1;
+  }
+  writeBlocks();
+  dp_outStream->flush();
+  return dp_outStream->good() ? 0 : -1;
+}
+
+void BGZFOutStreamBuf::close() {
+  if (!dp_outStream) {
+    return;
+  }
+  writeBlocks();
+  dp_outStream->write(eofBlock, sizeof(eofBlock) - 1);
+  dp_outStream->flush();
+  if (df_owner) {
+    delete dp_outStream;
+    df_owner = false;
+  }
+  dp_outStream = nullptr;
+  setp(nullptr, nullptr);
+}
+
+bgzfstream::bgzfstream(const std::string &fname, int numThreads)
+    : std::istream(nullptr) {
+  auto *inStream = new std::ifstream(fname.c_str(), std::ios_base::binary);
+  if (!(*inStream) || !isBGZFStream(*inStream)) {
+    delete inStream;
+    throw BadFileException("Bad BGZF input file " + fname);
+  }
+  dp_buf.reset(new BGZFInStreamBuf(inStream, true, numThreads));
+  rdbuf(dp_buf.get());
+}
+
+bgzfstream::bgzfstream(std::istream *inStream, bool takeOwnership,
+                       int numThreads)
+    : std::istream(nullptr),
+      dp_buf(new BGZFInStreamBuf(inStream, takeOwnership, numThreads)) {
+  rdbuf(dp_buf.get());
+}
+
+bgzfstream::~bgzfstream() { rdbuf(nullptr); }
+
+bgzfostream::bgzfostream(const std::string &fname, int numThreads,
+                         int compressionLevel)
+    : std::ostream(nullptr) {
+  auto *outStream = new std::ofstream(fname.c_str(), std::ios_base::binary);
+  if (!(*outStream)) {
+    delete outStream;
+    throw BadFileException("Bad output file " + fname);
+  }
+  dp_buf.reset(
+      new BGZFOutStreamBuf(outStream, true, numThreads, compressionLevel));
+  rdbuf(dp_buf.get());
+}
+
+bgzfostream::bgzfostream(std::ostream *outStream, bool takeOwnership,
+                         int numThreads, int compressionLevel)
+    : std::ostream(nullptr),
+      dp_buf(new BGZFOutStreamBuf(outStream, takeOwnership, numThreads,
+                                  compressionLevel)) {
+  rdbuf(dp_buf.get());
+}
+
+bgzfostream::~bgzfostream() {
+  try {
+    close();
+  } catch (const std::runtime_error &) {
+  }
+  rdbuf(nullptr);
+}
+
+void bgzfostream::close() {
+  if (dp_buf) {
+    dp_buf->close();
+  }
+}
+}  // namespace RDKit
+#endif
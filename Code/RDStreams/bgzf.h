@@ -0,0 +1,141 @@
+//
+//  Copyright (C) 2024 Greg Landrum and other RDKit contributors
+//
+//   @@ All Rights Reserved @@
+//  This file is part of the RDKit.
+//  The contents are covered by the terms of the BSD license
+//  which is included in the file license.txt, found at the root
+//  of the RDKit source tree.
+//
+
+/*! \file bgzf.h
+
+  \brief Streams for BGZF (block gzip) compressed data
+
+  BGZF files, as written by bgzip and samtools, are a series of gzip
+  members with at most 64KB of uncompressed data each. Any gzip reader can
+  read them, but because the blocks are independent of each other they can
+  also be decompressed in parallel, and a position in the uncompressed data
+  can be found without decompressing everything in front of it.
+
+  The positions returned by tellg() on a bgzfstream are BGZF "virtual
+  offsets": the offset of the block in the compressed file shifted left by
+  16 bits, combined with the offset in the uncompressed block. They can be
+  passed to seekg(), but arithmetic on them doesn't make sense.
+*/
+#include <RDGeneral/export.h>
+#ifndef RD_BGZF_H
+#define RD_BGZF_H
+#ifdef RDK_USE_BOOST_IOSTREAMS
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace RDKit {
+
+//! returns whether or not the stream is positioned at the start of a BGZF
+//! block. The position of the stream is not changed.
+RDKIT_RDSTREAMS_EXPORT bool isBGZFStream(std::istream &inStream);
+//! returns whether or not the file starts with a BGZF block
+RDKIT_RDSTREAMS_EXPORT bool isBGZFFile(const std::string &fname);
+
+//! a streambuf that reads BGZF compressed data from another stream
+class RDKIT_RDSTREAMS_EXPORT BGZFInStreamBuf : public std::streambuf {
+ public:
+  //! numThreads is the number of threads used to decompress blocks, values
+  //! <= 0 are interpreted as in getNumThreadsToUse()
+  BGZFInStreamBuf(std::istream *inStream, bool takeOwnership = false,
+                  int numThreads = 1);
+  ~BGZFInStreamBuf() override;
+
+  BGZFInStreamBuf(const BGZFInStreamBuf &) = delete;
+  BGZFInStreamBuf &operator=(const BGZFInStreamBuf &) = delete;
+
+ protected:
+  int_type underflow() override;
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                   std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+ private:
+  struct Block {
+    std::uint64_t offset = 0;  // in the compressed stream
+    std::string raw;
+    std::vector<char> data;
+  };
+  bool readBlocks();
+  bool nextBlock();
+  void setBlock(size_t idx, size_t pos);
+  std::uint64_t tell() const;
+
+  std::istream *dp_inStream = nullptr;
+  bool df_owner = false;
+  unsigned int d_numThreads = 1;
+  std::uint64_t d_nextOffset = 0;
+  std::vector<Block> d_blocks;
+  size_t d_current = 0;
+};
+
+//! a streambuf that writes BGZF compressed data to another stream
+class RDKIT_RDSTREAMS_EXPORT BGZFOutStreamBuf : public std::streambuf {
+ public:
+  //! numThreads is the number of threads used to compress blocks, values
+  //! <= 0 are interpreted as in getNumThreadsToUse()
+  BGZFOutStreamBuf(std::ostream *outStream, bool takeOwnership = false,
+                   int numThreads = 1, int compressionLevel = -1);
+  ~BGZFOutStreamBuf() override;
+
+  BGZFOutStreamBuf(const BGZFOutStreamBuf &) = delete;
+  BGZFOutStreamBuf &operator=(const BGZFOutStreamBuf &) = delete;
+
+  //! writes the remaining data and the end-of-file marker block
+  void close();
+
+ protected:
+  int_type overflow(int_type c) override;
+  int sync() override;
+
+ private:
+  void writeBlocks();
+
+  std::ostream *dp_outStream = nullptr;
+  bool df_owner = false;
+  unsigned int d_numThreads = 1;
+  int d_compressionLevel = -1;
+  std::vector<char> d_buffer;
+};
+
+//! bgzfstream from a file or stream
+class RDKIT_RDSTREAMS_EXPORT bgzfstream : public std::istream {
+  std::unique_ptr<BGZFInStreamBuf> dp_buf;
+
+ public:
+  //! throws a BadFileException if the file can't be opened or isn't BGZF
+  bgzfstream(const std::string &fname, int numThreads = 1);
+  bgzfstream(std::istream *inStream, bool takeOwnership = false,
+             int numThreads = 1);
+  ~bgzfstream() override;
+};
+
+//! BGZF output to a file or stream
+class RDKIT_RDSTREAMS_EXPORT bgzfostream : public std::ostream {
+  std::unique_ptr<BGZFOutStreamBuf> dp_buf;
+
+ public:
+  //! throws a BadFileException if the file can't be opened
+  bgzfostream(const std::string &fname, int numThreads = 1,
+              int compressionLevel = -1);
+  bgzfostream(std::ostream *outStream, bool takeOwnership = false,
+              int numThreads = 1, int compressionLevel = -1);
+  ~bgzfostream() override;
+
+  //! finishes the BGZF data, nothing can be written afterwards
+  void close();
+};
+}  // namespace RDKit
+#endif
+#endif